@@ -322,12 +322,22 @@ void Engine::startup_benchmark_end_measure() {
 	uint64_t total = OS::get_singleton()->get_ticks_usec() - startup_benchmark_from;
 	double total_f = double(total) / double(1000000);
 
+	MutexLock lock(startup_benchmark_mutex);
 	startup_benchmark_json[startup_benchmark_section] = total_f;
 }
 
+void Engine::startup_benchmark_add_measure(const String &p_what, uint64_t p_usec) {
+	double total_f = double(p_usec) / double(1000000);
+
+	MutexLock lock(startup_benchmark_mutex);
+	startup_benchmark_json[p_what] = double(startup_benchmark_json.get(p_what, 0.0)) + total_f;
+}
+
 void Engine::startup_dump(const String &p_to_file) {
 	uint64_t total = OS::get_singleton()->get_ticks_usec() - startup_benchmark_total_from;
 	double total_f = double(total) / double(1000000);
+
+	MutexLock lock(startup_benchmark_mutex);
 	startup_benchmark_json["total_time"] = total_f;
 
 	if (!p_to_file.is_empty()) {
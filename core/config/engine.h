@@ -32,6 +32,7 @@
 #define ENGINE_H
 
 #include "core/os/main_loop.h"
+#include "core/os/mutex.h"
 #include "core/string/ustring.h"
 #include "core/templates/list.h"
 #include "core/templates/vector.h"
@@ -86,6 +87,7 @@ private:
 	String startup_benchmark_section;
 	uint64_t startup_benchmark_from = 0;
 	uint64_t startup_benchmark_total_from = 0;
+	Mutex startup_benchmark_mutex;
 
 public:
 	static Engine *get_singleton();
@@ -162,6 +164,7 @@ public:
 	void startup_begin();
 	void startup_benchmark_begin_measure(const String &p_what);
 	void startup_benchmark_end_measure();
+	void startup_benchmark_add_measure(const String &p_what, uint64_t p_usec); // Accumulates, can be called from any thread.
 	void startup_dump(const String &p_to_file);
 
 	Engine();
@@ -33,6 +33,7 @@
 #include "core/core_bind.h" // For Compression enum.
 #include "core/core_string_names.h"
 #include "core/input/input_map.h"
+#include "core/io/derived_data_cache.h"
 #include "core/io/dir_access.h"
 #include "core/io/file_access.h"
 #include "core/io/file_access_network.h"
@@ -634,10 +635,25 @@ Error ProjectSettings::setup(const String &p_path, const String &p_main_pack, bo
 	Compression::zstd_level = GLOBAL_GET("compression/formats/zstd/compression_level");
 	Compression::zstd_window_log_size = GLOBAL_GET("compression/formats/zstd/window_log_size");
 
+	// Registered after the level is known, so it is digested for the level it will be used at.
+	Compression::zstd_dictionary_id = 0;
+	String zstd_dictionary_path = GLOBAL_GET("compression/formats/zstd/dictionary");
+	if (!zstd_dictionary_path.is_empty()) {
+		Vector<uint8_t> zstd_dictionary = FileAccess::get_file_as_array(zstd_dictionary_path);
+		if (zstd_dictionary.is_empty()) {
+			ERR_PRINT("Can't load the Zstandard dictionary from: " + zstd_dictionary_path + ".");
+		} else {
+			Compression::zstd_dictionary_id = Compression::add_zstd_dictionary(zstd_dictionary);
+		}
+	}
+
 	Compression::zlib_level = GLOBAL_GET("compression/formats/zlib/compression_level");
 
 	Compression::gzip_level = GLOBAL_GET("compression/formats/gzip/compression_level");
 
+	DerivedDataCache::enabled = GLOBAL_GET("filesystem/derived_data_cache/enabled");
+	DerivedDataCache::path = GLOBAL_GET("filesystem/derived_data_cache/path");
+
 	return err;
 }
 
@@ -1285,6 +1301,8 @@ ProjectSettings::ProjectSettings() {
 	custom_prop_info["compression/formats/zstd/compression_level"] = PropertyInfo(Variant::INT, "compression/formats/zstd/compression_level", PROPERTY_HINT_RANGE, "1,22,1");
 	GLOBAL_DEF("compression/formats/zstd/window_log_size", Compression::zstd_window_log_size);
 	custom_prop_info["compression/formats/zstd/window_log_size"] = PropertyInfo(Variant::INT, "compression/formats/zstd/window_log_size", PROPERTY_HINT_RANGE, "10,30,1");
+	GLOBAL_DEF("compression/formats/zstd/dictionary", "");
+	custom_prop_info["compression/formats/zstd/dictionary"] = PropertyInfo(Variant::STRING, "compression/formats/zstd/dictionary", PROPERTY_HINT_FILE, "");
 
 	GLOBAL_DEF("compression/formats/zlib/compression_level", Compression::zlib_level);
 	custom_prop_info["compression/formats/zlib/compression_level"] = PropertyInfo(Variant::INT, "compression/formats/zlib/compression_level", PROPERTY_HINT_RANGE, "-1,9,1");
@@ -1292,6 +1310,9 @@ ProjectSettings::ProjectSettings() {
 	GLOBAL_DEF("compression/formats/gzip/compression_level", Compression::gzip_level);
 	custom_prop_info["compression/formats/gzip/compression_level"] = PropertyInfo(Variant::INT, "compression/formats/gzip/compression_level", PROPERTY_HINT_RANGE, "-1,9,1");
 
+	GLOBAL_DEF("filesystem/derived_data_cache/enabled", DerivedDataCache::enabled);
+	GLOBAL_DEF("filesystem/derived_data_cache/path", DerivedDataCache::path);
+
 	// These properties will not show up in the dialog nor in the documentation. If you want to exclude whole groups, see _get_property_list() method.
 	GLOBAL_DEF_INTERNAL("application/config/features", PackedStringArray());
 	GLOBAL_DEF_INTERNAL("internationalization/locale/translation_remaps", PackedStringArray());
@@ -32,13 +32,30 @@
 
 #include "core/config/project_settings.h"
 #include "core/io/zip_io.h"
+#include "core/os/rw_lock.h"
+#include "core/templates/hash_map.h"
 
 #include "thirdparty/misc/fastlz.h"
 
+#include <zdict.h>
 #include <zlib.h>
 #include <zstd.h>
 
-int Compression::compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, Mode p_mode) {
+// Dictionaries are digested once when registered, since that is the costly part of using them.
+// The lock is held for reading during each (de)compression, so removing one waits for its users.
+struct ZstdDictionary {
+	Vector<uint8_t> data;
+	ZSTD_CDict *cdict = nullptr;
+	int cdict_level = 0;
+	ZSTD_DDict *ddict = nullptr;
+};
+
+static HashMap<uint32_t, ZstdDictionary> zstd_dictionaries;
+static RWLock zstd_dictionaries_lock;
+
+int Compression::compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, Mode p_mode, uint32_t p_zstd_dictionary_id) {
+	ERR_FAIL_COND_V_MSG(p_zstd_dictionary_id != 0 && p_mode != MODE_ZSTD, -1, "Dictionaries can only be used with Zstandard compression.");
+
 	switch (p_mode) {
 		case MODE_FASTLZ: {
 			if (p_src_size < 16) {
@@ -84,6 +101,23 @@ int Compression::compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size,
 				ZSTD_CCtx_setParameter(cctx, ZSTD_c_windowLog, zstd_window_log_size);
 			}
 			int max_dst_size = get_max_compressed_buffer_size(p_src_size, MODE_ZSTD);
+			if (p_zstd_dictionary_id != 0) {
+				RWLockRead lock(zstd_dictionaries_lock);
+				const ZstdDictionary *dictionary = zstd_dictionaries.getptr(p_zstd_dictionary_id);
+				if (!dictionary) {
+					ZSTD_freeCCtx(cctx);
+					ERR_FAIL_V_MSG(-1, vformat("Zstandard dictionary %d is not registered.", p_zstd_dictionary_id));
+				}
+				if (dictionary->cdict_level == zstd_level) {
+					ZSTD_CCtx_refCDict(cctx, dictionary->cdict);
+				} else {
+					// The level changed after registering, digest it again for this call.
+					ZSTD_CCtx_loadDictionary(cctx, dictionary->data.ptr(), dictionary->data.size());
+				}
+				size_t ret = ZSTD_compress2(cctx, p_dst, max_dst_size, p_src, p_src_size);
+				ZSTD_freeCCtx(cctx);
+				return ZSTD_isError(ret) ? -1 : int(ret);
+			}
 			int ret = ZSTD_compressCCtx(cctx, p_dst, max_dst_size, p_src, p_src_size, zstd_level);
 			ZSTD_freeCCtx(cctx);
 			return ret;
@@ -127,7 +161,9 @@ int Compression::get_max_compressed_buffer_size(int p_src_size, Mode p_mode) {
 	ERR_FAIL_V(-1);
 }
 
-int Compression::decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, Mode p_mode) {
+int Compression::decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, Mode p_mode, uint32_t p_zstd_dictionary_id) {
+	ERR_FAIL_COND_V_MSG(p_zstd_dictionary_id != 0 && p_mode != MODE_ZSTD, -1, "Dictionaries can only be used with Zstandard compression.");
+
 	switch (p_mode) {
 		case MODE_FASTLZ: {
 			int ret_size = 0;
@@ -171,6 +207,18 @@ int Compression::decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p
 			if (zstd_long_distance_matching) {
 				ZSTD_DCtx_setParameter(dctx, ZSTD_d_windowLogMax, zstd_window_log_size);
 			}
+			if (p_zstd_dictionary_id != 0) {
+				RWLockRead lock(zstd_dictionaries_lock);
+				const ZstdDictionary *dictionary = zstd_dictionaries.getptr(p_zstd_dictionary_id);
+				if (!dictionary) {
+					ZSTD_freeDCtx(dctx);
+					ERR_FAIL_V_MSG(-1, vformat("Zstandard dictionary %d is not registered.", p_zstd_dictionary_id));
+				}
+				ZSTD_DCtx_refDDict(dctx, dictionary->ddict);
+				size_t ret = ZSTD_decompressDCtx(dctx, p_dst, p_dst_max_size, p_src, p_src_size);
+				ZSTD_freeDCtx(dctx);
+				return ZSTD_isError(ret) ? -1 : int(ret);
+			}
 			int ret = ZSTD_decompressDCtx(dctx, p_dst, p_dst_max_size, p_src, p_src_size);
 			ZSTD_freeDCtx(dctx);
 			return ret;
@@ -269,9 +317,73 @@ int Compression::decompress_dynamic(Vector<uint8_t> *p_dst_vect, int p_max_dst_s
 	return Z_OK;
 }
 
+Vector<uint8_t> Compression::train_zstd_dictionary(const Vector<Vector<uint8_t>> &p_samples, int p_max_size) {
+	ERR_FAIL_COND_V(p_max_size <= 0, Vector<uint8_t>());
+
+	// The trainer takes all samples one after the other, along with the size of each.
+	Vector<uint8_t> samples;
+	Vector<size_t> sample_sizes;
+	for (const Vector<uint8_t> &sample : p_samples) {
+		if (!sample.is_empty()) {
+			samples.append_array(sample);
+			sample_sizes.push_back(sample.size());
+		}
+	}
+	ERR_FAIL_COND_V_MSG(sample_sizes.is_empty(), Vector<uint8_t>(), "Can't train a Zstandard dictionary without samples.");
+
+	Vector<uint8_t> dictionary;
+	dictionary.resize(p_max_size);
+	size_t size = ZDICT_trainFromBuffer(dictionary.ptrw(), p_max_size, samples.ptr(), sample_sizes.ptr(), sample_sizes.size());
+	ERR_FAIL_COND_V_MSG(ZDICT_isError(size), Vector<uint8_t>(), vformat("Training a Zstandard dictionary failed: %s (%d samples, %d bytes).", ZDICT_getErrorName(size), sample_sizes.size(), samples.size()));
+	dictionary.resize(size);
+	return dictionary;
+}
+
+uint32_t Compression::add_zstd_dictionary(const Vector<uint8_t> &p_dictionary) {
+	ERR_FAIL_COND_V_MSG(p_dictionary.is_empty(), 0, "Can't register an empty Zstandard dictionary.");
+
+	// Identify dictionaries by content, so files compressed with one can find it again.
+	uint32_t id = hash_murmur3_buffer(p_dictionary.ptr(), p_dictionary.size());
+	if (id == 0) {
+		id = 1;
+	}
+
+	RWLockWrite lock(zstd_dictionaries_lock);
+	ZstdDictionary *dictionary = zstd_dictionaries.getptr(id);
+	if (dictionary && dictionary->cdict_level == zstd_level) {
+		return id;
+	}
+	if (!dictionary) {
+		dictionary = &zstd_dictionaries.insert(id, ZstdDictionary())->value;
+		dictionary->data = p_dictionary;
+		dictionary->ddict = ZSTD_createDDict(p_dictionary.ptr(), p_dictionary.size());
+	} else {
+		ZSTD_freeCDict(dictionary->cdict);
+	}
+	dictionary->cdict = ZSTD_createCDict(p_dictionary.ptr(), p_dictionary.size(), zstd_level);
+	dictionary->cdict_level = zstd_level;
+
+	return id;
+}
+
+bool Compression::has_zstd_dictionary(uint32_t p_id) {
+	RWLockRead lock(zstd_dictionaries_lock);
+	return zstd_dictionaries.has(p_id);
+}
+
+void Compression::remove_zstd_dictionary(uint32_t p_id) {
+	RWLockWrite lock(zstd_dictionaries_lock);
+	ZstdDictionary *dictionary = zstd_dictionaries.getptr(p_id);
+	ERR_FAIL_COND_MSG(!dictionary, vformat("Zstandard dictionary %d is not registered.", p_id));
+	ZSTD_freeCDict(dictionary->cdict);
+	ZSTD_freeDDict(dictionary->ddict);
+	zstd_dictionaries.erase(p_id);
+}
+
 int Compression::zlib_level = Z_DEFAULT_COMPRESSION;
 int Compression::gzip_level = Z_DEFAULT_COMPRESSION;
 int Compression::zstd_level = 3;
 bool Compression::zstd_long_distance_matching = false;
 int Compression::zstd_window_log_size = 27; // ZSTD_WINDOWLOG_LIMIT_DEFAULT
 int Compression::gzip_chunk = 16384;
+uint32_t Compression::zstd_dictionary_id = 0;
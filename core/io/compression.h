@@ -42,6 +42,7 @@ public:
 	static bool zstd_long_distance_matching;
 	static int zstd_window_log_size;
 	static int gzip_chunk;
+	static uint32_t zstd_dictionary_id;
 
 	enum Mode {
 		MODE_FASTLZ,
@@ -50,10 +51,22 @@ public:
 		MODE_GZIP
 	};
 
-	static int compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, Mode p_mode = MODE_ZSTD);
+	// p_zstd_dictionary_id is only valid with MODE_ZSTD, and must have been registered with add_zstd_dictionary().
+	static int compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, Mode p_mode = MODE_ZSTD, uint32_t p_zstd_dictionary_id = 0);
 	static int get_max_compressed_buffer_size(int p_src_size, Mode p_mode = MODE_ZSTD);
-	static int decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, Mode p_mode = MODE_ZSTD);
+	static int decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, Mode p_mode = MODE_ZSTD, uint32_t p_zstd_dictionary_id = 0);
 	static int decompress_dynamic(Vector<uint8_t> *p_dst_vect, int p_max_dst_size, const uint8_t *p_src, int p_src_size, Mode p_mode);
+
+	enum {
+		ZSTD_DICTIONARY_DEFAULT_SIZE = 112640, // Same as `zstd --train`.
+	};
+
+	// Samples should be uncompressed data like what the dictionary will be used on, such as each resource of a project.
+	static Vector<uint8_t> train_zstd_dictionary(const Vector<Vector<uint8_t>> &p_samples, int p_max_size = ZSTD_DICTIONARY_DEFAULT_SIZE);
+	// Any raw content is also accepted as a dictionary.
+	static uint32_t add_zstd_dictionary(const Vector<uint8_t> &p_dictionary);
+	static bool has_zstd_dictionary(uint32_t p_id);
+	static void remove_zstd_dictionary(uint32_t p_id);
 };
 
 #endif // COMPRESSION_H
@@ -0,0 +1,148 @@
+/*************************************************************************/
+/*  derived_data_cache.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "derived_data_cache.h"
+
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/io/resource_loader.h"
+#include "core/os/thread.h"
+#include "core/version.h"
+
+#define DERIVED_DATA_CACHE_FORMAT_VERSION 1
+
+Mutex DerivedDataCache::mutex;
+bool DerivedDataCache::dir_created = false;
+bool DerivedDataCache::enabled = false;
+String DerivedDataCache::path = "user://derived_data_cache";
+
+String DerivedDataCache::_get_file(const String &p_resource_path, const String &p_kind) {
+	String base_path = p_resource_path.get_slice("::", 0);
+	String key = base_path;
+	ResourceUID::ID uid = ResourceLoader::get_resource_uid(base_path);
+	if (uid != ResourceUID::INVALID_ID) {
+		// Stays valid when the file is moved or renamed.
+		key = ResourceUID::get_singleton()->id_to_text(uid);
+	}
+	if (p_resource_path.contains("::")) {
+		key += "::" + p_resource_path.get_slice("::", 1);
+	}
+	key += "::" + p_kind;
+
+	return path.path_join(key.md5_text() + ".ddc");
+}
+
+bool DerivedDataCache::get(const String &p_resource_path, const String &p_kind, const String &p_content_hash, Vector<uint8_t> &r_data) {
+	if (!enabled || p_resource_path.is_empty()) {
+		return false;
+	}
+
+	Ref<FileAccess> f = FileAccess::open(_get_file(p_resource_path, p_kind), FileAccess::READ);
+	if (f.is_null()) {
+		return false;
+	}
+
+	uint8_t header[4];
+	if (f->get_buffer(header, 4) != 4 || header[0] != 'G' || header[1] != 'D' || header[2] != 'D' || header[3] != 'C') {
+		return false;
+	}
+	if (f->get_32() != DERIVED_DATA_CACHE_FORMAT_VERSION || f->get_pascal_string() != VERSION_FULL_BUILD || f->get_pascal_string() != p_content_hash) {
+		return false;
+	}
+
+	uint64_t size = f->get_64();
+	if (f->eof_reached() || size > f->get_length() - f->get_position()) {
+		return false;
+	}
+
+	r_data.resize(size);
+	if (f->get_buffer(r_data.ptrw(), size) != size) {
+		r_data.clear();
+		return false;
+	}
+	return true;
+}
+
+void DerivedDataCache::store(const String &p_resource_path, const String &p_kind, const String &p_content_hash, const Vector<uint8_t> &p_data) {
+	if (!enabled || p_resource_path.is_empty()) {
+		return;
+	}
+
+	{
+		MutexLock lock(mutex);
+		if (!dir_created) {
+			Error err = DirAccess::make_dir_recursive_absolute(path);
+			ERR_FAIL_COND_MSG(err != OK, "Can't create the derived data cache directory: " + path + ".");
+			dir_created = true;
+		}
+	}
+
+	// Written aside and moved in place, so readers never see a partial entry.
+	String file = _get_file(p_resource_path, p_kind);
+	String temp_file = file + "." + itos(Thread::get_caller_id()) + ".tmp";
+	{
+		Ref<FileAccess> f = FileAccess::open(temp_file, FileAccess::WRITE);
+		ERR_FAIL_COND_MSG(f.is_null(), "Can't write to the derived data cache: " + temp_file + ".");
+
+		f->store_buffer((const uint8_t *)"GDDC", 4);
+		f->store_32(DERIVED_DATA_CACHE_FORMAT_VERSION);
+		f->store_pascal_string(VERSION_FULL_BUILD);
+		f->store_pascal_string(p_content_hash);
+		f->store_64(p_data.size());
+		f->store_buffer(p_data.ptr(), p_data.size());
+		if (f->get_error() != OK) {
+			f.unref();
+			DirAccess::remove_absolute(temp_file);
+			ERR_FAIL_MSG("Can't write to the derived data cache: " + temp_file + ".");
+		}
+	}
+
+	if (FileAccess::exists(file)) {
+		DirAccess::remove_absolute(file);
+	}
+	if (DirAccess::rename_absolute(temp_file, file) != OK) {
+		DirAccess::remove_absolute(temp_file);
+	}
+}
+
+void DerivedDataCache::clear() {
+	MutexLock lock(mutex);
+	Ref<DirAccess> da = DirAccess::open(path);
+	if (da.is_null()) {
+		return;
+	}
+
+	PackedStringArray files = da->get_files();
+	for (int i = 0; i < files.size(); i++) {
+		if (files[i].ends_with(".ddc") || files[i].ends_with(".tmp")) {
+			da->remove(files[i]);
+		}
+	}
+}
@@ -0,0 +1,59 @@
+/*************************************************************************/
+/*  derived_data_cache.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef DERIVED_DATA_CACHE_H
+#define DERIVED_DATA_CACHE_H
+
+#include "core/os/mutex.h"
+#include "core/string/ustring.h"
+#include "core/templates/vector.h"
+
+// Keeps data computed from resources on disk across runs, such as acceleration structures.
+// Entries are keyed by the ResourceUID of the resource (or its path, if it has none), the
+// sub-resource ID and a kind, and are only valid for the content hash they were stored with.
+// They are also dropped when the engine build changes, so raw engine structures can be stored.
+class DerivedDataCache {
+	static Mutex mutex;
+	static bool dir_created;
+
+	static String _get_file(const String &p_resource_path, const String &p_kind);
+
+public:
+	static bool enabled;
+	static String path;
+
+	static bool is_enabled() { return enabled; }
+
+	static bool get(const String &p_resource_path, const String &p_kind, const String &p_content_hash, Vector<uint8_t> &r_data);
+	static void store(const String &p_resource_path, const String &p_kind, const String &p_content_hash, const Vector<uint8_t> &p_data);
+	static void clear();
+};
+
+#endif // DERIVED_DATA_CACHE_H
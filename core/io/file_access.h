@@ -127,6 +127,9 @@ public:
 	Variant get_var(bool p_allow_objects = false) const;
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const; ///< get an array of bytes
+	// Returns the next p_length bytes without copying them, and moves past them. The data is read-only and stays valid until the file is closed.
+	// Returns nullptr and reads nothing if the file can't provide views (then use get_buffer()) or fewer bytes remain.
+	virtual const uint8_t *get_buffer_view(uint64_t p_length) const { return nullptr; }
 	Vector<uint8_t> _get_buffer(int64_t p_length) const;
 	virtual String get_line() const;
 	virtual String get_token() const;
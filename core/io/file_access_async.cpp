@@ -0,0 +1,163 @@
+/*************************************************************************/
+/*  file_access_async.cpp                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "file_access_async.h"
+
+#include "core/io/file_access.h"
+
+FileAccessAsync *FileAccessAsync::singleton = nullptr;
+FileAccessAsync *(*FileAccessAsync::create_func)() = nullptr;
+
+FileAccessAsync *FileAccessAsync::create() {
+	singleton = create_func ? create_func() : memnew(FileAccessAsync);
+	return singleton;
+}
+
+void FileAccessAsync::_read_task(Read *p_read) {
+	Error err;
+	Ref<FileAccess> f = FileAccess::open(p_read->path, FileAccess::READ, &err);
+	if (f.is_null()) {
+		p_read->error = err;
+	} else {
+		uint64_t file_length = f->get_length();
+		uint64_t offset = MIN(p_read->offset, file_length);
+		uint64_t length = file_length - offset;
+		if (p_read->length >= 0) {
+			length = MIN((uint64_t)p_read->length, length);
+		}
+
+		p_read->data.resize(length);
+		if (length > 0) {
+			f->seek(offset);
+			uint64_t got = f->get_buffer(p_read->data.ptrw(), length);
+			if (got < length) {
+				p_read->data.resize(got);
+			}
+		}
+	}
+
+	p_read->completed.set();
+	if (p_read->callback) {
+		p_read->callback(p_read->userdata, p_read->id, p_read->error, p_read->data);
+	}
+	p_read->done.post();
+}
+
+void FileAccessAsync::_callback_task(Read *p_read) {
+	p_read->callback(p_read->userdata, p_read->id, p_read->error, p_read->data);
+}
+
+void FileAccessAsync::_submit(Read *p_read) {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool && pool->get_thread_count() > 0) {
+		p_read->read_task_id = pool->add_template_task(this, &FileAccessAsync::_read_task, p_read, true, "Read file " + p_read->path);
+	} else {
+		_read_task(p_read);
+	}
+}
+
+void FileAccessAsync::_finish_read(Read *p_read) {
+	p_read->completed.set();
+	if (p_read->callback) {
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+		if (pool && pool->get_thread_count() > 0) {
+			// Set before posting, so wait_for_read() sees it.
+			p_read->callback_task_id = pool->add_template_task(this, &FileAccessAsync::_callback_task, p_read, true, "Read callback " + p_read->path);
+		} else {
+			_callback_task(p_read);
+		}
+	}
+	p_read->done.post();
+}
+
+FileAccessAsync::ReadID FileAccessAsync::read(const String &p_path, uint64_t p_offset, int64_t p_length, ReadCallback p_callback, void *p_userdata) {
+	Read *r = memnew(Read);
+	r->path = p_path;
+	r->offset = p_offset;
+	r->length = p_length;
+	r->callback = p_callback;
+	r->userdata = p_userdata;
+
+	{
+		MutexLock lock(mutex);
+		r->id = ++last_read_id;
+		reads.insert(r->id, r);
+	}
+
+	_submit(r);
+	return r->id;
+}
+
+bool FileAccessAsync::is_read_completed(ReadID p_read_id) const {
+	MutexLock lock(mutex);
+	Read *const *r = reads.getptr(p_read_id);
+	ERR_FAIL_COND_V_MSG(!r, false, "Invalid read ID: " + itos(p_read_id) + ".");
+	return (*r)->completed.is_set();
+}
+
+Error FileAccessAsync::wait_for_read(ReadID p_read_id, Vector<uint8_t> *r_data) {
+	Read *r = nullptr;
+	{
+		MutexLock lock(mutex);
+		HashMap<ReadID, Read *>::Iterator E = reads.find(p_read_id);
+		ERR_FAIL_COND_V_MSG(!E, ERR_INVALID_PARAMETER, "Invalid read ID: " + itos(p_read_id) + ". It may have already been waited for.");
+		r = E->value;
+		reads.remove(E);
+	}
+
+	if (r->read_task_id != WorkerThreadPool::INVALID_TASK_ID) {
+		// Lets pool threads run other tasks while waiting, as reading may be queued behind them.
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(r->read_task_id);
+	}
+	r->done.wait();
+	if (r->callback_task_id != WorkerThreadPool::INVALID_TASK_ID) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(r->callback_task_id);
+	}
+
+	Error err = r->error;
+	if (r_data) {
+		*r_data = r->data;
+	}
+	memdelete(r);
+	return err;
+}
+
+FileAccessAsync::~FileAccessAsync() {
+	if (!reads.is_empty()) {
+		WARN_PRINT(itos(reads.size()) + " file reads were not waited for.");
+		while (!reads.is_empty()) {
+			wait_for_read(reads.begin()->key);
+		}
+	}
+
+	if (singleton == this) {
+		singleton = nullptr;
+	}
+}
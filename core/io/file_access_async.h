@@ -0,0 +1,112 @@
+/*************************************************************************/
+/*  file_access_async.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef FILE_ACCESS_ASYNC_H
+#define FILE_ACCESS_ASYNC_H
+
+#include "core/object/worker_thread_pool.h"
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/safe_refcount.h"
+
+// Reads files without blocking the caller. Reads are submitted, then polled or awaited,
+// and can run a callback on the WorkerThreadPool once their data is ready.
+// This implementation reads on the WorkerThreadPool with FileAccess; platforms can
+// register a backend that reads with asynchronous system calls instead.
+class FileAccessAsync {
+public:
+	typedef int64_t ReadID;
+
+	enum {
+		INVALID_READ_ID = -1
+	};
+
+	typedef void (*ReadCallback)(void *p_userdata, ReadID p_read_id, Error p_error, const Vector<uint8_t> &p_data);
+
+protected:
+	struct Read {
+		ReadID id = INVALID_READ_ID;
+		String path;
+		uint64_t offset = 0;
+		int64_t length = -1;
+		ReadCallback callback = nullptr;
+		void *userdata = nullptr;
+
+		Vector<uint8_t> data;
+		Error error = OK;
+		SafeFlag completed;
+		Semaphore done;
+		WorkerThreadPool::TaskID read_task_id = WorkerThreadPool::INVALID_TASK_ID;
+		WorkerThreadPool::TaskID callback_task_id = WorkerThreadPool::INVALID_TASK_ID;
+	};
+
+	// Reads p_read with FileAccess on the WorkerThreadPool, for anything a backend can't handle.
+	virtual void _submit(Read *p_read);
+	// For backends, once the data and error of p_read are set.
+	void _finish_read(Read *p_read);
+
+private:
+	static FileAccessAsync *singleton;
+	static FileAccessAsync *(*create_func)();
+
+	template <class T>
+	static FileAccessAsync *_create_builtin() {
+		return memnew(T);
+	}
+
+	mutable Mutex mutex;
+	ReadID last_read_id = 0;
+	HashMap<ReadID, Read *> reads;
+
+	void _read_task(Read *p_read);
+	void _callback_task(Read *p_read);
+
+public:
+	static FileAccessAsync *get_singleton() { return singleton; }
+	static FileAccessAsync *create();
+
+	template <class T>
+	static void make_default() {
+		create_func = _create_builtin<T>;
+	}
+
+	// Reads p_length bytes from p_offset, or up to the end of the file if p_length is negative.
+	// Like FileAccess::get_buffer(), reads going past the end of the file return less data.
+	// Every read must be finished with wait_for_read(), which also runs after its callback.
+	ReadID read(const String &p_path, uint64_t p_offset = 0, int64_t p_length = -1, ReadCallback p_callback = nullptr, void *p_userdata = nullptr);
+	bool is_read_completed(ReadID p_read_id) const;
+	Error wait_for_read(ReadID p_read_id, Vector<uint8_t> *r_data = nullptr);
+
+	FileAccessAsync() {}
+	virtual ~FileAccessAsync();
+};
+
+#endif // FILE_ACCESS_ASYNC_H
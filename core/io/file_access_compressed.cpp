@@ -32,7 +32,9 @@
 
 #include "core/string/print_string.h"
 
-void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_mode, uint32_t p_block_size) {
+void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_mode, uint32_t p_block_size, uint32_t p_zstd_dictionary_id) {
+	ERR_FAIL_COND_MSG(p_zstd_dictionary_id != 0 && p_mode != Compression::MODE_ZSTD, "Dictionaries can only be used with Zstandard compression.");
+
 	magic = p_magic.ascii().get_data();
 	if (magic.length() > 4) {
 		magic = magic.substr(0, 4);
@@ -44,6 +46,7 @@ void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_
 
 	cmode = p_mode;
 	block_size = p_block_size;
+	zstd_dictionary_id = p_zstd_dictionary_id;
 }
 
 #define WRITE_FIT(m_bytes)                                  \
@@ -60,39 +63,176 @@ void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_
 
 Error FileAccessCompressed::open_after_magic(Ref<FileAccess> p_base) {
 	f = p_base;
-	cmode = (Compression::Mode)f->get_32();
+	uint32_t stored_mode = f->get_32();
+	cmode = (Compression::Mode)(stored_mode & ~MODE_ZSTD_DICTIONARY_FLAG);
 	block_size = f->get_32();
 	if (block_size == 0) {
 		f.unref();
 		ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, "Can't open compressed file '" + p_base->get_path() + "' with block size 0, it is corrupted.");
 	}
 	read_total = f->get_32();
+	zstd_dictionary_id = 0;
+	if (stored_mode & MODE_ZSTD_DICTIONARY_FLAG) {
+		zstd_dictionary_id = f->get_32();
+		if (!Compression::has_zstd_dictionary(zstd_dictionary_id)) {
+			f.unref();
+			ERR_FAIL_V_MSG(ERR_FILE_MISSING_DEPENDENCIES, vformat("Can't open compressed file '%s', the Zstandard dictionary it was compressed with (%d) is not registered.", p_base->get_path(), zstd_dictionary_id));
+		}
+	}
 	uint32_t bc = (read_total / block_size) + 1;
 	uint64_t acc_ofs = f->get_position() + bc * 4;
-	uint32_t max_bs = 0;
 	for (uint32_t i = 0; i < bc; i++) {
 		ReadBlock rb;
 		rb.offset = acc_ofs;
 		rb.csize = f->get_32();
 		acc_ofs += rb.csize;
-		max_bs = MAX(max_bs, rb.csize);
 		read_blocks.push_back(rb);
 	}
 
-	comp_buffer.resize(max_bs);
-	buffer.resize(block_size);
-	read_ptr = buffer.ptrw();
-	f->get_buffer(comp_buffer.ptrw(), read_blocks[0].csize);
 	at_end = false;
 	read_eof = false;
 	read_block_count = bc;
-	read_block_size = read_blocks.size() == 1 ? read_total : block_size;
 
-	int ret = Compression::decompress(buffer.ptrw(), read_block_size, comp_buffer.ptr(), read_blocks[0].csize, cmode);
-	read_block = 0;
+	// Decompressing ahead only pays off when there is more than one run to spread over the pool.
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	read_run_blocks = 1;
+	read_ahead_runs = 0;
+	if (bc > 1 && pool && pool->get_thread_count() > 0) {
+		read_run_blocks = MAX(uint32_t(READ_RUN_SIZE) / block_size, 1u);
+		uint32_t run_count = (bc + read_run_blocks - 1) / read_run_blocks;
+		read_ahead_runs = MIN(MIN(uint32_t(pool->get_thread_count()), uint32_t(MAX_READ_AHEAD_RUNS)), run_count - 1);
+		if (read_ahead_runs == 0) {
+			read_run_blocks = 1;
+		}
+	}
+
+	uint32_t max_run_csize = 0;
+	for (uint32_t i = 0; i < bc; i += read_run_blocks) {
+		uint32_t run_csize = 0;
+		for (uint32_t j = i; j < MIN(i + read_run_blocks, bc); j++) {
+			run_csize += read_blocks[j].csize;
+		}
+		max_run_csize = MAX(max_run_csize, run_csize);
+	}
+
+	read_runs.resize(read_ahead_runs + 1);
+	for (uint32_t i = 0; i < read_runs.size(); i++) {
+		read_runs[i].comp_buffer.resize(max_run_csize);
+		read_runs[i].buffer.resize(block_size * read_run_blocks);
+	}
+
+	bool valid = _load_block(0);
 	read_pos = 0;
 
-	return ret == -1 ? ERR_FILE_CORRUPT : OK;
+	return valid ? OK : ERR_FILE_CORRUPT;
+}
+
+void FileAccessCompressed::_decompress_run(ReadRun *p_run) const {
+	uint32_t from = p_run->run * read_run_blocks;
+	uint32_t to = MIN(from + read_run_blocks, read_block_count);
+	const uint8_t *src = p_run->comp_buffer.ptr();
+	uint8_t *dst = p_run->buffer.ptrw();
+
+	for (uint32_t i = from; i < to; i++) {
+		int ret = Compression::decompress(dst, read_blocks.size() == 1 ? read_total : block_size, src, read_blocks[i].csize, cmode, zstd_dictionary_id);
+		if (ret == -1) {
+			p_run->corrupt = true;
+			return;
+		}
+		src += read_blocks[i].csize;
+		dst += block_size;
+	}
+}
+
+FileAccessCompressed::ReadRun *FileAccessCompressed::_get_free_run(uint32_t p_first_run) const {
+	// Any run outside the window being read from and read ahead can be reused.
+	for (uint32_t i = 0; i < read_runs.size(); i++) {
+		ReadRun &rr = read_runs[i];
+		if (rr.run < p_first_run || rr.run - p_first_run > read_ahead_runs) {
+			if (rr.task != WorkerThreadPool::INVALID_TASK_ID) {
+				WorkerThreadPool::get_singleton()->wait_for_task_completion(rr.task);
+				rr.task = WorkerThreadPool::INVALID_TASK_ID;
+			}
+			return &rr;
+		}
+	}
+
+	CRASH_NOW_MSG("No free run to decompress into, this is a bug.");
+}
+
+void FileAccessCompressed::_read_run(ReadRun *p_run, uint32_t p_run_index) const {
+	uint32_t from = p_run_index * read_run_blocks;
+	uint32_t to = MIN(from + read_run_blocks, read_block_count);
+	uint32_t csize = 0;
+	for (uint32_t i = from; i < to; i++) {
+		csize += read_blocks[i].csize;
+	}
+
+	// Blocks of a run are stored contiguously, so they are read in one go.
+	const_cast<FileAccess *>(f.ptr())->seek(read_blocks[from].offset);
+	f->get_buffer(p_run->comp_buffer.ptrw(), csize);
+	p_run->run = p_run_index;
+	p_run->corrupt = false;
+}
+
+bool FileAccessCompressed::_load_block(uint32_t p_block) const {
+	uint32_t run_index = p_block / read_run_blocks;
+
+	ReadRun *run = nullptr;
+	for (uint32_t i = 0; i < read_runs.size(); i++) {
+		if (read_runs[i].run == run_index) {
+			run = &read_runs[i];
+			break;
+		}
+	}
+
+	if (run) {
+		if (run->task != WorkerThreadPool::INVALID_TASK_ID) {
+			WorkerThreadPool::get_singleton()->wait_for_task_completion(run->task);
+			run->task = WorkerThreadPool::INVALID_TASK_ID;
+		}
+	} else {
+		run = _get_free_run(run_index);
+		_read_run(run, run_index);
+		_decompress_run(run);
+	}
+
+	// Queue the runs that follow, so they are ready by the time the reader gets to them.
+	uint32_t run_count = (read_block_count + read_run_blocks - 1) / read_run_blocks;
+	for (uint32_t i = run_index + 1; i <= run_index + read_ahead_runs && i < run_count; i++) {
+		bool queued = false;
+		for (uint32_t j = 0; j < read_runs.size(); j++) {
+			if (read_runs[j].run == i) {
+				queued = true;
+				break;
+			}
+		}
+		if (queued) {
+			continue;
+		}
+
+		ReadRun *ahead = _get_free_run(run_index);
+		_read_run(ahead, i);
+		ahead->task = WorkerThreadPool::get_singleton()->add_template_task(this, &FileAccessCompressed::_decompress_run, ahead, true, "Decompress file blocks");
+	}
+
+	read_block = p_block;
+	read_ptr = run->buffer.ptr() + (p_block % read_run_blocks) * block_size;
+	read_block_size = p_block == read_block_count - 1 ? read_total % block_size : block_size;
+
+	return !run->corrupt;
+}
+
+void FileAccessCompressed::_compress_blocks(uint32_t p_first_block) {
+	uint32_t bc = (write_max / block_size) + 1;
+	uint32_t to = MIN(p_first_block + compress_task_blocks, bc);
+
+	for (uint32_t i = p_first_block; i < to; i++) {
+		uint32_t bl = i == (bc - 1) ? write_max % block_size : block_size;
+		CompressedBlock &cb = compressed_blocks[i];
+		cb.data.resize(Compression::get_max_compressed_buffer_size(bl, cmode));
+		cb.size = Compression::compress(cb.data.ptrw(), &write_ptr[uint64_t(i) * block_size], bl, cmode, zstd_dictionary_id);
+	}
 }
 
 Error FileAccessCompressed::open_internal(const String &p_path, int p_mode_flags) {
@@ -141,29 +281,53 @@ void FileAccessCompressed::_close() {
 
 		CharString mgc = magic.utf8();
 		f->store_buffer((const uint8_t *)mgc.get_data(), mgc.length()); //write header 4
-		f->store_32(cmode); //write compression mode 4
+		f->store_32(cmode | (zstd_dictionary_id ? uint32_t(MODE_ZSTD_DICTIONARY_FLAG) : 0u)); //write compression mode 4
 		f->store_32(block_size); //write block size 4
 		f->store_32(write_max); //max amount of data written 4
+		if (zstd_dictionary_id) {
+			f->store_32(zstd_dictionary_id); //dictionary the blocks need 4
+		}
 		uint32_t bc = (write_max / block_size) + 1;
 
+		uint64_t block_table_ofs = f->get_position();
+
 		for (uint32_t i = 0; i < bc; i++) {
 			f->store_32(0); //compressed sizes, will update later
 		}
 
-		Vector<int> block_sizes;
-		for (uint32_t i = 0; i < bc; i++) {
-			uint32_t bl = i == (bc - 1) ? write_max % block_size : block_size;
-			uint8_t *bp = &write_ptr[i * block_size];
+		// Blocks are independent, so groups of them are compressed on the WorkerThreadPool
+		// and stored in order as each group completes.
+		compressed_blocks.resize(bc);
+		compress_task_blocks = MAX(uint32_t(COMPRESS_TASK_SIZE) / block_size, 1u);
+		uint32_t task_count = (bc + compress_task_blocks - 1) / compress_task_blocks;
+
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+		LocalVector<WorkerThreadPool::TaskID> tasks;
+		if (task_count > 1 && pool && pool->get_thread_count() > 0) {
+			tasks.resize(task_count);
+			for (uint32_t i = 0; i < task_count; i++) {
+				tasks[i] = pool->add_template_task(this, &FileAccessCompressed::_compress_blocks, i * compress_task_blocks, true, "Compress file blocks");
+			}
+		}
 
-			Vector<uint8_t> cblock;
-			cblock.resize(Compression::get_max_compressed_buffer_size(bl, cmode));
-			int s = Compression::compress(cblock.ptrw(), bp, bl, cmode);
+		LocalVector<int> block_sizes;
+		block_sizes.resize(bc);
+		for (uint32_t i = 0; i < task_count; i++) {
+			if (tasks.size()) {
+				pool->wait_for_task_completion(tasks[i]);
+			} else {
+				_compress_blocks(i * compress_task_blocks);
+			}
 
-			f->store_buffer(cblock.ptr(), s);
-			block_sizes.push_back(s);
+			for (uint32_t j = i * compress_task_blocks; j < MIN((i + 1) * compress_task_blocks, bc); j++) {
+				f->store_buffer(compressed_blocks[j].data.ptr(), compressed_blocks[j].size);
+				block_sizes[j] = compressed_blocks[j].size;
+				compressed_blocks[j].data.clear();
+			}
 		}
+		compressed_blocks.clear();
 
-		f->seek(16); //ok write block sizes
+		f->seek(block_table_ofs); //ok write block sizes
 		for (uint32_t i = 0; i < bc; i++) {
 			f->store_32(block_sizes[i]);
 		}
@@ -173,7 +337,12 @@ void FileAccessCompressed::_close() {
 		buffer.clear();
 
 	} else {
-		comp_buffer.clear();
+		for (uint32_t i = 0; i < read_runs.size(); i++) {
+			if (read_runs[i].task != WorkerThreadPool::INVALID_TASK_ID) {
+				WorkerThreadPool::get_singleton()->wait_for_task_completion(read_runs[i].task);
+			}
+		}
+		read_runs.clear();
 		buffer.clear();
 		read_blocks.clear();
 	}
@@ -201,12 +370,7 @@ void FileAccessCompressed::seek(uint64_t p_position) {
 			read_eof = false;
 			uint32_t block_idx = p_position / block_size;
 			if (block_idx != read_block) {
-				read_block = block_idx;
-				f->seek(read_blocks[read_block].offset);
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				int ret = Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				ERR_FAIL_COND_MSG(ret == -1, "Compressed file is corrupt.");
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+				ERR_FAIL_COND_MSG(!_load_block(block_idx), "Compressed file is corrupt.");
 			}
 
 			read_pos = p_position % block_size;
@@ -263,18 +427,13 @@ uint8_t FileAccessCompressed::get_8() const {
 
 	read_pos++;
 	if (read_pos >= read_block_size) {
-		read_block++;
-
-		if (read_block < read_block_count) {
+		if (read_block + 1 < read_block_count) {
 			//read another block of compressed data
-			f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-			int total = Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-			ERR_FAIL_COND_V_MSG(total == -1, 0, "Compressed file is corrupt.");
-			read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+			bool valid = _load_block(read_block + 1);
 			read_pos = 0;
+			ERR_FAIL_COND_V_MSG(!valid, 0, "Compressed file is corrupt.");
 
 		} else {
-			read_block--;
 			at_end = true;
 		}
 	}
@@ -292,27 +451,26 @@ uint64_t FileAccessCompressed::get_buffer(uint8_t *p_dst, uint64_t p_length) con
 		return 0;
 	}
 
-	for (uint64_t i = 0; i < p_length; i++) {
-		p_dst[i] = read_ptr[read_pos];
-		read_pos++;
-		if (read_pos >= read_block_size) {
-			read_block++;
+	uint64_t dst_pos = 0;
+	while (dst_pos < p_length) {
+		uint64_t to_copy = MIN(uint64_t(read_block_size - read_pos), p_length - dst_pos);
+		memcpy(p_dst + dst_pos, read_ptr + read_pos, to_copy);
+		dst_pos += to_copy;
+		read_pos += to_copy;
 
-			if (read_block < read_block_count) {
+		if (read_pos >= read_block_size) {
+			if (read_block + 1 < read_block_count) {
 				//read another block of compressed data
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				int ret = Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				ERR_FAIL_COND_V_MSG(ret == -1, -1, "Compressed file is corrupt.");
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+				bool valid = _load_block(read_block + 1);
 				read_pos = 0;
+				ERR_FAIL_COND_V_MSG(!valid, -1, "Compressed file is corrupt.");
 
 			} else {
-				read_block--;
 				at_end = true;
-				if (i + 1 < p_length) {
+				if (dst_pos < p_length) {
 					read_eof = true;
 				}
-				return i + 1;
+				return dst_pos;
 			}
 		}
 	}
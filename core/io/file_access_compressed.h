@@ -33,9 +33,12 @@
 
 #include "core/io/compression.h"
 #include "core/io/file_access.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/templates/local_vector.h"
 
 class FileAccessCompressed : public FileAccess {
 	Compression::Mode cmode = Compression::MODE_ZSTD;
+	uint32_t zstd_dictionary_id = 0;
 	bool writing = false;
 	uint64_t write_pos = 0;
 	uint8_t *write_ptr = nullptr;
@@ -50,8 +53,27 @@ class FileAccessCompressed : public FileAccess {
 		uint64_t offset;
 	};
 
-	mutable Vector<uint8_t> comp_buffer;
-	uint8_t *read_ptr = nullptr;
+	// Consecutive blocks are decompressed together as a run. While one run is being consumed,
+	// the next ones are decompressed ahead on the WorkerThreadPool.
+	struct ReadRun {
+		uint32_t run = UINT32_MAX;
+		Vector<uint8_t> comp_buffer;
+		Vector<uint8_t> buffer;
+		bool corrupt = false;
+		WorkerThreadPool::TaskID task = WorkerThreadPool::INVALID_TASK_ID;
+	};
+
+	enum {
+		MODE_ZSTD_DICTIONARY_FLAG = 1u << 31, // Set in the stored mode when a dictionary ID follows the header.
+		READ_RUN_SIZE = 65536,
+		MAX_READ_AHEAD_RUNS = 8,
+		COMPRESS_TASK_SIZE = 262144,
+	};
+
+	mutable LocalVector<ReadRun> read_runs;
+	uint32_t read_run_blocks = 1;
+	uint32_t read_ahead_runs = 0;
+	mutable const uint8_t *read_ptr = nullptr;
 	mutable uint32_t read_block = 0;
 	uint32_t read_block_count = 0;
 	mutable uint32_t read_block_size = 0;
@@ -59,16 +81,30 @@ class FileAccessCompressed : public FileAccess {
 	Vector<ReadBlock> read_blocks;
 	uint64_t read_total = 0;
 
+	struct CompressedBlock {
+		Vector<uint8_t> data;
+		int size = 0;
+	};
+	LocalVector<CompressedBlock> compressed_blocks;
+	uint32_t compress_task_blocks = 1;
+
 	String magic = "GCMP";
 	mutable Vector<uint8_t> buffer;
 	Ref<FileAccess> f;
 
 	void _close();
 
+	void _compress_blocks(uint32_t p_first_block);
+	void _decompress_run(ReadRun *p_run) const;
+	ReadRun *_get_free_run(uint32_t p_first_run) const;
+	void _read_run(ReadRun *p_run, uint32_t p_run_index) const;
+	bool _load_block(uint32_t p_block) const;
+
 public:
-	void configure(const String &p_magic, Compression::Mode p_mode = Compression::MODE_ZSTD, uint32_t p_block_size = 4096);
+	void configure(const String &p_magic, Compression::Mode p_mode = Compression::MODE_ZSTD, uint32_t p_block_size = 4096, uint32_t p_zstd_dictionary_id = 0);
 
 	Error open_after_magic(Ref<FileAccess> p_base);
+	uint32_t get_zstd_dictionary_id() const { return zstd_dictionary_id; }
 
 	virtual Error open_internal(const String &p_path, int p_mode_flags) override; ///< open a file
 	virtual bool is_open() const override; ///< true when file is open
@@ -78,6 +78,11 @@ Error FileAccessMemory::open_custom(const uint8_t *p_data, uint64_t p_len) {
 	return OK;
 }
 
+Error FileAccessMemory::open_custom(const Vector<uint8_t> &p_data) {
+	buffer = p_data;
+	return open_custom(buffer.ptr(), buffer.size());
+}
+
 Error FileAccessMemory::open_internal(const String &p_path, int p_mode_flags) {
 	ERR_FAIL_COND_V(!files, ERR_FILE_NOT_FOUND);
 
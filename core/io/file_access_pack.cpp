@@ -30,6 +30,7 @@
 
 #include "file_access_pack.h"
 
+#include "core/io/compression.h"
 #include "core/io/file_access_encrypted.h"
 #include "core/object/script_language.h"
 #include "core/os/os.h"
@@ -40,6 +41,12 @@
 Error PackedData::add_pack(const String &p_path, bool p_replace_files, uint64_t p_offset) {
 	for (int i = 0; i < sources.size(); i++) {
 		if (sources[i]->try_open_pack(p_path, p_replace_files, p_offset)) {
+			if (has_path(PACK_ZSTD_DICTIONARY_PATH)) {
+				Vector<uint8_t> zstd_dictionary = FileAccess::get_file_as_array(PACK_ZSTD_DICTIONARY_PATH);
+				if (!zstd_dictionary.is_empty()) {
+					Compression::add_zstd_dictionary(zstd_dictionary);
+				}
+			}
 			return OK;
 		}
 	}
@@ -117,7 +124,29 @@ void PackedData::_free_packed_dirs(PackedDir *p_dir) {
 	memdelete(p_dir);
 }
 
+const uint8_t *PackedData::_get_pack_map(const String &p_pack) {
+	MutexLock lock(mapped_packs_mutex);
+
+	HashMap<String, MappedPack>::Iterator E = mapped_packs.find(p_pack);
+	if (E) {
+		return E->value.data;
+	}
+
+	// Also remembered when mapping fails, so it's only tried once.
+	MappedPack mapped;
+	mapped.file = FileAccess::open(p_pack, FileAccess::READ);
+	if (mapped.file.is_valid()) {
+		mapped.data = mapped.file->get_buffer_view(mapped.file->get_length());
+	}
+	mapped_packs.insert(p_pack, mapped);
+	return mapped.data;
+}
+
 PackedData::~PackedData() {
+	if (singleton == this) {
+		singleton = nullptr;
+	}
+	mapped_packs.clear();
 	for (int i = 0; i < sources.size(); i++) {
 		memdelete(sources[i]);
 	}
@@ -257,6 +286,16 @@ Ref<FileAccess> PackedSourcePCK::get_file(const String &p_path, PackedData::Pack
 	return memnew(FileAccessPack(p_path, *p_file));
 }
 
+bool PackedSourcePCK::get_file_location(const PackedData::PackedFile *p_file, String &r_pack_path, uint64_t &r_offset) {
+	if (p_file->encrypted) {
+		return false;
+	}
+
+	r_pack_path = p_file->pack;
+	r_offset = p_file->offset;
+	return true;
+}
+
 //////////////////////////////////////////////////////////////////
 
 Error FileAccessPack::open_internal(const String &p_path, int p_mode_flags) {
@@ -281,7 +320,9 @@ void FileAccessPack::seek(uint64_t p_position) {
 		eof = false;
 	}
 
-	f->seek(off + p_position);
+	if (!map) {
+		f->seek(off + p_position);
+	}
 	pos = p_position;
 }
 
@@ -308,6 +349,10 @@ uint8_t FileAccessPack::get_8() const {
 		return 0;
 	}
 
+	if (map) {
+		return map[pos++];
+	}
+
 	pos++;
 	return f->get_8();
 }
@@ -326,16 +371,41 @@ uint64_t FileAccessPack::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 		to_read = (int64_t)pf.size - (int64_t)pos;
 	}
 
+	uint64_t read_pos = pos;
 	pos += p_length;
 
 	if (to_read <= 0) {
 		return 0;
 	}
-	f->get_buffer(p_dst, to_read);
+	if (map) {
+		memcpy(p_dst, map + read_pos, to_read);
+	} else {
+		f->get_buffer(p_dst, to_read);
+	}
 
 	return to_read;
 }
 
+const uint8_t *FileAccessPack::get_buffer_view(uint64_t p_length) const {
+	ERR_FAIL_COND_V_MSG(f.is_null(), nullptr, "File must be opened before use.");
+
+	if (pf.encrypted || eof || pos > pf.size || p_length > pf.size - pos) {
+		return nullptr;
+	}
+
+	if (!map) {
+		const uint8_t *pack = PackedData::get_singleton()->_get_pack_map(pf.pack);
+		if (!pack) {
+			return nullptr;
+		}
+		map = pack + pf.offset;
+	}
+
+	const uint8_t *view = map + pos;
+	pos += p_length;
+	return view;
+}
+
 void FileAccessPack::set_big_endian(bool p_big_endian) {
 	ERR_FAIL_COND_MSG(f.is_null(), "File must be opened before use.");
 
@@ -33,6 +33,7 @@
 
 #include "core/io/dir_access.h"
 #include "core/io/file_access.h"
+#include "core/os/mutex.h"
 #include "core/string/print_string.h"
 #include "core/templates/hash_set.h"
 #include "core/templates/list.h"
@@ -43,6 +44,9 @@
 // The current packed file format version number.
 #define PACK_FORMAT_VERSION 2
 
+// Where PCKPacker stores the package's Zstandard dictionary, registered when the package is loaded.
+#define PACK_ZSTD_DICTIONARY_PATH "res://.pack_zstd_dictionary"
+
 enum PackFlags {
 	PACK_DIR_ENCRYPTED = 1 << 0
 };
@@ -105,7 +109,16 @@ private:
 	static PackedData *singleton;
 	bool disabled = false;
 
+	// Pack files mapped for FileAccessPack::get_buffer_view(), kept open until exit.
+	struct MappedPack {
+		Ref<FileAccess> file;
+		const uint8_t *data = nullptr;
+	};
+	HashMap<String, MappedPack> mapped_packs;
+	Mutex mapped_packs_mutex;
+
 	void _free_packed_dirs(PackedDir *p_dir);
+	const uint8_t *_get_pack_map(const String &p_pack);
 
 public:
 	void add_pack_source(PackSource *p_source);
@@ -119,6 +132,7 @@ public:
 
 	_FORCE_INLINE_ Ref<FileAccess> try_open_path(const String &p_path);
 	_FORCE_INLINE_ bool has_path(const String &p_path);
+	_FORCE_INLINE_ bool get_path_location(const String &p_path, String &r_pack_path, uint64_t &r_offset, uint64_t &r_size);
 
 	_FORCE_INLINE_ Ref<DirAccess> try_open_directory(const String &p_path);
 	_FORCE_INLINE_ bool has_directory(const String &p_path);
@@ -131,6 +145,8 @@ class PackSource {
 public:
 	virtual bool try_open_pack(const String &p_path, bool p_replace_files, uint64_t p_offset) = 0;
 	virtual Ref<FileAccess> get_file(const String &p_path, PackedData::PackedFile *p_file) = 0;
+	// Where the contents of p_file start in the pack file, if they are stored as is.
+	virtual bool get_file_location(const PackedData::PackedFile *p_file, String &r_pack_path, uint64_t &r_offset) { return false; }
 	virtual ~PackSource() {}
 };
 
@@ -138,6 +154,7 @@ class PackedSourcePCK : public PackSource {
 public:
 	virtual bool try_open_pack(const String &p_path, bool p_replace_files, uint64_t p_offset) override;
 	virtual Ref<FileAccess> get_file(const String &p_path, PackedData::PackedFile *p_file) override;
+	virtual bool get_file_location(const PackedData::PackedFile *p_file, String &r_pack_path, uint64_t &r_offset) override;
 };
 
 class FileAccessPack : public FileAccess {
@@ -146,6 +163,8 @@ class FileAccessPack : public FileAccess {
 	mutable uint64_t pos;
 	mutable bool eof;
 	uint64_t off;
+	// Contents of the file in the mapped pack. Once set, reads go through it instead of f.
+	mutable const uint8_t *map = nullptr;
 
 	Ref<FileAccess> f;
 	virtual Error open_internal(const String &p_path, int p_mode_flags) override;
@@ -166,6 +185,7 @@ public:
 	virtual uint8_t get_8() const override;
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const override;
+	virtual const uint8_t *get_buffer_view(uint64_t p_length) const override;
 
 	virtual void set_big_endian(bool p_big_endian) override;
 
@@ -198,6 +218,18 @@ bool PackedData::has_path(const String &p_path) {
 	return files.has(PathMD5(p_path.md5_buffer()));
 }
 
+// For readers going straight to the pack file instead of through FileAccessPack, such as FileAccessAsync.
+// Fails for files that are missing or not stored as is, e.g. encrypted ones.
+bool PackedData::get_path_location(const String &p_path, String &r_pack_path, uint64_t &r_offset, uint64_t &r_size) {
+	HashMap<PathMD5, PackedFile, PathMD5>::Iterator E = files.find(PathMD5(p_path.md5_buffer()));
+	if (!E || E->value.offset == 0) {
+		return false;
+	}
+
+	r_size = E->value.size;
+	return E->value.src->get_file_location(&E->value, r_pack_path, r_offset);
+}
+
 bool PackedData::has_directory(const String &p_path) {
 	Ref<DirAccess> da = try_open_directory(p_path);
 	if (da.is_valid()) {
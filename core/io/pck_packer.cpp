@@ -33,7 +33,7 @@
 #include "core/crypto/crypto_core.h"
 #include "core/io/file_access.h"
 #include "core/io/file_access_encrypted.h"
-#include "core/io/file_access_pack.h" // PACK_HEADER_MAGIC, PACK_FORMAT_VERSION
+#include "core/io/file_access_pack.h" // PACK_HEADER_MAGIC, PACK_FORMAT_VERSION, PACK_ZSTD_DICTIONARY_PATH
 #include "core/version.h"
 
 static int _get_pad(int p_alignment, int p_n) {
@@ -49,6 +49,8 @@ static int _get_pad(int p_alignment, int p_n) {
 void PCKPacker::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("pck_start", "pck_name", "alignment", "key", "encrypt_directory"), &PCKPacker::pck_start, DEFVAL(32), DEFVAL("0000000000000000000000000000000000000000000000000000000000000000"), DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("add_file", "pck_path", "source_path", "encrypt"), &PCKPacker::add_file, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("train_zstd_dictionary", "max_size"), &PCKPacker::train_zstd_dictionary, DEFVAL(Compression::ZSTD_DICTIONARY_DEFAULT_SIZE));
+	ClassDB::bind_method(D_METHOD("set_zstd_dictionary", "dictionary"), &PCKPacker::set_zstd_dictionary);
 	ClassDB::bind_method(D_METHOD("flush", "verbose"), &PCKPacker::flush, DEFVAL(false));
 }
 
@@ -147,6 +149,50 @@ Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encr
 	return OK;
 }
 
+Vector<uint8_t> PCKPacker::train_zstd_dictionary(int p_max_size) const {
+	// Each file added so far is a sample.
+	Vector<Vector<uint8_t>> samples;
+	for (int i = 0; i < files.size(); i++) {
+		if (files[i].path == PACK_ZSTD_DICTIONARY_PATH) {
+			continue;
+		}
+		samples.push_back(files[i].data.is_empty() ? FileAccess::get_file_as_array(files[i].src_path) : files[i].data);
+	}
+	ERR_FAIL_COND_V_MSG(samples.is_empty(), Vector<uint8_t>(), "Files must be added to the package before training a Zstandard dictionary from them.");
+
+	return Compression::train_zstd_dictionary(samples, p_max_size);
+}
+
+Error PCKPacker::set_zstd_dictionary(const Vector<uint8_t> &p_dictionary) {
+	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_INVALID_PARAMETER, "File must be opened before use.");
+	ERR_FAIL_COND_V(p_dictionary.is_empty(), ERR_INVALID_PARAMETER);
+	for (int i = 0; i < files.size(); i++) {
+		ERR_FAIL_COND_V_MSG(files[i].path == PACK_ZSTD_DICTIONARY_PATH, ERR_ALREADY_EXISTS, "A Zstandard dictionary was already set for this package.");
+	}
+
+	// Stored as a regular file, PackedData registers it when the package is loaded.
+	File pf;
+	pf.path = PACK_ZSTD_DICTIONARY_PATH;
+	pf.ofs = ofs;
+	pf.size = p_dictionary.size();
+	pf.data = p_dictionary;
+	{
+		unsigned char hash[16];
+		CryptoCore::md5(p_dictionary.ptr(), p_dictionary.size(), hash);
+		pf.md5.resize(16);
+		for (int i = 0; i < 16; i++) {
+			pf.md5.write[i] = hash[i];
+		}
+	}
+
+	int pad = _get_pad(alignment, ofs + pf.size);
+	ofs = ofs + pf.size + pad;
+
+	files.push_back(pf);
+
+	return OK;
+}
+
 Error PCKPacker::flush(bool p_verbose) {
 	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_INVALID_PARAMETER, "File must be opened before use.");
 
@@ -214,6 +260,17 @@ Error PCKPacker::flush(bool p_verbose) {
 
 	int count = 0;
 	for (int i = 0; i < files.size(); i++) {
+		if (!files[i].data.is_empty()) {
+			file->store_buffer(files[i].data.ptr(), files[i].data.size());
+
+			int pad = _get_pad(alignment, file->get_position());
+			for (int j = 0; j < pad; j++) {
+				file->store_8(Math::rand() % 256);
+			}
+			count += 1;
+			continue;
+		}
+
 		Ref<FileAccess> src = FileAccess::open(files[i].src_path, FileAccess::READ);
 		uint64_t to_write = files[i].size;
 
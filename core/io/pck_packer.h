@@ -31,6 +31,7 @@
 #ifndef PCK_PACKER_H
 #define PCK_PACKER_H
 
+#include "core/io/compression.h"
 #include "core/object/ref_counted.h"
 
 class FileAccess;
@@ -54,12 +55,15 @@ class PCKPacker : public RefCounted {
 		uint64_t size = 0;
 		bool encrypted = false;
 		Vector<uint8_t> md5;
+		Vector<uint8_t> data; // Stored from memory instead of src_path when set.
 	};
 	Vector<File> files;
 
 public:
 	Error pck_start(const String &p_file, int p_alignment = 32, const String &p_key = "0000000000000000000000000000000000000000000000000000000000000000", bool p_encrypt_directory = false);
 	Error add_file(const String &p_file, const String &p_src, bool p_encrypt = false);
+	Vector<uint8_t> train_zstd_dictionary(int p_max_size = Compression::ZSTD_DICTIONARY_DEFAULT_SIZE) const;
+	Error set_zstd_dictionary(const Vector<uint8_t> &p_dictionary);
 	Error flush(bool p_verbose = false);
 
 	PCKPacker() {}
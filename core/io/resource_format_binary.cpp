@@ -159,8 +159,13 @@ StringName ResourceLoaderBinary::_get_string() {
 		if (len == 0) {
 			return StringName();
 		}
-		f->get_buffer((uint8_t *)&str_buf[0], len);
 		String s;
+		const uint8_t *view = f->get_buffer_view(len);
+		if (view) {
+			s.parse_utf8((const char *)view, len);
+			return s;
+		}
+		f->get_buffer((uint8_t *)&str_buf[0], len);
 		s.parse_utf8(&str_buf[0]);
 		return s;
 	}
@@ -405,6 +410,16 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 						path += res_path + "::" + itos(index);
 					}
 
+					if (lazy_resources && !internal_index_cache.has(path)) {
+						// Not reached before, load it now and get back to where this one was.
+						uint64_t pos = f->get_position();
+						Error err = _load_internal_resource(index);
+						f->seek(pos);
+						if (err != OK) {
+							return err;
+						}
+					}
+
 					//always use internal cache for loading internal resources
 					if (!internal_index_cache.has(path)) {
 						WARN_PRINT(String("Couldn't load resource (no cache): " + path).utf8().get_data());
@@ -446,8 +461,21 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 					} else {
 						if (external_resources[erindex].cache.is_null()) {
 							//cache not here yet, wait for it?
-							if (use_sub_threads) {
+							if (lazy_resources) {
+								// Dependencies are only loaded once something references them.
+								external_resources.write[erindex].cache = ResourceLoader::load(external_resources[erindex].path, external_resources[erindex].type);
+
+								if (external_resources[erindex].cache.is_null()) {
+									if (!ResourceLoader::get_abort_on_missing_resources()) {
+										ResourceLoader::notify_dependency_error(local_path, external_resources[erindex].path, external_resources[erindex].type);
+									} else {
+										error = ERR_FILE_MISSING_DEPENDENCIES;
+										ERR_FAIL_V_MSG(error, "Can't load dependency: " + external_resources[erindex].path + ".");
+									}
+								}
+							} else if (use_sub_threads) {
 								Error err;
+								external_resources.write[erindex].requested = false;
 								external_resources.write[erindex].cache = ResourceLoader::load_threaded_get(external_resources[erindex].path, &err);
 
 								if (err != OK || external_resources[erindex].cache.is_null()) {
@@ -669,6 +697,158 @@ Ref<Resource> ResourceLoaderBinary::get_resource() {
 	return resource;
 }
 
+Error ResourceLoaderBinary::_load_internal_resource(int p_index) {
+	bool main = p_index == (internal_resources.size() - 1);
+
+	//maybe it is loaded already
+	String path;
+	String id;
+
+	if (!main) {
+		path = internal_resources[p_index].path;
+
+		if (path.begins_with("local://")) {
+			path = path.replace_first("local://", "");
+			id = path;
+			path = res_path + "::" + path;
+
+			internal_resources.write[p_index].path = path; // Update path.
+		} else if (lazy_resources) {
+			id = path.substr(res_path.length() + 2); // Resolved by load() already.
+		}
+
+		if (cache_mode == ResourceFormatLoader::CACHE_MODE_REUSE && ResourceCache::has(path)) {
+			Ref<Resource> cached = ResourceCache::get_ref(path);
+			if (cached.is_valid()) {
+				//already loaded, don't do anything
+				error = OK;
+				internal_index_cache[path] = cached;
+				return OK;
+			}
+		}
+	} else {
+		if (cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE && !ResourceCache::has(res_path)) {
+			path = res_path;
+		}
+	}
+
+	uint64_t offset = internal_resources[p_index].offset;
+
+	f->seek(offset);
+
+	String t = get_unicode_string();
+
+	Ref<Resource> res;
+
+	if (cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE && ResourceCache::has(path)) {
+		//use the existing one
+		Ref<Resource> cached = ResourceCache::get_ref(path);
+		if (cached->get_class() == t) {
+			cached->reset_state();
+			res = cached;
+		}
+	}
+
+	MissingResource *missing_resource = nullptr;
+
+	if (res.is_null()) {
+		//did not replace
+
+		Object *obj = ClassDB::instantiate(t);
+		if (!obj) {
+			if (ResourceLoader::is_creating_missing_resources_if_class_unavailable_enabled()) {
+				//create a missing resource
+				missing_resource = memnew(MissingResource);
+				missing_resource->set_original_class(t);
+				missing_resource->set_recording_properties(true);
+				obj = missing_resource;
+			} else {
+				error = ERR_FILE_CORRUPT;
+				ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource of unrecognized type in file: " + t + ".");
+			}
+		}
+
+		Resource *r = Object::cast_to<Resource>(obj);
+		if (!r) {
+			String obj_class = obj->get_class();
+			error = ERR_FILE_CORRUPT;
+			memdelete(obj); //bye
+			ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource type in resource field not a resource, type is: " + obj_class + ".");
+		}
+
+		res = Ref<Resource>(r);
+		if (!path.is_empty() && cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE) {
+			r->set_path(path, cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE); //if got here because the resource with same path has different type, replace it
+		}
+		r->set_scene_unique_id(id);
+	}
+
+	if (!main) {
+		internal_index_cache[path] = res;
+	}
+
+	int pc = f->get_32();
+
+	//set properties
+
+	Dictionary missing_resource_properties;
+
+	for (int j = 0; j < pc; j++) {
+		StringName name = _get_string();
+
+		if (name == StringName()) {
+			error = ERR_FILE_CORRUPT;
+			ERR_FAIL_V(ERR_FILE_CORRUPT);
+		}
+
+		Variant value;
+
+		error = parse_variant(value);
+		if (error) {
+			return error;
+		}
+
+		bool set_valid = true;
+		if (value.get_type() == Variant::OBJECT && missing_resource != nullptr) {
+			// If the property being set is a missing resource (and the parent is not),
+			// then setting it will most likely not work.
+			// Instead, save it as metadata.
+
+			Ref<MissingResource> mr = value;
+			if (mr.is_valid()) {
+				missing_resource_properties[name] = mr;
+				set_valid = false;
+			}
+		}
+
+		if (set_valid) {
+			res->set(name, value);
+		}
+	}
+
+	if (missing_resource) {
+		missing_resource->set_recording_properties(false);
+	}
+
+	if (!missing_resource_properties.is_empty()) {
+		res->set_meta(META_MISSING_RESOURCES, missing_resource_properties);
+	}
+
+#ifdef TOOLS_ENABLED
+	res->set_edited(false);
+#endif
+
+	resource_cache.push_back(res);
+
+	if (main) {
+		resource = res;
+		resource->set_as_translation_remapped(translation_remapped);
+	}
+
+	error = OK;
+	return OK;
+}
+
 Error ResourceLoaderBinary::load() {
 	if (error != OK) {
 		return error;
@@ -687,6 +867,23 @@ Error ResourceLoaderBinary::load() {
 		}
 
 		external_resources.write[i].path = path; //remap happens here, not on load because on load it can actually be used for filesystem dock resource remap
+	}
+
+	if (!lazy_resources) {
+		// Dependencies are loaded one after another, their files are read in the meantime.
+		Vector<String> paths;
+		for (int i = 0; i < external_resources.size(); i++) {
+			paths.push_back(external_resources[i].path);
+		}
+		prefetched_files = ResourceLoader::prefetch_files(paths);
+	}
+
+	for (int i = 0; i < external_resources.size(); i++) {
+		String path = external_resources[i].path;
+
+		if (lazy_resources) {
+			continue;
+		}
 
 		if (!use_sub_threads) {
 			external_resources.write[i].cache = ResourceLoader::load(path, external_resources[i].type);
@@ -702,6 +899,7 @@ Error ResourceLoaderBinary::load() {
 
 		} else {
 			Error err = ResourceLoader::load_threaded_request(path, external_resources[i].type, use_sub_threads, ResourceFormatLoader::CACHE_MODE_REUSE, local_path);
+			external_resources.write[i].requested = err == OK;
 			if (err != OK) {
 				if (!ResourceLoader::get_abort_on_missing_resources()) {
 					ResourceLoader::notify_dependency_error(local_path, path, external_resources[i].type);
@@ -713,156 +911,59 @@ Error ResourceLoaderBinary::load() {
 		}
 	}
 
-	for (int i = 0; i < internal_resources.size(); i++) {
-		bool main = i == (internal_resources.size() - 1);
-
-		//maybe it is loaded already
-		String path;
-		String id;
-
-		if (!main) {
-			path = internal_resources[i].path;
-
-			if (path.begins_with("local://")) {
-				path = path.replace_first("local://", "");
-				id = path;
-				path = res_path + "::" + path;
-
-				internal_resources.write[i].path = path; // Update path.
-			}
-
-			if (cache_mode == ResourceFormatLoader::CACHE_MODE_REUSE && ResourceCache::has(path)) {
-				Ref<Resource> cached = ResourceCache::get_ref(path);
-				if (cached.is_valid()) {
-					//already loaded, don't do anything
-					error = OK;
-					internal_index_cache[path] = cached;
-					continue;
-				}
-			}
-		} else {
-			if (cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE && !ResourceCache::has(res_path)) {
-				path = res_path;
-			}
+	if (lazy_resources) {
+		if (!using_named_scene_ids) {
+			error = ERR_UNAVAILABLE;
+			ERR_FAIL_V_MSG(error, "Sub-resources can't be loaded on their own from files in the old format: " + local_path + ".");
 		}
 
-		uint64_t offset = internal_resources[i].offset;
-
-		f->seek(offset);
-
-		String t = get_unicode_string();
-
-		Ref<Resource> res;
-
-		if (cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE && ResourceCache::has(path)) {
-			//use the existing one
-			Ref<Resource> cached = ResourceCache::get_ref(path);
-			if (cached->get_class() == t) {
-				cached->reset_state();
-				res = cached;
+		// Resources being loaded are cached before their properties are parsed, so references back to them don't recurse.
+		int index = -1;
+		for (int i = 0; i < internal_resources.size() - 1; i++) {
+			if (internal_resources[i].path == "local://" + sub_resource_id) {
+				index = i;
 			}
+			// Resolved up front, as they can be referenced before being loaded.
+			internal_resources.write[i].path = internal_resources[i].path.replace_first("local://", res_path + "::");
 		}
-
-		MissingResource *missing_resource = nullptr;
-
-		if (res.is_null()) {
-			//did not replace
-
-			Object *obj = ClassDB::instantiate(t);
-			if (!obj) {
-				if (ResourceLoader::is_creating_missing_resources_if_class_unavailable_enabled()) {
-					//create a missing resource
-					missing_resource = memnew(MissingResource);
-					missing_resource->set_original_class(t);
-					missing_resource->set_recording_properties(true);
-					obj = missing_resource;
-				} else {
-					error = ERR_FILE_CORRUPT;
-					ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource of unrecognized type in file: " + t + ".");
-				}
-			}
-
-			Resource *r = Object::cast_to<Resource>(obj);
-			if (!r) {
-				String obj_class = obj->get_class();
-				error = ERR_FILE_CORRUPT;
-				memdelete(obj); //bye
-				ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource type in resource field not a resource, type is: " + obj_class + ".");
-			}
-
-			res = Ref<Resource>(r);
-			if (!path.is_empty() && cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE) {
-				r->set_path(path, cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE); //if got here because the resource with same path has different type, replace it
-			}
-			r->set_scene_unique_id(id);
+		if (index == -1) {
+			error = ERR_FILE_NOT_FOUND;
+			ERR_FAIL_V_MSG(error, "No sub-resource with ID '" + sub_resource_id + "' in: " + local_path + ".");
 		}
 
-		if (!main) {
-			internal_index_cache[path] = res;
+		error = _load_internal_resource(index);
+		if (error != OK) {
+			return error;
 		}
+		f.unref();
+		resource = internal_index_cache[internal_resources[index].path];
+		return OK;
+	}
 
-		int pc = f->get_32();
-
-		//set properties
-
-		Dictionary missing_resource_properties;
-
-		for (int j = 0; j < pc; j++) {
-			StringName name = _get_string();
-
-			if (name == StringName()) {
-				error = ERR_FILE_CORRUPT;
-				ERR_FAIL_V(ERR_FILE_CORRUPT);
-			}
-
-			Variant value;
-
-			error = parse_variant(value);
-			if (error) {
-				return error;
-			}
-
-			bool set_valid = true;
-			if (value.get_type() == Variant::OBJECT && missing_resource != nullptr) {
-				// If the property being set is a missing resource (and the parent is not),
-				// then setting it will most likely not work.
-				// Instead, save it as metadata.
-
-				Ref<MissingResource> mr = value;
-				if (mr.is_valid()) {
-					missing_resource_properties[name] = mr;
-					set_valid = false;
+	for (int i = 0; i < internal_resources.size(); i++) {
+		if (ResourceLoader::is_load_canceled()) {
+			// Drop the external resources still requested, so they don't keep loading for nobody.
+			for (int j = 0; j < external_resources.size(); j++) {
+				if (external_resources[j].requested) {
+					external_resources.write[j].requested = false;
+					ResourceLoader::load_threaded_cancel(external_resources[j].path);
 				}
 			}
-
-			if (set_valid) {
-				res->set(name, value);
-			}
+			error = ERR_SKIP;
+			return error;
 		}
 
-		if (missing_resource) {
-			missing_resource->set_recording_properties(false);
-		}
-
-		if (!missing_resource_properties.is_empty()) {
-			res->set_meta(META_MISSING_RESOURCES, missing_resource_properties);
+		error = _load_internal_resource(i);
+		if (error != OK) {
+			return error;
 		}
 
-#ifdef TOOLS_ENABLED
-		res->set_edited(false);
-#endif
-
 		if (progress) {
 			*progress = (i + 1) / float(internal_resources.size());
 		}
 
-		resource_cache.push_back(res);
-
-		if (main) {
+		if (resource.is_valid()) {
 			f.unref();
-			resource = res;
-			resource->set_as_translation_remapped(translation_remapped);
-			error = OK;
 			return OK;
 		}
 	}
@@ -898,8 +999,13 @@ String ResourceLoaderBinary::get_unicode_string() {
 	if (len == 0) {
 		return String();
 	}
-	f->get_buffer((uint8_t *)&str_buf[0], len);
 	String s;
+	const uint8_t *view = f->get_buffer_view(len);
+	if (view) {
+		s.parse_utf8((const char *)view, len);
+		return s;
+	}
+	f->get_buffer((uint8_t *)&str_buf[0], len);
 	s.parse_utf8(&str_buf[0]);
 	return s;
 }
@@ -1117,21 +1223,36 @@ String ResourceLoaderBinary::recognize(Ref<FileAccess> p_f) {
 	return get_unicode_string();
 }
 
+ResourceLoaderBinary::~ResourceLoaderBinary() {
+	ResourceLoader::release_prefetched_files(prefetched_files);
+}
+
+bool ResourceFormatLoaderBinary::recognize_path(const String &p_path, const String &p_for_type) const {
+	// Sub-resources can be loaded on their own, as "path::id".
+	return ResourceFormatLoader::recognize_path(p_path.get_slice("::", 0), p_for_type);
+}
+
 Ref<Resource> ResourceFormatLoaderBinary::load(const String &p_path, const String &p_original_path, Error *r_error, bool p_use_sub_threads, float *r_progress, CacheMode p_cache_mode) {
 	if (r_error) {
 		*r_error = ERR_FILE_CANT_OPEN;
 	}
 
+	String file_path = p_path.get_slice("::", 0);
 	Error err;
-	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ, &err);
+	Ref<FileAccess> f = ResourceLoader::open_file(file_path, &err);
 
-	ERR_FAIL_COND_V_MSG(err != OK, Ref<Resource>(), "Cannot open file '" + p_path + "'.");
+	ERR_FAIL_COND_V_MSG(err != OK, Ref<Resource>(), "Cannot open file '" + file_path + "'.");
 
 	ResourceLoaderBinary loader;
 	loader.cache_mode = p_cache_mode;
 	loader.use_sub_threads = p_use_sub_threads;
 	loader.progress = r_progress;
 	String path = !p_original_path.is_empty() ? p_original_path : p_path;
+	if (path.contains("::")) {
+		loader.sub_resource_id = path.get_slice("::", 1);
+		loader.lazy_resources = true;
+		path = path.get_slice("::", 0);
+	}
 	loader.local_path = ProjectSettings::get_singleton()->localize_path(path);
 	loader.res_path = loader.local_path;
 	loader.open(f);
@@ -1210,7 +1331,7 @@ Error ResourceFormatLoaderBinary::rename_dependencies(const String &p_path, cons
 
 		Ref<FileAccessCompressed> facw;
 		facw.instantiate();
-		facw->configure("RSCC");
+		facw->configure("RSCC", Compression::MODE_ZSTD, 4096, Compression::zstd_dictionary_id);
 		err = facw->open_internal(p_path + ".depren", FileAccess::WRITE);
 		ERR_FAIL_COND_V_MSG(err, ERR_FILE_CORRUPT, "Cannot create file '" + p_path + ".depren'.");
 
@@ -1989,7 +2110,7 @@ Error ResourceFormatSaverBinaryInstance::save(const String &p_path, const Ref<Re
 	if (p_flags & ResourceSaver::FLAG_COMPRESS) {
 		Ref<FileAccessCompressed> fac;
 		fac.instantiate();
-		fac->configure("RSCC");
+		fac->configure("RSCC", Compression::MODE_ZSTD, 4096, Compression::zstd_dictionary_id);
 		f = fac;
 		err = fac->open_internal(p_path, FileAccess::WRITE);
 	} else {
@@ -61,6 +61,7 @@ class ResourceLoaderBinary {
 		String type;
 		ResourceUID::ID uid = ResourceUID::INVALID_ID;
 		Ref<Resource> cache;
+		bool requested = false; // Requested with load_threaded_request() and not collected yet.
 	};
 
 	bool using_named_scene_ids = false;
@@ -68,6 +69,8 @@ class ResourceLoaderBinary {
 	bool use_sub_threads = false;
 	float *progress = nullptr;
 	Vector<ExtResource> external_resources;
+	// Files of external resources read ahead, see ResourceLoader::prefetch_files().
+	Vector<String> prefetched_files;
 
 	struct IntResource {
 		String path;
@@ -77,6 +80,12 @@ class ResourceLoaderBinary {
 	Vector<IntResource> internal_resources;
 	HashMap<String, Ref<Resource>> internal_index_cache;
 
+	// When loading a single sub-resource ("path::id"), only it and what it references are loaded, as they are reached.
+	String sub_resource_id;
+	bool lazy_resources = false;
+
+	Error _load_internal_resource(int p_index);
+
 	String get_unicode_string();
 	void _advance_padding(uint32_t p_len);
 
@@ -104,10 +113,12 @@ public:
 	void get_classes_used(Ref<FileAccess> p_f, HashSet<StringName> *p_classes);
 
 	ResourceLoaderBinary() {}
+	~ResourceLoaderBinary();
 };
 
 class ResourceFormatLoaderBinary : public ResourceFormatLoader {
 public:
+	virtual bool recognize_path(const String &p_path, const String &p_for_type = String()) const;
 	virtual Ref<Resource> load(const String &p_path, const String &p_original_path = "", Error *r_error = nullptr, bool p_use_sub_threads = false, float *r_progress = nullptr, CacheMode p_cache_mode = CACHE_MODE_REUSE);
 	virtual void get_recognized_extensions_for_type(const String &p_type, List<String> *p_extensions) const;
 	virtual void get_recognized_extensions(List<String> *p_extensions) const;
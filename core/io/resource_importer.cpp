@@ -40,7 +40,7 @@ bool ResourceFormatImporter::SortImporterByName::operator()(const Ref<ResourceIm
 
 Error ResourceFormatImporter::_get_path_and_type(const String &p_path, PathAndType &r_path_and_type, bool *r_valid) const {
 	Error err;
-	Ref<FileAccess> f = FileAccess::open(p_path + ".import", FileAccess::READ, &err);
+	Ref<FileAccess> f = ResourceLoader::open_file(p_path + ".import", &err);
 
 	if (f.is_null()) {
 		if (r_valid) {
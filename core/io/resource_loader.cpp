@@ -32,6 +32,7 @@
 
 #include "core/config/project_settings.h"
 #include "core/io/file_access.h"
+#include "core/io/file_access_memory.h"
 #include "core/io/resource_importer.h"
 #include "core/os/os.h"
 #include "core/string/print_string.h"
@@ -224,38 +225,42 @@ Ref<Resource> ResourceLoader::_load(const String &p_path, const String &p_origin
 
 void ResourceLoader::_thread_load_function(void *p_userdata) {
 	ThreadLoadTask &load_task = *(ThreadLoadTask *)p_userdata;
-	load_task.loader_id = Thread::get_caller_id();
 
-	if (load_task.semaphore) {
-		//this is an actual thread, so wait for Ok from semaphore
-		thread_load_semaphore->wait(); //wait until its ok to start loading
+	// Worker threads run other tasks while they wait, so this may run on top of a load that is waiting.
+	ThreadLoadTask *prev_load_task = curr_load_task;
+
+	thread_load_mutex->lock();
+	bool canceled = load_task.canceled;
+	if (prev_load_task && !canceled) {
+		prev_load_task->nested_load_task = &load_task;
+	}
+	thread_load_mutex->unlock();
+
+	if (canceled) {
+		load_task.error = ERR_SKIP; // Canceled before it could start.
+	} else {
+		curr_load_task = &load_task;
+		load_task.resource = _load(load_task.remapped_path, load_task.remapped_path != load_task.local_path ? load_task.local_path : String(), load_task.type_hint, load_task.cache_mode, &load_task.error, load_task.use_sub_threads, &load_task.progress);
+		curr_load_task = prev_load_task;
 	}
-	load_task.resource = _load(load_task.remapped_path, load_task.remapped_path != load_task.local_path ? load_task.local_path : String(), load_task.type_hint, load_task.cache_mode, &load_task.error, load_task.use_sub_threads, &load_task.progress);
 
 	load_task.progress = 1.0; //it was fully loaded at this point, so force progress to 1.0
 
 	thread_load_mutex->lock();
+	if (prev_load_task) {
+		prev_load_task->nested_load_task = nullptr;
+	}
 	if (load_task.error != OK) {
 		load_task.status = THREAD_LOAD_FAILED;
 	} else {
 		load_task.status = THREAD_LOAD_LOADED;
 	}
-	if (load_task.semaphore) {
-		if (load_task.start_next && thread_waiting_count > 0) {
-			thread_waiting_count--;
-			//thread loading count remains constant, this ends but another one begins
-			thread_load_semaphore->post();
-		} else {
-			thread_loading_count--; //no threads waiting, just reduce loading count
-		}
 
-		print_lt("END: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
+	print_lt("END: " + load_task.local_path + " / waiting: " + itos(load_task.poll_requests));
 
-		for (int i = 0; i < load_task.poll_requests; i++) {
-			load_task.semaphore->post();
-		}
-		memdelete(load_task.semaphore);
-		load_task.semaphore = nullptr;
+	// Waiters free the semaphore once they are all woken up.
+	for (int i = 0; i < load_task.poll_requests; i++) {
+		load_task.semaphore->post();
 	}
 
 	if (load_task.resource.is_valid()) {
@@ -280,6 +285,21 @@ void ResourceLoader::_thread_load_function(void *p_userdata) {
 		}
 	}
 
+	if (load_task.uses_slot) {
+		load_task.uses_slot = false;
+		thread_loading_count--;
+		_start_queued_load_tasks();
+	}
+
+	if (load_task.requests == 0) {
+		// Canceled by everyone who requested it, so nobody will come to get it.
+		if (load_task.task_id) {
+			thread_load_tasks_to_await.push_back(load_task.task_id);
+		}
+		String local_path = load_task.local_path;
+		thread_load_tasks.erase(local_path);
+	}
+
 	thread_load_mutex->unlock();
 }
 
@@ -296,6 +316,8 @@ static String _validate_local_path(const String &p_path) {
 Error ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint, bool p_use_sub_threads, ResourceFormatLoader::CacheMode p_cache_mode, const String &p_source_resource) {
 	String local_path = _validate_local_path(p_path);
 
+	_await_finished_tasks();
+
 	thread_load_mutex->lock();
 
 	if (!p_source_resource.is_empty()) {
@@ -305,7 +327,7 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 			ERR_FAIL_V_MSG(ERR_INVALID_PARAMETER, "There is no thread loading source resource '" + p_source_resource + "'.");
 		}
 		//must be loading from this thread
-		if (thread_load_tasks[p_source_resource].loader_id != Thread::get_caller_id()) {
+		if (curr_load_task != &thread_load_tasks[p_source_resource]) {
 			thread_load_mutex->unlock();
 			ERR_FAIL_V_MSG(ERR_INVALID_PARAMETER, "Threading loading resource'" + local_path + " failed: Source specified: '" + p_source_resource + "' but was not called by it.");
 		}
@@ -318,7 +340,12 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 	}
 
 	if (thread_load_tasks.has(local_path)) {
-		thread_load_tasks[local_path].requests++;
+		ThreadLoadTask &load_task = thread_load_tasks[local_path];
+		load_task.requests++;
+		if (load_task.canceled) {
+			// Wanted again, let it go on if it didn't stop yet.
+			_set_canceled(load_task, false);
+		}
 		if (!p_source_resource.is_empty()) {
 			thread_load_tasks[p_source_resource].sub_tasks.insert(local_path);
 		}
@@ -340,11 +367,6 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 
 		{ //must check if resource is already loaded before attempting to load it in a thread
 
-			if (load_task.loader_id == Thread::get_caller_id()) {
-				thread_load_mutex->unlock();
-				ERR_FAIL_V_MSG(ERR_INVALID_PARAMETER, "Attempted to load a resource already being loaded from this thread, cyclic reference?");
-			}
-
 			Ref<Resource> existing = ResourceCache::get_ref(local_path);
 
 			if (existing.is_valid()) {
@@ -365,20 +387,17 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 	ThreadLoadTask &load_task = thread_load_tasks[local_path];
 
 	if (load_task.resource.is_null()) { //needs to be loaded in thread
-
-		load_task.semaphore = memnew(Semaphore);
-		if (thread_loading_count < thread_load_max) {
-			thread_loading_count++;
-			thread_load_semaphore->post(); //we have free threads, so allow one
+		// Sub-resources hold up the load that requested them, so they go ahead of other work in the pool
+		// and don't count towards thread_load_max.
+		bool high_priority = !p_source_resource.is_empty();
+		if (!high_priority && thread_loading_count >= thread_load_max) {
+			load_task.queued = true;
+			thread_load_queue.push_back(local_path);
 		} else {
-			thread_waiting_count++;
+			_start_load_task(load_task, high_priority);
 		}
 
-		print_lt("REQUEST: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
-
-		load_task.thread = memnew(Thread);
-		load_task.thread->start(_thread_load_function, &thread_load_tasks[local_path]);
-		load_task.loader_id = load_task.thread->get_id();
+		print_lt("REQUEST: " + local_path + (high_priority ? " (sub-resource of " + p_source_resource + ")" : "") + (load_task.queued ? " (queued)" : "") + " / load count: " + itos(thread_loading_count) + " / queued: " + itos(thread_load_queue.size()));
 	}
 
 	thread_load_mutex->unlock();
@@ -440,43 +459,59 @@ Ref<Resource> ResourceLoader::load_threaded_get(const String &p_path, Error *r_e
 		return Ref<Resource>();
 	}
 
-	ThreadLoadTask &load_task = thread_load_tasks[local_path];
-
-	//semaphore still exists, meaning it's still loading, request poll
-	Semaphore *semaphore = load_task.semaphore;
-	if (semaphore) {
-		load_task.poll_requests++;
+	ThreadLoadTask *load_task = &thread_load_tasks[local_path];
+	bool waited_on_semaphore = false;
 
-		{
-			// As we got a semaphore, this means we are going to have to wait
-			// until the sub-resource is done loading
-			//
-			// As this thread will become 'blocked' we should "exchange" its
-			// active status with a waiting one, to ensure load continues.
-			//
-			// This ensures loading is never blocked and that is also within
-			// the maximum number of active threads.
-
-			if (thread_waiting_count > 0) {
-				thread_waiting_count--;
-				thread_loading_count++;
-				thread_load_semaphore->post();
-
-				load_task.start_next = false; //do not start next since we are doing it here
+	if (load_task->status == THREAD_LOAD_IN_PROGRESS) {
+		if (_is_cyclic_wait(local_path)) {
+			load_task->requests--;
+			thread_load_mutex->unlock();
+			if (r_error) {
+				*r_error = ERR_BUSY;
 			}
+			ERR_FAIL_V_MSG(Ref<Resource>(), "Attempted to get resource '" + local_path + "' from a load it is waiting for. Either it is a cyclic reference, or this load runs on top of it on the same thread.");
+		}
 
-			thread_suspended_count++;
+		if (load_task->queued && curr_load_task) {
+			// A load waiting for it would hold on to its slot meanwhile, so this can't wait for a free one.
+			load_task->queued = false;
+			thread_load_queue.erase(local_path);
+			_start_load_task(*load_task, true);
+		}
 
-			print_lt("GET: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
+		ThreadLoadTask *caller_load_task = curr_load_task;
+		if (caller_load_task) {
+			caller_load_task->awaiting = local_path;
 		}
 
-		thread_load_mutex->unlock();
-		semaphore->wait();
-		thread_load_mutex->lock();
+		if (load_task->task_id && !load_task->awaited) {
+			// Waiting on the pool task keeps a worker thread busy with other tasks meanwhile,
+			// such as the sub-resources of this load, instead of blocking it.
+			load_task->awaited = true;
+			WorkerThreadPool::TaskID task_id = load_task->task_id;
+
+			thread_load_mutex->unlock();
+			WorkerThreadPool::get_singleton()->wait_for_task_completion(task_id);
+			thread_load_mutex->lock();
+		} else {
+			if (!load_task->semaphore) {
+				load_task->semaphore = memnew(Semaphore);
+			}
+			Semaphore *semaphore = load_task->semaphore;
+			load_task->poll_requests++;
+
+			thread_load_mutex->unlock();
+			semaphore->wait();
+			thread_load_mutex->lock();
+			waited_on_semaphore = true;
+		}
 
-		thread_suspended_count--;
+		if (caller_load_task) {
+			caller_load_task->awaiting = String();
+		}
 
-		if (!thread_load_tasks.has(local_path)) { //may have been erased during unlock and this was always an invalid call
+		load_task = thread_load_tasks.getptr(local_path);
+		if (!load_task) { //may have been erased during unlock and this was always an invalid call
 			thread_load_mutex->unlock();
 			if (r_error) {
 				*r_error = ERR_INVALID_PARAMETER;
@@ -485,26 +520,174 @@ Ref<Resource> ResourceLoader::load_threaded_get(const String &p_path, Error *r_e
 		}
 	}
 
-	Ref<Resource> resource = load_task.resource;
+	if (waited_on_semaphore) {
+		load_task->poll_requests--;
+		if (load_task->poll_requests == 0) {
+			memdelete(load_task->semaphore);
+			load_task->semaphore = nullptr;
+		}
+	}
+
+	Ref<Resource> resource = load_task->resource;
 	if (r_error) {
-		*r_error = load_task.error;
+		*r_error = load_task->error;
 	}
 
-	load_task.requests--;
+	load_task->requests--;
 
-	if (load_task.requests == 0) {
-		if (load_task.thread) { //thread may not have been used
-			load_task.thread->wait_to_finish();
-			memdelete(load_task.thread);
+	WorkerThreadPool::TaskID task_to_await = 0;
+	if (load_task->requests == 0) {
+		if (load_task->task_id && !load_task->awaited) {
+			task_to_await = load_task->task_id;
 		}
 		thread_load_tasks.erase(local_path);
 	}
 
 	thread_load_mutex->unlock();
 
+	if (task_to_await) {
+		// It's done, but the pool task must still be waited on to be freed.
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(task_to_await);
+	}
+
 	return resource;
 }
 
+void ResourceLoader::load_threaded_cancel(const String &p_path) {
+	String local_path = _validate_local_path(p_path);
+
+	_await_finished_tasks();
+
+	thread_load_mutex->lock();
+	ThreadLoadTask *load_task = thread_load_tasks.getptr(local_path);
+	if (!load_task || load_task->requests <= 0) {
+		thread_load_mutex->unlock();
+		ERR_FAIL_MSG("There is no thread loading resource '" + local_path + "' to cancel.");
+	}
+
+	load_task->requests--;
+	if (load_task->requests > 0) {
+		// Somebody else still wants it.
+		thread_load_mutex->unlock();
+		return;
+	}
+
+	if (load_task->status == THREAD_LOAD_IN_PROGRESS) {
+		// Stop it as soon as possible, it removes itself when done.
+		_set_canceled(*load_task, true);
+		thread_load_mutex->unlock();
+		return;
+	}
+
+	WorkerThreadPool::TaskID task_to_await = 0;
+	if (load_task->task_id && !load_task->awaited) {
+		task_to_await = load_task->task_id;
+	}
+	thread_load_tasks.erase(local_path);
+
+	thread_load_mutex->unlock();
+
+	if (task_to_await) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(task_to_await);
+	}
+}
+
+bool ResourceLoader::is_load_canceled() {
+	if (!curr_load_task) {
+		return false;
+	}
+
+	MutexLock lock(*thread_load_mutex);
+	return curr_load_task->canceled;
+}
+
+void ResourceLoader::_set_canceled(ThreadLoadTask &p_load_task, bool p_canceled) {
+	p_load_task.canceled = p_canceled;
+
+	// Sub-resources only requested by this load follow it.
+	for (const String &E : p_load_task.sub_tasks) {
+		ThreadLoadTask *sub_task = thread_load_tasks.getptr(E);
+		if (sub_task && sub_task->requests == 1 && sub_task->canceled != p_canceled) {
+			_set_canceled(*sub_task, p_canceled);
+		}
+	}
+}
+
+void ResourceLoader::_start_load_task(ThreadLoadTask &p_load_task, bool p_high_priority) {
+	// Other loads are low priority, so background loading never takes all the worker threads.
+	if (!p_high_priority) {
+		p_load_task.uses_slot = true;
+		thread_loading_count++;
+	}
+	p_load_task.task_id = WorkerThreadPool::get_singleton()->add_native_task(&ResourceLoader::_thread_load_function, &p_load_task, p_high_priority, "Load " + p_load_task.local_path);
+}
+
+void ResourceLoader::_start_queued_load_tasks() {
+	while (thread_loading_count < thread_load_max && !thread_load_queue.is_empty()) {
+		String local_path = thread_load_queue.front()->get();
+		thread_load_queue.pop_front();
+
+		ThreadLoadTask *load_task = thread_load_tasks.getptr(local_path);
+		if (load_task && load_task->queued) {
+			load_task->queued = false;
+			_start_load_task(*load_task, false);
+		}
+	}
+}
+
+bool ResourceLoader::_is_cyclic_wait(const String &p_path) {
+	if (!curr_load_task) {
+		return false;
+	}
+
+	// A load goes on once the load it awaits has ended, and once the load its thread started on top of it has returned.
+	// Following both from the one to wait for, reaching the calling load means it would end up waiting for itself.
+	// That covers loads waiting on each other across threads, and the one to wait for being lower on this thread's stack.
+	LocalVector<const ThreadLoadTask *> to_visit;
+	HashSet<const ThreadLoadTask *> visited;
+	const ThreadLoadTask *awaited = thread_load_tasks.getptr(p_path);
+	if (awaited) {
+		to_visit.push_back(awaited);
+	}
+	while (!to_visit.is_empty()) {
+		const ThreadLoadTask *load_task = to_visit[to_visit.size() - 1];
+		to_visit.remove_at(to_visit.size() - 1);
+		if (load_task == curr_load_task) {
+			return true;
+		}
+		if (visited.has(load_task)) {
+			continue;
+		}
+		visited.insert(load_task);
+
+		if (load_task->nested_load_task) {
+			to_visit.push_back(load_task->nested_load_task);
+		}
+		if (!load_task->awaiting.is_empty()) {
+			awaited = thread_load_tasks.getptr(load_task->awaiting);
+			if (awaited) {
+				to_visit.push_back(awaited);
+			}
+		}
+	}
+	return false;
+}
+
+void ResourceLoader::_await_finished_tasks() {
+	thread_load_mutex->lock();
+	if (thread_load_tasks_to_await.is_empty()) {
+		thread_load_mutex->unlock();
+		return;
+	}
+	LocalVector<WorkerThreadPool::TaskID> task_ids = thread_load_tasks_to_await;
+	thread_load_tasks_to_await.clear();
+	thread_load_mutex->unlock();
+
+	for (uint32_t i = 0; i < task_ids.size(); i++) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(task_ids[i]);
+	}
+}
+
 Ref<Resource> ResourceLoader::load(const String &p_path, const String &p_type_hint, ResourceFormatLoader::CacheMode p_cache_mode, Error *r_error) {
 	if (r_error) {
 		*r_error = ERR_CANT_OPEN;
@@ -517,15 +700,15 @@ Ref<Resource> ResourceLoader::load(const String &p_path, const String &p_type_hi
 
 		//Is it already being loaded? poll until done
 		if (thread_load_tasks.has(local_path)) {
+			thread_load_mutex->unlock();
+
 			Error err = load_threaded_request(p_path, p_type_hint);
 			if (err != OK) {
 				if (r_error) {
 					*r_error = err;
 				}
-				thread_load_mutex->unlock();
 				return Ref<Resource>();
 			}
-			thread_load_mutex->unlock();
 
 			return load_threaded_get(p_path, r_error);
 		}
@@ -552,14 +735,25 @@ Ref<Resource> ResourceLoader::load(const String &p_path, const String &p_type_hi
 		load_task.remapped_path = _path_remap(local_path, &load_task.xl_remapped);
 		load_task.type_hint = p_type_hint;
 		load_task.cache_mode = p_cache_mode; //ignore
-		load_task.loader_id = Thread::get_caller_id();
 
 		thread_load_tasks[local_path] = load_task;
 
+		// A load calling load() waits for it, which is part of the chain checked for cycles.
+		ThreadLoadTask *caller_load_task = curr_load_task;
+		if (caller_load_task) {
+			caller_load_task->awaiting = local_path;
+		}
+
 		thread_load_mutex->unlock();
 
 		_thread_load_function(&thread_load_tasks[local_path]);
 
+		if (caller_load_task) {
+			thread_load_mutex->lock();
+			caller_load_task->awaiting = String();
+			thread_load_mutex->unlock();
+		}
+
 		return load_threaded_get(p_path, r_error);
 
 	} else {
@@ -621,6 +815,90 @@ bool ResourceLoader::exists(const String &p_path, const String &p_type_hint) {
 	return false;
 }
 
+Vector<String> ResourceLoader::prefetch_files(const Vector<String> &p_paths) {
+	Vector<String> files;
+	FileAccessAsync *file_access_async = FileAccessAsync::get_singleton();
+	if (!file_access_async || !prefetch_mutex) {
+		return files;
+	}
+
+	for (int i = 0; i < p_paths.size(); i++) {
+		String local_path = _validate_local_path(p_paths[i]);
+		if (ResourceCache::has(local_path)) {
+			continue;
+		}
+
+		// Only files read through open_file() are worth reading ahead: resources
+		// in the built-in formats, and the .import files of imported ones.
+		String path = _path_remap(local_path);
+		if (FileAccess::exists(path + ".import")) {
+			path += ".import";
+		} else {
+			String extension = path.get_extension().to_lower();
+			if (extension != "res" && extension != "scn" && extension != "tres" && extension != "tscn") {
+				continue;
+			}
+		}
+		files.push_back(path);
+	}
+
+	MutexLock lock(*prefetch_mutex);
+	for (int i = files.size() - 1; i >= 0; i--) {
+		if (prefetched_files.has(files[i])) {
+			// Already being read for another resource, which releases it.
+			files.remove_at(i);
+			continue;
+		}
+		prefetched_files.insert(files[i], file_access_async->read(files[i]));
+	}
+
+	return files;
+}
+
+void ResourceLoader::release_prefetched_files(const Vector<String> &p_files) {
+	for (int i = 0; i < p_files.size(); i++) {
+		FileAccessAsync::ReadID read_id = FileAccessAsync::INVALID_READ_ID;
+		{
+			MutexLock lock(*prefetch_mutex);
+			HashMap<String, FileAccessAsync::ReadID>::Iterator E = prefetched_files.find(p_files[i]);
+			if (!E) {
+				continue; // Already opened.
+			}
+			read_id = E->value;
+			prefetched_files.remove(E);
+		}
+		FileAccessAsync::get_singleton()->wait_for_read(read_id);
+	}
+}
+
+Ref<FileAccess> ResourceLoader::open_file(const String &p_path, Error *r_error) {
+	FileAccessAsync::ReadID read_id = FileAccessAsync::INVALID_READ_ID;
+	if (prefetch_mutex) {
+		MutexLock lock(*prefetch_mutex);
+		HashMap<String, FileAccessAsync::ReadID>::Iterator E = prefetched_files.find(p_path);
+		if (E) {
+			read_id = E->value;
+			prefetched_files.remove(E);
+		}
+	}
+
+	if (read_id != FileAccessAsync::INVALID_READ_ID) {
+		Vector<uint8_t> data;
+		if (FileAccessAsync::get_singleton()->wait_for_read(read_id, &data) == OK && !data.is_empty()) {
+			Ref<FileAccessMemory> f;
+			f.instantiate();
+			f->open_custom(data);
+			if (r_error) {
+				*r_error = OK;
+			}
+			return f;
+		}
+		// Let FileAccess report errors, and open empty files.
+	}
+
+	return FileAccess::open(p_path, FileAccess::READ, r_error);
+}
+
 void ResourceLoader::add_resource_format_loader(Ref<ResourceFormatLoader> p_format_loader, bool p_at_front) {
 	ERR_FAIL_COND(p_format_loader.is_null());
 	ERR_FAIL_COND(loader_count >= MAX_LOADERS);
@@ -1028,14 +1306,13 @@ void ResourceLoader::initialize() {
 	thread_load_mutex = memnew(Mutex);
 	thread_load_max = OS::get_singleton()->get_processor_count();
 	thread_loading_count = 0;
-	thread_waiting_count = 0;
-	thread_suspended_count = 0;
-	thread_load_semaphore = memnew(Semaphore);
+	prefetch_mutex = memnew(Mutex);
 }
 
 void ResourceLoader::finalize() {
 	memdelete(thread_load_mutex);
-	memdelete(thread_load_semaphore);
+	memdelete(prefetch_mutex);
+	prefetch_mutex = nullptr;
 }
 
 ResourceLoadErrorNotify ResourceLoader::err_notify = nullptr;
@@ -1050,13 +1327,15 @@ bool ResourceLoader::timestamp_on_load = false;
 
 Mutex *ResourceLoader::thread_load_mutex = nullptr;
 HashMap<String, ResourceLoader::ThreadLoadTask> ResourceLoader::thread_load_tasks;
-Semaphore *ResourceLoader::thread_load_semaphore = nullptr;
-
+LocalVector<WorkerThreadPool::TaskID> ResourceLoader::thread_load_tasks_to_await;
+thread_local ResourceLoader::ThreadLoadTask *ResourceLoader::curr_load_task = nullptr;
+List<String> ResourceLoader::thread_load_queue;
 int ResourceLoader::thread_loading_count = 0;
-int ResourceLoader::thread_waiting_count = 0;
-int ResourceLoader::thread_suspended_count = 0;
 int ResourceLoader::thread_load_max = 0;
 
+Mutex *ResourceLoader::prefetch_mutex = nullptr;
+HashMap<String, FileAccessAsync::ReadID> ResourceLoader::prefetched_files;
+
 SelfList<Resource>::List ResourceLoader::remapped_list;
 HashMap<String, Vector<String>> ResourceLoader::translation_remaps;
 HashMap<String, String> ResourceLoader::path_remaps;
@@ -31,9 +31,11 @@
 #ifndef RESOURCE_LOADER_H
 #define RESOURCE_LOADER_H
 
+#include "core/io/file_access_async.h"
 #include "core/io/resource.h"
 #include "core/object/gdvirtual.gen.inc"
 #include "core/object/script_language.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/semaphore.h"
 #include "core/os/thread.h"
 
@@ -132,8 +134,14 @@ private:
 	static Ref<ResourceFormatLoader> _find_custom_resource_format_loader(String path);
 
 	struct ThreadLoadTask {
-		Thread *thread = nullptr;
-		Thread::ID loader_id = 0;
+		WorkerThreadPool::TaskID task_id = 0; // Zero if it's loaded on the thread calling load().
+		bool awaited = false; // The pool task can only be waited on once, other waiters use the semaphore.
+		bool queued = false; // Waiting in thread_load_queue for a free slot.
+		bool uses_slot = false; // Counted in thread_loading_count while it runs.
+		String awaiting; // Path of the load this one is blocked on, to detect cyclic loads.
+		// Load the thread running this one started on top of it while it waits, the next on the thread's stack of loads.
+		// This one can't go on before that one returns, even once what it awaits has ended.
+		ThreadLoadTask *nested_load_task = nullptr;
 		Semaphore *semaphore = nullptr;
 		String local_path;
 		String remapped_path;
@@ -145,7 +153,7 @@ private:
 		Ref<Resource> resource;
 		bool xl_remapped = false;
 		bool use_sub_threads = false;
-		bool start_next = true;
+		bool canceled = false;
 		int requests = 0;
 		int poll_requests = 0;
 		HashSet<String> sub_tasks;
@@ -154,22 +162,42 @@ private:
 	static void _thread_load_function(void *p_userdata);
 	static Mutex *thread_load_mutex;
 	static HashMap<String, ThreadLoadTask> thread_load_tasks;
-	static Semaphore *thread_load_semaphore;
-	static int thread_waiting_count;
+	// Pool tasks of canceled loads that finished after their last request was dropped.
+	static LocalVector<WorkerThreadPool::TaskID> thread_load_tasks_to_await;
+	static thread_local ThreadLoadTask *curr_load_task;
+	// Top-level loads beyond thread_load_max wait here until a running one finishes.
+	static List<String> thread_load_queue;
 	static int thread_loading_count;
-	static int thread_suspended_count;
 	static int thread_load_max;
 
 	static float _dependency_get_progress(const String &p_path);
+	static void _set_canceled(ThreadLoadTask &p_load_task, bool p_canceled);
+	static void _await_finished_tasks();
+	static void _start_load_task(ThreadLoadTask &p_load_task, bool p_high_priority);
+	static void _start_queued_load_tasks();
+	static bool _is_cyclic_wait(const String &p_path);
+
+	// Files of dependencies read ahead with FileAccessAsync, until open_file() or release_prefetched_files().
+	static Mutex *prefetch_mutex;
+	static HashMap<String, FileAccessAsync::ReadID> prefetched_files;
 
 public:
 	static Error load_threaded_request(const String &p_path, const String &p_type_hint = "", bool p_use_sub_threads = false, ResourceFormatLoader::CacheMode p_cache_mode = ResourceFormatLoader::CACHE_MODE_REUSE, const String &p_source_resource = String());
 	static ThreadLoadStatus load_threaded_get_status(const String &p_path, float *r_progress = nullptr);
 	static Ref<Resource> load_threaded_get(const String &p_path, Error *r_error = nullptr);
+	static void load_threaded_cancel(const String &p_path);
+	static bool is_load_canceled();
 
 	static Ref<Resource> load(const String &p_path, const String &p_type_hint = "", ResourceFormatLoader::CacheMode p_cache_mode = ResourceFormatLoader::CACHE_MODE_REUSE, Error *r_error = nullptr);
 	static bool exists(const String &p_path, const String &p_type_hint = "");
 
+	// Starts reading the files of the given resources at once, for format loaders about to load them
+	// as dependencies. Returns the files to release once done, whether they were used or not.
+	static Vector<String> prefetch_files(const Vector<String> &p_paths);
+	static void release_prefetched_files(const Vector<String> &p_files);
+	// For format loaders, opens p_path from its prefetched data if there is any.
+	static Ref<FileAccess> open_file(const String &p_path, Error *r_error = nullptr);
+
 	static void get_recognized_extensions_for_type(const String &p_type, List<String> *p_extensions);
 	static void add_resource_format_loader(Ref<ResourceFormatLoader> p_format_loader, bool p_at_front = false);
 	static void remove_resource_format_loader(Ref<ResourceFormatLoader> p_format_loader);
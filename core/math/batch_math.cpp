@@ -0,0 +1,666 @@
+/*************************************************************************/
+/*  batch_math.cpp                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "batch_math.h"
+
+#include "core/error/error_macros.h"
+#include "core/string/ustring.h"
+
+#include <atomic>
+
+#ifndef REAL_T_IS_DOUBLE
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BATCH_MATH_SSE2
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define BATCH_MATH_AVX
+#endif
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define BATCH_MATH_NEON
+#endif
+#endif
+
+#ifdef BATCH_MATH_SSE2
+#include <emmintrin.h>
+#endif
+#ifdef BATCH_MATH_AVX
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+// MSVC allows AVX intrinsics in any function.
+#define BATCH_MATH_TARGET_AVX
+#else
+#define BATCH_MATH_TARGET_AVX __attribute__((target("avx")))
+#endif
+#endif
+#ifdef BATCH_MATH_NEON
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+struct Kernels {
+	void (*xform_points)(const Transform3D &, const Vector3 *, Vector3 *, uint32_t);
+	void (*xform_normals)(const Basis &, const Vector3 *, Vector3 *, uint32_t);
+	void (*xform_aabbs)(const Transform3D &, const AABB *, AABB *, uint32_t);
+	AABB (*merge_aabbs)(const AABB *, uint32_t);
+	void (*multiply_transforms)(const Transform3D &, const Transform3D *, Transform3D *, uint32_t);
+	void (*transforms_to_buffer)(const Transform3D *, uint32_t, float *, uint32_t, uint32_t);
+	void (*multiply_transforms_to_buffer)(const Transform3D &, const Transform3D *, uint32_t, float *, uint32_t, uint32_t);
+};
+
+_FORCE_INLINE_ const Transform3D &get_strided(const Transform3D *p_src, uint32_t p_stride, uint32_t p_index) {
+	return *(const Transform3D *)((const uint8_t *)p_src + size_t(p_stride) * p_index);
+}
+
+_FORCE_INLINE_ void write_buffer_transform(const Transform3D &p_transform, float *p_dst) {
+	p_dst[0] = p_transform.basis.rows[0][0];
+	p_dst[1] = p_transform.basis.rows[0][1];
+	p_dst[2] = p_transform.basis.rows[0][2];
+	p_dst[3] = p_transform.origin.x;
+	p_dst[4] = p_transform.basis.rows[1][0];
+	p_dst[5] = p_transform.basis.rows[1][1];
+	p_dst[6] = p_transform.basis.rows[1][2];
+	p_dst[7] = p_transform.origin.y;
+	p_dst[8] = p_transform.basis.rows[2][0];
+	p_dst[9] = p_transform.basis.rows[2][1];
+	p_dst[10] = p_transform.basis.rows[2][2];
+	p_dst[11] = p_transform.origin.z;
+}
+
+/* Scalar */
+
+void xform_points_scalar(const Transform3D &p_transform, const Vector3 *p_src, Vector3 *p_dst, uint32_t p_count) {
+	for (uint32_t i = 0; i < p_count; i++) {
+		p_dst[i] = p_transform.xform(p_src[i]);
+	}
+}
+
+void xform_normals_scalar(const Basis &p_basis, const Vector3 *p_src, Vector3 *p_dst, uint32_t p_count) {
+	for (uint32_t i = 0; i < p_count; i++) {
+		p_dst[i] = p_basis.xform(p_src[i]).normalized();
+	}
+}
+
+void xform_aabbs_scalar(const Transform3D &p_transform, const AABB *p_src, AABB *p_dst, uint32_t p_count) {
+	for (uint32_t i = 0; i < p_count; i++) {
+		p_dst[i] = p_transform.xform(p_src[i]);
+	}
+}
+
+AABB merge_aabbs_scalar(const AABB *p_src, uint32_t p_count) {
+	if (p_count == 0) {
+		return AABB();
+	}
+	Vector3 min = p_src[0].position;
+	Vector3 max = p_src[0].position + p_src[0].size;
+	for (uint32_t i = 1; i < p_count; i++) {
+		Vector3 begin = p_src[i].position;
+		Vector3 end = p_src[i].position + p_src[i].size;
+		for (int j = 0; j < 3; j++) {
+			min[j] = min[j] < begin[j] ? min[j] : begin[j];
+			max[j] = max[j] > end[j] ? max[j] : end[j];
+		}
+	}
+	return AABB(min, max - min);
+}
+
+void multiply_transforms_scalar(const Transform3D &p_transform, const Transform3D *p_src, Transform3D *p_dst, uint32_t p_count) {
+	for (uint32_t i = 0; i < p_count; i++) {
+		p_dst[i] = p_transform * p_src[i];
+	}
+}
+
+void transforms_to_buffer_scalar(const Transform3D *p_src, uint32_t p_src_stride, float *p_dst, uint32_t p_dst_stride, uint32_t p_count) {
+	for (uint32_t i = 0; i < p_count; i++) {
+		write_buffer_transform(get_strided(p_src, p_src_stride, i), p_dst + size_t(p_dst_stride) * i);
+	}
+}
+
+void multiply_transforms_to_buffer_scalar(const Transform3D &p_transform, const Transform3D *p_src, uint32_t p_src_stride, float *p_dst, uint32_t p_dst_stride, uint32_t p_count) {
+	for (uint32_t i = 0; i < p_count; i++) {
+		write_buffer_transform(p_transform * get_strided(p_src, p_src_stride, i), p_dst + size_t(p_dst_stride) * i);
+	}
+}
+
+const Kernels scalar_kernels = {
+	xform_points_scalar,
+	xform_normals_scalar,
+	xform_aabbs_scalar,
+	merge_aabbs_scalar,
+	multiply_transforms_scalar,
+	transforms_to_buffer_scalar,
+	multiply_transforms_to_buffer_scalar,
+};
+
+/* SSE2 */
+
+#ifdef BATCH_MATH_SSE2
+
+#define SHUFFLE(m_a, m_b, m_x, m_y, m_z, m_w) _mm_shuffle_ps(m_a, m_b, _MM_SHUFFLE(m_w, m_z, m_y, m_x))
+
+// Four packed Vector3 (x0 y0 z0 x1, y1 z1 x2 y2, z2 x3 y3 z3) to one register per axis, and back.
+_FORCE_INLINE_ void deinterleave_sse2(__m128 p_a, __m128 p_b, __m128 p_c, __m128 &r_x, __m128 &r_y, __m128 &r_z) {
+	r_x = SHUFFLE(p_a, SHUFFLE(p_b, p_c, 2, 2, 1, 1), 0, 3, 0, 2);
+	r_y = SHUFFLE(SHUFFLE(p_a, p_b, 1, 1, 0, 0), SHUFFLE(p_b, p_c, 3, 3, 2, 2), 0, 2, 0, 2);
+	r_z = SHUFFLE(SHUFFLE(p_a, p_b, 2, 2, 1, 1), SHUFFLE(p_c, p_c, 0, 0, 3, 3), 0, 2, 0, 2);
+}
+
+_FORCE_INLINE_ void interleave_sse2(__m128 p_x, __m128 p_y, __m128 p_z, __m128 &r_a, __m128 &r_b, __m128 &r_c) {
+	r_a = SHUFFLE(SHUFFLE(p_x, p_y, 0, 0, 0, 0), SHUFFLE(p_z, p_x, 0, 0, 1, 1), 0, 2, 0, 2);
+	r_b = SHUFFLE(SHUFFLE(p_y, p_z, 1, 1, 1, 1), SHUFFLE(p_x, p_y, 2, 2, 2, 2), 0, 2, 0, 2);
+	r_c = SHUFFLE(SHUFFLE(p_z, p_x, 2, 2, 3, 3), SHUFFLE(p_y, p_z, 3, 3, 3, 3), 0, 2, 0, 2);
+}
+
+// Element i of the result is p_m0[i] * p_v0 + p_m1[i] * p_v1 + p_m2[i] * p_v2, in the order Vector3::dot() uses.
+_FORCE_INLINE_ __m128 dot3_sse2(__m128 p_m0, __m128 p_m1, __m128 p_m2, __m128 p_v0, __m128 p_v1, __m128 p_v2) {
+	return _mm_add_ps(_mm_add_ps(_mm_mul_ps(p_m0, p_v0), _mm_mul_ps(p_m1, p_v1)), _mm_mul_ps(p_m2, p_v2));
+}
+
+_FORCE_INLINE_ __m128 normalize_component_sse2(__m128 p_v, __m128 p_length, __m128 p_nonzero) {
+	return _mm_and_ps(p_nonzero, _mm_div_ps(p_v, p_length));
+}
+
+void xform_points_sse2(const Transform3D &p_transform, const Vector3 *p_src, Vector3 *p_dst, uint32_t p_count) {
+	const Basis &b = p_transform.basis;
+	const __m128 m00 = _mm_set1_ps(b.rows[0][0]), m01 = _mm_set1_ps(b.rows[0][1]), m02 = _mm_set1_ps(b.rows[0][2]);
+	const __m128 m10 = _mm_set1_ps(b.rows[1][0]), m11 = _mm_set1_ps(b.rows[1][1]), m12 = _mm_set1_ps(b.rows[1][2]);
+	const __m128 m20 = _mm_set1_ps(b.rows[2][0]), m21 = _mm_set1_ps(b.rows[2][1]), m22 = _mm_set1_ps(b.rows[2][2]);
+	const __m128 ox = _mm_set1_ps(p_transform.origin.x), oy = _mm_set1_ps(p_transform.origin.y), oz = _mm_set1_ps(p_transform.origin.z);
+
+	uint32_t i = 0;
+	for (; i + 4 <= p_count; i += 4) {
+		const float *src = (const float *)(p_src + i);
+		float *dst = (float *)(p_dst + i);
+		__m128 x, y, z;
+		deinterleave_sse2(_mm_loadu_ps(src), _mm_loadu_ps(src + 4), _mm_loadu_ps(src + 8), x, y, z);
+
+		__m128 a, b2, c;
+		interleave_sse2(_mm_add_ps(dot3_sse2(m00, m01, m02, x, y, z), ox), _mm_add_ps(dot3_sse2(m10, m11, m12, x, y, z), oy), _mm_add_ps(dot3_sse2(m20, m21, m22, x, y, z), oz), a, b2, c);
+		_mm_storeu_ps(dst, a);
+		_mm_storeu_ps(dst + 4, b2);
+		_mm_storeu_ps(dst + 8, c);
+	}
+	xform_points_scalar(p_transform, p_src + i, p_dst + i, p_count - i);
+}
+
+void xform_normals_sse2(const Basis &p_basis, const Vector3 *p_src, Vector3 *p_dst, uint32_t p_count) {
+	const __m128 m00 = _mm_set1_ps(p_basis.rows[0][0]), m01 = _mm_set1_ps(p_basis.rows[0][1]), m02 = _mm_set1_ps(p_basis.rows[0][2]);
+	const __m128 m10 = _mm_set1_ps(p_basis.rows[1][0]), m11 = _mm_set1_ps(p_basis.rows[1][1]), m12 = _mm_set1_ps(p_basis.rows[1][2]);
+	const __m128 m20 = _mm_set1_ps(p_basis.rows[2][0]), m21 = _mm_set1_ps(p_basis.rows[2][1]), m22 = _mm_set1_ps(p_basis.rows[2][2]);
+	const __m128 zero = _mm_setzero_ps();
+
+	uint32_t i = 0;
+	for (; i + 4 <= p_count; i += 4) {
+		const float *src = (const float *)(p_src + i);
+		float *dst = (float *)(p_dst + i);
+		__m128 x, y, z;
+		deinterleave_sse2(_mm_loadu_ps(src), _mm_loadu_ps(src + 4), _mm_loadu_ps(src + 8), x, y, z);
+
+		__m128 rx = dot3_sse2(m00, m01, m02, x, y, z);
+		__m128 ry = dot3_sse2(m10, m11, m12, x, y, z);
+		__m128 rz = dot3_sse2(m20, m21, m22, x, y, z);
+		__m128 length_squared = dot3_sse2(rx, ry, rz, rx, ry, rz);
+		__m128 length = _mm_sqrt_ps(length_squared);
+		__m128 nonzero = _mm_cmpneq_ps(length_squared, zero);
+
+		__m128 a, b, c;
+		interleave_sse2(normalize_component_sse2(rx, length, nonzero), normalize_component_sse2(ry, length, nonzero), normalize_component_sse2(rz, length, nonzero), a, b, c);
+		_mm_storeu_ps(dst, a);
+		_mm_storeu_ps(dst + 4, b);
+		_mm_storeu_ps(dst + 8, c);
+	}
+	xform_normals_scalar(p_basis, p_src + i, p_dst + i, p_count - i);
+}
+
+void xform_aabbs_sse2(const Transform3D &p_transform, const AABB *p_src, AABB *p_dst, uint32_t p_count) {
+	const Basis &b = p_transform.basis;
+	const __m128 column0 = _mm_setr_ps(b.rows[0][0], b.rows[1][0], b.rows[2][0], 0);
+	const __m128 column1 = _mm_setr_ps(b.rows[0][1], b.rows[1][1], b.rows[2][1], 0);
+	const __m128 column2 = _mm_setr_ps(b.rows[0][2], b.rows[1][2], b.rows[2][2], 0);
+	const __m128 origin = _mm_setr_ps(p_transform.origin.x, p_transform.origin.y, p_transform.origin.z, 0);
+
+	for (uint32_t i = 0; i < p_count; i++) {
+		// An AABB is six floats: position, then size.
+		const float *src = (const float *)(p_src + i);
+		float *dst = (float *)(p_dst + i);
+		__m128 min = _mm_loadu_ps(src);
+		__m128 tail = _mm_loadu_ps(src + 2);
+		__m128 max = _mm_add_ps(min, SHUFFLE(tail, tail, 1, 2, 3, 3));
+
+		__m128 tmin = origin;
+		__m128 tmax = origin;
+		__m128 e = _mm_mul_ps(column0, SHUFFLE(min, min, 0, 0, 0, 0));
+		__m128 f = _mm_mul_ps(column0, SHUFFLE(max, max, 0, 0, 0, 0));
+		tmin = _mm_add_ps(tmin, _mm_min_ps(e, f));
+		tmax = _mm_add_ps(tmax, _mm_max_ps(f, e));
+		e = _mm_mul_ps(column1, SHUFFLE(min, min, 1, 1, 1, 1));
+		f = _mm_mul_ps(column1, SHUFFLE(max, max, 1, 1, 1, 1));
+		tmin = _mm_add_ps(tmin, _mm_min_ps(e, f));
+		tmax = _mm_add_ps(tmax, _mm_max_ps(f, e));
+		e = _mm_mul_ps(column2, SHUFFLE(min, min, 2, 2, 2, 2));
+		f = _mm_mul_ps(column2, SHUFFLE(max, max, 2, 2, 2, 2));
+		tmin = _mm_add_ps(tmin, _mm_min_ps(e, f));
+		tmax = _mm_add_ps(tmax, _mm_max_ps(f, e));
+
+		__m128 size = _mm_sub_ps(tmax, tmin);
+		__m128 mid = SHUFFLE(tmin, size, 2, 2, 0, 0);
+		_mm_storeu_ps(dst, SHUFFLE(tmin, mid, 0, 1, 0, 2));
+		_mm_storeu_ps(dst + 2, SHUFFLE(mid, size, 0, 2, 1, 2));
+	}
+}
+
+AABB merge_aabbs_sse2(const AABB *p_src, uint32_t p_count) {
+	if (p_count < 2) {
+		return merge_aabbs_scalar(p_src, p_count);
+	}
+
+	const float *first = (const float *)p_src;
+	__m128 min = _mm_loadu_ps(first);
+	__m128 tail = _mm_loadu_ps(first + 2);
+	__m128 max = _mm_add_ps(min, SHUFFLE(tail, tail, 1, 2, 3, 3));
+	for (uint32_t i = 1; i < p_count; i++) {
+		const float *src = (const float *)(p_src + i);
+		__m128 begin = _mm_loadu_ps(src);
+		tail = _mm_loadu_ps(src + 2);
+		min = _mm_min_ps(min, begin);
+		max = _mm_max_ps(max, _mm_add_ps(begin, SHUFFLE(tail, tail, 1, 2, 3, 3)));
+	}
+
+	float result_min[4];
+	float result_size[4];
+	_mm_storeu_ps(result_min, min);
+	_mm_storeu_ps(result_size, _mm_sub_ps(max, min));
+	return AABB(Vector3(result_min[0], result_min[1], result_min[2]), Vector3(result_size[0], result_size[1], result_size[2]));
+}
+
+// Computes p_transform * p_src, as the basis rows and the origin in registers.
+struct TransformMultiplierSSE2 {
+	__m128 a[3][3]; // Each element of the basis, broadcast.
+	__m128 column[3];
+	__m128 origin;
+
+	_FORCE_INLINE_ void multiply(const Transform3D &p_src, __m128 &r_row0, __m128 &r_row1, __m128 &r_row2, __m128 &r_origin) const {
+		const float *src = (const float *)&p_src;
+		__m128 row0 = _mm_loadu_ps(src);
+		__m128 row1 = _mm_loadu_ps(src + 3);
+		__m128 row2 = _mm_loadu_ps(src + 6);
+		__m128 src_origin = _mm_loadu_ps(src + 8); // Last element of the basis, then the origin.
+
+		r_row0 = dot3_sse2(row0, row1, row2, a[0][0], a[0][1], a[0][2]);
+		r_row1 = dot3_sse2(row0, row1, row2, a[1][0], a[1][1], a[1][2]);
+		r_row2 = dot3_sse2(row0, row1, row2, a[2][0], a[2][1], a[2][2]);
+		r_origin = _mm_add_ps(dot3_sse2(column[0], column[1], column[2], SHUFFLE(src_origin, src_origin, 1, 1, 1, 1), SHUFFLE(src_origin, src_origin, 2, 2, 2, 2), SHUFFLE(src_origin, src_origin, 3, 3, 3, 3)), origin);
+	}
+
+	TransformMultiplierSSE2(const Transform3D &p_transform) {
+		const Basis &b = p_transform.basis;
+		for (int i = 0; i < 3; i++) {
+			for (int j = 0; j < 3; j++) {
+				a[i][j] = _mm_set1_ps(b.rows[i][j]);
+			}
+			column[i] = _mm_setr_ps(b.rows[0][i], b.rows[1][i], b.rows[2][i], 0);
+		}
+		origin = _mm_setr_ps(p_transform.origin.x, p_transform.origin.y, p_transform.origin.z, 0);
+	}
+};
+
+_FORCE_INLINE_ void load_transform_sse2(const Transform3D &p_src, __m128 &r_row0, __m128 &r_row1, __m128 &r_row2, __m128 &r_origin) {
+	const float *src = (const float *)&p_src;
+	r_row0 = _mm_loadu_ps(src);
+	r_row1 = _mm_loadu_ps(src + 3);
+	r_row2 = _mm_loadu_ps(src + 6);
+	__m128 tail = _mm_loadu_ps(src + 8);
+	r_origin = SHUFFLE(tail, tail, 1, 2, 3, 3);
+}
+
+_FORCE_INLINE_ void store_transform_sse2(__m128 p_row0, __m128 p_row1, __m128 p_row2, __m128 p_origin, Transform3D &r_dst) {
+	float *dst = (float *)&r_dst;
+	// Stored in order, each store overwriting the unused last element of the previous one.
+	_mm_storeu_ps(dst, p_row0);
+	_mm_storeu_ps(dst + 3, p_row1);
+	_mm_storeu_ps(dst + 6, p_row2);
+	_mm_storeu_ps(dst + 8, SHUFFLE(SHUFFLE(p_row2, p_origin, 2, 2, 0, 0), p_origin, 0, 2, 1, 2));
+}
+
+_FORCE_INLINE_ void store_buffer_transform_sse2(__m128 p_row0, __m128 p_row1, __m128 p_row2, __m128 p_origin, float *p_dst) {
+	_mm_storeu_ps(p_dst, SHUFFLE(p_row0, SHUFFLE(p_row0, p_origin, 2, 2, 0, 0), 0, 1, 0, 2));
+	_mm_storeu_ps(p_dst + 4, SHUFFLE(p_row1, SHUFFLE(p_row1, p_origin, 2, 2, 1, 1), 0, 1, 0, 2));
+	_mm_storeu_ps(p_dst + 8, SHUFFLE(p_row2, SHUFFLE(p_row2, p_origin, 2, 2, 2, 2), 0, 1, 0, 2));
+}
+
+void multiply_transforms_sse2(const Transform3D &p_transform, const Transform3D *p_src, Transform3D *p_dst, uint32_t p_count) {
+	const TransformMultiplierSSE2 multiplier(p_transform);
+	for (uint32_t i = 0; i < p_count; i++) {
+		__m128 row0, row1, row2, origin;
+		multiplier.multiply(p_src[i], row0, row1, row2, origin);
+		store_transform_sse2(row0, row1, row2, origin, p_dst[i]);
+	}
+}
+
+void transforms_to_buffer_sse2(const Transform3D *p_src, uint32_t p_src_stride, float *p_dst, uint32_t p_dst_stride, uint32_t p_count) {
+	for (uint32_t i = 0; i < p_count; i++) {
+		__m128 row0, row1, row2, origin;
+		load_transform_sse2(get_strided(p_src, p_src_stride, i), row0, row1, row2, origin);
+		store_buffer_transform_sse2(row0, row1, row2, origin, p_dst + size_t(p_dst_stride) * i);
+	}
+}
+
+void multiply_transforms_to_buffer_sse2(const Transform3D &p_transform, const Transform3D *p_src, uint32_t p_src_stride, float *p_dst, uint32_t p_dst_stride, uint32_t p_count) {
+	const TransformMultiplierSSE2 multiplier(p_transform);
+	for (uint32_t i = 0; i < p_count; i++) {
+		__m128 row0, row1, row2, origin;
+		multiplier.multiply(get_strided(p_src, p_src_stride, i), row0, row1, row2, origin);
+		store_buffer_transform_sse2(row0, row1, row2, origin, p_dst + size_t(p_dst_stride) * i);
+	}
+}
+
+const Kernels sse2_kernels = {
+	xform_points_sse2,
+	xform_normals_sse2,
+	xform_aabbs_sse2,
+	merge_aabbs_sse2,
+	multiply_transforms_sse2,
+	transforms_to_buffer_sse2,
+	multiply_transforms_to_buffer_sse2,
+};
+
+#endif // BATCH_MATH_SSE2
+
+/* AVX */
+
+#ifdef BATCH_MATH_AVX
+
+// Same as SSE2, with two groups of four vectors, one per 128-bit lane. Shuffles work within lanes.
+#define SHUFFLE256(m_a, m_b, m_x, m_y, m_z, m_w) _mm256_shuffle_ps(m_a, m_b, _MM_SHUFFLE(m_w, m_z, m_y, m_x))
+
+BATCH_MATH_TARGET_AVX _FORCE_INLINE_ __m256 load2_avx(const float *p_low, const float *p_high) {
+	return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p_low)), _mm_loadu_ps(p_high), 1);
+}
+
+BATCH_MATH_TARGET_AVX _FORCE_INLINE_ void store2_avx(float *p_low, float *p_high, __m256 p_value) {
+	_mm_storeu_ps(p_low, _mm256_castps256_ps128(p_value));
+	_mm_storeu_ps(p_high, _mm256_extractf128_ps(p_value, 1));
+}
+
+BATCH_MATH_TARGET_AVX _FORCE_INLINE_ void deinterleave_avx(__m256 p_a, __m256 p_b, __m256 p_c, __m256 &r_x, __m256 &r_y, __m256 &r_z) {
+	r_x = SHUFFLE256(p_a, SHUFFLE256(p_b, p_c, 2, 2, 1, 1), 0, 3, 0, 2);
+	r_y = SHUFFLE256(SHUFFLE256(p_a, p_b, 1, 1, 0, 0), SHUFFLE256(p_b, p_c, 3, 3, 2, 2), 0, 2, 0, 2);
+	r_z = SHUFFLE256(SHUFFLE256(p_a, p_b, 2, 2, 1, 1), SHUFFLE256(p_c, p_c, 0, 0, 3, 3), 0, 2, 0, 2);
+}
+
+BATCH_MATH_TARGET_AVX _FORCE_INLINE_ void interleave_avx(__m256 p_x, __m256 p_y, __m256 p_z, __m256 &r_a, __m256 &r_b, __m256 &r_c) {
+	r_a = SHUFFLE256(SHUFFLE256(p_x, p_y, 0, 0, 0, 0), SHUFFLE256(p_z, p_x, 0, 0, 1, 1), 0, 2, 0, 2);
+	r_b = SHUFFLE256(SHUFFLE256(p_y, p_z, 1, 1, 1, 1), SHUFFLE256(p_x, p_y, 2, 2, 2, 2), 0, 2, 0, 2);
+	r_c = SHUFFLE256(SHUFFLE256(p_z, p_x, 2, 2, 3, 3), SHUFFLE256(p_y, p_z, 3, 3, 3, 3), 0, 2, 0, 2);
+}
+
+BATCH_MATH_TARGET_AVX _FORCE_INLINE_ __m256 dot3_avx(__m256 p_m0, __m256 p_m1, __m256 p_m2, __m256 p_v0, __m256 p_v1, __m256 p_v2) {
+	return _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p_m0, p_v0), _mm256_mul_ps(p_m1, p_v1)), _mm256_mul_ps(p_m2, p_v2));
+}
+
+BATCH_MATH_TARGET_AVX _FORCE_INLINE_ void load_vectors_avx(const Vector3 *p_src, __m256 &r_x, __m256 &r_y, __m256 &r_z) {
+	const float *src = (const float *)p_src;
+	deinterleave_avx(load2_avx(src, src + 12), load2_avx(src + 4, src + 16), load2_avx(src + 8, src + 20), r_x, r_y, r_z);
+}
+
+BATCH_MATH_TARGET_AVX _FORCE_INLINE_ void store_vectors_avx(__m256 p_x, __m256 p_y, __m256 p_z, Vector3 *p_dst) {
+	float *dst = (float *)p_dst;
+	__m256 a, b, c;
+	interleave_avx(p_x, p_y, p_z, a, b, c);
+	store2_avx(dst, dst + 12, a);
+	store2_avx(dst + 4, dst + 16, b);
+	store2_avx(dst + 8, dst + 20, c);
+}
+
+BATCH_MATH_TARGET_AVX void xform_points_avx(const Transform3D &p_transform, const Vector3 *p_src, Vector3 *p_dst, uint32_t p_count) {
+	const Basis &b = p_transform.basis;
+	const __m256 m00 = _mm256_set1_ps(b.rows[0][0]), m01 = _mm256_set1_ps(b.rows[0][1]), m02 = _mm256_set1_ps(b.rows[0][2]);
+	const __m256 m10 = _mm256_set1_ps(b.rows[1][0]), m11 = _mm256_set1_ps(b.rows[1][1]), m12 = _mm256_set1_ps(b.rows[1][2]);
+	const __m256 m20 = _mm256_set1_ps(b.rows[2][0]), m21 = _mm256_set1_ps(b.rows[2][1]), m22 = _mm256_set1_ps(b.rows[2][2]);
+	const __m256 ox = _mm256_set1_ps(p_transform.origin.x), oy = _mm256_set1_ps(p_transform.origin.y), oz = _mm256_set1_ps(p_transform.origin.z);
+
+	uint32_t i = 0;
+	for (; i + 8 <= p_count; i += 8) {
+		__m256 x, y, z;
+		load_vectors_avx(p_src + i, x, y, z);
+		store_vectors_avx(_mm256_add_ps(dot3_avx(m00, m01, m02, x, y, z), ox), _mm256_add_ps(dot3_avx(m10, m11, m12, x, y, z), oy), _mm256_add_ps(dot3_avx(m20, m21, m22, x, y, z), oz), p_dst + i);
+	}
+	xform_points_sse2(p_transform, p_src + i, p_dst + i, p_count - i);
+}
+
+BATCH_MATH_TARGET_AVX _FORCE_INLINE_ __m256 normalize_component_avx(__m256 p_v, __m256 p_length, __m256 p_nonzero) {
+	return _mm256_and_ps(p_nonzero, _mm256_div_ps(p_v, p_length));
+}
+
+BATCH_MATH_TARGET_AVX void xform_normals_avx(const Basis &p_basis, const Vector3 *p_src, Vector3 *p_dst, uint32_t p_count) {
+	const __m256 m00 = _mm256_set1_ps(p_basis.rows[0][0]), m01 = _mm256_set1_ps(p_basis.rows[0][1]), m02 = _mm256_set1_ps(p_basis.rows[0][2]);
+	const __m256 m10 = _mm256_set1_ps(p_basis.rows[1][0]), m11 = _mm256_set1_ps(p_basis.rows[1][1]), m12 = _mm256_set1_ps(p_basis.rows[1][2]);
+	const __m256 m20 = _mm256_set1_ps(p_basis.rows[2][0]), m21 = _mm256_set1_ps(p_basis.rows[2][1]), m22 = _mm256_set1_ps(p_basis.rows[2][2]);
+	const __m256 zero = _mm256_setzero_ps();
+
+	uint32_t i = 0;
+	for (; i + 8 <= p_count; i += 8) {
+		__m256 x, y, z;
+		load_vectors_avx(p_src + i, x, y, z);
+
+		__m256 rx = dot3_avx(m00, m01, m02, x, y, z);
+		__m256 ry = dot3_avx(m10, m11, m12, x, y, z);
+		__m256 rz = dot3_avx(m20, m21, m22, x, y, z);
+		__m256 length_squared = dot3_avx(rx, ry, rz, rx, ry, rz);
+		__m256 length = _mm256_sqrt_ps(length_squared);
+		__m256 nonzero = _mm256_cmp_ps(length_squared, zero, _CMP_NEQ_UQ);
+
+		store_vectors_avx(normalize_component_avx(rx, length, nonzero), normalize_component_avx(ry, length, nonzero), normalize_component_avx(rz, length, nonzero), p_dst + i);
+	}
+	xform_normals_sse2(p_basis, p_src + i, p_dst + i, p_count - i);
+}
+
+const Kernels avx_kernels = {
+	xform_points_avx,
+	xform_normals_avx,
+	xform_aabbs_sse2,
+	merge_aabbs_sse2,
+	multiply_transforms_sse2,
+	transforms_to_buffer_sse2,
+	multiply_transforms_to_buffer_sse2,
+};
+
+bool cpu_has_avx() {
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	const bool os_saves_registers = (info[2] & (1 << 27)) != 0;
+	const bool avx = (info[2] & (1 << 28)) != 0;
+	return os_saves_registers && avx && (_xgetbv(0) & 6) == 6;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx");
+#endif
+}
+
+#endif // BATCH_MATH_AVX
+
+/* NEON */
+
+#ifdef BATCH_MATH_NEON
+
+_FORCE_INLINE_ float32x4_t dot3_neon(float32x4_t p_m0, float32x4_t p_m1, float32x4_t p_m2, float32x4_t p_v0, float32x4_t p_v1, float32x4_t p_v2) {
+	// No vfmaq_f32, to round like the scalar code.
+	return vaddq_f32(vaddq_f32(vmulq_f32(p_m0, p_v0), vmulq_f32(p_m1, p_v1)), vmulq_f32(p_m2, p_v2));
+}
+
+void xform_points_neon(const Transform3D &p_transform, const Vector3 *p_src, Vector3 *p_dst, uint32_t p_count) {
+	const Basis &b = p_transform.basis;
+	const float32x4_t m00 = vdupq_n_f32(b.rows[0][0]), m01 = vdupq_n_f32(b.rows[0][1]), m02 = vdupq_n_f32(b.rows[0][2]);
+	const float32x4_t m10 = vdupq_n_f32(b.rows[1][0]), m11 = vdupq_n_f32(b.rows[1][1]), m12 = vdupq_n_f32(b.rows[1][2]);
+	const float32x4_t m20 = vdupq_n_f32(b.rows[2][0]), m21 = vdupq_n_f32(b.rows[2][1]), m22 = vdupq_n_f32(b.rows[2][2]);
+	const float32x4_t ox = vdupq_n_f32(p_transform.origin.x), oy = vdupq_n_f32(p_transform.origin.y), oz = vdupq_n_f32(p_transform.origin.z);
+
+	uint32_t i = 0;
+	for (; i + 4 <= p_count; i += 4) {
+		float32x4x3_t v = vld3q_f32((const float *)(p_src + i));
+		float32x4x3_t r;
+		r.val[0] = vaddq_f32(dot3_neon(m00, m01, m02, v.val[0], v.val[1], v.val[2]), ox);
+		r.val[1] = vaddq_f32(dot3_neon(m10, m11, m12, v.val[0], v.val[1], v.val[2]), oy);
+		r.val[2] = vaddq_f32(dot3_neon(m20, m21, m22, v.val[0], v.val[1], v.val[2]), oz);
+		vst3q_f32((float *)(p_dst + i), r);
+	}
+	xform_points_scalar(p_transform, p_src + i, p_dst + i, p_count - i);
+}
+
+void xform_normals_neon(const Basis &p_basis, const Vector3 *p_src, Vector3 *p_dst, uint32_t p_count) {
+	const float32x4_t m00 = vdupq_n_f32(p_basis.rows[0][0]), m01 = vdupq_n_f32(p_basis.rows[0][1]), m02 = vdupq_n_f32(p_basis.rows[0][2]);
+	const float32x4_t m10 = vdupq_n_f32(p_basis.rows[1][0]), m11 = vdupq_n_f32(p_basis.rows[1][1]), m12 = vdupq_n_f32(p_basis.rows[1][2]);
+	const float32x4_t m20 = vdupq_n_f32(p_basis.rows[2][0]), m21 = vdupq_n_f32(p_basis.rows[2][1]), m22 = vdupq_n_f32(p_basis.rows[2][2]);
+	const float32x4_t zero = vdupq_n_f32(0);
+
+	uint32_t i = 0;
+	for (; i + 4 <= p_count; i += 4) {
+		float32x4x3_t v = vld3q_f32((const float *)(p_src + i));
+		float32x4_t rx = dot3_neon(m00, m01, m02, v.val[0], v.val[1], v.val[2]);
+		float32x4_t ry = dot3_neon(m10, m11, m12, v.val[0], v.val[1], v.val[2]);
+		float32x4_t rz = dot3_neon(m20, m21, m22, v.val[0], v.val[1], v.val[2]);
+		float32x4_t length_squared = dot3_neon(rx, ry, rz, rx, ry, rz);
+		float32x4_t length = vsqrtq_f32(length_squared);
+		uint32x4_t is_zero = vceqq_f32(length_squared, zero);
+
+		float32x4x3_t r;
+		r.val[0] = vbslq_f32(is_zero, zero, vdivq_f32(rx, length));
+		r.val[1] = vbslq_f32(is_zero, zero, vdivq_f32(ry, length));
+		r.val[2] = vbslq_f32(is_zero, zero, vdivq_f32(rz, length));
+		vst3q_f32((float *)(p_dst + i), r);
+	}
+	xform_normals_scalar(p_basis, p_src + i, p_dst + i, p_count - i);
+}
+
+const Kernels neon_kernels = {
+	xform_points_neon,
+	xform_normals_neon,
+	xform_aabbs_scalar,
+	merge_aabbs_scalar,
+	multiply_transforms_scalar,
+	transforms_to_buffer_scalar,
+	multiply_transforms_to_buffer_scalar,
+};
+
+#endif // BATCH_MATH_NEON
+
+const Kernels *get_implementation_kernels(BatchMath::Implementation p_implementation) {
+	switch (p_implementation) {
+#ifdef BATCH_MATH_SSE2
+		case BatchMath::IMPLEMENTATION_SSE2:
+			return &sse2_kernels;
+#endif
+#ifdef BATCH_MATH_AVX
+		case BatchMath::IMPLEMENTATION_AVX:
+			return cpu_has_avx() ? &avx_kernels : nullptr;
+#endif
+#ifdef BATCH_MATH_NEON
+		case BatchMath::IMPLEMENTATION_NEON:
+			return &neon_kernels;
+#endif
+		case BatchMath::IMPLEMENTATION_SCALAR:
+			return &scalar_kernels;
+		default:
+			return nullptr;
+	}
+}
+
+std::atomic<const Kernels *> current_kernels(nullptr);
+std::atomic<BatchMath::Implementation> current_implementation(BatchMath::IMPLEMENTATION_SCALAR);
+
+_FORCE_INLINE_ const Kernels &get_kernels() {
+	const Kernels *kernels = current_kernels.load(std::memory_order_relaxed);
+	if (unlikely(!kernels)) {
+		// Pick the best supported one, from the last.
+		for (int i = BatchMath::IMPLEMENTATION_MAX - 1; i >= 0; i--) {
+			kernels = get_implementation_kernels(BatchMath::Implementation(i));
+			if (kernels) {
+				current_implementation.store(BatchMath::Implementation(i), std::memory_order_relaxed);
+				break;
+			}
+		}
+		current_kernels.store(kernels, std::memory_order_relaxed);
+	}
+	return *kernels;
+}
+
+} // namespace
+
+void BatchMath::xform_points(const Transform3D &p_transform, const Vector3 *p_src, Vector3 *p_dst, uint32_t p_count) {
+	get_kernels().xform_points(p_transform, p_src, p_dst, p_count);
+}
+
+void BatchMath::xform_normals(const Basis &p_basis, const Vector3 *p_src, Vector3 *p_dst, uint32_t p_count) {
+	get_kernels().xform_normals(p_basis, p_src, p_dst, p_count);
+}
+
+void BatchMath::xform_aabbs(const Transform3D &p_transform, const AABB *p_src, AABB *p_dst, uint32_t p_count) {
+	get_kernels().xform_aabbs(p_transform, p_src, p_dst, p_count);
+}
+
+AABB BatchMath::merge_aabbs(const AABB *p_src, uint32_t p_count) {
+	return get_kernels().merge_aabbs(p_src, p_count);
+}
+
+void BatchMath::multiply_transforms(const Transform3D &p_transform, const Transform3D *p_src, Transform3D *p_dst, uint32_t p_count) {
+	get_kernels().multiply_transforms(p_transform, p_src, p_dst, p_count);
+}
+
+void BatchMath::transforms_to_buffer(const Transform3D *p_src, uint32_t p_src_stride, float *p_dst, uint32_t p_dst_stride, uint32_t p_count) {
+	get_kernels().transforms_to_buffer(p_src, p_src_stride, p_dst, p_dst_stride, p_count);
+}
+
+void BatchMath::multiply_transforms_to_buffer(const Transform3D &p_transform, const Transform3D *p_src, uint32_t p_src_stride, float *p_dst, uint32_t p_dst_stride, uint32_t p_count) {
+	get_kernels().multiply_transforms_to_buffer(p_transform, p_src, p_src_stride, p_dst, p_dst_stride, p_count);
+}
+
+BatchMath::Implementation BatchMath::get_implementation() {
+	get_kernels();
+	return current_implementation.load(std::memory_order_relaxed);
+}
+
+bool BatchMath::is_implementation_supported(Implementation p_implementation) {
+	return get_implementation_kernels(p_implementation) != nullptr;
+}
+
+void BatchMath::set_implementation(Implementation p_implementation) {
+	const Kernels *kernels = get_implementation_kernels(p_implementation);
+	ERR_FAIL_COND_MSG(!kernels, "Batch math implementation '" + String(get_implementation_name(p_implementation)) + "' is not supported on this CPU.");
+	current_implementation.store(p_implementation, std::memory_order_relaxed);
+	current_kernels.store(kernels, std::memory_order_relaxed);
+}
+
+const char *BatchMath::get_implementation_name(Implementation p_implementation) {
+	static const char *names[IMPLEMENTATION_MAX] = { "Scalar", "SSE2", "AVX", "NEON" };
+	ERR_FAIL_INDEX_V(p_implementation, IMPLEMENTATION_MAX, "");
+	return names[p_implementation];
+}
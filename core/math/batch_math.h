@@ -0,0 +1,83 @@
+/*************************************************************************/
+/*  batch_math.h                                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef BATCH_MATH_H
+#define BATCH_MATH_H
+
+#include "core/math/aabb.h"
+#include "core/math/transform_3d.h"
+
+// Math on arrays, for code looping over many points or transforms at once.
+//
+// Uses SSE2, AVX or NEON when available, picked at runtime from what the CPU supports.
+// Results are the same as the scalar Transform3D and Basis operations, as every
+// implementation evaluates them in the same order and without fused multiply-add.
+// Builds with double precision always use the scalar implementation.
+//
+// Unless noted otherwise, the source and destination arrays may be the same.
+class BatchMath {
+public:
+	enum Implementation {
+		IMPLEMENTATION_SCALAR,
+		IMPLEMENTATION_SSE2,
+		IMPLEMENTATION_AVX,
+		IMPLEMENTATION_NEON,
+		IMPLEMENTATION_MAX
+	};
+
+	// p_dst[i] = p_transform.xform(p_src[i]).
+	static void xform_points(const Transform3D &p_transform, const Vector3 *p_src, Vector3 *p_dst, uint32_t p_count);
+	// p_dst[i] = p_basis.xform(p_src[i]).normalized().
+	static void xform_normals(const Basis &p_basis, const Vector3 *p_src, Vector3 *p_dst, uint32_t p_count);
+
+	// p_dst[i] = p_transform.xform(p_src[i]).
+	static void xform_aabbs(const Transform3D &p_transform, const AABB *p_src, AABB *p_dst, uint32_t p_count);
+	// The AABB enclosing all of them, or an empty one if p_count is zero.
+	static AABB merge_aabbs(const AABB *p_src, uint32_t p_count);
+
+	// p_dst[i] = p_transform * p_src[i].
+	static void multiply_transforms(const Transform3D &p_transform, const Transform3D *p_src, Transform3D *p_dst, uint32_t p_count);
+
+	// Write transforms to a buffer using the layout of RenderingServer multimesh and
+	// particle buffers (the rows of the 3x4 matrix), p_dst_stride floats apart.
+	// The source is read p_src_stride bytes apart, so it can point into an array of structs.
+	// The source and destination must not overlap.
+	static void transforms_to_buffer(const Transform3D *p_src, uint32_t p_src_stride, float *p_dst, uint32_t p_dst_stride, uint32_t p_count);
+	// Same as above, but writes p_transform * p_src[i].
+	static void multiply_transforms_to_buffer(const Transform3D &p_transform, const Transform3D *p_src, uint32_t p_src_stride, float *p_dst, uint32_t p_dst_stride, uint32_t p_count);
+
+	static Implementation get_implementation();
+	static bool is_implementation_supported(Implementation p_implementation);
+	// Meant for tests and benchmarks, the best supported one is used by default.
+	static void set_implementation(Implementation p_implementation);
+	static const char *get_implementation_name(Implementation p_implementation);
+};
+
+#endif // BATCH_MATH_H
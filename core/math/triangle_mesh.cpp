@@ -30,6 +30,8 @@
 
 #include "triangle_mesh.h"
 
+#include "core/templates/local_vector.h"
+#include "core/templates/pair.h"
 #include "core/templates/sort_array.h"
 
 int TriangleMesh::_create_bvh(BVH *p_bvh, BVH **p_bb, int p_from, int p_size, int p_depth, int &r_max_depth, int &r_max_alloc) {
@@ -699,6 +701,98 @@ Vector<Face3> TriangleMesh::get_faces() const {
 	return faces;
 }
 
+Vector<uint8_t> TriangleMesh::save_to_buffer() const {
+	ERR_FAIL_COND_V(!valid, Vector<uint8_t>());
+
+	uint32_t header[6] = { sizeof(Triangle), sizeof(BVH), uint32_t(triangles.size()), uint32_t(vertices.size()), uint32_t(bvh.size()), uint32_t(max_depth) };
+	uint64_t triangles_size = triangles.size() * sizeof(Triangle);
+	uint64_t vertices_size = vertices.size() * sizeof(Vector3);
+	uint64_t bvh_size = bvh.size() * sizeof(BVH);
+
+	Vector<uint8_t> buffer;
+	buffer.resize(sizeof(header) + triangles_size + vertices_size + bvh_size);
+	uint8_t *w = buffer.ptrw();
+	memcpy(w, header, sizeof(header));
+	w += sizeof(header);
+	memcpy(w, triangles.ptr(), triangles_size);
+	w += triangles_size;
+	memcpy(w, vertices.ptr(), vertices_size);
+	w += vertices_size;
+	memcpy(w, bvh.ptr(), bvh_size);
+
+	return buffer;
+}
+
+Error TriangleMesh::load_from_buffer(const Vector<uint8_t> &p_buffer) {
+	valid = false;
+
+	uint32_t header[6];
+	ERR_FAIL_COND_V(uint64_t(p_buffer.size()) < sizeof(header), ERR_INVALID_DATA);
+	const uint8_t *r = p_buffer.ptr();
+	memcpy(header, r, sizeof(header));
+	r += sizeof(header);
+	ERR_FAIL_COND_V(header[0] != sizeof(Triangle) || header[1] != sizeof(BVH), ERR_INVALID_DATA);
+
+	uint64_t triangles_size = uint64_t(header[2]) * sizeof(Triangle);
+	uint64_t vertices_size = uint64_t(header[3]) * sizeof(Vector3);
+	uint64_t bvh_size = uint64_t(header[4]) * sizeof(BVH);
+	ERR_FAIL_COND_V(uint64_t(p_buffer.size()) != sizeof(header) + triangles_size + vertices_size + bvh_size, ERR_INVALID_DATA);
+	// Queries keep node indices below the visit flags of their stacks, which are sized by the depth on the stack.
+	ERR_FAIL_COND_V(header[4] == 0 || header[4] > (1 << 29), ERR_INVALID_DATA);
+	ERR_FAIL_COND_V(header[5] == 0 || header[5] > MAX_BVH_DEPTH || header[5] > header[4], ERR_INVALID_DATA);
+
+	triangles.resize(header[2]);
+	memcpy(triangles.ptrw(), r, triangles_size);
+	r += triangles_size;
+	vertices.resize(header[3]);
+	memcpy(vertices.ptrw(), r, vertices_size);
+	r += vertices_size;
+	bvh.resize(header[4]);
+	memcpy(bvh.ptrw(), r, bvh_size);
+	max_depth = header[5];
+
+	// Damaged data must not make queries read out of bounds.
+	const Triangle *tr = triangles.ptr();
+	for (int i = 0; i < triangles.size(); i++) {
+		for (int j = 0; j < 3; j++) {
+			ERR_FAIL_UNSIGNED_INDEX_V((uint32_t)tr[i].indices[j], (uint32_t)vertices.size(), ERR_INVALID_DATA);
+		}
+	}
+	// Leaves have a face and no children, other nodes have two children and no face.
+	const BVH *br = bvh.ptr();
+	const int bvh_count = bvh.size();
+	for (int i = 0; i < bvh_count; i++) {
+		if (br[i].face_index == -1) {
+			ERR_FAIL_COND_V(br[i].left < 0 || br[i].left >= bvh_count || br[i].right < 0 || br[i].right >= bvh_count, ERR_INVALID_DATA);
+		} else {
+			ERR_FAIL_COND_V(br[i].face_index < 0 || br[i].face_index >= triangles.size() || br[i].left != -1 || br[i].right != -1, ERR_INVALID_DATA);
+		}
+	}
+
+	// Queries start at the last node. Every node must be reached at most once, so there are no cycles,
+	// and no deeper than the stored depth.
+	LocalVector<bool> reached;
+	reached.resize(bvh_count);
+	for (int i = 0; i < bvh_count; i++) {
+		reached[i] = false;
+	}
+	LocalVector<Pair<int, int>> pending;
+	pending.push_back(Pair<int, int>(bvh_count - 1, 1));
+	while (!pending.is_empty()) {
+		Pair<int, int> node = pending[pending.size() - 1];
+		pending.resize(pending.size() - 1);
+		ERR_FAIL_COND_V(reached[node.first] || node.second > max_depth, ERR_INVALID_DATA);
+		reached[node.first] = true;
+		if (br[node.first].face_index == -1) {
+			pending.push_back(Pair<int, int>(br[node.first].left, node.second + 1));
+			pending.push_back(Pair<int, int>(br[node.first].right, node.second + 1));
+		}
+	}
+
+	valid = true;
+	return OK;
+}
+
 TriangleMesh::TriangleMesh() {
 	valid = false;
 	max_depth = 0;
@@ -76,6 +76,10 @@ private:
 
 	int _create_bvh(BVH *p_bvh, BVH **p_bb, int p_from, int p_size, int p_depth, int &max_depth, int &max_alloc);
 
+	enum {
+		MAX_BVH_DEPTH = 64, // Trees are split at the median, so this is far deeper than any mesh needs.
+	};
+
 	Vector<BVH> bvh;
 	int max_depth;
 	bool valid;
@@ -94,6 +98,10 @@ public:
 	void get_indices(Vector<int> *r_triangles_indices) const;
 
 	void create(const Vector<Vector3> &p_faces, const Vector<int32_t> &p_surface_indices = Vector<int32_t>());
+
+	// Raw copies of the built mesh, only meant to be read back by the same engine build (see DerivedDataCache).
+	Vector<uint8_t> save_to_buffer() const;
+	Error load_from_buffer(const Vector<uint8_t> &p_buffer);
 	TriangleMesh();
 };
 
@@ -62,6 +62,7 @@ ClassDB::APIType ClassDB::get_current_api() {
 }
 
 HashMap<StringName, ClassDB::ClassInfo> ClassDB::classes;
+SafeNumeric<uint32_t> ClassDB::methods_version(1);
 HashMap<StringName, StringName> ClassDB::resource_base_extensions;
 HashMap<StringName, StringName> ClassDB::compat_classes;
 
@@ -543,6 +544,74 @@ MethodBind *ClassDB::get_method(const StringName &p_class, const StringName &p_n
 	return nullptr;
 }
 
+// Recent get_method_cached() results of this thread, by class and method name.
+// Entries are only added for existing methods, which keep both names alive until methods_version changes.
+struct MethodCacheEntry {
+	const void *class_name = nullptr;
+	const void *method_name = nullptr;
+	uint32_t version = 0;
+	MethodBind *method = nullptr;
+};
+
+static const uint32_t METHOD_CACHE_SIZE = 256;
+static thread_local MethodCacheEntry method_cache[METHOD_CACHE_SIZE];
+
+MethodBind *ClassDB::get_method_cached(const StringName &p_class, const StringName &p_name) {
+	const uint32_t version = methods_version.get();
+	const void *class_name = p_class.data_unique_pointer();
+	const void *method_name = p_name.data_unique_pointer();
+	MethodCacheEntry &entry = method_cache[hash_one_uint64(uint64_t(uintptr_t(class_name)) * 31 + uint64_t(uintptr_t(method_name))) & (METHOD_CACHE_SIZE - 1)];
+	if (entry.class_name == class_name && entry.method_name == method_name && entry.version == version) {
+		return entry.method;
+	}
+
+	MethodBind *method = nullptr;
+	bool found = false;
+	{
+		OBJTYPE_RLOCK;
+		ClassInfo *type = classes.getptr(p_class);
+		if (!type) {
+			return nullptr;
+		}
+		if (type->method_table_version == version) {
+			MethodBind **table_method = type->method_table.getptr(p_name);
+			method = table_method ? *table_method : nullptr;
+			found = true;
+		}
+	}
+
+	if (!found) {
+		// Build the table. Happens once per class, unless methods are bound later on.
+		OBJTYPE_WLOCK;
+		ClassInfo *type = classes.getptr(p_class);
+		if (!type) {
+			return nullptr;
+		}
+		const uint32_t current_version = methods_version.get();
+		if (type->method_table_version != current_version) {
+			type->method_table.clear();
+			for (ClassInfo *t = type; t; t = t->inherits_ptr) {
+				for (const KeyValue<StringName, MethodBind *> &E : t->method_map) {
+					if (E.value && !type->method_table.has(E.key)) {
+						type->method_table.insert(E.key, E.value);
+					}
+				}
+			}
+			type->method_table_version = current_version;
+		}
+		MethodBind **table_method = type->method_table.getptr(p_name);
+		method = table_method ? *table_method : nullptr;
+	}
+
+	if (method) {
+		entry.class_name = class_name;
+		entry.method_name = method_name;
+		entry.version = version;
+		entry.method = method;
+	}
+	return method;
+}
+
 void ClassDB::bind_integer_constant(const StringName &p_class, const StringName &p_enum, const StringName &p_name, int64_t p_constant, bool p_is_bitfield) {
 	OBJTYPE_WLOCK;
 
@@ -1197,6 +1266,25 @@ StringName ClassDB::get_property_setter(const StringName &p_class, const StringN
 	return StringName();
 }
 
+MethodBind *ClassDB::get_property_setter_bind(const StringName &p_class, const StringName &p_property, int *r_index) {
+	OBJTYPE_RLOCK;
+
+	ClassInfo *check = classes.getptr(p_class);
+	while (check) {
+		const PropertySetGet *psg = check->property_setget.getptr(p_property);
+		if (psg) {
+			if (r_index) {
+				*r_index = psg->index;
+			}
+			return psg->_setptr;
+		}
+
+		check = check->inherits_ptr;
+	}
+
+	return nullptr;
+}
+
 StringName ClassDB::get_property_getter(const StringName &p_class, const StringName &p_property) {
 	ClassInfo *type = classes.getptr(p_class);
 	ClassInfo *check = type;
@@ -1212,6 +1300,30 @@ StringName ClassDB::get_property_getter(const StringName &p_class, const StringN
 	return StringName();
 }
 
+MethodBind *ClassDB::get_property_getter_bind(const StringName &p_class, const StringName &p_property, int *r_index) {
+	OBJTYPE_RLOCK;
+
+	ClassInfo *check = classes.getptr(p_class);
+	while (check) {
+		const PropertySetGet *psg = check->property_setget.getptr(p_property);
+		if (psg) {
+			if (r_index) {
+				*r_index = psg->index;
+			}
+			return psg->_getptr;
+		}
+
+		// Same lookup order as get_property().
+		if (check->constant_map.has(p_property) || check->method_map.has(p_property) || check->signal_map.has(p_property)) {
+			return nullptr;
+		}
+
+		check = check->inherits_ptr;
+	}
+
+	return nullptr;
+}
+
 bool ClassDB::has_property(const StringName &p_class, const StringName &p_property, bool p_no_inheritance) {
 	ClassInfo *type = classes.getptr(p_class);
 	ClassInfo *check = type;
@@ -1270,6 +1382,7 @@ void ClassDB::bind_method_custom(const StringName &p_class, MethodBind *p_method
 #endif
 
 	type->method_map[p_method->get_name()] = p_method;
+	methods_version.increment();
 }
 
 #ifdef DEBUG_METHODS_ENABLED
@@ -1316,6 +1429,7 @@ MethodBind *ClassDB::bind_methodfi(uint32_t p_flags, MethodBind *p_bind, const c
 #endif
 
 	type->method_map[mdname] = p_bind;
+	methods_version.increment();
 
 	Vector<Variant> defvals;
 
@@ -1547,6 +1661,7 @@ void ClassDB::unregister_extension_class(const StringName &p_class) {
 		memdelete(F.value);
 	}
 	classes.erase(p_class);
+	methods_version.increment();
 }
 
 HashMap<StringName, ClassDB::NativeStruct> ClassDB::native_structs;
@@ -1591,6 +1706,7 @@ void ClassDB::cleanup() {
 		}
 	}
 	classes.clear();
+	methods_version.increment();
 	resource_base_extensions.clear();
 	compat_classes.clear();
 	native_structs.clear();
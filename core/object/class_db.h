@@ -38,6 +38,7 @@
 // Makes callable_mp readily available in all classes connecting signals.
 // Needs to come after method_bind and object have been included.
 #include "core/object/callable_method_pointer.h"
+#include "core/templates/flat_hash_map.h"
 #include "core/templates/hash_set.h"
 
 #define DEFVAL(m_defval) (m_defval)
@@ -103,6 +104,9 @@ public:
 		ObjectNativeExtension *native_extension = nullptr;
 
 		HashMap<StringName, MethodBind *> method_map;
+		// Methods of this class and all its parents, built on demand by get_method_cached().
+		FlatHashMap<StringName, MethodBind *> method_table;
+		uint32_t method_table_version = 0;
 		HashMap<StringName, int64_t> constant_map;
 		struct EnumInfo {
 			List<StringName> constants;
@@ -142,6 +146,8 @@ public:
 
 	static RWLock lock;
 	static HashMap<StringName, ClassInfo> classes;
+	// Changes whenever methods are bound or classes removed, making method tables and cached lookups stale.
+	static SafeNumeric<uint32_t> methods_version;
 	static HashMap<StringName, StringName> resource_base_extensions;
 	static HashMap<StringName, StringName> compat_classes;
 
@@ -320,7 +326,12 @@ public:
 	static int get_property_index(const StringName &p_class, const StringName &p_property, bool *r_is_valid = nullptr);
 	static Variant::Type get_property_type(const StringName &p_class, const StringName &p_property, bool *r_is_valid = nullptr);
 	static StringName get_property_setter(const StringName &p_class, const StringName &p_property);
+	// The setter of a property, for callers that set it many times and cache it along with get_methods_version().
+	// Returns nullptr if it has no setter bound as a method.
+	static MethodBind *get_property_setter_bind(const StringName &p_class, const StringName &p_property, int *r_index = nullptr);
 	static StringName get_property_getter(const StringName &p_class, const StringName &p_property);
+	// Same as get_property_setter_bind(), for the getter. Returns nullptr if get_property() would not call it.
+	static MethodBind *get_property_getter_bind(const StringName &p_class, const StringName &p_property, int *r_index = nullptr);
 
 	static bool has_method(const StringName &p_class, const StringName &p_method, bool p_no_inheritance = false);
 	static void set_method_flags(const StringName &p_class, const StringName &p_method, int p_flags);
@@ -328,6 +339,9 @@ public:
 	static void get_method_list(const StringName &p_class, List<MethodInfo> *p_methods, bool p_no_inheritance = false, bool p_exclude_from_properties = false);
 	static bool get_method_info(const StringName &p_class, const StringName &p_method, MethodInfo *r_info, bool p_no_inheritance = false, bool p_exclude_from_properties = false);
 	static MethodBind *get_method(const StringName &p_class, const StringName &p_name);
+	// Same as get_method(), for dynamic calls. Looks up a per-thread cache first, then a flattened method table of the class.
+	static MethodBind *get_method_cached(const StringName &p_class, const StringName &p_name);
+	static uint32_t get_methods_version() { return methods_version.get(); }
 
 	static void add_virtual_method(const StringName &p_class, const MethodInfo &p_method, bool p_virtual = true, const Vector<String> &p_arg_names = Vector<String>(), bool p_object_core = false);
 	static void get_virtual_methods(const StringName &p_class, List<MethodInfo> *p_methods, bool p_no_inheritance = false);
@@ -37,65 +37,155 @@
 
 MessageQueue *MessageQueue::singleton = nullptr;
 
+thread_local MessageQueue::ThreadBufferOwner MessageQueue::thread_buffer_owner;
+SafeNumeric<uint64_t> MessageQueue::last_id;
+BinaryMutex MessageQueue::singleton_mutex;
+
+MessageQueue::ThreadBufferOwner::~ThreadBufferOwner() {
+	if (!buffer) {
+		return;
+	}
+	MutexLock lock(singleton_mutex);
+	if (singleton && singleton->id == queue_id) {
+		singleton->thread_buffers_mutex.lock();
+		singleton->unowned_thread_buffers.push_back(buffer);
+		singleton->thread_buffers_mutex.unlock();
+	}
+	buffer = nullptr;
+}
+
 MessageQueue *MessageQueue::get_singleton() {
 	return singleton;
 }
 
-Error MessageQueue::push_callp(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
-	return push_callablep(Callable(p_id, p_method), p_args, p_argcount, p_show_error);
+MessageQueue::ThreadBuffer *MessageQueue::_get_thread_buffer() {
+	ThreadBufferOwner &owner = thread_buffer_owner;
+	if (likely(owner.queue_id == id)) {
+		return owner.buffer;
+	}
+
+	// First message posted by this thread to this queue. Reuse the buffer of a thread that exited, if any,
+	// so short-lived threads don't add to the buffers checked on every flush.
+	ThreadBuffer *buffer = nullptr;
+	thread_buffers_mutex.lock();
+	if (unowned_thread_buffers.size()) {
+		buffer = unowned_thread_buffers[unowned_thread_buffers.size() - 1];
+		unowned_thread_buffers.resize(unowned_thread_buffers.size() - 1);
+	} else {
+		buffer = memnew(ThreadBuffer);
+		thread_buffers.push_back(buffer);
+	}
+	thread_buffers_mutex.unlock();
+
+	owner.buffer = buffer;
+	owner.queue_id = id;
+	return buffer;
 }
 
-Error MessageQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant &p_value) {
-	_THREAD_SAFE_METHOD_
+MessageQueue::Page *MessageQueue::_alloc_page(uint32_t p_min_size) {
+	if (p_min_size <= PAGE_SIZE_BYTES) {
+		Page *page = nullptr;
+		free_pages_lock.lock();
+		if (free_pages.size()) {
+			page = free_pages[free_pages.size() - 1];
+			free_pages.resize(free_pages.size() - 1);
+			free_pages_bytes -= page->size;
+		}
+		free_pages_lock.unlock();
+		if (page) {
+			return page;
+		}
+	}
 
-	uint8_t room_needed = sizeof(Message) + sizeof(Variant);
+	// Messages with many arguments may not fit in a regular page, those get one of their own.
+	uint32_t size = MAX(p_min_size, (uint32_t)PAGE_SIZE_BYTES);
+	Page *page = memnew_placement(memalloc(sizeof(Page) + size), Page);
+	page->size = size;
+	return page;
+}
 
-	if ((buffer_end + room_needed) >= buffer_size) {
-		String type;
-		if (ObjectDB::get_instance(p_id)) {
-			type = ObjectDB::get_instance(p_id)->get_class();
+void MessageQueue::_free_page(Page *p_page) {
+	p_page->used = 0;
+	if (p_page->size == PAGE_SIZE_BYTES) {
+		free_pages_lock.lock();
+		if (free_pages_bytes + p_page->size <= free_pages_max_bytes) {
+			free_pages.push_back(p_page);
+			free_pages_bytes += p_page->size;
+			p_page = nullptr;
 		}
-		print_line("Failed set: " + type + ":" + p_prop + " target ID: " + itos(p_id));
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
+		free_pages_lock.unlock();
+	}
+	if (p_page) {
+		memfree(p_page);
+	}
+}
+
+MessageQueue::Message *MessageQueue::_alloc_message(ThreadBuffer *p_buffer, uint32_t p_size) {
+	// Called with the buffer locked.
+	Page *page = p_buffer->pages.size() ? p_buffer->pages[p_buffer->pages.size() - 1] : nullptr;
+	if (!page || page->used + p_size > page->size) {
+		page = _alloc_page(p_size);
+		p_buffer->pages.push_back(page);
 	}
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = memnew_placement(page->get_data() + page->used, Message);
+	msg->order = message_order.postincrement();
+	page->used += p_size;
+	return msg;
+}
+
+uint32_t MessageQueue::_get_message_size(const Message *p_message) {
+	uint32_t size = sizeof(Message);
+	if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+		size += sizeof(Variant) * p_message->args;
+	}
+	return size;
+}
+
+void MessageQueue::_destroy_message(Message *p_message) {
+	if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+		Variant *args = (Variant *)(p_message + 1);
+		for (int i = 0; i < p_message->args; i++) {
+			args[i].~Variant();
+		}
+	}
+	p_message->~Message();
+}
+
+Error MessageQueue::push_callp(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
+	return push_callablep(Callable(p_id, p_method), p_args, p_argcount, p_show_error);
+}
+
+Error MessageQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant &p_value) {
+	ThreadBuffer *buffer = _get_thread_buffer();
+	buffer->lock.lock();
+
+	Message *msg = _alloc_message(buffer, sizeof(Message) + sizeof(Variant));
 	msg->args = 1;
 	msg->callable = Callable(p_id, p_prop);
 	msg->type = TYPE_SET;
 
-	buffer_end += sizeof(Message);
-
-	Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-	buffer_end += sizeof(Variant);
+	Variant *v = memnew_placement(msg + 1, Variant);
 	*v = p_value;
 
+	buffer->lock.unlock();
 	return OK;
 }
 
 Error MessageQueue::push_notification(ObjectID p_id, int p_notification) {
-	_THREAD_SAFE_METHOD_
-
 	ERR_FAIL_COND_V(p_notification < 0, ERR_INVALID_PARAMETER);
 
-	uint8_t room_needed = sizeof(Message);
-
-	if ((buffer_end + room_needed) >= buffer_size) {
-		print_line("Failed notification: " + itos(p_notification) + " target ID: " + itos(p_id));
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
-	}
+	ThreadBuffer *buffer = _get_thread_buffer();
+	buffer->lock.lock();
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = _alloc_message(buffer, sizeof(Message));
 
 	msg->type = TYPE_NOTIFICATION;
 	msg->callable = Callable(p_id, CoreStringNames::get_singleton()->notification); //name is meaningless but callable needs it
 	//msg->target;
 	msg->notification = p_notification;
 
-	buffer_end += sizeof(Message);
-
+	buffer->lock.unlock();
 	return OK;
 }
 
@@ -112,17 +202,10 @@ Error MessageQueue::push_set(Object *p_object, const StringName &p_prop, const V
 }
 
 Error MessageQueue::push_callablep(const Callable &p_callable, const Variant **p_args, int p_argcount, bool p_show_error) {
-	_THREAD_SAFE_METHOD_
-
-	int room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
+	ThreadBuffer *buffer = _get_thread_buffer();
+	buffer->lock.lock();
 
-	if ((buffer_end + room_needed) >= buffer_size) {
-		print_line("Failed method: " + p_callable);
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
-	}
-
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = _alloc_message(buffer, sizeof(Message) + sizeof(Variant) * p_argcount);
 	msg->args = p_argcount;
 	msg->callable = p_callable;
 	msg->type = TYPE_CALL;
@@ -130,14 +213,13 @@ Error MessageQueue::push_callablep(const Callable &p_callable, const Variant **p
 		msg->type |= FLAG_SHOW_ERROR;
 	}
 
-	buffer_end += sizeof(Message);
-
+	Variant *args = (Variant *)(msg + 1);
 	for (int i = 0; i < p_argcount; i++) {
-		Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-		buffer_end += sizeof(Variant);
+		Variant *v = memnew_placement(&args[i], Variant);
 		*v = *p_args[i];
 	}
 
+	buffer->lock.unlock();
 	return OK;
 }
 
@@ -146,56 +228,65 @@ void MessageQueue::statistics() {
 	HashMap<int, int> notify_count;
 	HashMap<Callable, int> call_count;
 	int null_count = 0;
-
-	uint32_t read_pos = 0;
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
-
-		Object *target = message->callable.get_object();
-
-		if (target != nullptr) {
-			switch (message->type & FLAG_MASK) {
-				case TYPE_CALL: {
-					if (!call_count.has(message->callable)) {
-						call_count[message->callable] = 0;
-					}
-
-					call_count[message->callable]++;
-
-				} break;
-				case TYPE_NOTIFICATION: {
-					if (!notify_count.has(message->notification)) {
-						notify_count[message->notification] = 0;
+	uint32_t total_bytes = 0;
+
+	thread_buffers_mutex.lock();
+	for (uint32_t i = 0; i < thread_buffers.size(); i++) {
+		ThreadBuffer *buffer = thread_buffers[i];
+		buffer->lock.lock();
+		for (uint32_t j = 0; j < buffer->pages.size(); j++) {
+			Page *page = buffer->pages[j];
+			uint32_t read_pos = 0;
+			while (read_pos < page->used) {
+				Message *message = (Message *)(page->get_data() + read_pos);
+
+				Object *target = message->callable.get_object();
+
+				if (target != nullptr) {
+					switch (message->type & FLAG_MASK) {
+						case TYPE_CALL: {
+							if (!call_count.has(message->callable)) {
+								call_count[message->callable] = 0;
+							}
+
+							call_count[message->callable]++;
+
+						} break;
+						case TYPE_NOTIFICATION: {
+							if (!notify_count.has(message->notification)) {
+								notify_count[message->notification] = 0;
+							}
+
+							notify_count[message->notification]++;
+
+						} break;
+						case TYPE_SET: {
+							StringName t = message->callable.get_method();
+							if (!set_count.has(t)) {
+								set_count[t] = 0;
+							}
+
+							set_count[t]++;
+
+						} break;
 					}
 
-					notify_count[message->notification]++;
-
-				} break;
-				case TYPE_SET: {
-					StringName t = message->callable.get_method();
-					if (!set_count.has(t)) {
-						set_count[t] = 0;
-					}
+				} else {
+					//object was deleted
+					print_line("Object was deleted while awaiting a callback");
 
-					set_count[t]++;
+					null_count++;
+				}
 
-				} break;
+				read_pos += _get_message_size(message);
 			}
-
-		} else {
-			//object was deleted
-			print_line("Object was deleted while awaiting a callback");
-
-			null_count++;
-		}
-
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			read_pos += sizeof(Variant) * message->args;
+			total_bytes += page->used;
 		}
+		buffer->lock.unlock();
 	}
+	thread_buffers_mutex.unlock();
 
-	print_line("TOTAL BYTES: " + itos(buffer_end));
+	print_line("TOTAL BYTES: " + itos(total_bytes));
 	print_line("NULL count: " + itos(null_count));
 
 	for (const KeyValue<StringName, int> &E : set_count) {
@@ -215,6 +306,11 @@ int MessageQueue::get_max_buffer_usage() const {
 	return buffer_max_used;
 }
 
+int MessageQueue::get_thread_buffer_count() {
+	MutexLock lock(thread_buffers_mutex);
+	return thread_buffers.size();
+}
+
 void MessageQueue::_call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error) {
 	const Variant **argptrs = nullptr;
 	if (p_argcount) {
@@ -233,77 +329,120 @@ void MessageQueue::_call_function(const Callable &p_callable, const Variant *p_a
 }
 
 void MessageQueue::flush() {
-	if (buffer_end > buffer_max_used) {
-		buffer_max_used = buffer_end;
-	}
-
-	uint32_t read_pos = 0;
-
-	//using reverse locking strategy
-	_THREAD_SAFE_LOCK_
-
+	thread_buffers_mutex.lock();
 	if (flushing) {
-		_THREAD_SAFE_UNLOCK_
+		thread_buffers_mutex.unlock();
 		ERR_FAIL_COND(flushing); //already flushing, you did something odd
 	}
 	flushing = true;
+	thread_buffers_mutex.unlock();
+
+	struct Source {
+		LocalVector<Page *> pages;
+		uint32_t page = 0;
+		uint32_t read_pos = 0;
+	};
+	LocalVector<Source> sources;
+
+	// Messages posted while flushing (like calls re-adding themselves) are taken in the next round.
+	while (true) {
+		uint32_t used = 0;
+		sources.clear();
+
+		thread_buffers_mutex.lock();
+		for (uint32_t i = 0; i < thread_buffers.size(); i++) {
+			ThreadBuffer *buffer = thread_buffers[i];
+			buffer->lock.lock();
+			if (buffer->pages.size()) {
+				sources.push_back(Source());
+				SWAP(sources[sources.size() - 1].pages, buffer->pages);
+			}
+			buffer->lock.unlock();
+		}
+		thread_buffers_mutex.unlock();
 
-	while (read_pos < buffer_end) {
-		//lock on each iteration, so a call can re-add itself to the message queue
-
-		Message *message = (Message *)&buffer[read_pos];
+		if (sources.is_empty()) {
+			break;
+		}
 
-		uint32_t advance = sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			advance += sizeof(Variant) * message->args;
+		for (uint32_t i = 0; i < sources.size(); i++) {
+			const Source &source = sources[i];
+			for (uint32_t j = 0; j < source.pages.size(); j++) {
+				const Page *page = source.pages[j];
+				used += page->used;
+			}
+		}
+		if (used > buffer_max_used) {
+			buffer_max_used = used;
 		}
 
-		//pre-advance so this function is reentrant
-		read_pos += advance;
+		while (true) {
+			// Each source is already in order, so merge by picking the oldest message among them.
+			Source *next = nullptr;
+			Message *message = nullptr;
+			for (uint32_t i = 0; i < sources.size(); i++) {
+				Source &source = sources[i];
+				if (source.page == source.pages.size()) {
+					continue;
+				}
+				Message *candidate = (Message *)(source.pages[source.page]->get_data() + source.read_pos);
+				if (!message || candidate->order < message->order) {
+					message = candidate;
+					next = &source;
+				}
+			}
 
-		_THREAD_SAFE_UNLOCK_
+			if (!message) {
+				break;
+			}
+
+			next->read_pos += _get_message_size(message);
+			if (next->read_pos >= next->pages[next->page]->used) {
+				next->page++;
+				next->read_pos = 0;
+			}
 
-		Object *target = message->callable.get_object();
+			Object *target = message->callable.get_object();
 
-		if (target != nullptr) {
-			switch (message->type & FLAG_MASK) {
-				case TYPE_CALL: {
-					Variant *args = (Variant *)(message + 1);
+			if (target != nullptr) {
+				switch (message->type & FLAG_MASK) {
+					case TYPE_CALL: {
+						Variant *args = (Variant *)(message + 1);
 
-					// messages don't expect a return value
+						// messages don't expect a return value
 
-					_call_function(message->callable, args, message->args, message->type & FLAG_SHOW_ERROR);
+						_call_function(message->callable, args, message->args, message->type & FLAG_SHOW_ERROR);
 
-				} break;
-				case TYPE_NOTIFICATION: {
-					// messages don't expect a return value
-					target->notification(message->notification);
+					} break;
+					case TYPE_NOTIFICATION: {
+						// messages don't expect a return value
+						target->notification(message->notification);
 
-				} break;
-				case TYPE_SET: {
-					Variant *arg = (Variant *)(message + 1);
-					// messages don't expect a return value
-					target->set(message->callable.get_method(), *arg);
+					} break;
+					case TYPE_SET: {
+						Variant *arg = (Variant *)(message + 1);
+						// messages don't expect a return value
+						target->set(message->callable.get_method(), *arg);
 
-				} break;
+					} break;
+				}
 			}
+
+			_destroy_message(message);
 		}
 
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			Variant *args = (Variant *)(message + 1);
-			for (int i = 0; i < message->args; i++) {
-				args[i].~Variant();
+		for (uint32_t i = 0; i < sources.size(); i++) {
+			Source &source = sources[i];
+			for (uint32_t j = 0; j < source.pages.size(); j++) {
+				Page *page = source.pages[j];
+				_free_page(page);
 			}
 		}
-
-		message->~Message();
-
-		_THREAD_SAFE_LOCK_
 	}
 
-	buffer_end = 0; // reset buffer
+	thread_buffers_mutex.lock();
 	flushing = false;
-	_THREAD_SAFE_UNLOCK_
+	thread_buffers_mutex.unlock();
 }
 
 bool MessageQueue::is_flushing() const {
@@ -312,34 +451,37 @@ bool MessageQueue::is_flushing() const {
 
 MessageQueue::MessageQueue() {
 	ERR_FAIL_COND_MSG(singleton != nullptr, "A MessageQueue singleton already exists.");
+	MutexLock lock(singleton_mutex);
 	singleton = this;
 
-	buffer_size = GLOBAL_DEF_RST("memory/limits/message_queue/max_size_kb", DEFAULT_QUEUE_SIZE_KB);
+	// Thread buffers are matched to the queue by ID, in case it is created again.
+	id = last_id.increment();
+
+	free_pages_max_bytes = GLOBAL_DEF_RST("memory/limits/message_queue/max_size_kb", DEFAULT_QUEUE_SIZE_KB);
 	ProjectSettings::get_singleton()->set_custom_property_info("memory/limits/message_queue/max_size_kb", PropertyInfo(Variant::INT, "memory/limits/message_queue/max_size_kb", PROPERTY_HINT_RANGE, "1024,4096,1,or_greater"));
-	buffer_size *= 1024;
-	buffer = memnew_arr(uint8_t, buffer_size);
+	free_pages_max_bytes *= 1024;
 }
 
 MessageQueue::~MessageQueue() {
-	uint32_t read_pos = 0;
-
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
-		Variant *args = (Variant *)(message + 1);
-		int argc = message->args;
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			for (int i = 0; i < argc; i++) {
-				args[i].~Variant();
+	MutexLock lock(singleton_mutex);
+	for (uint32_t i = 0; i < thread_buffers.size(); i++) {
+		ThreadBuffer *buffer = thread_buffers[i];
+		for (uint32_t j = 0; j < buffer->pages.size(); j++) {
+			Page *page = buffer->pages[j];
+			uint32_t read_pos = 0;
+			while (read_pos < page->used) {
+				Message *message = (Message *)(page->get_data() + read_pos);
+				read_pos += _get_message_size(message);
+				_destroy_message(message);
 			}
+			memfree(page);
 		}
-		message->~Message();
+		memdelete(buffer);
+	}
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			read_pos += sizeof(Variant) * message->args;
-		}
+	for (uint32_t i = 0; i < free_pages.size(); i++) {
+		memfree(free_pages[i]);
 	}
 
 	singleton = nullptr;
-	memdelete_arr(buffer);
 }
@@ -32,16 +32,21 @@
 #define MESSAGE_QUEUE_H
 
 #include "core/object/object_id.h"
-#include "core/os/thread_safe.h"
+#include "core/os/mutex.h"
+#include "core/os/spin_lock.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
 #include "core/variant/variant.h"
 
 class Object;
 
+// Messages are written to per-thread buffers made of pages, so threads posting
+// deferred calls don't contend with each other. Each message gets a global
+// sequence number, used to merge all buffers back in order when flushing.
 class MessageQueue {
-	_THREAD_SAFE_CLASS_
-
 	enum {
-		DEFAULT_QUEUE_SIZE_KB = 4096
+		DEFAULT_QUEUE_SIZE_KB = 4096,
+		PAGE_SIZE_BYTES = 64 * 1024,
 	};
 
 	enum {
@@ -55,6 +60,7 @@ class MessageQueue {
 
 	struct Message {
 		Callable callable;
+		uint64_t order;
 		int16_t type;
 		union {
 			int16_t notification;
@@ -62,10 +68,50 @@ class MessageQueue {
 		};
 	};
 
-	uint8_t *buffer = nullptr;
-	uint32_t buffer_end = 0;
+	struct Page {
+		uint32_t used = 0;
+		uint32_t size = 0;
+
+		_FORCE_INLINE_ uint8_t *get_data() { return (uint8_t *)(this + 1); }
+	};
+
+	struct ThreadBuffer {
+		SpinLock lock;
+		LocalVector<Page *> pages;
+	};
+
+	// Hands the buffer back to the queue when its thread exits, so it can be reused by another thread.
+	struct ThreadBufferOwner {
+		ThreadBuffer *buffer = nullptr;
+		uint64_t queue_id = 0;
+		~ThreadBufferOwner();
+	};
+
+	uint64_t id = 0;
+	SafeNumeric<uint64_t> message_order;
+
+	BinaryMutex thread_buffers_mutex;
+	LocalVector<ThreadBuffer *> thread_buffers;
+	LocalVector<ThreadBuffer *> unowned_thread_buffers; // Still flushed, their messages may be pending.
+
+	// Pages are recycled after flushing, up to the configured size.
+	SpinLock free_pages_lock;
+	LocalVector<Page *> free_pages;
+	uint32_t free_pages_max_bytes = 0;
+	uint32_t free_pages_bytes = 0;
+
 	uint32_t buffer_max_used = 0;
-	uint32_t buffer_size = 0;
+
+	static thread_local ThreadBufferOwner thread_buffer_owner;
+	static SafeNumeric<uint64_t> last_id;
+	static BinaryMutex singleton_mutex; // Keeps the queue alive while exiting threads hand their buffer back.
+
+	ThreadBuffer *_get_thread_buffer();
+	Message *_alloc_message(ThreadBuffer *p_buffer, uint32_t p_size);
+	Page *_alloc_page(uint32_t p_min_size);
+	void _free_page(Page *p_page);
+	static uint32_t _get_message_size(const Message *p_message);
+	static void _destroy_message(Message *p_message);
 
 	void _call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error);
 
@@ -121,6 +167,7 @@ public:
 	bool is_flushing() const;
 
 	int get_max_buffer_usage() const;
+	int get_thread_buffer_count();
 
 	MessageQueue();
 	~MessageQueue();
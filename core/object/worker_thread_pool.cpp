@@ -41,12 +41,68 @@ void WorkerThreadPool::Task::free_template_userdata() {
 
 WorkerThreadPool *WorkerThreadPool::singleton = nullptr;
 
-void WorkerThreadPool::_process_task_queue() {
-	task_mutex.lock();
-	Task *task = task_queue.first()->self();
-	task_queue.remove(task_queue.first());
-	task_mutex.unlock();
+thread_local WorkerThreadPool *WorkerThreadPool::current_pool = nullptr;
+thread_local uint32_t WorkerThreadPool::current_thread_index = 0;
+
+WorkerThreadPool::Task *WorkerThreadPool::_pop_inbox(ThreadData &p_thread) {
+	Task *task = nullptr;
+	p_thread.inbox_lock.lock();
+	SelfList<Task> *first = p_thread.inbox.first();
+	if (first) {
+		task = first->self();
+		p_thread.inbox.remove(first);
+	}
+	p_thread.inbox_lock.unlock();
+	return task;
+}
+
+WorkerThreadPool::Task *WorkerThreadPool::_pop_task(uint32_t p_thread_index) {
+	ThreadData &thread = threads[p_thread_index];
+	Task *task = nullptr;
+
+	// Own work first, most recently posted is likely the hottest in cache.
+	if (thread.queue.pop(task)) {
+		return task;
+	}
+	task = _pop_inbox(thread);
+	if (task) {
+		return task;
+	}
+
+	// Nothing local, try stealing from the other workers, starting at a different one each time to spread thieves out.
+	uint32_t thread_count = threads.size();
+	uint32_t offset = thread.steal_seed++;
+	for (uint32_t i = 0; i + 1 < thread_count; i++) {
+		ThreadData &victim = threads[(p_thread_index + 1 + (offset + i) % (thread_count - 1)) % thread_count];
+		if (victim.queue.steal(task)) {
+			return task;
+		}
+		task = _pop_inbox(victim);
+		if (task) {
+			return task;
+		}
+	}
+
+	return nullptr;
+}
+
+bool WorkerThreadPool::_process_task_queue(uint32_t p_thread_index) {
+	Task *task = _pop_task(p_thread_index);
+	if (!task) {
+		return false;
+	}
+	queued_tasks.fetch_sub(1, std::memory_order_seq_cst);
 	_process_task(task);
+	return true;
+}
+
+void WorkerThreadPool::_wait_for_tasks() {
+	sleeping_threads.fetch_add(1, std::memory_order_seq_cst);
+	// Check again after announcing, so a task posted in between is not missed.
+	if (queued_tasks.load(std::memory_order_seq_cst) == 0 && !exit_threads.is_set()) {
+		task_available_semaphore.wait();
+	}
+	sleeping_threads.fetch_sub(1, std::memory_order_seq_cst);
 }
 
 void WorkerThreadPool::_process_task(Task *p_task) {
@@ -87,6 +143,10 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 			memdelete(p_task->template_userdata); // This is no longer needed at this point, so get rid of it.
 		}
 
+		if (do_post) {
+			_release_dependents(p_task->group);
+		}
+
 		if (low_priority && use_native_low_priority_threads) {
 			p_task->completed = true;
 			p_task->done_semaphore.post();
@@ -103,16 +163,11 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 
 			if (finished_users == max_users) {
 				// Get rid of the group, because nobody else is using it.
-				task_mutex.lock();
 				group_allocator.free(p_task->group);
-				task_mutex.unlock();
 			}
 
 			// For groups, tasks get rid of themselves.
-
-			task_mutex.lock();
 			task_allocator.free(p_task);
-			task_mutex.unlock();
 		}
 	} else {
 		if (p_task->native_func) {
@@ -126,71 +181,150 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 			p_task->callable.callp(nullptr, 0, ret, ce);
 		}
 
+		_release_dependents(p_task);
 		p_task->completed = true;
 		p_task->done_semaphore.post();
 	}
 
 	if (!use_native_low_priority_threads && low_priority) {
 		// A low prioriry task was freed, so see if we can move a pending one to the high priority queue.
-		bool post = false;
+		Task *low_prio_task = nullptr;
 		task_mutex.lock();
 		if (low_priority_task_queue.first()) {
-			Task *low_prio_task = low_priority_task_queue.first()->self();
+			low_prio_task = low_priority_task_queue.first()->self();
 			low_priority_task_queue.remove(low_priority_task_queue.first());
-			task_queue.add_last(&low_prio_task->task_elem);
-			post = true;
 		} else {
 			low_priority_threads_used.decrement();
 		}
-		task_mutex.lock();
-		if (post) {
-			task_available_semaphore.post();
+		task_mutex.unlock();
+		if (low_prio_task) {
+			_push_task(low_prio_task);
 		}
 	}
 }
 
 void WorkerThreadPool::_thread_function(void *p_user) {
+	ThreadData *thread_data = (ThreadData *)p_user;
+	WorkerThreadPool *pool = thread_data->pool;
+	current_pool = pool;
+	current_thread_index = thread_data->index;
+
 	while (true) {
-		singleton->task_available_semaphore.wait();
-		if (singleton->exit_threads.is_set()) {
+		if (pool->_process_task_queue(thread_data->index)) {
+			continue;
+		}
+		if (pool->exit_threads.is_set()) {
 			break;
 		}
-		singleton->_process_task_queue();
+		pool->_wait_for_tasks();
 	}
 }
 
 void WorkerThreadPool::_native_low_priority_thread_function(void *p_user) {
 	Task *task = (Task *)p_user;
-	singleton->_process_task(task);
+	task->pool->_process_task(task);
+}
+
+void WorkerThreadPool::_push_task(Task *p_task) {
+	if (current_pool == this) {
+		// Posted from one of our workers, no locking needed.
+		threads[current_thread_index].queue.push(p_task);
+	} else {
+		ThreadData &thread = threads[next_inbox.postincrement() % threads.size()];
+		thread.inbox_lock.lock();
+		thread.inbox.add_last(&p_task->task_elem);
+		thread.inbox_lock.unlock();
+	}
+
+	queued_tasks.fetch_add(1, std::memory_order_seq_cst);
+	if (sleeping_threads.load(std::memory_order_seq_cst) > 0) {
+		task_available_semaphore.post();
+	}
 }
 
 void WorkerThreadPool::_post_task(Task *p_task, bool p_high_priority) {
-	task_mutex.lock();
 	p_task->low_priority = !p_high_priority;
+	p_task->pool = this;
 	if (!p_high_priority && use_native_low_priority_threads) {
-		task_mutex.unlock();
 		p_task->low_priority_thread = native_thread_allocator.alloc();
 		p_task->low_priority_thread->start(_native_low_priority_thread_function, p_task); // Pask task directly to thread.
 
-	} else if (p_high_priority || low_priority_threads_used.get() < max_low_priority_threads) {
-		task_queue.add_last(&p_task->task_elem);
-		if (!p_high_priority) {
+	} else if (p_high_priority) {
+		_push_task(p_task);
+	} else {
+		task_mutex.lock();
+		if (low_priority_threads_used.get() < max_low_priority_threads) {
 			low_priority_threads_used.increment();
+			task_mutex.unlock();
+			_push_task(p_task);
+		} else {
+			// Too many threads using low priority, must go to queue.
+			low_priority_task_queue.add_last(&p_task->task_elem);
+			task_mutex.unlock();
 		}
-		task_mutex.unlock();
-		task_available_semaphore.post();
-	} else {
-		// Too many threads using low priority, must go to queue.
-		low_priority_task_queue.add_last(&p_task->task_elem);
-		task_mutex.unlock();
 	}
 }
 
+void WorkerThreadPool::_add_dependencies(Task *p_task, const Vector<TaskID> &p_dependencies) {
+	// Called with task_mutex locked, so dependencies can't be freed meanwhile.
+	for (int i = 0; i < p_dependencies.size(); i++) {
+		TaskID dependency = p_dependencies[i];
+		Task **taskp = tasks.getptr(dependency);
+		if (taskp) {
+			Task *dependency_task = *taskp;
+			dependency_task->dependents_lock.lock();
+			if (!dependency_task->dependents_released) {
+				dependency_task->dependents.push_back(p_task);
+				p_task->dependencies_pending.increment();
+			}
+			dependency_task->dependents_lock.unlock();
+			continue;
+		}
+
+		Group **groupp = groups.getptr(dependency);
+		if (groupp) {
+			Group *dependency_group = *groupp;
+			dependency_group->dependents_lock.lock();
+			if (!dependency_group->dependents_released) {
+				dependency_group->dependents.push_back(p_task);
+				p_task->dependencies_pending.increment();
+			}
+			dependency_group->dependents_lock.unlock();
+			continue;
+		}
+
+		// Not found, so it was already completed and waited for, unless it never existed.
+		ERR_CONTINUE_MSG(dependency <= 0 || dependency >= (TaskID)last_task, "Invalid Task or Group ID as dependency: " + itos(dependency));
+	}
+}
+
+template <class T>
+void WorkerThreadPool::_release_dependents(T *p_completed) {
+	p_completed->dependents_lock.lock();
+	p_completed->dependents_released = true;
+	p_completed->dependents_lock.unlock();
+
+	// Nothing else can be added once released, so it's safe to iterate unlocked.
+	for (uint32_t i = 0; i < p_completed->dependents.size(); i++) {
+		Task *dependent = p_completed->dependents[i];
+		if (dependent->dependencies_pending.decrement() == 0) {
+			_post_task(dependent, !dependent->low_priority);
+		}
+	}
+	p_completed->dependents.clear();
+}
+
 WorkerThreadPool::TaskID WorkerThreadPool::add_native_task(void (*p_func)(void *), void *p_userdata, bool p_high_priority, const String &p_description) {
 	return _add_task(Callable(), p_func, p_userdata, nullptr, p_high_priority, p_description);
 }
 
-WorkerThreadPool::TaskID WorkerThreadPool::_add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description) {
+WorkerThreadPool::TaskID WorkerThreadPool::_add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description, const Vector<TaskID> &p_dependencies) {
+	bool has_dependencies = !p_dependencies.is_empty();
+	if (has_dependencies && use_native_low_priority_threads) {
+		// Waiting on native threads that may not be started yet is not possible, so keep these in the pool.
+		p_high_priority = true;
+	}
+
 	task_mutex.lock();
 	// Get a free task
 	Task *task = task_allocator.alloc();
@@ -200,9 +334,18 @@ WorkerThreadPool::TaskID WorkerThreadPool::_add_task(const Callable &p_callable,
 	task->native_func_userdata = p_userdata;
 	task->description = p_description;
 	task->template_userdata = p_template_userdata;
+	task->low_priority = !p_high_priority;
 	tasks.insert(id, task);
+	if (has_dependencies) {
+		task->dependencies_pending.set(1); // Hold it until all dependencies are registered.
+		_add_dependencies(task, p_dependencies);
+	}
 	task_mutex.unlock();
 
+	if (has_dependencies && task->dependencies_pending.decrement() > 0) {
+		return id; // The last dependency to complete will post it.
+	}
+
 	_post_task(task, p_high_priority);
 
 	return id;
@@ -212,6 +355,14 @@ WorkerThreadPool::TaskID WorkerThreadPool::add_task(const Callable &p_action, bo
 	return _add_task(p_action, nullptr, nullptr, nullptr, p_high_priority, p_description);
 }
 
+WorkerThreadPool::TaskID WorkerThreadPool::add_native_dependent_task(void (*p_func)(void *), void *p_userdata, const Vector<TaskID> &p_dependencies, bool p_high_priority, const String &p_description) {
+	return _add_task(Callable(), p_func, p_userdata, nullptr, p_high_priority, p_description, p_dependencies);
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::add_dependent_task(const Callable &p_action, const Vector<TaskID> &p_dependencies, bool p_high_priority, const String &p_description) {
+	return _add_task(p_action, nullptr, nullptr, nullptr, p_high_priority, p_description, p_dependencies);
+}
+
 bool WorkerThreadPool::is_task_completed(TaskID p_task_id) const {
 	task_mutex.lock();
 	const Task *const *taskp = tasks.getptr(p_task_id);
@@ -253,18 +404,15 @@ void WorkerThreadPool::wait_for_task_completion(TaskID p_task_id) {
 		task->low_priority_thread->wait_to_finish();
 		native_thread_allocator.free(task->low_priority_thread);
 	} else {
-		int *index = thread_ids.getptr(Thread::get_caller_id());
-
-		if (index) {
+		if (current_pool == this) {
 			// We are an actual process thread, we must not be blocked so continue processing stuff if available.
 			while (true) {
 				if (task->done_semaphore.try_wait()) {
 					// If done, exit
 					break;
 				}
-				if (task_available_semaphore.try_wait()) {
+				if (_process_task_queue(current_thread_index)) {
 					// Solve tasks while they are around.
-					_process_task_queue();
 					continue;
 				}
 				OS::get_singleton()->delay_usec(1); // Microsleep, this could be converted to waiting for multiple objects in supported platforms for a bit more performance.
@@ -280,12 +428,18 @@ void WorkerThreadPool::wait_for_task_completion(TaskID p_task_id) {
 	task_mutex.unlock();
 }
 
-WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description) {
+WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description, const Vector<TaskID> &p_dependencies) {
 	ERR_FAIL_COND_V(p_elements < 0, INVALID_TASK_ID);
 	if (p_tasks < 0) {
 		p_tasks = threads.size();
 	}
 
+	bool has_dependencies = !p_dependencies.is_empty();
+	if (has_dependencies && use_native_low_priority_threads) {
+		// Same as for single tasks, keep these in the pool.
+		p_high_priority = true;
+	}
+
 	task_mutex.lock();
 	Group *group = group_allocator.alloc();
 	GroupID id = last_task++;
@@ -297,6 +451,7 @@ WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_ca
 		// Should really not call it with zero Elements, but at least it should work.
 		group->completed.set_to(true);
 		group->done_semaphore.post();
+		group->dependents_released = true;
 		group->tasks_used = 0;
 		p_tasks = 0;
 		if (p_template_userdata) {
@@ -314,6 +469,12 @@ WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_ca
 			task->group = group;
 			task->callable = p_callable;
 			task->template_userdata = p_template_userdata;
+			task->low_priority = !p_high_priority;
+			if (has_dependencies) {
+				// Each task of the group waits on the dependencies by itself.
+				task->dependencies_pending.set(1);
+				_add_dependencies(task, p_dependencies);
+			}
 			tasks_posted[i] = task;
 			// No task ID is used.
 		}
@@ -327,6 +488,9 @@ WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_ca
 	}
 
 	for (int i = 0; i < p_tasks; i++) {
+		if (has_dependencies && tasks_posted[i]->dependencies_pending.decrement() > 0) {
+			continue; // The last dependency to complete will post it.
+		}
 		_post_task(tasks_posted[i], p_high_priority);
 		if (!p_high_priority && use_native_low_priority_threads) {
 			group->low_priority_native_tasks[i] = tasks_posted[i];
@@ -344,6 +508,14 @@ WorkerThreadPool::GroupID WorkerThreadPool::add_group_task(const Callable &p_act
 	return _add_group_task(p_action, nullptr, nullptr, nullptr, p_elements, p_tasks, p_high_priority, p_description);
 }
 
+WorkerThreadPool::GroupID WorkerThreadPool::add_native_dependent_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, const Vector<TaskID> &p_dependencies, int p_tasks, bool p_high_priority, const String &p_description) {
+	return _add_group_task(Callable(), p_func, p_userdata, nullptr, p_elements, p_tasks, p_high_priority, p_description, p_dependencies);
+}
+
+WorkerThreadPool::GroupID WorkerThreadPool::add_dependent_group_task(const Callable &p_action, int p_elements, const Vector<TaskID> &p_dependencies, int p_tasks, bool p_high_priority, const String &p_description) {
+	return _add_group_task(p_action, nullptr, nullptr, nullptr, p_elements, p_tasks, p_high_priority, p_description, p_dependencies);
+}
+
 uint32_t WorkerThreadPool::get_group_processed_element_count(GroupID p_group) const {
 	task_mutex.lock();
 	const Group *const *groupp = groups.getptr(p_group);
@@ -370,39 +542,41 @@ bool WorkerThreadPool::is_group_task_completed(GroupID p_group) const {
 void WorkerThreadPool::wait_for_group_task_completion(GroupID p_group) {
 	task_mutex.lock();
 	Group **groupp = groups.getptr(p_group);
-	task_mutex.unlock();
 	if (!groupp) {
+		task_mutex.unlock();
 		ERR_FAIL_MSG("Invalid Group ID");
 	}
 	Group *group = *groupp;
+	task_mutex.unlock();
 
 	if (group->low_priority_native_tasks.size() > 0) {
 		for (uint32_t i = 0; i < group->low_priority_native_tasks.size(); i++) {
 			group->low_priority_native_tasks[i]->low_priority_thread->wait_to_finish();
 			native_thread_allocator.free(group->low_priority_native_tasks[i]->low_priority_thread);
-			task_mutex.lock();
 			task_allocator.free(group->low_priority_native_tasks[i]);
-			task_mutex.unlock();
 		}
 
 		task_mutex.lock();
-		group_allocator.free(group);
+		groups.erase(p_group);
 		task_mutex.unlock();
+
+		group_allocator.free(group);
 	} else {
 		group->done_semaphore.wait();
 
+		// Unregister before giving up our use of the group, as tasks depending on it look it up from other threads.
+		task_mutex.lock();
+		groups.erase(p_group);
+		task_mutex.unlock();
+
 		uint32_t max_users = group->tasks_used + 1; // Add 1 because the thread waiting for it is also user. Read before to avoid another thread freeing task after increment.
 		uint32_t finished_users = group->finished.increment(); // fetch happens before inc, so increment later.
 
 		if (finished_users == max_users) {
 			// All tasks using this group are gone (finished before the group), so clear the group too.
-			task_mutex.lock();
 			group_allocator.free(group);
-			task_mutex.unlock();
 		}
 	}
-
-	groups.erase(p_group); // Threads do not access this, so safe to erase here.
 }
 
 void WorkerThreadPool::init(int p_thread_count, bool p_use_native_threads_low_priority, float p_low_priority_task_ratio) {
@@ -423,8 +597,12 @@ void WorkerThreadPool::init(int p_thread_count, bool p_use_native_threads_low_pr
 
 	for (uint32_t i = 0; i < threads.size(); i++) {
 		threads[i].index = i;
+		threads[i].pool = this;
+	}
+
+	// Start only once all are set up, as workers may steal from each other right away.
+	for (uint32_t i = 0; i < threads.size(); i++) {
 		threads[i].thread.start(&WorkerThreadPool::_thread_function, &threads[i]);
-		thread_ids.insert(threads[i].thread.get_id(), i);
 	}
 }
 
@@ -458,17 +636,25 @@ void WorkerThreadPool::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("add_task", "action", "high_priority", "description"), &WorkerThreadPool::add_task, DEFVAL(false), DEFVAL(String()));
 	ClassDB::bind_method(D_METHOD("is_task_completed", "task_id"), &WorkerThreadPool::is_task_completed);
 	ClassDB::bind_method(D_METHOD("wait_for_task_completion", "task_id"), &WorkerThreadPool::wait_for_task_completion);
+	ClassDB::bind_method(D_METHOD("add_dependent_task", "action", "dependencies", "high_priority", "description"), &WorkerThreadPool::add_dependent_task, DEFVAL(false), DEFVAL(String()));
 
 	ClassDB::bind_method(D_METHOD("add_group_task", "action", "elements", "tasks_needed", "high_priority", "description"), &WorkerThreadPool::add_group_task, DEFVAL(-1), DEFVAL(false), DEFVAL(String()));
 	ClassDB::bind_method(D_METHOD("is_group_task_completed", "group_id"), &WorkerThreadPool::is_group_task_completed);
 	ClassDB::bind_method(D_METHOD("get_group_processed_element_count", "group_id"), &WorkerThreadPool::get_group_processed_element_count);
 	ClassDB::bind_method(D_METHOD("wait_for_group_task_completion", "group_id"), &WorkerThreadPool::wait_for_group_task_completion);
+	ClassDB::bind_method(D_METHOD("add_dependent_group_task", "action", "elements", "dependencies", "tasks_needed", "high_priority", "description"), &WorkerThreadPool::add_dependent_group_task, DEFVAL(-1), DEFVAL(false), DEFVAL(String()));
 }
 
 WorkerThreadPool::WorkerThreadPool() {
-	singleton = this;
+	// Only the first pool created is the engine-wide one, others may be created for private use.
+	if (!singleton) {
+		singleton = this;
+	}
 }
 
 WorkerThreadPool::~WorkerThreadPool() {
 	finish();
+	if (singleton == this) {
+		singleton = nullptr;
+	}
 }
@@ -34,11 +34,15 @@
 #include "core/os/memory.h"
 #include "core/os/os.h"
 #include "core/os/semaphore.h"
+#include "core/os/spin_lock.h"
 #include "core/os/thread.h"
 #include "core/templates/local_vector.h"
 #include "core/templates/paged_allocator.h"
 #include "core/templates/rid.h"
 #include "core/templates/safe_refcount.h"
+#include "core/templates/work_stealing_deque.h"
+
+#include <atomic>
 
 class WorkerThreadPool : public Object {
 	GDCLASS(WorkerThreadPool, Object)
@@ -69,6 +73,10 @@ private:
 		SafeNumeric<uint32_t> finished;
 		uint32_t tasks_used = 0;
 		TightLocalVector<Task *> low_priority_native_tasks;
+		// Tasks waiting for this group to complete.
+		SpinLock dependents_lock;
+		TightLocalVector<Task *> dependents;
+		bool dependents_released = false;
 	};
 
 	struct Task {
@@ -85,31 +93,52 @@ private:
 		bool low_priority = false;
 		BaseTemplateUserdata *template_userdata = nullptr;
 		Thread *low_priority_thread = nullptr;
+		WorkerThreadPool *pool = nullptr;
+		// Tasks waiting for this one to complete.
+		SpinLock dependents_lock;
+		TightLocalVector<Task *> dependents;
+		bool dependents_released = false;
+		// Dependencies of this task still running, it is posted once this reaches zero.
+		SafeNumeric<uint32_t> dependencies_pending;
 
 		void free_template_userdata();
 		Task() :
 				task_elem(this) {}
 	};
 
-	PagedAllocator<Task> task_allocator;
-	PagedAllocator<Group> group_allocator;
-	PagedAllocator<Thread> native_thread_allocator;
+	// Tasks of a group free themselves from worker threads, so these must be thread safe.
+	PagedAllocator<Task, true> task_allocator;
+	PagedAllocator<Group, true> group_allocator;
+	PagedAllocator<Thread, true> native_thread_allocator;
 
 	SelfList<Task>::List low_priority_task_queue;
-	SelfList<Task>::List task_queue;
 
 	Mutex task_mutex;
 	Semaphore task_available_semaphore;
 
 	struct ThreadData {
 		uint32_t index;
+		uint32_t steal_seed = 0;
 		Thread thread;
+		WorkerThreadPool *pool = nullptr;
+		// Tasks posted from this worker, popped LIFO by it and stolen FIFO by the others.
+		WorkStealingDeque<Task *> queue;
+		// Tasks posted from threads outside the pool, spread across workers.
+		SpinLock inbox_lock;
+		SelfList<Task>::List inbox;
 	};
 
 	TightLocalVector<ThreadData> threads;
 	SafeFlag exit_threads;
 
-	HashMap<Thread::ID, int> thread_ids;
+	// Dekker-style handshake between posting and sleeping threads, which needs sequential consistency.
+	std::atomic<uint32_t> queued_tasks = { 0 };
+	std::atomic<uint32_t> sleeping_threads = { 0 };
+	SafeNumeric<uint32_t> next_inbox;
+
+	static thread_local WorkerThreadPool *current_pool;
+	static thread_local uint32_t current_thread_index;
+
 	HashMap<TaskID, Task *> tasks;
 	HashMap<GroupID, Group *> groups;
 
@@ -122,15 +151,23 @@ private:
 	static void _thread_function(void *p_user);
 	static void _native_low_priority_thread_function(void *p_user);
 
-	void _process_task_queue();
+	Task *_pop_inbox(ThreadData &p_thread);
+	Task *_pop_task(uint32_t p_thread_index);
+	bool _process_task_queue(uint32_t p_thread_index);
 	void _process_task(Task *task);
+	void _wait_for_tasks();
 
+	void _push_task(Task *p_task);
 	void _post_task(Task *p_task, bool p_high_priority);
 
+	void _add_dependencies(Task *p_task, const Vector<TaskID> &p_dependencies);
+	template <class T>
+	void _release_dependents(T *p_completed);
+
 	static WorkerThreadPool *singleton;
 
-	TaskID _add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description);
-	GroupID _add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description);
+	TaskID _add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description, const Vector<TaskID> &p_dependencies = Vector<TaskID>());
+	GroupID _add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description, const Vector<TaskID> &p_dependencies = Vector<TaskID>());
 
 	template <class C, class M, class U>
 	struct TaskUserData : public BaseTemplateUserdata {
@@ -168,6 +205,21 @@ public:
 	TaskID add_native_task(void (*p_func)(void *), void *p_userdata, bool p_high_priority = false, const String &p_description = String());
 	TaskID add_task(const Callable &p_action, bool p_high_priority = false, const String &p_description = String());
 
+	// Dependent tasks are only posted once all the tasks and groups in p_dependencies have completed,
+	// so they can be chained into a graph without blocking on waits. A single dependency acts as a continuation.
+	// They always run on the pool threads, even if low priority tasks are set to use native threads.
+	template <class C, class M, class U>
+	TaskID add_template_dependent_task(C *p_instance, M p_method, U p_userdata, const Vector<TaskID> &p_dependencies, bool p_high_priority = false, const String &p_description = String()) {
+		typedef TaskUserData<C, M, U> TUD;
+		TUD *ud = memnew(TUD);
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+		return _add_task(Callable(), nullptr, nullptr, ud, p_high_priority, p_description, p_dependencies);
+	}
+	TaskID add_native_dependent_task(void (*p_func)(void *), void *p_userdata, const Vector<TaskID> &p_dependencies, bool p_high_priority = false, const String &p_description = String());
+	TaskID add_dependent_task(const Callable &p_action, const Vector<TaskID> &p_dependencies, bool p_high_priority = false, const String &p_description = String());
+
 	bool is_task_completed(TaskID p_task_id) const;
 	void wait_for_task_completion(TaskID p_task_id);
 
@@ -182,6 +234,18 @@ public:
 	}
 	GroupID add_native_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String());
 	GroupID add_group_task(const Callable &p_action, int p_elements, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String());
+
+	template <class C, class M, class U>
+	GroupID add_template_dependent_group_task(C *p_instance, M p_method, U p_userdata, int p_elements, const Vector<TaskID> &p_dependencies, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String()) {
+		typedef GroupUserData<C, M, U> GUD;
+		GUD *ud = memnew(GUD);
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+		return _add_group_task(Callable(), nullptr, nullptr, ud, p_elements, p_tasks, p_high_priority, p_description, p_dependencies);
+	}
+	GroupID add_native_dependent_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, const Vector<TaskID> &p_dependencies, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String());
+	GroupID add_dependent_group_task(const Callable &p_action, int p_elements, const Vector<TaskID> &p_dependencies, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String());
 	uint32_t get_group_processed_element_count(GroupID p_group) const;
 	bool is_group_task_completed(GroupID p_group) const;
 	void wait_for_group_task_completion(GroupID p_group);
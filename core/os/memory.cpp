@@ -33,8 +33,13 @@
 #include "core/error/error_macros.h"
 #include "core/templates/safe_refcount.h"
 
+#ifdef SMALL_ALLOCATOR_ENABLED
+#include "core/os/small_allocator.h"
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 void *operator new(size_t p_size, const char *p_description) {
 	return Memory::alloc_static(p_size, false);
@@ -65,14 +70,35 @@ SafeNumeric<uint64_t> Memory::max_usage;
 
 SafeNumeric<uint64_t> Memory::alloc_count;
 
-void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
-#ifdef DEBUG_ENABLED
-	bool prepad = true;
+#ifdef SMALL_ALLOCATOR_ENABLED
+// The size is always stored in front, as it tells which allocator a block belongs to.
+#define MEMORY_PREPAD(m_pad_align) true
+
+static _FORCE_INLINE_ void *_alloc_block(size_t p_bytes) {
+	return SmallAllocator::is_small(p_bytes) ? SmallAllocator::alloc(p_bytes) : malloc(p_bytes);
+}
+
+static _FORCE_INLINE_ void _free_block(void *p_mem, size_t p_bytes) {
+	if (SmallAllocator::is_small(p_bytes)) {
+		SmallAllocator::free(p_mem, p_bytes);
+	} else {
+		free(p_mem);
+	}
+}
+#elif defined(DEBUG_ENABLED)
+#define MEMORY_PREPAD(m_pad_align) true
 #else
-	bool prepad = p_pad_align;
+#define MEMORY_PREPAD(m_pad_align) m_pad_align
 #endif
 
+void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
+	bool prepad = MEMORY_PREPAD(p_pad_align);
+
+#ifdef SMALL_ALLOCATOR_ENABLED
+	void *mem = _alloc_block(p_bytes + PAD_ALIGN);
+#else
 	void *mem = malloc(p_bytes + (prepad ? PAD_ALIGN : 0));
+#endif
 
 	ERR_FAIL_COND_V(!mem, nullptr);
 
@@ -101,11 +127,7 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 
 	uint8_t *mem = (uint8_t *)p_memory;
 
-#ifdef DEBUG_ENABLED
-	bool prepad = true;
-#else
-	bool prepad = p_pad_align;
-#endif
+	bool prepad = MEMORY_PREPAD(p_pad_align);
 
 	if (prepad) {
 		mem -= PAD_ALIGN;
@@ -120,6 +142,32 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 		}
 #endif
 
+#ifdef SMALL_ALLOCATOR_ENABLED
+		uint64_t old_bytes = *s;
+		if (p_bytes == 0) {
+			_free_block(mem, old_bytes + PAD_ALIGN);
+			return nullptr;
+		}
+
+		if (SmallAllocator::is_small(old_bytes + PAD_ALIGN) || SmallAllocator::is_small(p_bytes + PAD_ALIGN)) {
+			if (SmallAllocator::is_small(old_bytes + PAD_ALIGN) && SmallAllocator::is_small(p_bytes + PAD_ALIGN) &&
+					SmallAllocator::get_size_class(old_bytes + PAD_ALIGN) == SmallAllocator::get_size_class(p_bytes + PAD_ALIGN)) {
+				// Still fits in the same block.
+				*s = p_bytes;
+				return mem + PAD_ALIGN;
+			}
+
+			uint8_t *new_mem = (uint8_t *)_alloc_block(p_bytes + PAD_ALIGN);
+			ERR_FAIL_COND_V(!new_mem, nullptr);
+			memcpy(new_mem + PAD_ALIGN, mem + PAD_ALIGN, MIN(old_bytes, (uint64_t)p_bytes));
+			_free_block(mem, old_bytes + PAD_ALIGN);
+
+			s = (uint64_t *)new_mem;
+			*s = p_bytes;
+			return new_mem + PAD_ALIGN;
+		}
+#endif
+
 		if (p_bytes == 0) {
 			free(mem);
 			return nullptr;
@@ -149,23 +197,26 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 
 	uint8_t *mem = (uint8_t *)p_ptr;
 
-#ifdef DEBUG_ENABLED
-	bool prepad = true;
-#else
-	bool prepad = p_pad_align;
-#endif
+	bool prepad = MEMORY_PREPAD(p_pad_align);
 
 	alloc_count.decrement();
 
 	if (prepad) {
 		mem -= PAD_ALIGN;
 
-#ifdef DEBUG_ENABLED
+#if defined(DEBUG_ENABLED) || defined(SMALL_ALLOCATOR_ENABLED)
 		uint64_t *s = (uint64_t *)mem;
+#endif
+
+#ifdef DEBUG_ENABLED
 		mem_usage.sub(*s);
 #endif
 
+#ifdef SMALL_ALLOCATOR_ENABLED
+		_free_block(mem, *s + PAD_ALIGN);
+#else
 		free(mem);
+#endif
 	} else {
 		free(mem);
 	}
@@ -0,0 +1,216 @@
+/*************************************************************************/
+/*  small_allocator.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "small_allocator.h"
+
+#include "core/os/spin_lock.h"
+
+#include <stdlib.h>
+
+namespace {
+
+struct FreeBlock {
+	FreeBlock *next;
+};
+
+// Shared state of a size class. Must be constant initialized, as memory is allocated before
+// any static constructor is guaranteed to have run.
+struct CentralSizeClass {
+	SpinLock lock;
+	FreeBlock *free_list = nullptr;
+	uint8_t *span_pos = nullptr;
+	uint8_t *span_end = nullptr;
+	uint64_t blocks_used = 0;
+	uint64_t blocks_reserved = 0;
+};
+
+CentralSizeClass central_classes[SmallAllocator::SIZE_CLASS_COUNT];
+
+// Trivial, so it's usable until the thread is completely gone. Releasing it is done
+// by ThreadCacheReleaser, which is destroyed when the thread exits.
+struct ThreadCache {
+	FreeBlock *free_lists[SmallAllocator::SIZE_CLASS_COUNT];
+	uint32_t free_counts[SmallAllocator::SIZE_CLASS_COUNT];
+	bool registered;
+	bool released;
+};
+
+thread_local ThreadCache thread_cache;
+
+_FORCE_INLINE_ uint32_t get_batch_size(uint32_t p_block_size) {
+	uint32_t batch = 8192 / p_block_size;
+	return batch < 8 ? 8 : (batch > 64 ? 64 : batch);
+}
+
+// Moves up to p_count blocks of a class from the shared lists to the given list, returns how many were moved.
+uint32_t take_from_central(uint32_t p_class, uint32_t p_count, FreeBlock *&r_list) {
+	CentralSizeClass &central = central_classes[p_class];
+	uint32_t block_size = SmallAllocator::get_size_class_block_size(p_class);
+	uint32_t taken = 0;
+
+	central.lock.lock();
+	while (taken < p_count) {
+		FreeBlock *block = central.free_list;
+		if (block) {
+			central.free_list = block->next;
+		} else {
+			if (central.span_pos + block_size > central.span_end) {
+				uint8_t *span = (uint8_t *)malloc(SmallAllocator::SPAN_SIZE);
+				if (!span) {
+					break;
+				}
+				central.span_pos = span;
+				central.span_end = span + SmallAllocator::SPAN_SIZE;
+				central.blocks_reserved += SmallAllocator::SPAN_SIZE / block_size;
+			}
+			block = (FreeBlock *)central.span_pos;
+			central.span_pos += block_size;
+		}
+		block->next = r_list;
+		r_list = block;
+		taken++;
+	}
+	central.blocks_used += taken;
+	central.lock.unlock();
+
+	return taken;
+}
+
+void give_to_central(uint32_t p_class, FreeBlock *p_first, FreeBlock *p_last, uint32_t p_count) {
+	CentralSizeClass &central = central_classes[p_class];
+	central.lock.lock();
+	p_last->next = central.free_list;
+	central.free_list = p_first;
+	central.blocks_used -= p_count;
+	central.lock.unlock();
+}
+
+void release_thread_cache() {
+	ThreadCache &cache = thread_cache;
+	for (uint32_t i = 0; i < SmallAllocator::SIZE_CLASS_COUNT; i++) {
+		FreeBlock *first = cache.free_lists[i];
+		if (!first) {
+			continue;
+		}
+		FreeBlock *last = first;
+		while (last->next) {
+			last = last->next;
+		}
+		give_to_central(i, first, last, cache.free_counts[i]);
+		cache.free_lists[i] = nullptr;
+		cache.free_counts[i] = 0;
+	}
+	// Anything allocated or freed by this thread from now on goes straight to the shared lists.
+	cache.released = true;
+}
+
+struct ThreadCacheReleaser {
+	void touch() {}
+	~ThreadCacheReleaser() {
+		release_thread_cache();
+	}
+};
+
+thread_local ThreadCacheReleaser thread_cache_releaser;
+
+_FORCE_INLINE_ void register_thread_cache(ThreadCache &p_cache) {
+	if (unlikely(!p_cache.registered)) {
+		p_cache.registered = true;
+		thread_cache_releaser.touch(); // Constructs it, so the cache is released on thread exit.
+	}
+}
+
+} // namespace
+
+void *SmallAllocator::alloc(size_t p_bytes) {
+	uint32_t size_class = get_size_class(p_bytes);
+	ThreadCache &cache = thread_cache;
+
+	if (unlikely(!cache.free_lists[size_class])) {
+		register_thread_cache(cache);
+		if (unlikely(cache.released)) {
+			FreeBlock *block = nullptr;
+			take_from_central(size_class, 1, block);
+			return block;
+		}
+		cache.free_counts[size_class] += take_from_central(size_class, get_batch_size(get_size_class_block_size(size_class)), cache.free_lists[size_class]);
+		if (unlikely(!cache.free_lists[size_class])) {
+			return nullptr; // Out of memory.
+		}
+	}
+
+	FreeBlock *block = cache.free_lists[size_class];
+	cache.free_lists[size_class] = block->next;
+	cache.free_counts[size_class]--;
+	return block;
+}
+
+void SmallAllocator::free(void *p_ptr, size_t p_bytes) {
+	uint32_t size_class = get_size_class(p_bytes);
+	ThreadCache &cache = thread_cache;
+	FreeBlock *block = (FreeBlock *)p_ptr;
+
+	if (unlikely(cache.released)) {
+		give_to_central(size_class, block, block, 1);
+		return;
+	}
+	register_thread_cache(cache);
+
+	block->next = cache.free_lists[size_class];
+	cache.free_lists[size_class] = block;
+	cache.free_counts[size_class]++;
+
+	uint32_t batch = get_batch_size(get_size_class_block_size(size_class));
+	if (unlikely(cache.free_counts[size_class] >= batch * 2)) {
+		// Too many cached, give a batch back so other threads can use them.
+		FreeBlock *first = cache.free_lists[size_class];
+		FreeBlock *last = first;
+		for (uint32_t i = 1; i < batch; i++) {
+			last = last->next;
+		}
+		cache.free_lists[size_class] = last->next;
+		cache.free_counts[size_class] -= batch;
+		give_to_central(size_class, first, last, batch);
+	}
+}
+
+SmallAllocator::SizeClassUsage SmallAllocator::get_size_class_usage(uint32_t p_class) {
+	SizeClassUsage usage;
+	if (p_class >= SIZE_CLASS_COUNT) {
+		return usage;
+	}
+	CentralSizeClass &central = central_classes[p_class];
+	usage.block_size = get_size_class_block_size(p_class);
+	central.lock.lock();
+	usage.used_bytes = central.blocks_used * usage.block_size;
+	usage.reserved_bytes = central.blocks_reserved * usage.block_size;
+	central.lock.unlock();
+	return usage;
+}
@@ -0,0 +1,80 @@
+/*************************************************************************/
+/*  small_allocator.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef SMALL_ALLOCATOR_H
+#define SMALL_ALLOCATOR_H
+
+#include "core/typedefs.h"
+
+#include <stddef.h>
+
+// Size-class allocator for small blocks, used underneath Memory::alloc_static() when
+// built with `small_allocator=yes`.
+//
+// Blocks are carved from large spans, one free list per size class. Each thread keeps
+// a cache of free blocks per class, so most allocations and frees touch no lock at all;
+// the cache is refilled from, and overflows to, the shared lists in batches.
+// Spans are never returned to the system.
+class SmallAllocator {
+public:
+	enum {
+		MAX_SIZE = 1024,
+		SIZE_CLASS_COUNT = 28,
+		SPAN_SIZE = 64 * 1024,
+	};
+
+	struct SizeClassUsage {
+		uint32_t block_size = 0;
+		uint64_t used_bytes = 0; // Handed out to threads, includes blocks sitting in thread caches.
+		uint64_t reserved_bytes = 0;
+	};
+
+	_FORCE_INLINE_ static bool is_small(size_t p_bytes) { return p_bytes <= MAX_SIZE; }
+
+	// Classes are 16 bytes apart up to 256 bytes, then 64 bytes apart.
+	_FORCE_INLINE_ static uint32_t get_size_class(size_t p_bytes) {
+		if (p_bytes <= 256) {
+			return p_bytes == 0 ? 0 : uint32_t((p_bytes + 15) >> 4) - 1;
+		}
+		return 15 + uint32_t((p_bytes - 256 + 63) >> 6);
+	}
+
+	_FORCE_INLINE_ static uint32_t get_size_class_block_size(uint32_t p_class) {
+		return p_class < 16 ? (p_class + 1) << 4 : 256 + ((p_class - 15) << 6);
+	}
+
+	// p_bytes must be at most MAX_SIZE, and be passed again when freeing.
+	static void *alloc(size_t p_bytes);
+	static void free(void *p_ptr, size_t p_bytes);
+
+	static SizeClassUsage get_size_class_usage(uint32_t p_class);
+};
+
+#endif // SMALL_ALLOCATOR_H
@@ -46,6 +46,7 @@
 #include "core/io/config_file.h"
 #include "core/io/dir_access.h"
 #include "core/io/dtls_server.h"
+#include "core/io/file_access_async.h"
 #include "core/io/http_client.h"
 #include "core/io/image_loader.h"
 #include "core/io/json.h"
@@ -106,6 +107,7 @@ static core_bind::Geometry2D *_geometry_2d = nullptr;
 static core_bind::Geometry3D *_geometry_3d = nullptr;
 
 static WorkerThreadPool *worker_thread_pool = nullptr;
+static FileAccessAsync *file_access_async = nullptr;
 
 extern Mutex _global_mutex;
 
@@ -289,6 +291,7 @@ void register_core_types() {
 	GDREGISTER_NATIVE_STRUCT(ScriptLanguageExtensionProfilingInfo, "StringName signature;uint64_t call_count;uint64_t total_time;uint64_t self_time");
 
 	worker_thread_pool = memnew(WorkerThreadPool);
+	file_access_async = FileAccessAsync::create();
 }
 
 void register_core_settings() {
@@ -378,6 +381,7 @@ void unregister_core_types() {
 	memdelete(_geometry_2d);
 	memdelete(_geometry_3d);
 
+	memdelete(file_access_async);
 	memdelete(worker_thread_pool);
 
 	ResourceLoader::remove_resource_format_loader(resource_format_image);
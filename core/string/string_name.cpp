@@ -33,20 +33,22 @@
 #include "core/os/os.h"
 #include "core/string/print_string.h"
 
+#include <string.h>
+
 StaticCString StaticCString::create(const char *p_ptr) {
 	StaticCString scs;
 	scs.ptr = p_ptr;
 	return scs;
 }
 
-StringName::_Data *StringName::_table[STRING_TABLE_LEN];
+std::atomic<StringName::_Data *> StringName::_table[STRING_TABLE_LEN];
+StringName::Shard StringName::_shards[STRING_TABLE_SHARDS];
 
 StringName _scs_create(const char *p_chr, bool p_static) {
 	return (p_chr[0] ? StringName(StaticCString::create(p_chr), p_static) : StringName());
 }
 
 bool StringName::configured = false;
-Mutex StringName::mutex;
 
 #ifdef DEBUG_ENABLED
 bool StringName::debug_stringname = false;
@@ -55,22 +57,24 @@ bool StringName::debug_stringname = false;
 void StringName::setup() {
 	ERR_FAIL_COND(configured);
 	for (int i = 0; i < STRING_TABLE_LEN; i++) {
-		_table[i] = nullptr;
+		_table[i].store(nullptr);
 	}
 	configured = true;
 }
 
 void StringName::cleanup() {
-	MutexLock lock(mutex);
+	for (int i = 0; i < STRING_TABLE_SHARDS; i++) {
+		_shards[i].mutex.lock();
+	}
 
 #ifdef DEBUG_ENABLED
 	if (unlikely(debug_stringname)) {
 		Vector<_Data *> data;
 		for (int i = 0; i < STRING_TABLE_LEN; i++) {
-			_Data *d = _table[i];
+			_Data *d = _table[i].load();
 			while (d) {
 				data.push_back(d);
-				d = d->next;
+				d = d->next.load();
 			}
 		}
 
@@ -80,10 +84,10 @@ void StringName::cleanup() {
 		int unreferenced_stringnames = 0;
 		int rarely_referenced_stringnames = 0;
 		for (int i = 0; i < data.size(); i++) {
-			print_line(itos(i + 1) + ": " + data[i]->get_name() + " - " + itos(data[i]->debug_references));
-			if (data[i]->debug_references == 0) {
+			print_line(itos(i + 1) + ": " + data[i]->get_name() + " - " + itos(data[i]->debug_references.get()));
+			if (data[i]->debug_references.get() == 0) {
 				unreferenced_stringnames += 1;
-			} else if (data[i]->debug_references < 5) {
+			} else if (data[i]->debug_references.get() < 5) {
 				rarely_referenced_stringnames += 1;
 			}
 		}
@@ -94,8 +98,8 @@ void StringName::cleanup() {
 #endif
 	int lost_strings = 0;
 	for (int i = 0; i < STRING_TABLE_LEN; i++) {
-		while (_table[i]) {
-			_Data *d = _table[i];
+		_Data *d = _table[i].load();
+		while (d) {
 			if (d->static_count.get() != d->refcount.get()) {
 				lost_strings++;
 
@@ -108,21 +112,136 @@ void StringName::cleanup() {
 				}
 			}
 
-			_table[i] = _table[i]->next;
+			_Data *next = d->next.load();
 			memdelete(d);
+			d = next;
 		}
+		_table[i].store(nullptr);
 	}
 	if (lost_strings) {
 		print_verbose("StringName: " + itos(lost_strings) + " unclaimed string names at exit.");
 	}
+
+	for (int i = 0; i < STRING_TABLE_SHARDS; i++) {
+		while (_shards[i].retired) {
+			_Data *d = _shards[i].retired;
+			_shards[i].retired = d->prev;
+			memdelete(d);
+		}
+		_shards[i].mutex.unlock();
+	}
 	configured = false;
 }
 
+// Compare against static names without building a String, searches of common names are frequent.
+static _FORCE_INLINE_ bool _cname_equals(const char *p_cname, const char *p_name) {
+	return strcmp(p_cname, p_name) == 0;
+}
+
+static _FORCE_INLINE_ bool _cname_equals(const char *p_cname, const char32_t *p_name) {
+	while (*p_cname && (char32_t)(uint8_t)*p_cname == *p_name) {
+		p_cname++;
+		p_name++;
+	}
+	return (char32_t)(uint8_t)*p_cname == *p_name;
+}
+
+static _FORCE_INLINE_ bool _cname_equals(const char *p_cname, const String &p_name) {
+	return p_name == p_cname;
+}
+
+// Searches without locking, returns the entry with a reference taken, or nullptr.
+template <class T>
+StringName::_Data *StringName::_find(uint32_t p_hash, const T &p_name) {
+	uint32_t idx = p_hash & STRING_TABLE_MASK;
+	Shard &shard = _shards[idx & STRING_TABLE_SHARD_MASK];
+
+	// Sequentially consistent along with unlinking in unref(), so entries removed after
+	// this increment can't be freed before the search ends, and earlier ones aren't seen.
+	shard.searches.fetch_add(1);
+
+	_Data *data = _table[idx].load();
+	while (data) {
+		// Compare hash first. Entries whose last reference is being released are skipped.
+		if (data->hash == p_hash && (data->cname ? _cname_equals(data->cname, p_name) : data->name == p_name) && data->refcount.ref()) {
+			break;
+		}
+		data = data->next.load();
+	}
+
+	shard.searches.fetch_sub(1);
+	return data;
+}
+
+template <class T>
+StringName::_Data *StringName::_intern(uint32_t p_hash, const T &p_name, bool p_static, const char *p_static_cname) {
+	_Data *data = _find(p_hash, p_name);
+
+	if (!data) {
+		uint32_t idx = p_hash & STRING_TABLE_MASK;
+		Shard &shard = _shards[idx & STRING_TABLE_SHARD_MASK];
+		MutexLock lock(shard.mutex);
+
+		// Another thread may have added it in the meantime.
+		data = _find(p_hash, p_name);
+		if (!data) {
+			data = memnew(_Data);
+			if (p_static_cname) {
+				data->cname = p_static_cname;
+			} else {
+				data->name = p_name;
+			}
+			data->refcount.init();
+			data->static_count.set(p_static ? 1 : 0);
+			data->hash = p_hash;
+			data->idx = idx;
+#ifdef DEBUG_ENABLED
+			if (unlikely(debug_stringname)) {
+				// Keep in memory, force static.
+				data->refcount.ref();
+				data->static_count.increment();
+			}
+#endif
+			_Data *head = _table[idx].load();
+			data->next.store(head);
+			if (head) {
+				head->prev = data;
+			}
+			_table[idx].store(data); // Published once fully initialized.
+			return data;
+		}
+	}
+
+	// Exists.
+	if (p_static) {
+		data->static_count.increment();
+	}
+#ifdef DEBUG_ENABLED
+	if (unlikely(debug_stringname)) {
+		data->debug_references.increment();
+	}
+#endif
+	return data;
+}
+
+// Must be called with the shard locked.
+void StringName::_free_retired(Shard &p_shard) {
+	if (!p_shard.retired || p_shard.searches.load() != 0) {
+		return;
+	}
+	while (p_shard.retired) {
+		_Data *d = p_shard.retired;
+		p_shard.retired = d->prev;
+		memdelete(d);
+	}
+}
+
 void StringName::unref() {
 	ERR_FAIL_COND(!configured);
 
 	if (_data && _data->refcount.unref()) {
-		MutexLock lock(mutex);
+		Shard &shard = _shards[_data->idx & STRING_TABLE_SHARD_MASK];
+		MutexLock lock(shard.mutex);
 
 		if (_data->static_count.get() > 0) {
 			if (_data->cname) {
@@ -131,19 +250,24 @@ void StringName::unref() {
 				ERR_PRINT("BUG: Unreferenced static string to 0: " + String(_data->name));
 			}
 		}
+		_Data *next = _data->next.load();
 		if (_data->prev) {
-			_data->prev->next = _data->next;
+			_data->prev->next.store(next);
 		} else {
-			if (_table[_data->idx] != _data) {
+			if (_table[_data->idx].load() != _data) {
 				ERR_PRINT("BUG!");
 			}
-			_table[_data->idx] = _data->next;
+			_table[_data->idx].store(next);
 		}
 
-		if (_data->next) {
-			_data->next->prev = _data->prev;
+		if (next) {
+			next->prev = _data->prev;
 		}
-		memdelete(_data);
+
+		// Searches may still be walking through it, next is left untouched for them.
+		_data->prev = shard.retired;
+		shard.retired = _data;
+		_free_retired(shard);
 	}
 
 	_data = nullptr;
@@ -206,59 +330,7 @@ StringName::StringName(const char *p_name, bool p_static) {
 		return; //empty, ignore
 	}
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = String::hash(p_name);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			if (p_static) {
-				_data->static_count.increment();
-			}
-#ifdef DEBUG_ENABLED
-			if (unlikely(debug_stringname)) {
-				_data->debug_references++;
-			}
-#endif
-		}
-
-		return;
-	}
-
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_data = _intern(String::hash(p_name), p_name, p_static);
 }
 
 StringName::StringName(const StaticCString &p_static_string, bool p_static) {
@@ -268,57 +340,7 @@ StringName::StringName(const StaticCString &p_static_string, bool p_static) {
 
 	ERR_FAIL_COND(!p_static_string.ptr || !p_static_string.ptr[0]);
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = String::hash(p_static_string.ptr);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_static_string.ptr) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			if (p_static) {
-				_data->static_count.increment();
-			}
-#ifdef DEBUG_ENABLED
-			if (unlikely(debug_stringname)) {
-				_data->debug_references++;
-			}
-#endif
-			return;
-		}
-	}
-
-	_data = memnew(_Data);
-
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = p_static_string.ptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_data = _intern(String::hash(p_static_string.ptr), p_static_string.ptr, p_static, p_static_string.ptr);
 }
 
 StringName::StringName(const String &p_name, bool p_static) {
@@ -330,56 +352,7 @@ StringName::StringName(const String &p_name, bool p_static) {
 		return;
 	}
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = p_name.hash();
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			if (p_static) {
-				_data->static_count.increment();
-			}
-#ifdef DEBUG_ENABLED
-			if (unlikely(debug_stringname)) {
-				_data->debug_references++;
-			}
-#endif
-			return;
-		}
-	}
-
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
-
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_data = _intern(p_name.hash(), p_name, p_static);
 }
 
 StringName StringName::search(const char *p_name) {
@@ -390,29 +363,14 @@ StringName StringName::search(const char *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = String::hash(p_name);
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
+	_Data *data = _find(String::hash(p_name), p_name);
+	if (data) {
 #ifdef DEBUG_ENABLED
 		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
+			data->debug_references.increment();
 		}
 #endif
-
-		return StringName(_data);
+		return StringName(data);
 	}
 
 	return StringName(); //does not exist
@@ -426,24 +384,9 @@ StringName StringName::search(const char32_t *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = String::hash(p_name);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		return StringName(_data);
+	_Data *data = _find(String::hash(p_name), p_name);
+	if (data) {
+		return StringName(data);
 	}
 
 	return StringName(); //does not exist
@@ -452,29 +395,14 @@ StringName StringName::search(const char32_t *p_name) {
 StringName StringName::search(const String &p_name) {
 	ERR_FAIL_COND_V(p_name.is_empty(), StringName());
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = p_name.hash();
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && p_name == _data->get_name()) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
+	_Data *data = _find(p_name.hash(), p_name);
+	if (data) {
 #ifdef DEBUG_ENABLED
 		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
+			data->debug_references.increment();
 		}
 #endif
-		return StringName(_data);
+		return StringName(data);
 	}
 
 	return StringName(); //does not exist
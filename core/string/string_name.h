@@ -35,6 +35,8 @@
 #include "core/string/ustring.h"
 #include "core/templates/safe_refcount.h"
 
+#include <atomic>
+
 #define UNIQUE_NODE_PREFIX "%"
 
 class Main;
@@ -48,7 +50,10 @@ class StringName {
 	enum {
 		STRING_TABLE_BITS = 16,
 		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		STRING_TABLE_MASK = STRING_TABLE_LEN - 1,
+		STRING_TABLE_SHARD_BITS = 6,
+		STRING_TABLE_SHARDS = 1 << STRING_TABLE_SHARD_BITS,
+		STRING_TABLE_SHARD_MASK = STRING_TABLE_SHARDS - 1
 	};
 
 	struct _Data {
@@ -57,17 +62,26 @@ class StringName {
 		const char *cname = nullptr;
 		String name;
 #ifdef DEBUG_ENABLED
-		uint32_t debug_references = 0;
+		SafeNumeric<uint32_t> debug_references;
 #endif
 		String get_name() const { return cname ? String(cname) : name; }
 		int idx = 0;
 		uint32_t hash = 0;
-		_Data *prev = nullptr;
-		_Data *next = nullptr;
+		_Data *prev = nullptr; // Once removed from the table, links the shard's retired entries instead.
+		std::atomic<_Data *> next = { nullptr };
 		_Data() {}
 	};
 
-	static _Data *_table[STRING_TABLE_LEN];
+	// Buckets are searched without locking. Adding and removing entries locks the shard
+	// owning the bucket, and removed entries are only freed once no search is running in it.
+	struct Shard {
+		BinaryMutex mutex;
+		std::atomic<uint32_t> searches = { 0 };
+		_Data *retired = nullptr;
+	};
+
+	static std::atomic<_Data *> _table[STRING_TABLE_LEN];
+	static Shard _shards[STRING_TABLE_SHARDS];
 
 	_Data *_data = nullptr;
 
@@ -80,14 +94,18 @@ class StringName {
 	friend void register_core_types();
 	friend void unregister_core_types();
 	friend class Main;
-	static Mutex mutex;
+	template <class T>
+	static _Data *_find(uint32_t p_hash, const T &p_name);
+	template <class T>
+	static _Data *_intern(uint32_t p_hash, const T &p_name, bool p_static, const char *p_static_cname = nullptr);
+	static void _free_retired(Shard &p_shard);
 	static void setup();
 	static void cleanup();
 	static bool configured;
 #ifdef DEBUG_ENABLED
 	struct DebugSortReferences {
 		bool operator()(const _Data *p_left, const _Data *p_right) const {
-			return p_left->debug_references > p_right->debug_references;
+			return p_left->debug_references.get() > p_right->debug_references.get();
 		}
 	};
 
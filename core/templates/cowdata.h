@@ -40,6 +40,8 @@
 
 template <class T>
 class Vector;
+template <class T>
+class OwnedVector;
 class String;
 class Char16String;
 class CharString;
@@ -58,6 +60,8 @@ template <class T>
 class CowData {
 	template <class TV>
 	friend class Vector;
+	template <class TV>
+	friend class OwnedVector;
 	friend class String;
 	friend class Char16String;
 	friend class CharString;
@@ -115,6 +119,10 @@ private:
 	void _ref(const CowData &p_from);
 	uint32_t _copy_on_write();
 
+	// If p_unique, the caller guarantees the data is not shared, so no copy on write check is done.
+	template <bool p_ensure_zero, bool p_unique>
+	Error _resize(int p_size);
+
 public:
 	void operator=(const CowData<T> &p_from) { _ref(p_from); }
 
@@ -158,7 +166,7 @@ public:
 	}
 
 	template <bool p_ensure_zero = false>
-	Error resize(int p_size);
+	Error resize(int p_size) { return _resize<p_ensure_zero, false>(p_size); }
 
 	_FORCE_INLINE_ void remove_at(int p_index) {
 		ERR_FAIL_INDEX(p_index, size());
@@ -257,8 +265,8 @@ uint32_t CowData<T>::_copy_on_write() {
 }
 
 template <class T>
-template <bool p_ensure_zero>
-Error CowData<T>::resize(int p_size) {
+template <bool p_ensure_zero, bool p_unique>
+Error CowData<T>::_resize(int p_size) {
 	ERR_FAIL_COND_V(p_size < 0, ERR_INVALID_PARAMETER);
 
 	int current_size = size();
@@ -275,7 +283,7 @@ Error CowData<T>::resize(int p_size) {
 	}
 
 	// possibly changing size, copy on write
-	uint32_t rc = _copy_on_write();
+	uint32_t rc = p_unique ? 1 : _copy_on_write();
 
 	size_t current_alloc_size = _get_alloc_size(current_size);
 	size_t alloc_size;
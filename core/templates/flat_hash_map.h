@@ -0,0 +1,560 @@
+/*************************************************************************/
+/*  flat_hash_map.h                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef FLAT_HASH_MAP_H
+#define FLAT_HASH_MAP_H
+
+#include "core/os/memory.h"
+#include "core/templates/hashfuncs.h"
+#include "core/templates/pair.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLAT_HASH_MAP_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+ * A HashMap implementation that stores its entries inplace, in a single
+ * allocation, and probes them in groups of 16 (like Abseil's SwissTable).
+ *
+ * Next to each entry there is a control byte, holding 7 bits of the entry's
+ * hash or marking the entry as empty or deleted. Lookups compare a whole group
+ * of control bytes at once (with SSE2 when available) and only compare keys
+ * whose hash bits match, so most lookups touch one group of control bytes and
+ * one entry.
+ *
+ * Unlike HashMap, the iteration order is arbitrary and inserting may move
+ * entries, so pointers and iterators to entries are invalidated by insertions.
+ * Erasing does not move entries, so it's fine to erase while iterating.
+ *
+ * The assignment operator copies the pairs from one map to the other.
+ */
+template <class TKey, class TValue,
+		class Hasher = HashMapHasherDefault,
+		class Comparator = HashMapComparatorDefault<TKey>>
+class FlatHashMap {
+public:
+	static constexpr uint32_t GROUP_WIDTH = 16;
+	static constexpr uint32_t MIN_CAPACITY = GROUP_WIDTH;
+
+private:
+	typedef KeyValue<TKey, TValue> Entry;
+
+	static constexpr int8_t CTRL_EMPTY = -128;
+	static constexpr int8_t CTRL_DELETED = -2;
+
+	// Capacity is a power of two, or zero before the first allocation.
+	// The control bytes follow the entries, and their first group is repeated
+	// after the last one, so a group can be loaded from any position.
+	KeyValue<TKey, TValue> *entries = nullptr;
+	int8_t *ctrl = nullptr;
+	uint32_t capacity = 0;
+	uint32_t num_elements = 0;
+	uint32_t growth_left = 0; // Empty entries that can still be used before growing.
+
+	static _FORCE_INLINE_ uint32_t _count_trailing_zeros(uint32_t p_mask) {
+#if defined(__GNUC__)
+		return __builtin_ctz(p_mask);
+#elif defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward(&index, p_mask);
+		return index;
+#else
+		uint32_t count = 0;
+		while (!(p_mask & 1)) {
+			p_mask >>= 1;
+			count++;
+		}
+		return count;
+#endif
+	}
+
+	// Leading zeros of a group mask, counting from bit 15.
+	static _FORCE_INLINE_ uint32_t _count_leading_zeros_16(uint32_t p_mask) {
+		uint32_t count = 0;
+		for (uint32_t bit = 1 << (GROUP_WIDTH - 1); bit && !(p_mask & bit); bit >>= 1) {
+			count++;
+		}
+		return count;
+	}
+
+	struct Group {
+#ifdef FLAT_HASH_MAP_SSE2
+		__m128i bytes;
+
+		_FORCE_INLINE_ uint32_t match(int8_t p_value) const {
+			return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(p_value), bytes));
+		}
+
+		// Empty and deleted are the only ones with the sign bit set.
+		_FORCE_INLINE_ uint32_t match_empty_or_deleted() const {
+			return _mm_movemask_epi8(bytes);
+		}
+
+		_FORCE_INLINE_ explicit Group(const int8_t *p_ctrl) {
+			bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_ctrl));
+		}
+#else
+		const int8_t *bytes;
+
+		_FORCE_INLINE_ uint32_t match(int8_t p_value) const {
+			uint32_t mask = 0;
+			for (uint32_t i = 0; i < GROUP_WIDTH; i++) {
+				mask |= uint32_t(bytes[i] == p_value) << i;
+			}
+			return mask;
+		}
+
+		_FORCE_INLINE_ uint32_t match_empty_or_deleted() const {
+			uint32_t mask = 0;
+			for (uint32_t i = 0; i < GROUP_WIDTH; i++) {
+				mask |= uint32_t(bytes[i] < 0) << i;
+			}
+			return mask;
+		}
+
+		_FORCE_INLINE_ explicit Group(const int8_t *p_ctrl) {
+			bytes = p_ctrl;
+		}
+#endif
+		_FORCE_INLINE_ uint32_t match_empty() const {
+			return match(CTRL_EMPTY);
+		}
+	};
+
+	// The low bits pick the first group, the high ones go to the control byte.
+	static _FORCE_INLINE_ int8_t _hash_ctrl(uint32_t p_hash) {
+		return int8_t(p_hash >> 25);
+	}
+
+	static _FORCE_INLINE_ uint32_t _max_elements(uint32_t p_capacity) {
+		return p_capacity - p_capacity / 8;
+	}
+
+	_FORCE_INLINE_ void _set_ctrl(uint32_t p_pos, int8_t p_value) {
+		ctrl[p_pos] = p_value;
+		if (p_pos < GROUP_WIDTH) {
+			ctrl[capacity + p_pos] = p_value;
+		}
+	}
+
+	// Groups are visited at triangular offsets, which reach all of them as the capacity is a power of two.
+	bool _lookup_pos(const TKey &p_key, uint32_t &r_pos) const {
+		if (num_elements == 0) {
+			return false;
+		}
+
+		const uint32_t hash = Hasher::hash(p_key);
+		const int8_t hash_ctrl = _hash_ctrl(hash);
+		const uint32_t mask = capacity - 1;
+		uint32_t pos = hash & mask;
+		uint32_t step = 0;
+
+		while (true) {
+			const Group group(ctrl + pos);
+			uint32_t matches = group.match(hash_ctrl);
+			while (matches) {
+				const uint32_t candidate = (pos + _count_trailing_zeros(matches)) & mask;
+				if (likely(Comparator::compare(entries[candidate].key, p_key))) {
+					r_pos = candidate;
+					return true;
+				}
+				matches &= matches - 1;
+			}
+
+			if (likely(group.match_empty())) {
+				return false;
+			}
+
+			step += GROUP_WIDTH;
+			pos = (pos + step) & mask;
+		}
+	}
+
+	uint32_t _find_free_pos(uint32_t p_hash) const {
+		const uint32_t mask = capacity - 1;
+		uint32_t pos = p_hash & mask;
+		uint32_t step = 0;
+
+		while (true) {
+			const uint32_t free = Group(ctrl + pos).match_empty_or_deleted();
+			if (free) {
+				return (pos + _count_trailing_zeros(free)) & mask;
+			}
+
+			step += GROUP_WIDTH;
+			pos = (pos + step) & mask;
+		}
+	}
+
+	void _resize_and_rehash(uint32_t p_new_capacity) {
+		KeyValue<TKey, TValue> *old_entries = entries;
+		int8_t *old_ctrl = ctrl;
+		const uint32_t old_capacity = capacity;
+
+		capacity = MAX(p_new_capacity, MIN_CAPACITY);
+		void *data = Memory::alloc_static(sizeof(KeyValue<TKey, TValue>) * capacity + capacity + GROUP_WIDTH);
+		entries = reinterpret_cast<KeyValue<TKey, TValue> *>(data);
+		ctrl = reinterpret_cast<int8_t *>(entries + capacity);
+		memset(ctrl, CTRL_EMPTY, capacity + GROUP_WIDTH);
+		growth_left = _max_elements(capacity) - num_elements;
+
+		if (old_entries == nullptr) {
+			return;
+		}
+
+		for (uint32_t i = 0; i < old_capacity; i++) {
+			if (old_ctrl[i] < 0) {
+				continue;
+			}
+
+			const uint32_t pos = _find_free_pos(Hasher::hash(old_entries[i].key));
+			memnew_placement(&entries[pos], Entry(old_entries[i].key, old_entries[i].value));
+			_set_ctrl(pos, old_ctrl[i]);
+			old_entries[i].~KeyValue<TKey, TValue>();
+		}
+
+		Memory::free_static(old_entries);
+	}
+
+	_FORCE_INLINE_ KeyValue<TKey, TValue> *_insert(const TKey &p_key, const TValue &p_value) {
+		uint32_t pos = 0;
+		if (_lookup_pos(p_key, pos)) {
+			entries[pos].value = p_value;
+			return &entries[pos];
+		}
+
+		if (unlikely(entries == nullptr)) {
+			// Allocate on demand to save memory.
+			_resize_and_rehash(MIN_CAPACITY);
+		}
+
+		const uint32_t hash = Hasher::hash(p_key);
+		pos = _find_free_pos(hash);
+
+		if (unlikely(growth_left == 0 && ctrl[pos] != CTRL_DELETED)) {
+			// Full of live and deleted entries. Grow if mostly live, else just clean the deleted ones up.
+			_resize_and_rehash(num_elements >= _max_elements(capacity) / 2 ? capacity * 2 : capacity);
+			pos = _find_free_pos(hash);
+		}
+
+		if (ctrl[pos] == CTRL_EMPTY) {
+			growth_left--;
+		}
+
+		memnew_placement(&entries[pos], Entry(p_key, p_value));
+		_set_ctrl(pos, _hash_ctrl(hash));
+		num_elements++;
+		return &entries[pos];
+	}
+
+public:
+	_FORCE_INLINE_ uint32_t get_capacity() const { return capacity; }
+	_FORCE_INLINE_ uint32_t size() const { return num_elements; }
+
+	/* Standard Godot Container API */
+
+	bool is_empty() const {
+		return num_elements == 0;
+	}
+
+	void clear() {
+		if (entries == nullptr) {
+			return;
+		}
+
+		for (uint32_t i = 0; i < capacity; i++) {
+			if (ctrl[i] >= 0) {
+				entries[i].~KeyValue<TKey, TValue>();
+			}
+		}
+
+		memset(ctrl, CTRL_EMPTY, capacity + GROUP_WIDTH);
+		num_elements = 0;
+		growth_left = _max_elements(capacity);
+	}
+
+	TValue &get(const TKey &p_key) {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		CRASH_COND_MSG(!exists, "FlatHashMap key not found.");
+		return entries[pos].value;
+	}
+
+	const TValue &get(const TKey &p_key) const {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		CRASH_COND_MSG(!exists, "FlatHashMap key not found.");
+		return entries[pos].value;
+	}
+
+	const TValue *getptr(const TKey &p_key) const {
+		uint32_t pos = 0;
+		if (_lookup_pos(p_key, pos)) {
+			return &entries[pos].value;
+		}
+		return nullptr;
+	}
+
+	TValue *getptr(const TKey &p_key) {
+		uint32_t pos = 0;
+		if (_lookup_pos(p_key, pos)) {
+			return &entries[pos].value;
+		}
+		return nullptr;
+	}
+
+	_FORCE_INLINE_ bool has(const TKey &p_key) const {
+		uint32_t _pos = 0;
+		return _lookup_pos(p_key, _pos);
+	}
+
+	bool erase(const TKey &p_key) {
+		uint32_t pos = 0;
+		if (!_lookup_pos(p_key, pos)) {
+			return false;
+		}
+
+		entries[pos].~KeyValue<TKey, TValue>();
+		num_elements--;
+
+		// If every group containing this position also has an empty one, no lookup
+		// ever probed past it, so it can become empty again instead of deleted.
+		const uint32_t empty_before = Group(ctrl + ((pos - GROUP_WIDTH) & (capacity - 1))).match_empty();
+		const uint32_t empty_after = Group(ctrl + pos).match_empty();
+		if (empty_before && empty_after && _count_leading_zeros_16(empty_before) + _count_trailing_zeros(empty_after) < GROUP_WIDTH) {
+			_set_ctrl(pos, CTRL_EMPTY);
+			growth_left++;
+		} else {
+			_set_ctrl(pos, CTRL_DELETED);
+		}
+
+		return true;
+	}
+
+	// Reserves space for a number of elements, useful to avoid many resizes and rehashes.
+	void reserve(uint32_t p_new_capacity) {
+		uint32_t new_capacity = MIN_CAPACITY;
+		while (_max_elements(new_capacity) < p_new_capacity) {
+			ERR_FAIL_COND_MSG(new_capacity >= (1u << 31), "Hash table maximum capacity reached.");
+			new_capacity *= 2;
+		}
+
+		if (new_capacity <= capacity) {
+			return;
+		}
+		_resize_and_rehash(new_capacity);
+	}
+
+	/** Iterator API **/
+
+	struct ConstIterator {
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> &operator*() const {
+			return entries[pos];
+		}
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> *operator->() const { return &entries[pos]; }
+		_FORCE_INLINE_ ConstIterator &operator++() {
+			pos = _next_pos(ctrl, capacity, pos + 1);
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const ConstIterator &b) const { return pos == b.pos && entries == b.entries; }
+		_FORCE_INLINE_ bool operator!=(const ConstIterator &b) const { return pos != b.pos || entries != b.entries; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return pos < capacity;
+		}
+
+		_FORCE_INLINE_ ConstIterator(const KeyValue<TKey, TValue> *p_entries, const int8_t *p_ctrl, uint32_t p_capacity, uint32_t p_pos) :
+				entries(p_entries), ctrl(p_ctrl), capacity(p_capacity), pos(p_pos) {}
+		_FORCE_INLINE_ ConstIterator() {}
+
+	private:
+		const KeyValue<TKey, TValue> *entries = nullptr;
+		const int8_t *ctrl = nullptr;
+		uint32_t capacity = 0;
+		uint32_t pos = 0;
+	};
+
+	struct Iterator {
+		_FORCE_INLINE_ KeyValue<TKey, TValue> &operator*() const {
+			return entries[pos];
+		}
+		_FORCE_INLINE_ KeyValue<TKey, TValue> *operator->() const { return &entries[pos]; }
+		_FORCE_INLINE_ Iterator &operator++() {
+			pos = _next_pos(ctrl, capacity, pos + 1);
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const Iterator &b) const { return pos == b.pos && entries == b.entries; }
+		_FORCE_INLINE_ bool operator!=(const Iterator &b) const { return pos != b.pos || entries != b.entries; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return pos < capacity;
+		}
+
+		_FORCE_INLINE_ Iterator(KeyValue<TKey, TValue> *p_entries, const int8_t *p_ctrl, uint32_t p_capacity, uint32_t p_pos) :
+				entries(p_entries), ctrl(p_ctrl), capacity(p_capacity), pos(p_pos) {}
+		_FORCE_INLINE_ Iterator() {}
+
+		operator ConstIterator() const {
+			return ConstIterator(entries, ctrl, capacity, pos);
+		}
+
+	private:
+		KeyValue<TKey, TValue> *entries = nullptr;
+		const int8_t *ctrl = nullptr;
+		uint32_t capacity = 0;
+		uint32_t pos = 0;
+	};
+
+private:
+	// First used position from p_pos, or p_capacity if there are none.
+	static _FORCE_INLINE_ uint32_t _next_pos(const int8_t *p_ctrl, uint32_t p_capacity, uint32_t p_pos) {
+		while (p_pos < p_capacity && p_ctrl[p_pos] < 0) {
+			p_pos++;
+		}
+		return p_pos;
+	}
+
+	_FORCE_INLINE_ Iterator _make_iterator(uint32_t p_pos) {
+		return Iterator(entries, ctrl, capacity, p_pos);
+	}
+
+	_FORCE_INLINE_ ConstIterator _make_iterator(uint32_t p_pos) const {
+		return ConstIterator(entries, ctrl, capacity, p_pos);
+	}
+
+public:
+	_FORCE_INLINE_ Iterator begin() {
+		return _make_iterator(num_elements ? _next_pos(ctrl, capacity, 0) : capacity);
+	}
+	_FORCE_INLINE_ Iterator end() {
+		return _make_iterator(capacity);
+	}
+
+	_FORCE_INLINE_ Iterator find(const TKey &p_key) {
+		uint32_t pos = 0;
+		if (!_lookup_pos(p_key, pos)) {
+			return end();
+		}
+		return _make_iterator(pos);
+	}
+
+	_FORCE_INLINE_ void remove(const Iterator &p_iter) {
+		if (p_iter) {
+			erase(p_iter->key);
+		}
+	}
+
+	_FORCE_INLINE_ ConstIterator begin() const {
+		return _make_iterator(num_elements ? _next_pos(ctrl, capacity, 0) : capacity);
+	}
+	_FORCE_INLINE_ ConstIterator end() const {
+		return _make_iterator(capacity);
+	}
+
+	_FORCE_INLINE_ ConstIterator find(const TKey &p_key) const {
+		uint32_t pos = 0;
+		if (!_lookup_pos(p_key, pos)) {
+			return end();
+		}
+		return _make_iterator(pos);
+	}
+
+	/* Indexing */
+
+	const TValue &operator[](const TKey &p_key) const {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		CRASH_COND(!exists);
+		return entries[pos].value;
+	}
+
+	TValue &operator[](const TKey &p_key) {
+		uint32_t pos = 0;
+		if (!_lookup_pos(p_key, pos)) {
+			return _insert(p_key, TValue())->value;
+		}
+		return entries[pos].value;
+	}
+
+	/* Insert */
+
+	Iterator insert(const TKey &p_key, const TValue &p_value) {
+		return _make_iterator(uint32_t(_insert(p_key, p_value) - entries));
+	}
+
+	/* Constructors */
+
+	FlatHashMap(const FlatHashMap &p_other) {
+		if (p_other.num_elements == 0) {
+			return;
+		}
+
+		reserve(p_other.num_elements);
+
+		for (const KeyValue<TKey, TValue> &E : p_other) {
+			insert(E.key, E.value);
+		}
+	}
+
+	void operator=(const FlatHashMap &p_other) {
+		if (this == &p_other) {
+			return; // Ignore self assignment.
+		}
+
+		clear();
+		reserve(p_other.num_elements);
+
+		for (const KeyValue<TKey, TValue> &E : p_other) {
+			insert(E.key, E.value);
+		}
+	}
+
+	FlatHashMap(uint32_t p_initial_capacity) {
+		reserve(p_initial_capacity);
+	}
+	FlatHashMap() {}
+
+	~FlatHashMap() {
+		clear();
+
+		if (entries != nullptr) {
+			Memory::free_static(entries);
+		}
+	}
+};
+
+#endif // FLAT_HASH_MAP_H
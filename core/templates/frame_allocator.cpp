@@ -0,0 +1,315 @@
+/*************************************************************************/
+/*  frame_allocator.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "frame_allocator.h"
+
+#include "core/error/error_macros.h"
+#include "core/os/memory.h"
+#include "core/templates/safe_refcount.h"
+
+#include <atomic>
+#include <string.h>
+
+namespace {
+
+struct Arena;
+
+// Precedes every allocation.
+struct AllocationHeader {
+	Arena *arena;
+	size_t size; // Usable size, a multiple of ALIGNMENT.
+};
+
+struct Block {
+	Block *next;
+	size_t size; // Usable size, after the header.
+};
+
+constexpr size_t HEADER_SIZE = FrameAllocator::ALIGNMENT;
+static_assert(sizeof(AllocationHeader) <= HEADER_SIZE);
+static_assert(sizeof(Block) <= HEADER_SIZE);
+
+// Frames after which an arena that never became empty is reported.
+constexpr uint64_t PINNED_FRAMES_WARNING = 8;
+
+std::atomic<uint64_t> current_frame(0);
+
+struct Arena {
+	Block *blocks = nullptr; // Newest first, allocations are bumped from the newest one.
+	uint8_t *pos = nullptr;
+	uint8_t *end = nullptr;
+	AllocationHeader *last = nullptr;
+
+	// Allocations minus frees done by the owner thread. Frees from other threads are
+	// subtracted from remote instead, and the owner adds its live count to it when exiting,
+	// so remote only reaches zero once the owner is gone and everything was freed.
+	uint32_t live = 0;
+	SafeNumeric<uint32_t> remote;
+
+	size_t used = 0;
+	size_t reserved = 0;
+	size_t frame_peak = 0;
+	uint64_t frame = 0; // Frame in which the arena was last rewound.
+};
+
+thread_local Arena *thread_arena = nullptr;
+thread_local bool thread_arena_released = false;
+
+_FORCE_INLINE_ size_t align_size(size_t p_bytes) {
+	return (p_bytes + FrameAllocator::ALIGNMENT - 1) & ~size_t(FrameAllocator::ALIGNMENT - 1);
+}
+
+_FORCE_INLINE_ AllocationHeader *get_header(void *p_ptr) {
+	return (AllocationHeader *)((uint8_t *)p_ptr - HEADER_SIZE);
+}
+
+_FORCE_INLINE_ bool is_idle(const Arena *p_arena) {
+	return p_arena->live + p_arena->remote.get() == 0;
+}
+
+bool add_block(Arena *p_arena, size_t p_size) {
+	Block *block = (Block *)memalloc(HEADER_SIZE + p_size);
+	if (!block) {
+		return false;
+	}
+	block->next = p_arena->blocks;
+	block->size = p_size;
+	p_arena->blocks = block;
+	p_arena->pos = (uint8_t *)block + HEADER_SIZE;
+	p_arena->end = p_arena->pos + p_size;
+	p_arena->reserved += HEADER_SIZE + p_size;
+	return true;
+}
+
+void free_blocks(Arena *p_arena, Block *p_first) {
+	while (p_first) {
+		Block *next = p_first->next;
+		p_arena->reserved -= HEADER_SIZE + p_first->size;
+		memfree(p_first);
+		p_first = next;
+	}
+}
+
+void destroy_arena(Arena *p_arena) {
+	free_blocks(p_arena, p_arena->blocks);
+	memdelete(p_arena);
+}
+
+// Must only be called by the owner thread while the arena is idle.
+void rewind(Arena *p_arena) {
+	uint64_t frame = current_frame.load(std::memory_order_relaxed);
+	if (p_arena->frame != frame) {
+		// Drop the memory the last frames did not need.
+		size_t keep = FrameAllocator::DEFAULT_BLOCK_SIZE;
+		while (keep < p_arena->frame_peak) {
+			keep <<= 1;
+		}
+		if (p_arena->blocks && p_arena->blocks->size > keep * 2) {
+			free_blocks(p_arena, p_arena->blocks);
+			p_arena->blocks = nullptr;
+			p_arena->pos = nullptr;
+			p_arena->end = nullptr;
+		}
+		p_arena->frame = frame;
+		p_arena->frame_peak = 0;
+	}
+
+	if (p_arena->blocks) {
+		// Only the newest block is kept, it's the largest.
+		free_blocks(p_arena, p_arena->blocks->next);
+		p_arena->blocks->next = nullptr;
+		p_arena->pos = (uint8_t *)p_arena->blocks + HEADER_SIZE;
+	}
+	p_arena->last = nullptr;
+	p_arena->used = 0;
+}
+
+_FORCE_INLINE_ void *bump(Arena *p_arena, size_t p_size) {
+	AllocationHeader *header = (AllocationHeader *)p_arena->pos;
+	header->arena = p_arena;
+	header->size = p_size;
+	p_arena->pos += HEADER_SIZE + p_size;
+	p_arena->last = header;
+	p_arena->live++;
+	p_arena->used += HEADER_SIZE + p_size;
+	if (p_arena->used > p_arena->frame_peak) {
+		p_arena->frame_peak = p_arena->used;
+	}
+	return (uint8_t *)header + HEADER_SIZE;
+}
+
+struct ThreadArenaReleaser {
+	void touch() {}
+	~ThreadArenaReleaser() {
+		Arena *arena = thread_arena;
+		thread_arena = nullptr;
+		thread_arena_released = true;
+		if (arena && arena->remote.add(arena->live) == 0) {
+			destroy_arena(arena);
+		}
+	}
+};
+
+thread_local ThreadArenaReleaser thread_arena_releaser;
+
+Arena *create_thread_arena() {
+	if (thread_arena_released) {
+		return nullptr;
+	}
+	Arena *arena = memnew(Arena);
+	arena->frame = current_frame.load(std::memory_order_relaxed);
+	thread_arena = arena;
+	thread_arena_releaser.touch(); // Constructs it, so the arena is released on thread exit.
+	return arena;
+}
+
+// Used while the thread is exiting. The allocation gets an arena of its own, which goes
+// away when it's freed.
+void *alloc_detached(size_t p_size) {
+	Arena *arena = memnew(Arena);
+	if (!add_block(arena, HEADER_SIZE + p_size)) {
+		memdelete(arena);
+		return nullptr;
+	}
+	void *ptr = bump(arena, p_size);
+	arena->remote.add(arena->live);
+	return ptr;
+}
+
+} // namespace
+
+void *FrameAllocator::alloc(size_t p_bytes) {
+	size_t size = align_size(p_bytes);
+	Arena *arena = thread_arena;
+
+	if (unlikely(!arena)) {
+		arena = create_thread_arena();
+		if (unlikely(!arena)) {
+			return alloc_detached(size);
+		}
+	}
+
+	if (is_idle(arena)) {
+		rewind(arena);
+	}
+
+	if (unlikely(size_t(arena->end - arena->pos) < HEADER_SIZE + size)) {
+#ifdef DEBUG_ENABLED
+		if (arena->frame + PINNED_FRAMES_WARNING < current_frame.load(std::memory_order_relaxed)) {
+			WARN_PRINT_ONCE("Frame allocations are being kept across frames, so their arena can't be reused and keeps growing.");
+		}
+#endif
+		size_t block_size = arena->blocks ? arena->blocks->size * 2 : size_t(DEFAULT_BLOCK_SIZE);
+		while (block_size < HEADER_SIZE + size) {
+			block_size <<= 1;
+		}
+		if (!add_block(arena, block_size)) {
+			return nullptr;
+		}
+	}
+
+	return bump(arena, size);
+}
+
+void *FrameAllocator::realloc(void *p_ptr, size_t p_bytes) {
+	if (!p_ptr) {
+		return alloc(p_bytes);
+	}
+	if (p_bytes == 0) {
+		free(p_ptr);
+		return nullptr;
+	}
+
+	AllocationHeader *header = get_header(p_ptr);
+	size_t size = align_size(p_bytes);
+	Arena *arena = thread_arena;
+
+	if (header->arena == arena && header == arena->last) {
+		// Most recent allocation, so it can be resized in place as long as it fits.
+		uint8_t *new_end = (uint8_t *)p_ptr + size;
+		if (new_end <= arena->end) {
+			arena->used = arena->used - header->size + size;
+			if (arena->used > arena->frame_peak) {
+				arena->frame_peak = arena->used;
+			}
+			arena->pos = new_end;
+			header->size = size;
+			return p_ptr;
+		}
+	} else if (size <= header->size) {
+		return p_ptr;
+	}
+
+	void *new_ptr = alloc(p_bytes);
+	if (new_ptr) {
+		memcpy(new_ptr, p_ptr, MIN(header->size, size));
+		free(p_ptr);
+	}
+	return new_ptr;
+}
+
+void FrameAllocator::free(void *p_ptr) {
+	if (!p_ptr) {
+		return;
+	}
+
+	AllocationHeader *header = get_header(p_ptr);
+	Arena *arena = header->arena;
+
+	if (arena == thread_arena) {
+		if (header == arena->last) {
+			arena->pos = (uint8_t *)header;
+			arena->used -= HEADER_SIZE + header->size;
+			arena->last = nullptr;
+		}
+		arena->live--;
+	} else if (arena->remote.decrement() == 0) {
+		// The owner thread is gone, and this was its last allocation.
+		destroy_arena(arena);
+	}
+}
+
+void FrameAllocator::advance_frame() {
+	current_frame.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t FrameAllocator::get_frame() {
+	return current_frame.load(std::memory_order_relaxed);
+}
+
+size_t FrameAllocator::get_thread_used_bytes() {
+	Arena *arena = thread_arena;
+	return arena ? arena->used : 0;
+}
+
+size_t FrameAllocator::get_thread_reserved_bytes() {
+	Arena *arena = thread_arena;
+	return arena ? arena->reserved : 0;
+}
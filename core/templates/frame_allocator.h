@@ -0,0 +1,76 @@
+/*************************************************************************/
+/*  frame_allocator.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef FRAME_ALLOCATOR_H
+#define FRAME_ALLOCATOR_H
+
+#include "core/templates/local_vector.h"
+#include "core/typedefs.h"
+
+#include <stddef.h>
+
+// Per-thread bump allocator for transient data, such as scratch arrays rebuilt every
+// frame. Allocating is a pointer bump in the calling thread's arena, and freeing only
+// releases memory when it's the most recent allocation.
+//
+// An arena rewinds to its start as soon as everything allocated from it has been freed,
+// and trims the memory it keeps once per frame (see advance_frame()), so allocations
+// should not outlive the frame they were made in: a long-lived allocation pins every
+// allocation made after it by the same thread.
+//
+// Memory can be freed from any thread, and an arena is kept alive after its thread
+// exits until its last allocation is freed.
+class FrameAllocator {
+public:
+	enum {
+		ALIGNMENT = 16,
+		DEFAULT_BLOCK_SIZE = 64 * 1024,
+	};
+
+	static void *alloc(size_t p_bytes);
+	static void *realloc(void *p_ptr, size_t p_bytes);
+	static void free(void *p_ptr);
+
+	// Called once per frame from Main::iteration(). Arenas pick the new frame up lazily
+	// on their next allocation.
+	static void advance_frame();
+	static uint64_t get_frame();
+
+	// Usage of the calling thread's arena.
+	static size_t get_thread_used_bytes();
+	static size_t get_thread_reserved_bytes();
+};
+
+// LocalVector allocating from the calling thread's frame arena. Growth happens in place
+// while it's the thread's most recent allocation.
+template <class T, class U = uint32_t, bool force_trivial = false, bool tight = false>
+using FrameLocalVector = LocalVector<T, U, force_trivial, tight, FrameAllocator>;
+
+#endif // FRAME_ALLOCATOR_H
@@ -0,0 +1,175 @@
+/*************************************************************************/
+/*  owned_vector.h                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef OWNED_VECTOR_H
+#define OWNED_VECTOR_H
+
+#include "core/error/error_macros.h"
+#include "core/templates/cowdata.h"
+#include "core/templates/vector.h"
+
+#include <initializer_list>
+
+// Array with the same storage as Vector (and thus the Packed*Array types), but which is
+// never shared. Writes need no copy on write checks, which keeps tight loops free of
+// refcount traffic and lets the compiler optimize them like plain arrays.
+//
+// Conversions are zero-copy: take() adopts the data of a Vector that's not shared, and
+// release() hands the data over to a Vector, to be used with Variant and the servers.
+template <class T>
+class OwnedVector {
+	CowData<T> _cowdata; // Its refcount is always 1.
+
+public:
+	_FORCE_INLINE_ T *ptrw() { return _cowdata._ptr; }
+	_FORCE_INLINE_ const T *ptr() const { return _cowdata._ptr; }
+	_FORCE_INLINE_ int size() const { return _cowdata.size(); }
+	_FORCE_INLINE_ bool is_empty() const { return _cowdata.is_empty(); }
+
+	_FORCE_INLINE_ T &operator[](int p_index) {
+		CRASH_BAD_INDEX(p_index, size());
+		return _cowdata._ptr[p_index];
+	}
+	_FORCE_INLINE_ const T &operator[](int p_index) const {
+		CRASH_BAD_INDEX(p_index, size());
+		return _cowdata._ptr[p_index];
+	}
+	_FORCE_INLINE_ void set(int p_index, const T &p_elem) {
+		ERR_FAIL_INDEX(p_index, size());
+		_cowdata._ptr[p_index] = p_elem;
+	}
+	_FORCE_INLINE_ const T &get(int p_index) const { return operator[](p_index); }
+
+	Error resize(int p_size) { return _cowdata.template _resize<false, true>(p_size); }
+	Error resize_zeroed(int p_size) { return _cowdata.template _resize<true, true>(p_size); }
+	_FORCE_INLINE_ void clear() { resize(0); }
+
+	_FORCE_INLINE_ bool push_back(const T &p_elem) {
+		int s = size();
+		Error err = resize(s + 1);
+		ERR_FAIL_COND_V(err, true);
+		_cowdata._ptr[s] = p_elem;
+		return false;
+	}
+	_FORCE_INLINE_ bool append(const T &p_elem) { return push_back(p_elem); } //alias
+
+	void remove_at(int p_index) {
+		ERR_FAIL_INDEX(p_index, size());
+		T *p = ptrw();
+		int len = size();
+		for (int i = p_index; i < len - 1; i++) {
+			p[i] = p[i + 1];
+		}
+		resize(len - 1);
+	}
+
+	void fill(const T &p_elem) {
+		T *p = ptrw();
+		for (int i = 0; i < size(); i++) {
+			p[i] = p_elem;
+		}
+	}
+
+	int find(const T &p_val, int p_from = 0) const { return _cowdata.find(p_val, p_from); }
+	_FORCE_INLINE_ bool has(const T &p_val) const { return find(p_val) != -1; }
+
+	_FORCE_INLINE_ T *begin() { return ptrw(); }
+	_FORCE_INLINE_ T *end() { return ptrw() + size(); }
+	_FORCE_INLINE_ const T *begin() const { return ptr(); }
+	_FORCE_INLINE_ const T *end() const { return ptr() + size(); }
+
+	// Adopts the data of p_from, leaving it empty. Only copies if the data is shared with
+	// another Vector.
+	static OwnedVector take(Vector<T> &p_from) {
+		OwnedVector owned;
+		owned._cowdata._ptr = p_from._cowdata._ptr;
+		p_from._cowdata._ptr = nullptr;
+		owned._cowdata._copy_on_write();
+		return owned;
+	}
+
+	// Hands the data over to a Vector, leaving this empty.
+	Vector<T> release() {
+		Vector<T> vector;
+		vector._cowdata._ptr = _cowdata._ptr;
+		_cowdata._ptr = nullptr;
+		return vector;
+	}
+
+	// Copies, while leaving this untouched.
+	Vector<T> to_vector() const {
+		Vector<T> vector;
+		vector._cowdata._ref(_cowdata);
+		vector._cowdata._copy_on_write();
+		return vector;
+	}
+
+	void operator=(const OwnedVector &p_from) {
+		if (this == &p_from) {
+			return;
+		}
+		_cowdata._ref(p_from._cowdata);
+		_cowdata._copy_on_write();
+	}
+	void operator=(OwnedVector &&p_from) {
+		if (this == &p_from) {
+			return;
+		}
+		_cowdata._unref(_cowdata._ptr);
+		_cowdata._ptr = p_from._cowdata._ptr;
+		p_from._cowdata._ptr = nullptr;
+	}
+
+	_FORCE_INLINE_ OwnedVector() {}
+	OwnedVector(std::initializer_list<T> p_init) {
+		Error err = resize(p_init.size());
+		ERR_FAIL_COND(err);
+
+		int i = 0;
+		for (const T &element : p_init) {
+			_cowdata._ptr[i++] = element;
+		}
+	}
+	// Copies, use take() to avoid it.
+	explicit OwnedVector(const Vector<T> &p_from) {
+		_cowdata._ref(p_from._cowdata);
+		_cowdata._copy_on_write();
+	}
+	OwnedVector(const OwnedVector &p_from) {
+		_cowdata._ref(p_from._cowdata);
+		_cowdata._copy_on_write();
+	}
+	_FORCE_INLINE_ OwnedVector(OwnedVector &&p_from) {
+		_cowdata._ptr = p_from._cowdata._ptr;
+		p_from._cowdata._ptr = nullptr;
+	}
+};
+
+#endif // OWNED_VECTOR_H
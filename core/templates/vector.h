@@ -58,6 +58,7 @@ public:
 template <class T>
 class Vector {
 	friend class VectorWriteProxy<T>;
+	friend class OwnedVector<T>;
 
 public:
 	VectorWriteProxy<T> write;
@@ -0,0 +1,176 @@
+/*************************************************************************/
+/*  work_stealing_deque.h                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef WORK_STEALING_DEQUE_H
+#define WORK_STEALING_DEQUE_H
+
+#include "core/os/memory.h"
+#include "core/typedefs.h"
+
+#include <atomic>
+#include <type_traits>
+
+// Chase-Lev work stealing deque, following the C11 formulation by Lê et al.
+// ("Correct and Efficient Work-Stealing for Weak Memory Models", 2013).
+//
+// - Only the owner thread may call push() and pop(), which work on the bottom end (LIFO).
+// - Any thread may call steal(), which takes elements from the top end (FIFO).
+//
+// The buffer grows on demand. Buffers that were replaced are kept around until the
+// deque is destroyed, as a thief may still be reading from them.
+
+template <class T>
+class WorkStealingDeque {
+	static_assert(std::is_trivially_copyable<T>::value, "WorkStealingDeque requires trivially copyable elements.");
+
+	struct Buffer {
+		int64_t capacity = 0;
+		int64_t mask = 0;
+		std::atomic<T> *data = nullptr;
+		Buffer *previous = nullptr;
+
+		_FORCE_INLINE_ T get(int64_t p_index) const {
+			return data[p_index & mask].load(std::memory_order_relaxed);
+		}
+		_FORCE_INLINE_ void put(int64_t p_index, T p_value) {
+			data[p_index & mask].store(p_value, std::memory_order_relaxed);
+		}
+	};
+
+	// Top and bottom are written by different threads, keep them on separate cache lines.
+	std::atomic<int64_t> top;
+	uint8_t padding_top[64 - sizeof(std::atomic<int64_t>)];
+	std::atomic<int64_t> bottom;
+	uint8_t padding_bottom[64 - sizeof(std::atomic<int64_t>)];
+	std::atomic<Buffer *> buffer;
+
+	static Buffer *_create_buffer(int64_t p_capacity) {
+		Buffer *b = memnew(Buffer);
+		b->capacity = p_capacity;
+		b->mask = p_capacity - 1;
+		b->data = memnew_arr(std::atomic<T>, p_capacity);
+		return b;
+	}
+
+	Buffer *_grow(Buffer *p_buffer, int64_t p_bottom, int64_t p_top) {
+		Buffer *b = _create_buffer(p_buffer->capacity * 2);
+		for (int64_t i = p_top; i < p_bottom; i++) {
+			b->put(i, p_buffer->get(i));
+		}
+		b->previous = p_buffer;
+		buffer.store(b, std::memory_order_release);
+		return b;
+	}
+
+public:
+	// Owner only.
+	void push(T p_value) {
+		int64_t b = bottom.load(std::memory_order_relaxed);
+		int64_t t = top.load(std::memory_order_acquire);
+		Buffer *a = buffer.load(std::memory_order_relaxed);
+		if (unlikely(b - t > a->capacity - 1)) {
+			a = _grow(a, b, t);
+		}
+		a->put(b, p_value);
+		std::atomic_thread_fence(std::memory_order_release);
+		bottom.store(b + 1, std::memory_order_relaxed);
+	}
+
+	// Owner only.
+	bool pop(T &r_value) {
+		int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+		Buffer *a = buffer.load(std::memory_order_relaxed);
+		bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t t = top.load(std::memory_order_relaxed);
+
+		if (t > b) {
+			// Empty.
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return false;
+		}
+
+		r_value = a->get(b);
+		if (t == b) {
+			// Last element, race against thieves for it.
+			bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return won;
+		}
+		return true;
+	}
+
+	// Any thread. May fail spuriously if another thread took the element first.
+	bool steal(T &r_value) {
+		int64_t t = top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t b = bottom.load(std::memory_order_acquire);
+
+		if (t >= b) {
+			return false;
+		}
+
+		Buffer *a = buffer.load(std::memory_order_acquire);
+		T value = a->get(t);
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			return false;
+		}
+		r_value = value;
+		return true;
+	}
+
+	// Approximate when called concurrently with other operations.
+	_FORCE_INLINE_ bool is_empty() const {
+		return bottom.load(std::memory_order_acquire) <= top.load(std::memory_order_acquire);
+	}
+
+	_FORCE_INLINE_ int64_t size() const {
+		int64_t s = bottom.load(std::memory_order_acquire) - top.load(std::memory_order_acquire);
+		return s > 0 ? s : 0;
+	}
+
+	WorkStealingDeque(uint32_t p_initial_capacity = 256) {
+		top.store(0, std::memory_order_relaxed);
+		bottom.store(0, std::memory_order_relaxed);
+		buffer.store(_create_buffer(nearest_power_of_2_templated(MAX(p_initial_capacity, 2u))), std::memory_order_relaxed);
+	}
+
+	~WorkStealingDeque() {
+		Buffer *b = buffer.load(std::memory_order_relaxed);
+		while (b) {
+			Buffer *previous = b->previous;
+			memdelete_arr(b->data);
+			memdelete(b);
+			b = previous;
+		}
+	}
+};
+
+#endif // WORK_STEALING_DEQUE_H
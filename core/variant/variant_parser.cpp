@@ -68,6 +68,35 @@ bool VariantParser::StreamString::is_eof() const {
 	return pos > s.length();
 }
 
+char32_t VariantParser::StreamBuffer::get_char() {
+	if (pos >= length) {
+		// Like files, EOF is only reported after trying to read past the end.
+		pos = length + 1;
+		return 0;
+	}
+	return data[pos++];
+}
+
+bool VariantParser::StreamBuffer::is_utf8() const {
+	return true;
+}
+
+bool VariantParser::StreamBuffer::is_eof() const {
+	return pos > length;
+}
+
+const uint8_t *VariantParser::StreamBuffer::get_unread_data(uint64_t &r_length) const {
+	if (pos >= length) {
+		return nullptr;
+	}
+	r_length = length - pos;
+	return data + pos;
+}
+
+void VariantParser::StreamBuffer::advance(uint64_t p_length) {
+	pos = MIN(pos + p_length, length);
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 const char *VariantParser::tk_name[TK_MAX] = {
@@ -491,6 +520,136 @@ Error VariantParser::_parse_enginecfg(Stream *p_stream, Vector<String> &strings,
 	}
 }
 
+template <class T>
+bool VariantParser::_parse_construct_buffer(Stream *p_stream, Vector<T> &r_construct, int &line, bool &r_first) {
+	uint64_t length = 0;
+	const uint8_t *data = p_stream->get_unread_data(length);
+	if (!data || p_stream->saved) {
+		return false;
+	}
+	const uint8_t *end = data + length;
+
+	// Size the array for every comma before the next ')', the common case of a plain list of numbers.
+	int64_t old_size = r_construct.size();
+	int64_t count = 0;
+	const uint8_t *close = (const uint8_t *)memchr(data, ')', length);
+	if (close) {
+		count = 1;
+		for (const uint8_t *p = data; p < close; p++) {
+			count += *p == ',';
+		}
+	}
+	r_construct.resize(old_size + count);
+	T *w = r_construct.ptrw();
+	int64_t filled = old_size;
+
+	// Everything up to 'from' is consumed. Anything unusual (identifiers, comments, more numbers than counted)
+	// stops the scan at the last element boundary, to be parsed token by token by the caller.
+	const uint8_t *from = data;
+	bool closed = false;
+	while (true) {
+		const uint8_t *p = from;
+		int lines = 0;
+		if (!r_first) {
+			while (p < end && *p && *p <= 32) {
+				lines += *p == '\n';
+				p++;
+			}
+			if (p < end && *p == ')') {
+				from = p + 1;
+				line += lines;
+				closed = true;
+				break;
+			} else if (p == end || *p != ',') {
+				break;
+			}
+			p++;
+		}
+		while (p < end && *p && *p <= 32) {
+			lines += *p == '\n';
+			p++;
+		}
+		if (p == end) {
+			break;
+		}
+		if (r_first && *p == ')') {
+			from = p + 1;
+			line += lines;
+			closed = true;
+			break;
+		}
+		if (*p != '-' && !is_digit(*p)) {
+			break;
+		}
+
+		// Same rules as get_token(), which also decide whether the number is an integer.
+		char32_t num[64];
+		int num_len = 0;
+		if (*p == '-') {
+			num[num_len++] = '-';
+			p++;
+		}
+		int reading = 0; // 0: integer part, 1: decimals, 2: exponent.
+		bool exp_sign = false;
+		bool exp_beg = false;
+		bool is_float = false;
+		bool done = false;
+		while (p < end && num_len < 63) {
+			uint8_t c = *p;
+			if (reading == 0) {
+				if (c == '.') {
+					reading = 1;
+					is_float = true;
+				} else if (c == 'e') {
+					reading = 2;
+					is_float = true;
+				} else if (!is_digit(c)) {
+					done = true;
+				}
+			} else if (reading == 1) {
+				if (c == 'e') {
+					reading = 2;
+				} else if (!is_digit(c)) {
+					done = true;
+				}
+			} else {
+				if (is_digit(c)) {
+					exp_beg = true;
+				} else if ((c == '-' || c == '+') && !exp_sign && !exp_beg) {
+					exp_sign = true;
+				} else {
+					done = true;
+				}
+			}
+			if (done) {
+				break;
+			}
+			num[num_len++] = c;
+			p++;
+		}
+		if (!done) {
+			break;
+		}
+		num[num_len] = 0;
+
+		if (filled == r_construct.size()) {
+			break;
+		}
+		if (is_float) {
+			w[filled++] = T(String::to_float(num));
+		} else {
+			w[filled++] = T(String::to_int(num));
+		}
+		from = p;
+		line += lines;
+		r_first = false;
+	}
+
+	r_construct.resize(filled);
+	p_stream->advance(from - data);
+	return closed;
+}
+
 template <class T>
 Error VariantParser::_parse_construct(Stream *p_stream, Vector<T> &r_construct, int &line, String &r_err_str) {
 	Token token;
@@ -501,6 +660,10 @@ Error VariantParser::_parse_construct(Stream *p_stream, Vector<T> &r_construct,
 	}
 
 	bool first = true;
+	if (_parse_construct_buffer(p_stream, r_construct, line, first)) {
+		return OK;
+	}
+
 	while (true) {
 		if (!first) {
 			get_token(p_stream, token, line, r_err_str);
@@ -979,17 +1142,7 @@ Error VariantParser::parse_value(Token &token, Variant &value, Stream *p_stream,
 				return err;
 			}
 
-			Vector<uint8_t> arr;
-			{
-				int len = args.size();
-				arr.resize(len);
-				uint8_t *w = arr.ptrw();
-				for (int i = 0; i < len; i++) {
-					w[i] = args[i];
-				}
-			}
-
-			value = arr;
+			value = args;
 		} else if (id == "PackedInt32Array" || id == "PackedIntArray" || id == "PoolIntArray" || id == "IntArray") {
 			Vector<int32_t> args;
 			Error err = _parse_construct<int32_t>(p_stream, args, line, r_err_str);
@@ -997,17 +1150,7 @@ Error VariantParser::parse_value(Token &token, Variant &value, Stream *p_stream,
 				return err;
 			}
 
-			Vector<int32_t> arr;
-			{
-				int32_t len = args.size();
-				arr.resize(len);
-				int32_t *w = arr.ptrw();
-				for (int32_t i = 0; i < len; i++) {
-					w[i] = int32_t(args[i]);
-				}
-			}
-
-			value = arr;
+			value = args;
 		} else if (id == "PackedInt64Array") {
 			Vector<int64_t> args;
 			Error err = _parse_construct<int64_t>(p_stream, args, line, r_err_str);
@@ -1015,17 +1158,7 @@ Error VariantParser::parse_value(Token &token, Variant &value, Stream *p_stream,
 				return err;
 			}
 
-			Vector<int64_t> arr;
-			{
-				int64_t len = args.size();
-				arr.resize(len);
-				int64_t *w = arr.ptrw();
-				for (int64_t i = 0; i < len; i++) {
-					w[i] = int64_t(args[i]);
-				}
-			}
-
-			value = arr;
+			value = args;
 		} else if (id == "PackedFloat32Array" || id == "PackedRealArray" || id == "PoolRealArray" || id == "FloatArray") {
 			Vector<float> args;
 			Error err = _parse_construct<float>(p_stream, args, line, r_err_str);
@@ -1033,17 +1166,7 @@ Error VariantParser::parse_value(Token &token, Variant &value, Stream *p_stream,
 				return err;
 			}
 
-			Vector<float> arr;
-			{
-				int len = args.size();
-				arr.resize(len);
-				float *w = arr.ptrw();
-				for (int i = 0; i < len; i++) {
-					w[i] = args[i];
-				}
-			}
-
-			value = arr;
+			value = args;
 		} else if (id == "PackedFloat64Array") {
 			Vector<double> args;
 			Error err = _parse_construct<double>(p_stream, args, line, r_err_str);
@@ -1051,17 +1174,7 @@ Error VariantParser::parse_value(Token &token, Variant &value, Stream *p_stream,
 				return err;
 			}
 
-			Vector<double> arr;
-			{
-				int len = args.size();
-				arr.resize(len);
-				double *w = arr.ptrw();
-				for (int i = 0; i < len; i++) {
-					w[i] = args[i];
-				}
-			}
-
-			value = arr;
+			value = args;
 		} else if (id == "PackedStringArray" || id == "PoolStringArray" || id == "StringArray") {
 			get_token(p_stream, token, line, r_err_str);
 			if (token.type != TK_PARENTHESIS_OPEN) {
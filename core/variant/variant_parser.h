@@ -42,6 +42,10 @@ public:
 		virtual bool is_utf8() const = 0;
 		virtual bool is_eof() const = 0;
 
+		// Streams reading from memory expose the unread bytes, so long literals can be scanned in bulk.
+		virtual const uint8_t *get_unread_data(uint64_t &r_length) const { return nullptr; }
+		virtual void advance(uint64_t p_length) {}
+
 		char32_t saved = 0;
 
 		Stream() {}
@@ -69,6 +73,21 @@ public:
 		StreamString() {}
 	};
 
+	struct StreamBuffer : public Stream {
+		const uint8_t *data = nullptr;
+		uint64_t length = 0;
+		uint64_t pos = 0;
+
+		virtual char32_t get_char() override;
+		virtual bool is_utf8() const override;
+		virtual bool is_eof() const override;
+
+		virtual const uint8_t *get_unread_data(uint64_t &r_length) const override;
+		virtual void advance(uint64_t p_length) override;
+
+		StreamBuffer() {}
+	};
+
 	typedef Error (*ParseResourceFunc)(void *p_self, Stream *p_stream, Ref<Resource> &r_res, int &line, String &r_err_str);
 
 	struct ResourceParser {
@@ -119,6 +138,8 @@ public:
 private:
 	static const char *tk_name[TK_MAX];
 
+	template <class T>
+	static bool _parse_construct_buffer(Stream *p_stream, Vector<T> &r_construct, int &line, bool &r_first);
 	template <class T>
 	static Error _parse_construct(Stream *p_stream, Vector<T> &r_construct, int &line, String &r_err_str);
 	static Error _parse_enginecfg(Stream *p_stream, Vector<String> &strings, int &line, String &r_err_str);
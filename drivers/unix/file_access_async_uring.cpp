@@ -0,0 +1,360 @@
+/*************************************************************************/
+/*  file_access_async_uring.cpp                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "file_access_async_uring.h"
+
+#ifdef IO_URING_ENABLED
+
+#include "core/config/project_settings.h"
+#include "core/io/file_access_pack.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// liburing is not used, the few system calls needed are made directly.
+#ifndef __NR_io_uring_setup
+#define __NR_io_uring_setup 425
+#endif
+#ifndef __NR_io_uring_enter
+#define __NR_io_uring_enter 426
+#endif
+
+#define IO_URING_QUEUE_ENTRIES 256
+// Linux never transfers more than this in a single read.
+#define IO_URING_MAX_READ 0x7ffff000
+
+static int io_uring_setup(unsigned p_entries, struct io_uring_params *p_params) {
+	return (int)syscall(__NR_io_uring_setup, p_entries, p_params);
+}
+
+static int io_uring_enter(int p_ring_fd, unsigned p_to_submit, unsigned p_min_complete, unsigned p_flags) {
+	return (int)syscall(__NR_io_uring_enter, p_ring_fd, p_to_submit, p_min_complete, p_flags, nullptr, 0);
+}
+
+bool FileAccessAsyncUring::_get_os_file(const String &p_path, String &r_os_path, uint64_t &r_offset, uint64_t &r_size) const {
+	PackedData *packed_data = PackedData::get_singleton();
+	if (packed_data && !packed_data->is_disabled() && packed_data->has_path(p_path)) {
+		String pack_path;
+		if (!packed_data->get_path_location(p_path, pack_path, r_offset, r_size)) {
+			return false;
+		}
+
+		// The pack may itself be a resource.
+		uint64_t pack_offset = 0;
+		uint64_t pack_size = UINT64_MAX;
+		if (!_get_os_file(pack_path, r_os_path, pack_offset, pack_size)) {
+			return false;
+		}
+		r_offset += pack_offset;
+		return true;
+	}
+
+	FileAccess::AccessType access_type = FileAccess::ACCESS_FILESYSTEM;
+	if (p_path.begins_with("res://")) {
+		access_type = FileAccess::ACCESS_RESOURCES;
+	} else if (p_path.begins_with("user://")) {
+		access_type = FileAccess::ACCESS_USERDATA;
+	}
+	if (FileAccess::get_create_func(access_type) != os_create_funcs[access_type]) {
+		// Replaced, e.g. by FileAccessNetwork.
+		return false;
+	}
+
+	r_os_path = ProjectSettings::get_singleton()->globalize_path(p_path);
+	r_offset = 0;
+	r_size = UINT64_MAX;
+	return true;
+}
+
+bool FileAccessAsyncUring::_push(Operation *p_op) {
+	uint32_t tail = *sq_tail;
+	uint32_t index = tail & sq_mask;
+	io_uring_sqe *sqe = &sqes[index];
+	memset(sqe, 0, sizeof(io_uring_sqe));
+
+	if (p_op) {
+		p_op->iov.iov_base = p_op->read->data.ptrw() + p_op->done;
+		p_op->iov.iov_len = MIN(p_op->length - p_op->done, (uint64_t)IO_URING_MAX_READ);
+		sqe->opcode = IORING_OP_READV;
+		sqe->fd = p_op->fd;
+		sqe->off = p_op->offset + p_op->done;
+		sqe->addr = (uint64_t)(uintptr_t)&p_op->iov;
+		sqe->len = 1;
+	} else {
+		// Only wakes up the reaper thread.
+		sqe->opcode = IORING_OP_NOP;
+	}
+	sqe->user_data = (uint64_t)(uintptr_t)p_op;
+
+	sq_array[index] = index;
+	__atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+	int ret;
+	do {
+		ret = io_uring_enter(ring_fd, 1, 0, 0);
+	} while (ret < 0 && errno == EINTR);
+
+	if (ret < 0) {
+		// Nothing was consumed, take the entry back.
+		__atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+		return false;
+	}
+	return true;
+}
+
+void FileAccessAsyncUring::_complete(Operation *p_op, int p_result) {
+	Read *r = p_op->read;
+	bool resubmit = false;
+
+	if (p_result == -EINTR || p_result == -EAGAIN) {
+		resubmit = true;
+	} else if (p_result < 0) {
+		r->error = ERR_FILE_CANT_READ;
+	} else if (p_result > 0) {
+		p_op->done += p_result;
+		resubmit = p_op->done < p_op->length;
+	}
+	// A result of zero is the end of the file, it was truncated since the read was submitted.
+
+	if (resubmit) {
+		MutexLock lock(submit_mutex);
+		if (_push(p_op)) {
+			return;
+		}
+		r->error = ERR_FILE_CANT_READ;
+	}
+
+	::close(p_op->fd);
+	if (r->error != OK) {
+		r->data.clear();
+	} else if (p_op->done < p_op->length) {
+		r->data.resize(p_op->done);
+	}
+	memdelete(p_op);
+
+	{
+		MutexLock lock(submit_mutex);
+		in_flight--;
+	}
+
+	_finish_read(r);
+}
+
+void FileAccessAsyncUring::_reaper_thread_func(void *p_self) {
+	FileAccessAsyncUring *self = (FileAccessAsyncUring *)p_self;
+
+	while (true) {
+		int ret = io_uring_enter(self->ring_fd, 0, 1, IORING_ENTER_GETEVENTS);
+		if (ret < 0 && errno != EINTR) {
+			int err = errno;
+			ERR_PRINT("Waiting for io_uring completions failed with error " + itos(err) + ".");
+			break;
+		}
+
+		uint32_t head = *self->cq_head;
+		uint32_t tail = __atomic_load_n(self->cq_tail, __ATOMIC_ACQUIRE);
+		while (head != tail) {
+			io_uring_cqe *cqe = &self->cqes[head & self->cq_mask];
+			Operation *op = (Operation *)(uintptr_t)cqe->user_data;
+			int result = cqe->res;
+			head++;
+			__atomic_store_n(self->cq_head, head, __ATOMIC_RELEASE);
+
+			if (op) {
+				self->_complete(op, result);
+			}
+		}
+
+		if (self->exit_requested.is_set()) {
+			MutexLock lock(self->submit_mutex);
+			if (self->in_flight == 0) {
+				break;
+			}
+		}
+	}
+}
+
+void FileAccessAsyncUring::_submit(Read *p_read) {
+	String os_path;
+	uint64_t offset = 0;
+	uint64_t size = UINT64_MAX;
+	if (ring_fd == -1 || exit_requested.is_set() || !_get_os_file(p_read->path, os_path, offset, size)) {
+		FileAccessAsync::_submit(p_read);
+		return;
+	}
+
+	// Failures to open go to the fallback too, which reports them as FileAccess does.
+	int fd = ::open(os_path.utf8().get_data(), O_RDONLY | O_CLOEXEC);
+	if (fd == -1) {
+		FileAccessAsync::_submit(p_read);
+		return;
+	}
+
+	if (size == UINT64_MAX) {
+		struct stat st = {};
+		if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+			::close(fd);
+			FileAccessAsync::_submit(p_read);
+			return;
+		}
+		size = st.st_size;
+	}
+
+	uint64_t start = MIN(p_read->offset, size);
+	uint64_t length = size - start;
+	if (p_read->length >= 0) {
+		length = MIN((uint64_t)p_read->length, length);
+	}
+	if (length == 0) {
+		::close(fd);
+		_finish_read(p_read);
+		return;
+	}
+
+	p_read->data.resize(length);
+
+	Operation *op = memnew(Operation);
+	op->read = p_read;
+	op->fd = fd;
+	op->offset = offset + start;
+	op->length = length;
+
+	{
+		MutexLock lock(submit_mutex);
+		// Completions can't overflow as long as there are fewer reads in flight than entries.
+		if (in_flight < entries && _push(op)) {
+			in_flight++;
+			return;
+		}
+	}
+
+	::close(fd);
+	memdelete(op);
+	p_read->data.clear();
+	FileAccessAsync::_submit(p_read);
+}
+
+FileAccessAsyncUring::FileAccessAsyncUring() {
+	for (int i = 0; i < FileAccess::ACCESS_MAX; i++) {
+		os_create_funcs[i] = FileAccess::get_create_func(FileAccess::AccessType(i));
+	}
+
+	struct io_uring_params params = {};
+	ring_fd = io_uring_setup(IO_URING_QUEUE_ENTRIES, &params);
+	if (ring_fd < 0) {
+		int err = errno;
+		print_verbose("io_uring is not available (error " + itos(err) + "), asynchronous file reads will use the WorkerThreadPool.");
+		ring_fd = -1;
+		return;
+	}
+
+	entries = params.sq_entries;
+	sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+	cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+
+	bool single_mmap = false;
+#ifdef IORING_FEAT_SINGLE_MMAP
+	single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+#endif
+	if (single_mmap) {
+		sq_ring_size = MAX(sq_ring_size, cq_ring_size);
+		cq_ring_size = sq_ring_size;
+	}
+
+	void *ptr = mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+	sq_ring = ptr == MAP_FAILED ? nullptr : (uint8_t *)ptr;
+	if (single_mmap) {
+		cq_ring = sq_ring;
+	} else {
+		ptr = mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+		cq_ring = ptr == MAP_FAILED ? nullptr : (uint8_t *)ptr;
+	}
+	ptr = mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+	sqes = ptr == MAP_FAILED ? nullptr : (io_uring_sqe *)ptr;
+
+	if (!sq_ring || !cq_ring || !sqes) {
+		ERR_PRINT("Mapping the io_uring queues failed, asynchronous file reads will use the WorkerThreadPool.");
+		if (sqes) {
+			munmap(sqes, sqes_size);
+			sqes = nullptr;
+		}
+		if (cq_ring && cq_ring != sq_ring) {
+			munmap(cq_ring, cq_ring_size);
+		}
+		cq_ring = nullptr;
+		if (sq_ring) {
+			munmap(sq_ring, sq_ring_size);
+			sq_ring = nullptr;
+		}
+		::close(ring_fd);
+		ring_fd = -1;
+		return;
+	}
+
+	sq_head = (uint32_t *)(sq_ring + params.sq_off.head);
+	sq_tail = (uint32_t *)(sq_ring + params.sq_off.tail);
+	sq_mask = *(uint32_t *)(sq_ring + params.sq_off.ring_mask);
+	sq_array = (uint32_t *)(sq_ring + params.sq_off.array);
+	cq_head = (uint32_t *)(cq_ring + params.cq_off.head);
+	cq_tail = (uint32_t *)(cq_ring + params.cq_off.tail);
+	cq_mask = *(uint32_t *)(cq_ring + params.cq_off.ring_mask);
+	cqes = (io_uring_cqe *)(cq_ring + params.cq_off.cqes);
+
+	reaper_thread.start(_reaper_thread_func, this);
+}
+
+FileAccessAsyncUring::~FileAccessAsyncUring() {
+	if (ring_fd == -1) {
+		return;
+	}
+
+	exit_requested.set();
+	{
+		MutexLock lock(submit_mutex);
+		_push(nullptr);
+	}
+	reaper_thread.wait_to_finish();
+
+	munmap(sqes, sqes_size);
+	if (cq_ring != sq_ring) {
+		munmap(cq_ring, cq_ring_size);
+	}
+	munmap(sq_ring, sq_ring_size);
+	::close(ring_fd);
+}
+
+#endif // IO_URING_ENABLED
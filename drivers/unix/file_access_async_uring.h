@@ -0,0 +1,107 @@
+/*************************************************************************/
+/*  file_access_async_uring.h                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef FILE_ACCESS_ASYNC_URING_H
+#define FILE_ACCESS_ASYNC_URING_H
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define IO_URING_ENABLED
+#endif
+#endif
+
+#ifdef IO_URING_ENABLED
+
+#include "core/io/file_access.h"
+#include "core/io/file_access_async.h"
+#include "core/os/thread.h"
+
+#include <sys/uio.h>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+// Reads files of the OS, including files stored as is in packs, with io_uring. A single
+// thread reaps completions. Other files, and every read if io_uring is not available
+// (old kernels, sandboxes), go to the WorkerThreadPool fallback.
+class FileAccessAsyncUring : public FileAccessAsync {
+	struct Operation {
+		Read *read = nullptr;
+		int fd = -1;
+		uint64_t offset = 0;
+		uint64_t length = 0;
+		uint64_t done = 0;
+		struct iovec iov = {};
+	};
+
+	int ring_fd = -1;
+	uint32_t entries = 0;
+
+	uint8_t *sq_ring = nullptr;
+	size_t sq_ring_size = 0;
+	uint8_t *cq_ring = nullptr;
+	size_t cq_ring_size = 0;
+	io_uring_sqe *sqes = nullptr;
+	size_t sqes_size = 0;
+
+	uint32_t *sq_head = nullptr;
+	uint32_t *sq_tail = nullptr;
+	uint32_t sq_mask = 0;
+	uint32_t *sq_array = nullptr;
+	uint32_t *cq_head = nullptr;
+	uint32_t *cq_tail = nullptr;
+	uint32_t cq_mask = 0;
+	io_uring_cqe *cqes = nullptr;
+
+	// Guards the submission queue and in_flight.
+	Mutex submit_mutex;
+	uint32_t in_flight = 0;
+	SafeFlag exit_requested;
+	Thread reaper_thread;
+
+	// Creation functions of the FileAccess types reading straight from the OS.
+	FileAccess::CreateFunc os_create_funcs[FileAccess::ACCESS_MAX] = {};
+
+	bool _get_os_file(const String &p_path, String &r_os_path, uint64_t &r_offset, uint64_t &r_size) const;
+	bool _push(Operation *p_op);
+	void _complete(Operation *p_op, int p_result);
+	static void _reaper_thread_func(void *p_self);
+
+protected:
+	virtual void _submit(Read *p_read) override;
+
+public:
+	FileAccessAsyncUring();
+	virtual ~FileAccessAsyncUring();
+};
+
+#endif // IO_URING_ENABLED
+
+#endif // FILE_ACCESS_ASYNC_URING_H
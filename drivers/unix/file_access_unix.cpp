@@ -37,6 +37,7 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
@@ -130,11 +131,42 @@ Error FileAccessUnix::open_internal(const String &p_path, int p_mode_flags) {
 	return OK;
 }
 
+bool FileAccessUnix::_map() const {
+	if (flags != READ) {
+		return false;
+	}
+
+	struct stat st = {};
+	if (fstat(fileno(f), &st) != 0 || st.st_size <= 0 || uint64_t(st.st_size) > SIZE_MAX) {
+		return false;
+	}
+
+	int64_t pos = ftello(f);
+	ERR_FAIL_COND_V(pos < 0, false);
+
+	void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+	if (data == MAP_FAILED) {
+		return false; // Not supported by this file system, keep using f.
+	}
+
+	map = (const uint8_t *)data;
+	map_length = st.st_size;
+	map_pos = pos;
+	return true;
+}
+
 void FileAccessUnix::_close() {
 	if (!f) {
 		return;
 	}
 
+	if (map) {
+		munmap((void *)map, map_length);
+		map = nullptr;
+		map_length = 0;
+		map_pos = 0;
+	}
+
 	fclose(f);
 	f = nullptr;
 
@@ -170,6 +202,10 @@ void FileAccessUnix::seek(uint64_t p_position) {
 	ERR_FAIL_COND_MSG(!f, "File must be opened before use.");
 
 	last_error = OK;
+	if (map) {
+		map_pos = p_position;
+		return;
+	}
 	if (fseeko(f, p_position, SEEK_SET)) {
 		check_errors();
 	}
@@ -178,6 +214,11 @@ void FileAccessUnix::seek(uint64_t p_position) {
 void FileAccessUnix::seek_end(int64_t p_position) {
 	ERR_FAIL_COND_MSG(!f, "File must be opened before use.");
 
+	if (map) {
+		ERR_FAIL_COND(int64_t(map_length) + p_position < 0);
+		map_pos = map_length + p_position;
+		return;
+	}
 	if (fseeko(f, p_position, SEEK_END)) {
 		check_errors();
 	}
@@ -186,6 +227,10 @@ void FileAccessUnix::seek_end(int64_t p_position) {
 uint64_t FileAccessUnix::get_position() const {
 	ERR_FAIL_COND_V_MSG(!f, 0, "File must be opened before use.");
 
+	if (map) {
+		return map_pos;
+	}
+
 	int64_t pos = ftello(f);
 	if (pos < 0) {
 		check_errors();
@@ -197,6 +242,10 @@ uint64_t FileAccessUnix::get_position() const {
 uint64_t FileAccessUnix::get_length() const {
 	ERR_FAIL_COND_V_MSG(!f, 0, "File must be opened before use.");
 
+	if (map) {
+		return map_length;
+	}
+
 	int64_t pos = ftello(f);
 	ERR_FAIL_COND_V(pos < 0, 0);
 	ERR_FAIL_COND_V(fseeko(f, 0, SEEK_END), 0);
@@ -213,6 +262,13 @@ bool FileAccessUnix::eof_reached() const {
 
 uint8_t FileAccessUnix::get_8() const {
 	ERR_FAIL_COND_V_MSG(!f, 0, "File must be opened before use.");
+	if (map) {
+		if (map_pos >= map_length) {
+			last_error = ERR_FILE_EOF;
+			return '\0';
+		}
+		return map[map_pos++];
+	}
 	uint8_t b;
 	if (fread(&b, 1, 1, f) == 0) {
 		check_errors();
@@ -225,11 +281,38 @@ uint64_t FileAccessUnix::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 	ERR_FAIL_COND_V(!p_dst && p_length > 0, -1);
 	ERR_FAIL_COND_V_MSG(!f, -1, "File must be opened before use.");
 
+	if (map) {
+		uint64_t read = map_pos < map_length ? MIN(p_length, map_length - map_pos) : 0;
+		if (read > 0) {
+			memcpy(p_dst, map + map_pos, read);
+			map_pos += read;
+		}
+		if (read < p_length) {
+			last_error = ERR_FILE_EOF;
+		}
+		return read;
+	}
+
 	uint64_t read = fread(p_dst, 1, p_length, f);
 	check_errors();
 	return read;
 }
 
+const uint8_t *FileAccessUnix::get_buffer_view(uint64_t p_length) const {
+	ERR_FAIL_COND_V_MSG(!f, nullptr, "File must be opened before use.");
+
+	if (!map && !_map()) {
+		return nullptr;
+	}
+	if (map_pos > map_length || p_length > map_length - map_pos) {
+		return nullptr;
+	}
+
+	const uint8_t *view = map + map_pos;
+	map_pos += p_length;
+	return view;
+}
+
 Error FileAccessUnix::get_error() const {
 	return last_error;
 }
@@ -43,6 +43,11 @@ typedef void (*CloseNotificationFunc)(const String &p_file, int p_flags);
 class FileAccessUnix : public FileAccess {
 	FILE *f = nullptr;
 	int flags = 0;
+	// The whole file, mapped once a view is requested. Reads then go through it instead of f.
+	mutable const uint8_t *map = nullptr;
+	mutable uint64_t map_length = 0;
+	mutable uint64_t map_pos = 0;
+	bool _map() const;
 	void check_errors() const;
 	mutable Error last_error = OK;
 	String save_path;
@@ -69,6 +74,7 @@ public:
 
 	virtual uint8_t get_8() const override; ///< get a byte
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const override;
+	virtual const uint8_t *get_buffer_view(uint64_t p_length) const override;
 
 	virtual Error get_error() const override; ///< get last error
 
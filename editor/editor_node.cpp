@@ -32,8 +32,10 @@
 
 #include "core/config/project_settings.h"
 #include "core/input/input.h"
+#include "core/io/compression.h"
 #include "core/io/config_file.h"
 #include "core/io/file_access.h"
+#include "core/io/file_access_compressed.h"
 #include "core/io/image_loader.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
@@ -581,6 +583,82 @@ void EditorNode::_update_from_settings() {
 	NavigationServer3D::get_singleton_mut()->set_debug_navigation_enable_edge_lines_xray(GLOBAL_GET("debug/shapes/navigation/enable_edge_lines_xray"));
 	NavigationServer3D::get_singleton_mut()->set_debug_navigation_enable_geometry_face_random_color(GLOBAL_GET("debug/shapes/navigation/enable_geometry_face_random_color"));
 #endif // DEBUG_ENABLED
+
+	String current_zstd_dictionary_path = GLOBAL_GET("compression/formats/zstd/dictionary");
+	if (current_zstd_dictionary_path != zstd_dictionary_path) {
+		zstd_dictionary_path = current_zstd_dictionary_path;
+		_update_zstd_dictionary();
+	}
+}
+
+void EditorNode::_update_zstd_dictionary() {
+	uint32_t dictionary_id = 0;
+	if (!zstd_dictionary_path.is_empty()) {
+		Vector<uint8_t> dictionary = FileAccess::get_file_as_array(zstd_dictionary_path);
+		if (dictionary.is_empty()) {
+			show_warning(vformat(TTR("Can't load the Zstandard dictionary from: %s.\nCompressed resources will keep using the previous one."), zstd_dictionary_path));
+			return;
+		}
+		dictionary_id = Compression::add_zstd_dictionary(dictionary);
+	}
+	if (dictionary_id == Compression::zstd_dictionary_id) {
+		return;
+	}
+
+	// The previous dictionary stays registered, so the files compressed with it can still be read while they are converted.
+	// Once the project is reopened, only the new one is.
+	Compression::zstd_dictionary_id = dictionary_id;
+
+	Vector<String> resave;
+	Vector<String> reimport;
+	_find_zstd_compressed_files(EditorFileSystem::get_singleton()->get_filesystem(), dictionary_id, resave, reimport);
+
+	// Rewriting the dependencies as they are recompresses the file with the current dictionary, without loading it.
+	for (int i = 0; i < resave.size(); i++) {
+		Error err = ResourceLoader::rename_dependencies(resave[i], HashMap<String, String>());
+		if (err != OK) {
+			ERR_PRINT("Can't recompress resource with the new Zstandard dictionary: " + resave[i] + ".");
+		}
+	}
+	if (!reimport.is_empty()) {
+		EditorFileSystem::get_singleton()->reimport_files(reimport);
+	}
+}
+
+void EditorNode::_find_zstd_compressed_files(EditorFileSystemDirectory *p_dir, uint32_t p_dictionary_id, Vector<String> &r_resave, Vector<String> &r_reimport) {
+	auto needs_update = [p_dictionary_id](const String &p_path) {
+		Ref<FileAccessCompressed> fac;
+		fac.instantiate();
+		fac->configure("RSCC");
+		return fac->open_internal(p_path, FileAccess::READ) == OK && fac->get_zstd_dictionary_id() != p_dictionary_id;
+	};
+
+	for (int i = 0; i < p_dir->get_subdir_count(); i++) {
+		_find_zstd_compressed_files(p_dir->get_subdir(i), p_dictionary_id, r_resave, r_reimport);
+	}
+
+	for (int i = 0; i < p_dir->get_file_count(); i++) {
+		String path = p_dir->get_file_path(i);
+		if (!FileAccess::exists(path + ".import")) {
+			if (needs_update(path)) {
+				r_resave.push_back(path);
+			}
+			continue;
+		}
+
+		Ref<ConfigFile> config;
+		config.instantiate();
+		if (config->load(path + ".import") != OK) {
+			continue;
+		}
+		Vector<String> dest_files = config->get_value("deps", "dest_files", Vector<String>());
+		for (int j = 0; j < dest_files.size(); j++) {
+			if (needs_update(dest_files[j])) {
+				r_reimport.push_back(path);
+				break;
+			}
+		}
+	}
 }
 
 void EditorNode::_select_default_main_screen_plugin() {
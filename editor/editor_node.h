@@ -59,6 +59,7 @@ class EditorCommandPalette;
 class EditorExport;
 class EditorExtensionManager;
 class EditorFeatureProfileManager;
+class EditorFileSystemDirectory;
 class EditorFileServer;
 class EditorFolding;
 class EditorInspector;
@@ -485,6 +486,7 @@ private:
 	AudioStreamImportSettings *audio_stream_import_settings = nullptr;
 
 	String import_reload_fn;
+	String zstd_dictionary_path;
 
 	HashSet<String> textfile_extensions;
 	HashSet<FileDialog *> file_dialogs;
@@ -600,6 +602,8 @@ private:
 	void _add_dropped_files_recursive(const Vector<String> &p_files, String to_path);
 
 	void _update_from_settings();
+	void _update_zstd_dictionary();
+	void _find_zstd_compressed_files(EditorFileSystemDirectory *p_dir, uint32_t p_dictionary_id, Vector<String> &r_resave, Vector<String> &r_reimport);
 
 	void _renderer_selected(int);
 	void _update_renderer_color();
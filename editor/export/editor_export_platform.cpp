@@ -34,7 +34,7 @@
 #include "core/crypto/crypto_core.h"
 #include "core/extension/native_extension.h"
 #include "core/io/file_access_encrypted.h"
-#include "core/io/file_access_pack.h" // PACK_HEADER_MAGIC, PACK_FORMAT_VERSION
+#include "core/io/file_access_pack.h" // PACK_HEADER_MAGIC, PACK_FORMAT_VERSION, PACK_ZSTD_DICTIONARY_PATH
 #include "core/io/zip_io.h"
 #include "core/version.h"
 #include "editor/editor_file_system.h"
@@ -1257,6 +1257,22 @@ Error EditorExportPlatform::export_project_files(const Ref<EditorExportPreset> &
 			return err;
 		}
 	}
+
+	// Compressed resources can't be loaded without the Zstandard dictionary they were saved with.
+	// Store it where PackedData registers it from, and point the exported setting there.
+	String zstd_dictionary = GLOBAL_GET("compression/formats/zstd/dictionary");
+	if (!zstd_dictionary.is_empty()) {
+		Vector<uint8_t> array = FileAccess::get_file_as_array(zstd_dictionary);
+		if (array.is_empty()) {
+			add_message(EXPORT_MESSAGE_ERROR, TTR("Export"), vformat(TTR("Can't read the Zstandard dictionary from path \"%s\"."), zstd_dictionary));
+			return ERR_FILE_NOT_FOUND;
+		}
+		err = p_func(p_udata, PACK_ZSTD_DICTIONARY_PATH, array, idx, total, enc_in_filters, enc_ex_filters, key);
+		if (err != OK) {
+			return err;
+		}
+		custom_map["compression/formats/zstd/dictionary"] = PACK_ZSTD_DICTIONARY_PATH;
+	}
 	String resource_cache_file = ResourceUID::get_cache_file();
 	if (FileAccess::exists(resource_cache_file)) {
 		Vector<uint8_t> array = FileAccess::get_file_as_array(resource_cache_file);
@@ -436,11 +436,16 @@ void GDScript::set_source_code(const String &p_code) {
 		return;
 	}
 	source = p_code;
+	binary_tokens.clear();
 #ifdef TOOLS_ENABLED
 	source_changed_cache = true;
 #endif
 }
 
+void GDScript::set_binary_tokens_source(const Vector<uint8_t> &p_binary_tokens) {
+	binary_tokens = p_binary_tokens;
+}
+
 #ifdef TOOLS_ENABLED
 void GDScript::_update_exports_values(HashMap<StringName, Variant> &values, List<PropertyInfo> &propnames) {
 	for (const KeyValue<StringName, Variant> &E : member_default_values_cache) {
@@ -881,26 +886,38 @@ Error GDScript::reload(bool p_keep_state) {
 	}
 
 	valid = false;
-	GDScriptParser parser;
-	Error err = parser.parse(source, path, false);
+	Error err = OK;
+	// The script may have been parsed ahead on another thread along with other scripts, see GDScriptCache::parse_scripts().
+	GDScriptParser *parser = GDScriptCache::take_parsed_script(get_path(), source, binary_tokens, err);
+	if (parser == nullptr) {
+		parser = memnew(GDScriptParser);
+		err = GDScriptCache::parse(parser, path, source, binary_tokens);
+	}
 	if (err) {
 		if (EngineDebugger::is_active()) {
-			GDScriptLanguage::get_singleton()->debug_break_parse(_get_debug_path(), parser.get_errors().front()->get().line, "Parser Error: " + parser.get_errors().front()->get().message);
+			GDScriptLanguage::get_singleton()->debug_break_parse(_get_debug_path(), parser->get_errors().front()->get().line, "Parser Error: " + parser->get_errors().front()->get().message);
 		}
 		// TODO: Show all error messages.
-		_err_print_error("GDScript::reload", path.is_empty() ? "built-in" : (const char *)path.utf8().get_data(), parser.get_errors().front()->get().line, ("Parse Error: " + parser.get_errors().front()->get().message).utf8().get_data(), false, ERR_HANDLER_SCRIPT);
+		_err_print_error("GDScript::reload", path.is_empty() ? "built-in" : (const char *)path.utf8().get_data(), parser->get_errors().front()->get().line, ("Parse Error: " + parser->get_errors().front()->get().message).utf8().get_data(), false, ERR_HANDLER_SCRIPT);
+		memdelete(parser);
 		return ERR_PARSE_ERROR;
 	}
 
-	GDScriptAnalyzer analyzer(&parser);
-	err = analyzer.analyze();
+	err = _compile_parsed(*parser, p_keep_state);
+	memdelete(parser);
+	return err;
+}
+
+Error GDScript::_compile_parsed(GDScriptParser &p_parser, bool p_keep_state) {
+	GDScriptAnalyzer analyzer(&p_parser);
+	Error err = analyzer.analyze();
 
 	if (err) {
 		if (EngineDebugger::is_active()) {
-			GDScriptLanguage::get_singleton()->debug_break_parse(_get_debug_path(), parser.get_errors().front()->get().line, "Parser Error: " + parser.get_errors().front()->get().message);
+			GDScriptLanguage::get_singleton()->debug_break_parse(_get_debug_path(), p_parser.get_errors().front()->get().line, "Parser Error: " + p_parser.get_errors().front()->get().message);
 		}
 
-		const List<GDScriptParser::ParserError>::Element *e = parser.get_errors().front();
+		const List<GDScriptParser::ParserError>::Element *e = p_parser.get_errors().front();
 		while (e != nullptr) {
 			_err_print_error("GDScript::reload", path.is_empty() ? "built-in" : (const char *)path.utf8().get_data(), e->get().line, ("Parse Error: " + e->get().message).utf8().get_data(), false, ERR_HANDLER_SCRIPT);
 			e = e->next();
@@ -908,10 +925,10 @@ Error GDScript::reload(bool p_keep_state) {
 		return ERR_PARSE_ERROR;
 	}
 
-	bool can_run = ScriptServer::is_scripting_enabled() || parser.is_tool();
+	bool can_run = ScriptServer::is_scripting_enabled() || p_parser.is_tool();
 
 	GDScriptCompiler compiler;
-	err = compiler.compile(&parser, this, p_keep_state);
+	err = compiler.compile(&p_parser, this, p_keep_state);
 
 #ifdef TOOLS_ENABLED
 	_update_doc();
@@ -929,7 +946,7 @@ Error GDScript::reload(bool p_keep_state) {
 		}
 	}
 #ifdef DEBUG_ENABLED
-	for (const GDScriptWarning &warning : parser.get_warnings()) {
+	for (const GDScriptWarning &warning : p_parser.get_warnings()) {
 		if (EngineDebugger::is_active()) {
 			Vector<ScriptLanguage::StackInfo> si;
 			EngineDebugger::get_script_debugger()->send_error("", get_path(), warning.start_line, warning.get_name(), warning.get_message(), false, ERR_HANDLER_WARNING, si);
@@ -1056,6 +1073,17 @@ void GDScript::set_path(const String &p_path, bool p_take_over) {
 }
 
 Error GDScript::load_source_code(const String &p_path) {
+	String remapped_path = ResourceLoader::path_remap(p_path);
+	if (remapped_path.get_extension().to_lower() == "gdc") {
+		// Exported projects ship scripts as parse trees (GDScriptTreeBuffer) or binary tokens (GDScriptTokenizerBuffer).
+		Vector<uint8_t> buffer = GDScriptCache::get_binary_tokens(remapped_path);
+		ERR_FAIL_COND_V_MSG(buffer.is_empty(), ERR_FILE_CANT_OPEN, "Cannot open binary script file '" + remapped_path + "'.");
+		source.clear();
+		binary_tokens = buffer;
+		path = p_path;
+		return OK;
+	}
+
 	Vector<uint8_t> sourcef;
 	Error err;
 	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ, &err);
@@ -1082,6 +1110,7 @@ Error GDScript::load_source_code(const String &p_path) {
 	}
 
 	source = s;
+	binary_tokens.clear();
 	path = p_path;
 #ifdef TOOLS_ENABLED
 	source_changed_cache = true;
@@ -1105,6 +1134,17 @@ StringName GDScript::debug_get_member_by_index(int p_idx) const {
 	return "<error>";
 }
 
+Vector<StringName> GDScript::get_member_names_by_index() const {
+	// member_indices is unordered, but indices follow the declaration order.
+	Vector<StringName> names;
+	names.resize(member_indices.size());
+	for (const KeyValue<StringName, MemberInfo> &E : member_indices) {
+		ERR_CONTINUE(E.value.index < 0 || E.value.index >= names.size());
+		names.write[E.value.index] = E.key;
+	}
+	return names;
+}
+
 Ref<GDScript> GDScript::get_base() const {
 	return base;
 }
@@ -1261,6 +1301,9 @@ void GDScript::_init_rpc_methods_properties() {
 	}
 }
 
+SafeNumeric<uint32_t> GDScript::last_layout_version;
+SafeNumeric<uint32_t> GDScript::reload_version;
+
 GDScript::~GDScript() {
 	{
 		MutexLock lock(GDScriptLanguage::get_singleton()->mutex);
@@ -1314,7 +1357,7 @@ GDScript::~GDScript() {
 bool GDScriptInstance::set(const StringName &p_name, const Variant &p_value) {
 	//member
 	{
-		HashMap<StringName, GDScript::MemberInfo>::Iterator E = script->member_indices.find(p_name);
+		FlatHashMap<StringName, GDScript::MemberInfo>::Iterator E = script->member_indices.find(p_name);
 		if (E) {
 			const GDScript::MemberInfo *member = &E->value;
 			if (member->setter) {
@@ -1378,7 +1421,7 @@ bool GDScriptInstance::get(const StringName &p_name, Variant &r_ret) const {
 	const GDScript *sptr = script.ptr();
 	while (sptr) {
 		{
-			HashMap<StringName, GDScript::MemberInfo>::ConstIterator E = script->member_indices.find(p_name);
+			FlatHashMap<StringName, GDScript::MemberInfo>::ConstIterator E = script->member_indices.find(p_name);
 			if (E) {
 				if (E->value.getter) {
 					Callable::CallError err;
@@ -1947,11 +1990,20 @@ void GDScriptLanguage::reload_all_scripts() {
 
 	scripts.sort_custom<GDScriptDepSort>(); //update in inheritance dependency order
 
+	uint64_t reload_from = OS::get_singleton()->get_ticks_usec();
+	Vector<Ref<GDScript>> to_parse;
 	for (Ref<GDScript> &scr : scripts) {
-		print_verbose("GDScript: Reloading: " + scr->get_path());
 		scr->load_source_code(scr->get_path());
+		to_parse.push_back(scr);
+	}
+	// Parsing doesn't depend on other scripts, so all of them are parsed concurrently before reloading in order.
+	int parsed_count = GDScriptCache::parse_scripts(to_parse);
+
+	for (Ref<GDScript> &scr : scripts) {
+		print_verbose("GDScript: Reloading: " + scr->get_path());
 		scr->reload(true);
 	}
+	print_verbose(vformat("GDScript: Reloaded %d scripts (%d parsed in parallel) in %d usec.", scripts.size(), parsed_count, OS::get_singleton()->get_ticks_usec() - reload_from));
 #endif
 }
 
@@ -2394,10 +2446,13 @@ Ref<Resource> ResourceFormatLoaderGDScript::load(const String &p_path, const Str
 		*r_error = ERR_FILE_CANT_OPEN;
 	}
 
+	// Binary scripts are loaded through their remap, keep caching them under the path the project uses.
+	String path = p_original_path.is_empty() ? p_path : p_original_path;
+
 	Error err;
-	Ref<GDScript> scr = GDScriptCache::get_full_script(p_path, err, "", p_cache_mode == CACHE_MODE_IGNORE);
+	Ref<GDScript> scr = GDScriptCache::get_full_script(path, err, "", p_cache_mode == CACHE_MODE_IGNORE);
 
-	// TODO: Reintroduce binary and encrypted scripts.
+	// TODO: Reintroduce encrypted scripts.
 
 	if (scr.is_null()) {
 		// Don't fail loading because of parsing error.
@@ -2413,8 +2468,8 @@ Ref<Resource> ResourceFormatLoaderGDScript::load(const String &p_path, const Str
 
 void ResourceFormatLoaderGDScript::get_recognized_extensions(List<String> *p_extensions) const {
 	p_extensions->push_back("gd");
-	// TODO: Reintroduce binary and encrypted scripts.
-	// p_extensions->push_back("gdc");
+	p_extensions->push_back("gdc");
+	// TODO: Reintroduce encrypted scripts.
 	// p_extensions->push_back("gde");
 }
 
@@ -2424,8 +2479,8 @@ bool ResourceFormatLoaderGDScript::handles_type(const String &p_type) const {
 
 String ResourceFormatLoaderGDScript::get_resource_type(const String &p_path) const {
 	String el = p_path.get_extension().to_lower();
-	// TODO: Reintroduce binary and encrypted scripts.
-	if (el == "gd" /*|| el == "gdc" || el == "gde"*/) {
+	// TODO: Reintroduce encrypted scripts.
+	if (el == "gd" || el == "gdc" /*|| el == "gde"*/) {
 		return "GDScript";
 	}
 	return "";
@@ -2435,14 +2490,19 @@ void ResourceFormatLoaderGDScript::get_dependencies(const String &p_path, List<S
 	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::READ);
 	ERR_FAIL_COND_MSG(file.is_null(), "Cannot open file '" + p_path + "'.");
 
-	String source = file->get_as_utf8_string();
-	if (source.is_empty()) {
-		return;
-	}
-
 	GDScriptParser parser;
-	if (OK != parser.parse(source, p_path, false)) {
-		return;
+	if (p_path.get_extension().to_lower() == "gdc") {
+		if (OK != parser.parse_binary(GDScriptCache::get_binary_tokens(p_path), p_path)) {
+			return;
+		}
+	} else {
+		String source = file->get_as_utf8_string();
+		if (source.is_empty()) {
+			return;
+		}
+		if (OK != parser.parse(source, p_path, false)) {
+			return;
+		}
 	}
 
 	for (const String &E : parser.get_dependencies()) {
@@ -37,9 +37,12 @@
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
 #include "core/object/script_language.h"
+#include "core/templates/flat_hash_map.h"
 #include "core/templates/rb_set.h"
 #include "gdscript_function.h"
 
+class GDScriptParser;
+
 class GDScriptNativeClass : public RefCounted {
 	GDCLASS(GDScriptNativeClass, RefCounted);
 
@@ -84,7 +87,7 @@ class GDScript : public Script {
 	HashSet<StringName> members; //members are just indices to the instantiated script.
 	HashMap<StringName, Variant> constants;
 	HashMap<StringName, GDScriptFunction *> member_functions;
-	HashMap<StringName, MemberInfo> member_indices; //members are just indices to the instantiated script.
+	FlatHashMap<StringName, MemberInfo> member_indices; //members are just indices to the instantiated script.
 	HashMap<StringName, Ref<GDScript>> subclasses;
 	HashMap<StringName, Vector<StringName>> _signals;
 	Dictionary rpc_config;
@@ -126,6 +129,7 @@ class GDScript : public Script {
 	RBSet<Object *> instances;
 	//exported members
 	String source;
+	Vector<uint8_t> binary_tokens;
 	String path;
 	String name;
 	String fully_qualified_name;
@@ -133,6 +137,13 @@ class GDScript : public Script {
 
 	SelfList<GDScriptFunctionState>::List pending_func_states;
 
+	// Identify member indices and functions for the VM's inline caches. Each compilation gets a new layout
+	// version, and compiling a script again also changes the reload version, since scripts inheriting from
+	// it keep their own layout version.
+	uint32_t layout_version = 0;
+	static SafeNumeric<uint32_t> last_layout_version;
+	static SafeNumeric<uint32_t> reload_version;
+
 	GDScriptFunction *_super_constructor(GDScript *p_script);
 	void _super_implicit_constructor(GDScript *p_script, GDScriptInstance *p_instance, Callable::CallError &r_error);
 	GDScriptInstance *_create_instance(const Variant **p_args, int p_argcount, Object *p_owner, bool p_is_ref_counted, Callable::CallError &r_error);
@@ -156,6 +167,7 @@ class GDScript : public Script {
 
 	void _save_orphaned_subclasses();
 	void _init_rpc_methods_properties();
+	Error _compile_parsed(GDScriptParser &p_parser, bool p_keep_state);
 
 	void _get_script_property_list(List<PropertyInfo> *r_list, bool p_include_base) const;
 	void _get_script_method_list(List<MethodInfo> *r_list, bool p_include_base) const;
@@ -195,9 +207,10 @@ public:
 	bool is_tool() const override { return tool; }
 	Ref<GDScript> get_base() const;
 
-	const HashMap<StringName, MemberInfo> &debug_get_member_indices() const { return member_indices; }
+	const FlatHashMap<StringName, MemberInfo> &debug_get_member_indices() const { return member_indices; }
 	const HashMap<StringName, GDScriptFunction *> &debug_get_member_functions() const; //this is debug only
 	StringName debug_get_member_by_index(int p_idx) const;
+	Vector<StringName> get_member_names_by_index() const;
 
 	Variant _new(const Variant **p_args, int p_argcount, Callable::CallError &r_error);
 	virtual bool can_instantiate() const override;
@@ -225,6 +238,8 @@ public:
 	virtual void set_path(const String &p_path, bool p_take_over = false) override;
 	void set_script_path(const String &p_path) { path = p_path; } //because subclasses need a path too...
 	Error load_source_code(const String &p_path);
+	void set_binary_tokens_source(const Vector<uint8_t> &p_binary_tokens);
+	const Vector<uint8_t> &get_binary_tokens_source() const { return binary_tokens; }
 	Error load_byte_code(const String &p_path);
 
 	Vector<uint8_t> get_as_byte_code() const;
@@ -30,7 +30,12 @@
 
 #include "gdscript_cache.h"
 
+#include "core/config/engine.h"
 #include "core/io/file_access.h"
+#include "core/io/resource_loader.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/vector.h"
 #include "gdscript.h"
 #include "gdscript_analyzer.h"
@@ -57,10 +62,16 @@ Error GDScriptParserRef::raise_status(Status p_new_status) {
 
 	while (p_new_status > status) {
 		switch (status) {
-			case EMPTY:
+			case EMPTY: {
 				status = PARSED;
-				result = parser->parse(GDScriptCache::get_source_code(path), path, false);
-				break;
+				String remapped_path = ResourceLoader::path_remap(path);
+				if (remapped_path.get_extension().to_lower() == "gdc") {
+					Vector<uint8_t> binary_tokens = GDScriptCache::get_binary_tokens(remapped_path);
+					result = binary_tokens.is_empty() ? ERR_FILE_CANT_READ : GDScriptCache::parse(parser, path, String(), binary_tokens);
+				} else {
+					result = GDScriptCache::parse(parser, path, GDScriptCache::get_source_code(path), Vector<uint8_t>());
+				}
+			} break;
 			case PARSED: {
 				analyzer = memnew(GDScriptAnalyzer(parser));
 				status = INHERITANCE_SOLVED;
@@ -112,6 +123,94 @@ void GDScriptCache::remove_script(const String &p_path) {
 	MutexLock lock(singleton->lock);
 	singleton->shallow_gdscript_cache.erase(p_path);
 	singleton->full_gdscript_cache.erase(p_path);
+
+	HashMap<String, ParsedScript>::Iterator E = singleton->parsed_scripts.find(p_path);
+	if (E) {
+		memdelete(E->value.parser);
+		singleton->parsed_scripts.remove(E);
+	}
+}
+
+void GDScriptCache::_parse_scripts_thread(void *p_batch) {
+	// Parsing reads project and editor settings, which are thread safe, and the table of builtin type names,
+	// which parse_scripts() fills beforehand. The analyzer resolves other scripts, so it runs afterwards.
+	ParseBatch *batch = (ParseBatch *)p_batch;
+	for (uint32_t i = batch->next.postincrement(); i < batch->count; i = batch->next.postincrement()) {
+		ParsedScript &parsed = batch->scripts[i];
+		parsed.parser = memnew(GDScriptParser);
+		parsed.error = parse(parsed.parser, parsed.path, parsed.source, parsed.binary_tokens);
+	}
+}
+
+int GDScriptCache::parse_scripts(const Vector<Ref<GDScript>> &p_scripts) {
+	LocalVector<ParsedScript> scripts;
+	{
+		MutexLock lock(singleton->lock);
+		for (const Ref<GDScript> &E : p_scripts) {
+			String path = E->get_path();
+			if (path.is_empty() || singleton->parsed_scripts.has(path) || (E->get_source_code().is_empty() && E->get_binary_tokens_source().is_empty())) {
+				continue;
+			}
+			ParsedScript parsed;
+			parsed.path = path;
+			parsed.source = E->get_source_code();
+			parsed.binary_tokens = E->get_binary_tokens_source();
+			scripts.push_back(parsed);
+		}
+	}
+	if (scripts.size() < 2) {
+		// Not worth starting threads, the script parses when compiled.
+		return 0;
+	}
+
+	// Filled lazily on first use, so not from several parsing threads at once.
+	GDScriptParser::get_builtin_type(SNAME("int"));
+
+	// The caller may hold the cache lock, which WorkerThreadPool threads can be blocked on, so waiting for pool
+	// tasks here could deadlock. The scripts are parsed on threads of their own and on this one instead.
+	ParseBatch batch;
+	batch.scripts = scripts.ptr();
+	batch.count = scripts.size();
+	int thread_count = MIN((int)scripts.size(), OS::get_singleton()->get_processor_count()) - 1;
+	LocalVector<Thread> threads;
+	threads.resize(thread_count);
+	for (int i = 0; i < thread_count; i++) {
+		threads[i].start(&GDScriptCache::_parse_scripts_thread, &batch);
+	}
+	_parse_scripts_thread(&batch);
+	for (int i = 0; i < thread_count; i++) {
+		threads[i].wait_to_finish();
+	}
+
+	MutexLock lock(singleton->lock);
+	for (uint32_t i = 0; i < scripts.size(); i++) {
+		if (singleton->parsed_scripts.has(scripts[i].path)) {
+			memdelete(scripts[i].parser);
+			continue;
+		}
+		singleton->parsed_scripts.insert(scripts[i].path, scripts[i]);
+	}
+	return scripts.size();
+}
+
+GDScriptParser *GDScriptCache::take_parsed_script(const String &p_path, const String &p_source, const Vector<uint8_t> &p_binary_tokens, Error &r_error) {
+	MutexLock lock(singleton->lock);
+	HashMap<String, ParsedScript>::Iterator E = singleton->parsed_scripts.find(p_path);
+	if (!E) {
+		return nullptr;
+	}
+
+	GDScriptParser *parser = E->value.parser;
+	bool matches = E->value.source == p_source && E->value.binary_tokens == p_binary_tokens;
+	if (matches) {
+		r_error = E->value.error;
+	} else {
+		// The script changed since it was parsed.
+		memdelete(parser);
+		parser = nullptr;
+	}
+	singleton->parsed_scripts.remove(E);
+	return parser;
 }
 
 Ref<GDScriptParserRef> GDScriptCache::get_parser(const String &p_path, GDScriptParserRef::Status p_status, Error &r_error, const String &p_owner) {
@@ -127,7 +226,7 @@ Ref<GDScriptParserRef> GDScriptCache::get_parser(const String &p_path, GDScriptP
 			return ref;
 		}
 	} else {
-		if (!FileAccess::exists(p_path)) {
+		if (!FileAccess::exists(ResourceLoader::path_remap(p_path))) {
 			r_error = ERR_FILE_NOT_FOUND;
 			return ref;
 		}
@@ -161,6 +260,33 @@ String GDScriptCache::get_source_code(const String &p_path) {
 	return source;
 }
 
+Vector<uint8_t> GDScriptCache::get_binary_tokens(const String &p_path) {
+	Vector<uint8_t> buffer;
+	Error err;
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ, &err);
+	ERR_FAIL_COND_V_MSG(err, buffer, "Failed to open binary GDScript file '" + p_path + "'.");
+
+	uint64_t len = f->get_length();
+	buffer.resize(len);
+	uint64_t read = f->get_buffer(buffer.ptrw(), buffer.size());
+	ERR_FAIL_COND_V(read != len, Vector<uint8_t>());
+
+	return buffer;
+}
+
+Error GDScriptCache::parse(GDScriptParser *p_parser, const String &p_path, const String &p_source, const Vector<uint8_t> &p_binary_tokens) {
+	// Timed on its own, so the startup benchmark shows how loading splits between parsing and analyzing or compiling.
+	uint64_t parse_from = OS::get_singleton()->get_ticks_usec();
+	Error err;
+	if (!p_binary_tokens.is_empty()) {
+		err = p_parser->parse_binary(p_binary_tokens, p_path);
+	} else {
+		err = p_parser->parse(p_source, p_path, false);
+	}
+	Engine::get_singleton()->startup_benchmark_add_measure("gdscript_parse", OS::get_singleton()->get_ticks_usec() - parse_from);
+	return err;
+}
+
 Ref<GDScript> GDScriptCache::get_shallow_script(const String &p_path, const String &p_owner) {
 	MutexLock lock(singleton->lock);
 	if (!p_owner.is_empty()) {
@@ -210,7 +336,16 @@ Ref<GDScript> GDScriptCache::get_full_script(const String &p_path, Error &r_erro
 		return script;
 	}
 
+	// Dependencies compile from within reload(), only time the outermost script.
+	uint64_t compile_from = singleton->compile_depth == 0 ? OS::get_singleton()->get_ticks_usec() : 0;
+	singleton->compile_depth++;
 	r_error = script->reload();
+	singleton->compile_depth--;
+	if (singleton->compile_depth == 0) {
+		uint64_t compile_time = OS::get_singleton()->get_ticks_usec() - compile_from;
+		Engine::get_singleton()->startup_benchmark_add_measure("gdscript_load", compile_time);
+		print_verbose(vformat("GDScript: Compiled '%s' and its dependencies in %d usec.", p_path, compile_time));
+	}
 	if (r_error) {
 		return script;
 	}
@@ -222,6 +357,8 @@ Ref<GDScript> GDScriptCache::get_full_script(const String &p_path, Error &r_erro
 }
 
 Error GDScriptCache::finish_compiling(const String &p_owner) {
+	MutexLock lock(singleton->lock);
+
 	// Mark this as compiled.
 	Ref<GDScript> script = get_shallow_script(p_owner);
 	singleton->full_gdscript_cache[p_owner] = script.ptr();
@@ -229,6 +366,15 @@ Error GDScriptCache::finish_compiling(const String &p_owner) {
 
 	HashSet<String> depends = singleton->dependencies[p_owner];
 
+	// Parse the dependencies that still have to be compiled concurrently, they are compiled one by one below.
+	Vector<Ref<GDScript>> to_parse;
+	for (const String &E : depends) {
+		if (!singleton->full_gdscript_cache.has(E)) {
+			to_parse.push_back(get_shallow_script(E));
+		}
+	}
+	parse_scripts(to_parse);
+
 	Error err = OK;
 	for (const String &E : depends) {
 		Error this_err = OK;
@@ -250,6 +396,10 @@ GDScriptCache::GDScriptCache() {
 }
 
 GDScriptCache::~GDScriptCache() {
+	for (KeyValue<String, ParsedScript> &E : parsed_scripts) {
+		memdelete(E.value.parser);
+	}
+	parsed_scripts.clear();
 	parser_map.clear();
 	shallow_gdscript_cache.clear();
 	full_gdscript_cache.clear();
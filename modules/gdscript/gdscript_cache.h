@@ -35,6 +35,7 @@
 #include "core/os/mutex.h"
 #include "core/templates/hash_map.h"
 #include "core/templates/hash_set.h"
+#include "core/templates/safe_refcount.h"
 #include "gdscript.h"
 
 class GDScriptAnalyzer;
@@ -70,11 +71,21 @@ public:
 };
 
 class GDScriptCache {
+	struct ParsedScript {
+		String path;
+		String source;
+		Vector<uint8_t> binary_tokens;
+		GDScriptParser *parser = nullptr;
+		Error error = OK;
+	};
+
 	// String key is full path.
 	HashMap<String, GDScriptParserRef *> parser_map;
 	HashMap<String, GDScript *> shallow_gdscript_cache;
 	HashMap<String, GDScript *> full_gdscript_cache;
 	HashMap<String, HashSet<String>> dependencies;
+	HashMap<String, ParsedScript> parsed_scripts; // Parsed ahead of compiling, taken by GDScript::reload().
+	int compile_depth = 0;
 
 	friend class GDScript;
 	friend class GDScriptParserRef;
@@ -84,13 +95,25 @@ class GDScriptCache {
 	Mutex lock;
 	static void remove_script(const String &p_path);
 
+	struct ParseBatch {
+		ParsedScript *scripts = nullptr;
+		uint32_t count = 0;
+		SafeNumeric<uint32_t> next;
+	};
+	static void _parse_scripts_thread(void *p_batch);
+
 public:
 	static Ref<GDScriptParserRef> get_parser(const String &p_path, GDScriptParserRef::Status status, Error &r_error, const String &p_owner = String());
 	static String get_source_code(const String &p_path);
+	static Vector<uint8_t> get_binary_tokens(const String &p_path);
+	static Error parse(GDScriptParser *p_parser, const String &p_path, const String &p_source, const Vector<uint8_t> &p_binary_tokens);
 	static Ref<GDScript> get_shallow_script(const String &p_path, const String &p_owner = String());
 	static Ref<GDScript> get_full_script(const String &p_path, Error &r_error, const String &p_owner = String(), bool p_update_from_disk = false);
 	static Error finish_compiling(const String &p_owner);
 
+	static int parse_scripts(const Vector<Ref<GDScript>> &p_scripts);
+	static GDScriptParser *take_parsed_script(const String &p_path, const String &p_source, const Vector<uint8_t> &p_binary_tokens, Error &r_error);
+
 	GDScriptCache();
 	~GDScriptCache();
 };
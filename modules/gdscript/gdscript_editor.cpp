@@ -184,7 +184,7 @@ bool GDScriptLanguage::supports_documentation() const {
 }
 
 int GDScriptLanguage::find_function(const String &p_function, const String &p_code) const {
-	GDScriptTokenizer tokenizer;
+	GDScriptTokenizerText tokenizer;
 	tokenizer.set_source_code(p_code);
 	int indent = 0;
 	GDScriptTokenizer::Token current = tokenizer.scan();
@@ -321,11 +321,10 @@ void GDScriptLanguage::debug_get_stack_level_members(int p_level, List<String> *
 	Ref<GDScript> scr = instance->get_script();
 	ERR_FAIL_COND(scr.is_null());
 
-	const HashMap<StringName, GDScript::MemberInfo> &mi = scr->debug_get_member_indices();
-
-	for (const KeyValue<StringName, GDScript::MemberInfo> &E : mi) {
-		p_members->push_back(E.key);
-		p_values->push_back(instance->debug_get_member_by_index(E.value.index));
+	const Vector<StringName> names = scr->get_member_names_by_index();
+	for (int i = 0; i < names.size(); i++) {
+		p_members->push_back(names[i]);
+		p_values->push_back(instance->debug_get_member_by_index(i));
 	}
 }
 
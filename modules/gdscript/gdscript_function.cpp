@@ -30,6 +30,8 @@
 
 #include "gdscript_function.h"
 
+#include "core/config/engine.h"
+#include "core/core_string_names.h"
 #include "gdscript.h"
 
 const int *GDScriptFunction::get_code() const {
@@ -138,6 +140,139 @@ void GDScriptFunction::debug_get_stack_member_state(int p_line, List<Pair<String
 	}
 }
 
+const GDScriptFunction::InlineCacheEntry *GDScriptFunction::_fill_inline_cache(int p_cache, InlineCacheAccess p_access, Object *p_object, GDScriptInstance *p_instance, const StringName &p_name) {
+	InlineCache &cache = _inline_caches_ptr[p_cache];
+
+	InlineCacheEntry entry;
+	GDScript *script = p_instance ? p_instance->script.ptr() : nullptr;
+	entry.script = script;
+	entry.class_name = p_object->get_class_name().data_unique_pointer();
+	entry.layout_version = script ? script->layout_version : 0;
+	entry.reload_version = GDScript::reload_version.get();
+	entry.methods_version = ClassDB::get_methods_version();
+
+	// Only accesses that always resolve the same way for this receiver type are cached, anything that
+	// can be intercepted by _get(), _set() or an extension keeps going through Object.
+	bool cacheable = false;
+	switch (p_access) {
+		case INLINE_CACHE_GET:
+		case INLINE_CACHE_SET: {
+#ifdef TOOLS_ENABLED
+			if (p_access == INLINE_CACHE_SET && Engine::get_singleton()->is_editor_hint()) {
+				break; // Object::set() marks the object as edited.
+			}
+#endif
+			bool shadowed = false;
+			if (script) {
+				const GDScript::MemberInfo *member = script->member_indices.getptr(p_name);
+				if (member) {
+					if (p_access == INLINE_CACHE_GET ? member->getter : member->setter) {
+						break;
+					}
+					if (p_access == INLINE_CACHE_SET && member->data_type.has_type) {
+						if (member->data_type.kind != GDScriptDataType::BUILTIN || member->data_type.has_container_element_type()) {
+							break;
+						}
+						// Values of other types need a conversion, those take the regular path.
+						entry.value_type = member->data_type.builtin_type;
+					}
+					entry.kind = InlineCacheEntry::SCRIPT_MEMBER;
+					entry.index = member->index;
+					cacheable = true;
+					break;
+				}
+
+				const StringName &hook = p_access == INLINE_CACHE_GET ? GDScriptLanguage::get_singleton()->strings._get : GDScriptLanguage::get_singleton()->strings._set;
+				for (const GDScript *sptr = script; sptr && !shadowed; sptr = sptr->_base) {
+					shadowed = sptr->member_functions.has(hook);
+					if (p_access == INLINE_CACHE_GET) {
+						shadowed = shadowed || sptr->constants.has(p_name) || sptr->_signals.has(p_name) || sptr->member_functions.has(p_name);
+					}
+				}
+			}
+
+			const StringName &class_name = p_object->get_class_name();
+			ClassDB::APIType api = ClassDB::get_api_type(class_name);
+			if (shadowed || (api != ClassDB::API_CORE && api != ClassDB::API_EDITOR)) {
+				break;
+			}
+
+			if (p_access == INLINE_CACHE_GET) {
+				int index = -1;
+				entry.method = ClassDB::get_property_getter_bind(class_name, p_name, &index);
+				if (index >= 0) {
+					break; // Indexed getters are rare, not worth an extra argument.
+				}
+			} else {
+				entry.method = ClassDB::get_property_setter_bind(class_name, p_name, &entry.index);
+			}
+			if (entry.method) {
+				entry.kind = InlineCacheEntry::NATIVE_PROPERTY;
+				cacheable = true;
+			}
+		} break;
+		case INLINE_CACHE_CALL: {
+			// Both get special handling in Object::callp() and GDScriptInstance::callp().
+			if (p_name == CoreStringNames::get_singleton()->_free || p_name == SNAME("_ready")) {
+				break;
+			}
+			// Scripts and native class wrappers look names up in their own callp(), static functions first,
+			// so their native methods of the same name must not be cached.
+			if (Object::cast_to<Script>(p_object) || Object::cast_to<GDScriptNativeClass>(p_object)) {
+				break;
+			}
+
+			for (GDScript *sptr = script; sptr; sptr = sptr->_base) {
+				GDScriptFunction **function = sptr->member_functions.getptr(p_name);
+				if (function) {
+					entry.kind = InlineCacheEntry::SCRIPT_FUNCTION;
+					entry.function = *function;
+					cacheable = true;
+					break;
+				}
+			}
+			if (!cacheable) {
+				entry.method = ClassDB::get_method_cached(p_object->get_class_name(), p_name);
+				if (entry.method) {
+					entry.kind = InlineCacheEntry::NATIVE_METHOD;
+					cacheable = true;
+				}
+			}
+		} break;
+	}
+
+	if (!cacheable) {
+		cache.failed_fills.fetch_add(1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	InlineCacheEntry *new_entry = memnew(InlineCacheEntry(entry));
+	for (int i = 0; i < INLINE_CACHE_ENTRIES; i++) {
+		InlineCacheEntry *expected = nullptr;
+		if (cache.entries[i].compare_exchange_strong(expected, new_entry, std::memory_order_release, std::memory_order_relaxed)) {
+			return new_entry;
+		}
+	}
+
+	// All taken, reuse an entry that can't match anymore. Its script may have been freed, so it's
+	// only compared by pointer, and an entry for this receiver type can only be here if it's stale.
+	for (int i = 0; i < INLINE_CACHE_ENTRIES; i++) {
+		InlineCacheEntry *old_entry = cache.entries[i].load(std::memory_order_acquire);
+		bool stale = old_entry->reload_version != entry.reload_version || old_entry->methods_version != entry.methods_version || (old_entry->script == entry.script && old_entry->class_name == entry.class_name);
+		if (stale && cache.entries[i].compare_exchange_strong(old_entry, new_entry, std::memory_order_release, std::memory_order_relaxed)) {
+			retired_inline_cache_entries_lock.lock();
+			retired_inline_cache_entries.push_back(old_entry);
+			retired_inline_cache_entries_lock.unlock();
+			return new_entry;
+		}
+	}
+
+	// Megamorphic site, stop trying.
+	memdelete(new_entry);
+	cache.failed_fills.store(INLINE_CACHE_MAX_FAILED_FILLS, std::memory_order_relaxed);
+	return nullptr;
+}
+
 GDScriptFunction::GDScriptFunction() {
 	name = "<anonymous>";
 #ifdef DEBUG_ENABLED
@@ -153,6 +288,21 @@ GDScriptFunction::~GDScriptFunction() {
 		memdelete(lambdas[i]);
 	}
 
+	for (int i = 0; i < _inline_caches_count; i++) {
+		for (int j = 0; j < INLINE_CACHE_ENTRIES; j++) {
+			InlineCacheEntry *entry = _inline_caches_ptr[i].entries[j].load(std::memory_order_relaxed);
+			if (entry) {
+				memdelete(entry);
+			}
+		}
+	}
+	for (uint32_t i = 0; i < retired_inline_cache_entries.size(); i++) {
+		memdelete(retired_inline_cache_entries[i]);
+	}
+	if (_inline_caches_ptr) {
+		memdelete_arr(_inline_caches_ptr);
+	}
+
 #ifdef DEBUG_ENABLED
 
 	MutexLock lock(GDScriptLanguage::get_singleton()->mutex);
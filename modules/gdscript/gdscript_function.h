@@ -33,13 +33,17 @@
 
 #include "core/object/ref_counted.h"
 #include "core/object/script_language.h"
+#include "core/os/spin_lock.h"
 #include "core/os/thread.h"
 #include "core/string/string_name.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/pair.h"
 #include "core/templates/self_list.h"
 #include "core/variant/variant.h"
 #include "gdscript_utility_functions.h"
 
+#include <atomic>
+
 class GDScriptInstance;
 class GDScript;
 
@@ -219,6 +223,29 @@ public:
 	enum Opcode {
 		OPCODE_OPERATOR,
 		OPCODE_OPERATOR_VALIDATED,
+		OPCODE_OPERATOR_ADD_INT,
+		OPCODE_OPERATOR_SUBTRACT_INT,
+		OPCODE_OPERATOR_MULTIPLY_INT,
+		OPCODE_OPERATOR_EQUAL_INT,
+		OPCODE_OPERATOR_NOT_EQUAL_INT,
+		OPCODE_OPERATOR_LESS_INT,
+		OPCODE_OPERATOR_LESS_EQUAL_INT,
+		OPCODE_OPERATOR_GREATER_INT,
+		OPCODE_OPERATOR_GREATER_EQUAL_INT,
+		OPCODE_OPERATOR_ADD_FLOAT,
+		OPCODE_OPERATOR_SUBTRACT_FLOAT,
+		OPCODE_OPERATOR_MULTIPLY_FLOAT,
+		OPCODE_OPERATOR_DIVIDE_FLOAT,
+		OPCODE_OPERATOR_LESS_FLOAT,
+		OPCODE_OPERATOR_LESS_EQUAL_FLOAT,
+		OPCODE_OPERATOR_GREATER_FLOAT,
+		OPCODE_OPERATOR_GREATER_EQUAL_FLOAT,
+		OPCODE_OPERATOR_ADD_VECTOR2,
+		OPCODE_OPERATOR_SUBTRACT_VECTOR2,
+		OPCODE_OPERATOR_MULTIPLY_VECTOR2_FLOAT,
+		OPCODE_OPERATOR_ADD_VECTOR3,
+		OPCODE_OPERATOR_SUBTRACT_VECTOR3,
+		OPCODE_OPERATOR_MULTIPLY_VECTOR3_FLOAT,
 		OPCODE_EXTENDS_TEST,
 		OPCODE_IS_BUILTIN,
 		OPCODE_SET_KEYED,
@@ -468,6 +495,9 @@ private:
 	MethodBind **_methods_ptr = nullptr;
 	int _lambdas_count = 0;
 	GDScriptFunction **_lambdas_ptr = nullptr;
+	struct InlineCache;
+	int _inline_caches_count = 0;
+	InlineCache *_inline_caches_ptr = nullptr;
 	const int *_code_ptr = nullptr;
 	int _code_size = 0;
 	int _argument_count = 0;
@@ -504,6 +534,55 @@ private:
 
 	HashMap<int, Variant::Type> temporary_slots;
 
+	// Inline caches of named accesses and calls on objects, one per OPCODE_GET_NAMED, OPCODE_SET_NAMED and
+	// OPCODE_CALL* instruction. Entries are filled on a miss and never change once published, so threads
+	// running the function can share them without locking. Stale ones can be swapped for new entries.
+	struct InlineCacheEntry {
+		enum Kind {
+			SCRIPT_MEMBER,
+			SCRIPT_FUNCTION,
+			NATIVE_PROPERTY,
+			NATIVE_METHOD,
+		};
+
+		Kind kind = SCRIPT_MEMBER;
+		const GDScript *script = nullptr; // Script of the receiver, nullptr if it has no script instance.
+		const void *class_name = nullptr; // Unique pointer of the receiver's class name.
+		uint32_t layout_version = 0;
+		uint32_t reload_version = 0;
+		uint32_t methods_version = 0;
+		int index = -1; // Member index, or the index passed to an indexed native setter.
+		Variant::Type value_type = Variant::NIL; // Type a typed member can be set to as is, NIL for untyped members.
+		GDScriptFunction *function = nullptr;
+		MethodBind *method = nullptr; // Native method, property getter or setter.
+	};
+
+	enum {
+		INLINE_CACHE_ENTRIES = 4, // Receiver types remembered per instruction.
+		INLINE_CACHE_MAX_FAILED_FILLS = 16, // Give up on instructions whose receivers can't be cached.
+	};
+
+	struct InlineCache {
+		std::atomic<InlineCacheEntry *> entries[INLINE_CACHE_ENTRIES] = {};
+		std::atomic<uint32_t> failed_fills = { 0 };
+	};
+
+	enum InlineCacheAccess {
+		INLINE_CACHE_GET,
+		INLINE_CACHE_SET,
+		INLINE_CACHE_CALL,
+	};
+
+	// Stale entries replaced by new ones, other threads may still be reading them until the function is freed.
+	SpinLock retired_inline_cache_entries_lock;
+	LocalVector<InlineCacheEntry *> retired_inline_cache_entries;
+
+	const InlineCacheEntry *_fill_inline_cache(int p_cache, InlineCacheAccess p_access, Object *p_object, GDScriptInstance *p_instance, const StringName &p_name);
+	_FORCE_INLINE_ const InlineCacheEntry *_get_inline_cache_entry(int p_cache, InlineCacheAccess p_access, Object *p_object, GDScriptInstance *p_instance, const StringName &p_name);
+	_FORCE_INLINE_ bool _inline_cache_get_named(int p_cache, const Variant *p_base, const StringName &p_name, Variant *r_ret);
+	_FORCE_INLINE_ bool _inline_cache_set_named(int p_cache, const Variant *p_base, const StringName &p_name, const Variant *p_value, bool &r_valid);
+	_FORCE_INLINE_ bool _inline_cache_call(int p_cache, const Variant *p_base, const StringName &p_name, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error);
+
 #ifdef TOOLS_ENABLED
 	Vector<StringName> arg_names;
 	Vector<Variant> default_arg_values;
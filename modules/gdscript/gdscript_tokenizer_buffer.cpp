@@ -0,0 +1,432 @@
+/*************************************************************************/
+/*  gdscript_tokenizer_buffer.cpp                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_tokenizer_buffer.h"
+
+#include "core/io/compression.h"
+#include "core/io/marshalls.h"
+#include "core/templates/local_vector.h"
+#include "core/version.h"
+
+// Header: "GDSC", format version, token type count, payload size, compressed payload size (0 if stored as is),
+// engine major and minor version. Tokens are checked against the engine version instead of the build hash, so
+// patch releases of export templates keep loading them while literals or parsing rules that change with a
+// minor version can't be misread.
+// The payload holds the table of identifiers and other token sources, the table of literals and the tokens,
+// as variable length integers. Lines are stored relative to the previous token.
+
+static void _encode_uint(LocalVector<uint8_t> &r_buffer, uint32_t p_value) {
+	while (p_value >= 0x80) {
+		r_buffer.push_back((p_value & 0x7F) | 0x80);
+		p_value >>= 7;
+	}
+	r_buffer.push_back(p_value);
+}
+
+static void _encode_int(LocalVector<uint8_t> &r_buffer, int32_t p_value) {
+	// Zigzag, so small negative deltas stay short.
+	_encode_uint(r_buffer, (uint32_t(p_value) << 1) ^ uint32_t(p_value >> 31));
+}
+
+static bool _decode_uint(const uint8_t *&r_ptr, const uint8_t *p_end, uint32_t &r_value) {
+	r_value = 0;
+	for (int shift = 0; shift < 32; shift += 7) {
+		if (r_ptr >= p_end) {
+			return false;
+		}
+		uint8_t byte = *r_ptr++;
+		r_value |= uint32_t(byte & 0x7F) << shift;
+		if (!(byte & 0x80)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool _decode_int(const uint8_t *&r_ptr, const uint8_t *p_end, int32_t &r_value) {
+	uint32_t value;
+	if (!_decode_uint(r_ptr, p_end, value)) {
+		return false;
+	}
+	r_value = int32_t(value >> 1) ^ -int32_t(value & 1);
+	return true;
+}
+
+Vector<uint8_t> GDScriptTokenizerBuffer::parse_code_string(const String &p_code) {
+	// The code must parse without errors. The tokenizer runs here without the parser, so indentation inside
+	// brackets and lambdas may look wrong to it, such errors are skipped and indentation is rebuilt on load.
+	GDScriptTokenizerText tokenizer;
+	tokenizer.set_source_code(p_code);
+
+	HashMap<String, uint32_t> string_map;
+	LocalVector<String> strings;
+	HashMap<Variant, uint32_t, VariantHasher, VariantComparator> constant_map;
+	LocalVector<Variant> constants;
+
+	LocalVector<uint8_t> token_data;
+	uint32_t token_count = 0;
+	int previous_start_line = 0;
+	int previous_end_line = 0;
+	bool after_newline = false;
+	Token newline;
+
+	for (;;) {
+		Token token = tokenizer.scan();
+		if (token.type == Token::ERROR || token.type == Token::INDENT || token.type == Token::DEDENT) {
+			continue;
+		}
+		if (token.type == Token::NEWLINE) {
+			after_newline = true;
+			newline = token;
+			continue;
+		}
+
+		uint32_t flags = 0;
+		uint32_t source_index = 0;
+		uint32_t literal_index = 0;
+		if (token.type == Token::LITERAL) {
+			flags |= TOKEN_HAS_LITERAL;
+			if (!constant_map.has(token.literal)) {
+				constant_map[token.literal] = constants.size();
+				constants.push_back(token.literal);
+			}
+			literal_index = constant_map[token.literal];
+		} else if (token.source != get_token_name(token.type)) {
+			flags |= TOKEN_HAS_SOURCE;
+			if (!string_map.has(token.source)) {
+				string_map[token.source] = strings.size();
+				strings.push_back(token.source);
+			}
+			source_index = string_map[token.source];
+		}
+		if (after_newline) {
+			flags |= TOKEN_AFTER_NEWLINE;
+		}
+		bool multiline = token.end_line != token.start_line || token.leftmost_column != token.start_column || token.rightmost_column != token.end_column;
+		if (multiline) {
+			flags |= TOKEN_MULTILINE;
+		}
+
+		_encode_uint(token_data, token.type | (flags << TOKEN_FLAGS_SHIFT));
+		if (flags & TOKEN_HAS_SOURCE) {
+			_encode_uint(token_data, source_index);
+		}
+		if (flags & TOKEN_HAS_LITERAL) {
+			_encode_uint(token_data, literal_index);
+		}
+		if (after_newline) {
+			_encode_int(token_data, newline.start_line - previous_end_line);
+			_encode_uint(token_data, newline.start_column);
+		}
+		_encode_int(token_data, token.start_line - previous_start_line);
+		_encode_uint(token_data, token.start_column);
+		_encode_int(token_data, token.end_column - token.start_column);
+		if (multiline) {
+			_encode_uint(token_data, token.end_line - token.start_line);
+			_encode_uint(token_data, token.leftmost_column);
+			_encode_uint(token_data, token.rightmost_column);
+		}
+
+		token_count++;
+		previous_start_line = token.start_line;
+		previous_end_line = token.end_line;
+		after_newline = false;
+
+		if (token.type == Token::TK_EOF) {
+			break;
+		}
+	}
+
+	LocalVector<uint8_t> payload;
+	_encode_uint(payload, strings.size());
+	for (uint32_t i = 0; i < strings.size(); i++) {
+		CharString utf8 = strings[i].utf8();
+		_encode_uint(payload, utf8.length());
+		for (int j = 0; j < utf8.length(); j++) {
+			payload.push_back(utf8[j]);
+		}
+	}
+	_encode_uint(payload, constants.size());
+	for (uint32_t i = 0; i < constants.size(); i++) {
+		int len;
+		Error err = encode_variant(constants[i], nullptr, len, false);
+		ERR_FAIL_COND_V(err != OK, Vector<uint8_t>());
+		_encode_uint(payload, len);
+		uint32_t pos = payload.size();
+		payload.resize(pos + len);
+		encode_variant(constants[i], &payload[pos], len, false);
+	}
+	_encode_uint(payload, token_count);
+	uint32_t tokens_start = payload.size();
+	payload.resize(tokens_start + token_data.size());
+	memcpy(&payload[tokens_start], token_data.ptr(), token_data.size());
+
+	Vector<uint8_t> buffer;
+	buffer.resize(HEADER_SIZE + Compression::get_max_compressed_buffer_size(payload.size(), Compression::MODE_ZSTD));
+	uint8_t *w = buffer.ptrw();
+	w[0] = 'G';
+	w[1] = 'D';
+	w[2] = 'S';
+	w[3] = 'C';
+	encode_uint32(TOKENIZER_VERSION, &w[4]);
+	encode_uint32(Token::TK_MAX, &w[8]);
+	encode_uint32(payload.size(), &w[12]);
+	encode_uint32((VERSION_MAJOR << 16) | VERSION_MINOR, &w[20]);
+
+	int compressed_size = Compression::compress(&w[HEADER_SIZE], payload.ptr(), payload.size(), Compression::MODE_ZSTD);
+	if (compressed_size > 0 && compressed_size < int(payload.size())) {
+		encode_uint32(compressed_size, &w[16]);
+		buffer.resize(HEADER_SIZE + compressed_size);
+	} else {
+		encode_uint32(0, &w[16]);
+		memcpy(&w[HEADER_SIZE], payload.ptr(), payload.size());
+		buffer.resize(HEADER_SIZE + payload.size());
+	}
+	return buffer;
+}
+
+Error GDScriptTokenizerBuffer::set_code_buffer(const Vector<uint8_t> &p_buffer) {
+	const uint8_t *buf = p_buffer.ptr();
+	ERR_FAIL_COND_V(p_buffer.size() < HEADER_SIZE || buf[0] != 'G' || buf[1] != 'D' || buf[2] != 'S' || buf[3] != 'C', ERR_INVALID_DATA);
+	ERR_FAIL_COND_V_MSG(decode_uint32(&buf[4]) != TOKENIZER_VERSION || decode_uint32(&buf[8]) != Token::TK_MAX, ERR_INVALID_DATA,
+			"Binary GDScript tokens were saved by an incompatible engine version. Export the project again.");
+	uint32_t engine_version = decode_uint32(&buf[20]);
+	ERR_FAIL_COND_V_MSG(engine_version != uint32_t((VERSION_MAJOR << 16) | VERSION_MINOR), ERR_INVALID_DATA,
+			vformat("Binary GDScript tokens were exported with Godot %d.%d, but this is Godot %d.%d. Export the project again.", engine_version >> 16, engine_version & 0xFFFF, VERSION_MAJOR, VERSION_MINOR));
+
+	uint32_t payload_size = decode_uint32(&buf[12]);
+	uint32_t compressed_size = decode_uint32(&buf[16]);
+	Vector<uint8_t> payload;
+	if (compressed_size == 0) {
+		ERR_FAIL_COND_V(payload_size != uint32_t(p_buffer.size() - HEADER_SIZE), ERR_INVALID_DATA);
+		payload = p_buffer.slice(HEADER_SIZE);
+	} else {
+		ERR_FAIL_COND_V(compressed_size != uint32_t(p_buffer.size() - HEADER_SIZE), ERR_INVALID_DATA);
+		payload.resize(payload_size);
+		int result = Compression::decompress(payload.ptrw(), payload_size, &buf[HEADER_SIZE], compressed_size, Compression::MODE_ZSTD);
+		ERR_FAIL_COND_V(result != int(payload_size), ERR_INVALID_DATA);
+	}
+
+	const uint8_t *ptr = payload.ptr();
+	const uint8_t *end = ptr + payload.size();
+	uint32_t count;
+
+	ERR_FAIL_COND_V(!_decode_uint(ptr, end, count) || count > uint32_t(payload.size()), ERR_INVALID_DATA);
+	Vector<String> strings;
+	Vector<StringName> string_names;
+	strings.resize(count);
+	string_names.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t len;
+		ERR_FAIL_COND_V(!_decode_uint(ptr, end, len) || len > uint32_t(end - ptr), ERR_INVALID_DATA);
+		String str;
+		str.parse_utf8((const char *)ptr, len);
+		strings.write[i] = str;
+		string_names.write[i] = str;
+		ptr += len;
+	}
+
+	ERR_FAIL_COND_V(!_decode_uint(ptr, end, count) || count > uint32_t(payload.size()), ERR_INVALID_DATA);
+	Vector<Variant> constants;
+	constants.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t len;
+		ERR_FAIL_COND_V(!_decode_uint(ptr, end, len) || len > uint32_t(end - ptr), ERR_INVALID_DATA);
+		Error err = decode_variant(constants.write[i], ptr, len, nullptr, false);
+		ERR_FAIL_COND_V(err != OK, err);
+		ptr += len;
+	}
+
+	ERR_FAIL_COND_V(!_decode_uint(ptr, end, count) || count == 0 || count > uint32_t(payload.size()), ERR_INVALID_DATA);
+	tokens.resize(count);
+	int previous_start_line = 0;
+	int previous_end_line = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		BufferToken &buffer_token = tokens.write[i];
+		Token &token = buffer_token.token;
+
+		uint32_t header;
+		ERR_FAIL_COND_V(!_decode_uint(ptr, end, header), ERR_INVALID_DATA);
+		uint32_t type = header & ((1 << TOKEN_FLAGS_SHIFT) - 1);
+		uint32_t flags = header >> TOKEN_FLAGS_SHIFT;
+		ERR_FAIL_COND_V(type >= Token::TK_MAX, ERR_INVALID_DATA);
+		token.type = Token::Type(type);
+
+		if (flags & TOKEN_HAS_SOURCE) {
+			uint32_t index;
+			ERR_FAIL_COND_V(!_decode_uint(ptr, end, index) || index >= uint32_t(strings.size()), ERR_INVALID_DATA);
+			token.source = strings[index];
+			if (token.type == Token::IDENTIFIER || token.type == Token::ANNOTATION) {
+				token.literal = string_names[index];
+			}
+		} else if (token.type != Token::LITERAL) {
+			token.source = get_token_name(token.type);
+		}
+		if (flags & TOKEN_HAS_LITERAL) {
+			uint32_t index;
+			ERR_FAIL_COND_V(!_decode_uint(ptr, end, index) || index >= uint32_t(constants.size()), ERR_INVALID_DATA);
+			token.literal = constants[index];
+		}
+
+		int32_t line_delta;
+		uint32_t column;
+		int32_t column_delta;
+		if (flags & TOKEN_AFTER_NEWLINE) {
+			ERR_FAIL_COND_V(!_decode_int(ptr, end, line_delta) || !_decode_uint(ptr, end, column), ERR_INVALID_DATA);
+			Token &newline = buffer_token.newline;
+			newline.type = Token::NEWLINE;
+			newline.start_line = previous_end_line + line_delta;
+			newline.end_line = newline.start_line;
+			newline.start_column = column;
+			newline.end_column = column + 1;
+			newline.leftmost_column = newline.start_column;
+			newline.rightmost_column = newline.end_column;
+			buffer_token.after_newline = true;
+		}
+
+		ERR_FAIL_COND_V(!_decode_int(ptr, end, line_delta) || !_decode_uint(ptr, end, column) || !_decode_int(ptr, end, column_delta), ERR_INVALID_DATA);
+		token.start_line = previous_start_line + line_delta;
+		token.end_line = token.start_line;
+		token.start_column = column;
+		token.end_column = column + column_delta;
+		token.leftmost_column = token.start_column;
+		token.rightmost_column = token.end_column;
+		if (flags & TOKEN_MULTILINE) {
+			uint32_t lines;
+			uint32_t leftmost;
+			uint32_t rightmost;
+			ERR_FAIL_COND_V(!_decode_uint(ptr, end, lines) || !_decode_uint(ptr, end, leftmost) || !_decode_uint(ptr, end, rightmost), ERR_INVALID_DATA);
+			token.end_line = token.start_line + lines;
+			token.leftmost_column = leftmost;
+			token.rightmost_column = rightmost;
+		}
+
+		previous_start_line = token.start_line;
+		previous_end_line = token.end_line;
+	}
+	ERR_FAIL_COND_V(ptr != end || tokens[count - 1].token.type != Token::TK_EOF, ERR_INVALID_DATA);
+
+	current = 0;
+	newline_checked = false;
+	multiline_mode = false;
+	pending_indents = 0;
+	indent_stack.clear();
+	indent_stack_stack.clear();
+	return OK;
+}
+
+void GDScriptTokenizerBuffer::set_multiline_mode(bool p_state) {
+	multiline_mode = p_state;
+}
+
+void GDScriptTokenizerBuffer::push_expression_indented_block() {
+	indent_stack_stack.push_back(indent_stack);
+}
+
+void GDScriptTokenizerBuffer::pop_expression_indented_block() {
+	ERR_FAIL_COND(indent_stack_stack.size() == 0);
+	indent_stack = indent_stack_stack.back()->get();
+	indent_stack_stack.pop_back();
+}
+
+void GDScriptTokenizerBuffer::_check_indent(int p_indent) {
+	// Same as GDScriptTokenizerText::check_indent(), the indentation is the column the line starts at.
+	int previous_indent = indent_stack.is_empty() ? 0 : indent_stack.back()->get();
+	if (p_indent == previous_indent) {
+		return;
+	}
+	if (p_indent > previous_indent) {
+		indent_stack.push_back(p_indent);
+		pending_indents++;
+		return;
+	}
+	while (!indent_stack.is_empty() && indent_stack.back()->get() > p_indent) {
+		indent_stack.pop_back();
+		pending_indents--;
+	}
+	if ((!indent_stack.is_empty() && indent_stack.back()->get() != p_indent) || (indent_stack.is_empty() && p_indent != 0)) {
+		// Mismatched alignment, which code that parsed can't have. Be lenient like the text tokenizer.
+		indent_stack.push_back(p_indent);
+	}
+}
+
+GDScriptTokenizer::Token GDScriptTokenizerBuffer::_make_indent_token(Token::Type p_type, const Token &p_next) const {
+	Token token(p_type);
+	token.start_line = p_next.start_line;
+	token.end_line = p_next.start_line;
+	token.start_column = 1;
+	token.leftmost_column = 1;
+	token.end_column = p_next.start_column;
+	token.rightmost_column = p_next.start_column;
+	if (p_type == Token::DEDENT) {
+		token.end_column += 1;
+		token.rightmost_column += 1;
+	}
+	return token;
+}
+
+GDScriptTokenizer::Token GDScriptTokenizerBuffer::scan() {
+	if (tokens.is_empty()) {
+		return Token(Token::TK_EOF);
+	}
+	const BufferToken &next = tokens[current];
+
+	// Line breaks before a token, and the indentation changes that come with them, depend on the
+	// multiline mode at the time the token is reached.
+	if (!newline_checked) {
+		newline_checked = true;
+		if (next.token.type == Token::TK_EOF && next.after_newline) {
+			// A line break at the end closes every indentation level, even in multiline mode.
+			pending_indents -= indent_stack.size();
+			indent_stack.clear();
+		}
+		if (next.after_newline && !multiline_mode) {
+			if (next.token.type != Token::TK_EOF) {
+				_check_indent(next.token.start_column - 1);
+			}
+			return next.newline;
+		}
+	}
+
+	if (pending_indents > 0) {
+		pending_indents--;
+		return _make_indent_token(Token::INDENT, next.token);
+	}
+	if (pending_indents < 0) {
+		pending_indents++;
+		return _make_indent_token(Token::DEDENT, next.token);
+	}
+
+	if (current < tokens.size() - 1) {
+		current++;
+		newline_checked = false;
+	}
+	return next.token;
+}
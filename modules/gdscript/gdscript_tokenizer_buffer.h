@@ -0,0 +1,96 @@
+/*************************************************************************/
+/*  gdscript_tokenizer_buffer.h                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_TOKENIZER_BUFFER_H
+#define GDSCRIPT_TOKENIZER_BUFFER_H
+
+#include "gdscript_tokenizer.h"
+
+// Replays the tokens of a script saved with parse_code_string(), which exported projects ship instead
+// of the source code. Only tokens are stored, line breaks and indentation are rebuilt while scanning,
+// since they depend on the multiline mode the parser is in.
+class GDScriptTokenizerBuffer : public GDScriptTokenizer {
+public:
+	enum {
+		TOKENIZER_VERSION = 2, // Bump when the token types or the encoding below change.
+		HEADER_SIZE = 24,
+	};
+
+private:
+	enum {
+		TOKEN_HAS_SOURCE = 1 << 0,
+		TOKEN_HAS_LITERAL = 1 << 1,
+		TOKEN_AFTER_NEWLINE = 1 << 2,
+		TOKEN_MULTILINE = 1 << 3,
+		TOKEN_FLAGS_SHIFT = 8,
+	};
+
+	struct BufferToken {
+		Token token;
+		bool after_newline = false;
+		Token newline;
+	};
+
+	Vector<BufferToken> tokens;
+	int current = 0;
+	bool newline_checked = false;
+	bool multiline_mode = false;
+	int pending_indents = 0;
+	List<int> indent_stack;
+	List<List<int>> indent_stack_stack; // For lambdas, which require manipulating the indentation point.
+
+#ifdef TOOLS_ENABLED
+	HashMap<int, CommentData> comments; // Comments aren't stored, always empty.
+#endif // TOOLS_ENABLED
+
+	void _check_indent(int p_indent);
+	Token _make_indent_token(Token::Type p_type, const Token &p_next) const;
+
+public:
+	static Vector<uint8_t> parse_code_string(const String &p_code);
+	Error set_code_buffer(const Vector<uint8_t> &p_buffer);
+
+#ifdef TOOLS_ENABLED
+	virtual const HashMap<int, CommentData> &get_comments() const override {
+		return comments;
+	}
+#endif // TOOLS_ENABLED
+
+	virtual int get_cursor_line() const override { return -1; }
+	virtual int get_cursor_column() const override { return -1; }
+	virtual void set_cursor_position(int p_line, int p_column) override {}
+	virtual void set_multiline_mode(bool p_state) override;
+	virtual bool is_past_cursor() const override { return false; }
+	virtual void push_expression_indented_block() override;
+	virtual void pop_expression_indented_block() override;
+	virtual Token scan() override;
+};
+
+#endif // GDSCRIPT_TOKENIZER_BUFFER_H
@@ -0,0 +1,996 @@
+/*************************************************************************/
+/*  gdscript_tree_buffer.cpp                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_tree_buffer.h"
+
+#include "core/io/compression.h"
+#include "core/io/marshalls.h"
+#include "core/templates/local_vector.h"
+#include "core/version.h"
+
+// Header: "GDST", format version, node type count, payload size, compressed payload size (0 if stored as is),
+// engine major and minor version, laid out like the one of GDScriptTokenizerBuffer.
+// The payload holds the table of strings, the table of constants, the type of every node and then the fields
+// of every node, in the order of the parser's node list. Nodes refer to each other by index, 0 being null.
+// Both directions go through the same field list, _process_node(), with an archive that either writes the
+// fields or reads them back, so the two can't drift apart.
+
+static void _encode_uint(LocalVector<uint8_t> &r_buffer, uint64_t p_value) {
+	while (p_value >= 0x80) {
+		r_buffer.push_back((p_value & 0x7F) | 0x80);
+		p_value >>= 7;
+	}
+	r_buffer.push_back(p_value);
+}
+
+static void _encode_int(LocalVector<uint8_t> &r_buffer, int64_t p_value) {
+	// Zigzag, so small negative values stay short.
+	_encode_uint(r_buffer, (uint64_t(p_value) << 1) ^ uint64_t(p_value >> 63));
+}
+
+static bool _decode_uint(const uint8_t *&r_ptr, const uint8_t *p_end, uint64_t &r_value) {
+	r_value = 0;
+	for (int shift = 0; shift < 64; shift += 7) {
+		if (r_ptr >= p_end) {
+			return false;
+		}
+		uint8_t byte = *r_ptr++;
+		r_value |= uint64_t(byte & 0x7F) << shift;
+		if (!(byte & 0x80)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+template <class T>
+static bool _is_node_type(const GDScriptParser::Node *p_node) {
+	static const GDScriptParser::Node::Type type = T().type;
+	return p_node->type == type;
+}
+
+template <>
+bool _is_node_type<GDScriptParser::Node>(const GDScriptParser::Node *p_node) {
+	return true;
+}
+
+template <>
+bool _is_node_type<GDScriptParser::ExpressionNode>(const GDScriptParser::Node *p_node) {
+	return p_node->is_expression();
+}
+
+class GDScriptTreeWriter {
+	HashMap<String, uint32_t> string_map;
+	HashMap<Variant, uint32_t, VariantHasher, VariantComparator> constant_map;
+
+public:
+	HashMap<const GDScriptParser::Node *, uint32_t> node_indices;
+	LocalVector<String> strings;
+	LocalVector<Variant> constants;
+	LocalVector<uint8_t> data;
+
+	bool is_reading() const { return false; }
+
+	int process_size(int p_size) {
+		_encode_uint(data, p_size);
+		return p_size;
+	}
+
+	template <class E>
+	void process_enum(E &r_value, int p_count) {
+		_encode_uint(data, uint32_t(r_value));
+	}
+
+	void process(bool &r_value) { _encode_uint(data, r_value); }
+	void process(uint32_t &r_value) { _encode_uint(data, r_value); }
+	void process(int &r_value) { _encode_int(data, r_value); }
+	void process(int64_t &r_value) { _encode_int(data, r_value); }
+
+	void process(String &r_value) {
+		if (!string_map.has(r_value)) {
+			string_map[r_value] = strings.size();
+			strings.push_back(r_value);
+		}
+		_encode_uint(data, string_map[r_value]);
+	}
+
+	void process(StringName &r_value) {
+		String string = r_value;
+		process(string);
+	}
+
+	void process(Variant &r_value) {
+		if (!constant_map.has(r_value)) {
+			constant_map[r_value] = constants.size();
+			constants.push_back(r_value);
+		}
+		_encode_uint(data, constant_map[r_value]);
+	}
+
+	template <class T>
+	void process(T *&r_node) {
+		if (r_node == nullptr) {
+			_encode_uint(data, 0);
+			return;
+		}
+		const uint32_t *index = node_indices.getptr(r_node);
+		ERR_FAIL_NULL_MSG(index, "Parse tree refers to a node that isn't in the parser's node list.");
+		_encode_uint(data, *index + 1);
+	}
+
+	template <class T>
+	void process(Vector<T> &r_vector) {
+		process_size(r_vector.size());
+		for (int i = 0; i < r_vector.size(); i++) {
+			T value = r_vector[i];
+			process(value);
+		}
+	}
+
+	template <class T>
+	void process(List<T *> &r_list) {
+		process_size(r_list.size());
+		for (T *value : r_list) {
+			process(value);
+		}
+	}
+
+	template <class V>
+	void process(HashMap<StringName, V> &r_map) {
+		process_size(r_map.size());
+		for (const KeyValue<StringName, V> &E : r_map) {
+			StringName key = E.key;
+			V value = E.value;
+			process(key);
+			process(value);
+		}
+	}
+};
+
+class GDScriptTreeReader {
+	uint64_t _read_uint(uint64_t p_max) {
+		uint64_t value;
+		if (error || !_decode_uint(ptr, end, value) || value > p_max) {
+			error = true;
+			return 0;
+		}
+		return value;
+	}
+
+	int64_t _read_int(int64_t p_min, int64_t p_max) {
+		uint64_t encoded = _read_uint(UINT64_MAX);
+		int64_t value = int64_t(encoded >> 1) ^ -int64_t(encoded & 1);
+		if (value < p_min || value > p_max) {
+			error = true;
+			return 0;
+		}
+		return value;
+	}
+
+public:
+	LocalVector<GDScriptParser::Node *> nodes;
+	Vector<String> strings;
+	Vector<StringName> string_names;
+	Vector<Variant> constants;
+	const uint8_t *ptr = nullptr;
+	const uint8_t *end = nullptr;
+	bool error = false;
+
+	bool is_reading() const { return true; }
+
+	int process_size(int p_size) {
+		// Every element takes at least a byte, which bounds sizes read from a damaged buffer.
+		return _read_uint(end - ptr);
+	}
+
+	template <class E>
+	void process_enum(E &r_value, int p_count) {
+		r_value = E(_read_uint(p_count - 1));
+	}
+
+	void process(bool &r_value) { r_value = _read_uint(1); }
+	void process(uint32_t &r_value) { r_value = _read_uint(UINT32_MAX); }
+	void process(int &r_value) { r_value = _read_int(INT32_MIN, INT32_MAX); }
+	void process(int64_t &r_value) { r_value = _read_int(INT64_MIN, INT64_MAX); }
+
+	void process(String &r_value) {
+		uint64_t index = _read_uint(UINT32_MAX);
+		if (!error && index < uint64_t(strings.size())) {
+			r_value = strings[index];
+		} else {
+			error = true;
+		}
+	}
+
+	void process(StringName &r_value) {
+		uint64_t index = _read_uint(UINT32_MAX);
+		if (!error && index < uint64_t(string_names.size())) {
+			r_value = string_names[index];
+		} else {
+			error = true;
+		}
+	}
+
+	void process(Variant &r_value) {
+		uint64_t index = _read_uint(UINT32_MAX);
+		if (!error && index < uint64_t(constants.size())) {
+			r_value = constants[index];
+		} else {
+			error = true;
+		}
+	}
+
+	template <class T>
+	void process(T *&r_node) {
+		r_node = nullptr;
+		uint64_t index = _read_uint(nodes.size());
+		if (index == 0) {
+			return;
+		}
+		GDScriptParser::Node *node = nodes[index - 1];
+		if (!_is_node_type<T>(node)) {
+			error = true;
+			return;
+		}
+		r_node = static_cast<T *>(node);
+	}
+
+	template <class T>
+	void process(Vector<T> &r_vector) {
+		r_vector.resize(process_size(0));
+		for (int i = 0; i < r_vector.size(); i++) {
+			process(r_vector.write[i]);
+		}
+	}
+
+	template <class T>
+	void process(List<T *> &r_list) {
+		r_list.clear();
+		int size = process_size(0);
+		for (int i = 0; i < size; i++) {
+			T *value = nullptr;
+			process(value);
+			r_list.push_back(value);
+		}
+	}
+
+	template <class V>
+	void process(HashMap<StringName, V> &r_map) {
+		r_map.clear();
+		int size = process_size(0);
+		for (int i = 0; i < size; i++) {
+			StringName key;
+			V value = V();
+			process(key);
+			process(value);
+			r_map.insert(key, value);
+		}
+	}
+};
+
+template <class A>
+static void _process_property_info(A &p_archive, PropertyInfo &r_info) {
+	p_archive.process_enum(r_info.type, Variant::VARIANT_MAX);
+	p_archive.process(r_info.name);
+	p_archive.process(r_info.class_name);
+	p_archive.process_enum(r_info.hint, PROPERTY_HINT_MAX);
+	p_archive.process(r_info.hint_string);
+	p_archive.process(r_info.usage);
+}
+
+template <class A>
+static void _process_enum_value(A &p_archive, GDScriptParser::EnumNode::Value &r_value) {
+	p_archive.process(r_value.identifier);
+	p_archive.process(r_value.custom_value);
+	p_archive.process(r_value.parent_enum);
+	p_archive.process(r_value.index);
+	p_archive.process(r_value.resolved);
+	p_archive.process(r_value.value);
+	p_archive.process(r_value.line);
+	p_archive.process(r_value.leftmost_column);
+	p_archive.process(r_value.rightmost_column);
+}
+
+// Stores the fields the parser sets. Data types, method infos and resolved flags are left out, only the
+// analyzer fills them. So are doc comments, which exported projects don't use.
+template <class A>
+static void _process_node(A &p_archive, GDScriptParser::Node *p_node) {
+	p_archive.process(p_node->start_line);
+	p_archive.process(p_node->end_line);
+	p_archive.process(p_node->start_column);
+	p_archive.process(p_node->end_column);
+	p_archive.process(p_node->leftmost_column);
+	p_archive.process(p_node->rightmost_column);
+	p_archive.process(p_node->annotations);
+	p_archive.process(p_node->ignored_warnings);
+
+	if (p_node->is_expression()) {
+		GDScriptParser::ExpressionNode *expression = static_cast<GDScriptParser::ExpressionNode *>(p_node);
+		p_archive.process(expression->reduced);
+		p_archive.process(expression->is_constant);
+		p_archive.process(expression->reduced_value);
+	}
+
+	switch (p_node->type) {
+		case GDScriptParser::Node::NONE:
+		case GDScriptParser::Node::BREAK:
+		case GDScriptParser::Node::BREAKPOINT:
+		case GDScriptParser::Node::PASS:
+			break;
+		case GDScriptParser::Node::ANNOTATION: {
+			GDScriptParser::AnnotationNode *annotation = static_cast<GDScriptParser::AnnotationNode *>(p_node);
+			p_archive.process(annotation->name);
+			p_archive.process(annotation->arguments);
+			p_archive.process(annotation->resolved_arguments);
+			_process_property_info(p_archive, annotation->export_info);
+		} break;
+		case GDScriptParser::Node::ARRAY: {
+			GDScriptParser::ArrayNode *array = static_cast<GDScriptParser::ArrayNode *>(p_node);
+			p_archive.process(array->elements);
+		} break;
+		case GDScriptParser::Node::ASSERT: {
+			GDScriptParser::AssertNode *assert = static_cast<GDScriptParser::AssertNode *>(p_node);
+			p_archive.process(assert->condition);
+			p_archive.process(assert->message);
+		} break;
+		case GDScriptParser::Node::ASSIGNMENT: {
+			GDScriptParser::AssignmentNode *assignment = static_cast<GDScriptParser::AssignmentNode *>(p_node);
+			p_archive.process_enum(assignment->operation, GDScriptParser::AssignmentNode::OP_BIT_XOR + 1);
+			p_archive.process_enum(assignment->variant_op, Variant::OP_MAX + 1);
+			p_archive.process(assignment->assignee);
+			p_archive.process(assignment->assigned_value);
+			p_archive.process(assignment->use_conversion_assign);
+		} break;
+		case GDScriptParser::Node::AWAIT: {
+			GDScriptParser::AwaitNode *await = static_cast<GDScriptParser::AwaitNode *>(p_node);
+			p_archive.process(await->to_await);
+		} break;
+		case GDScriptParser::Node::BINARY_OPERATOR: {
+			GDScriptParser::BinaryOpNode *binary_op = static_cast<GDScriptParser::BinaryOpNode *>(p_node);
+			p_archive.process_enum(binary_op->operation, GDScriptParser::BinaryOpNode::OP_COMP_GREATER_EQUAL + 1);
+			p_archive.process_enum(binary_op->variant_op, Variant::OP_MAX + 1);
+			p_archive.process(binary_op->left_operand);
+			p_archive.process(binary_op->right_operand);
+		} break;
+		case GDScriptParser::Node::CALL: {
+			GDScriptParser::CallNode *call = static_cast<GDScriptParser::CallNode *>(p_node);
+			p_archive.process(call->callee);
+			p_archive.process(call->arguments);
+			p_archive.process(call->function_name);
+			p_archive.process(call->is_super);
+		} break;
+		case GDScriptParser::Node::CAST: {
+			GDScriptParser::CastNode *cast = static_cast<GDScriptParser::CastNode *>(p_node);
+			p_archive.process(cast->operand);
+			p_archive.process(cast->cast_type);
+		} break;
+		case GDScriptParser::Node::CLASS: {
+			GDScriptParser::ClassNode *class_node = static_cast<GDScriptParser::ClassNode *>(p_node);
+			p_archive.process(class_node->identifier);
+			p_archive.process(class_node->icon_path);
+			class_node->members.resize(p_archive.process_size(class_node->members.size()));
+			for (GDScriptParser::ClassNode::Member &member : class_node->members) {
+				p_archive.process_enum(member.type, GDScriptParser::ClassNode::Member::GROUP + 1);
+				switch (member.type) {
+					case GDScriptParser::ClassNode::Member::UNDEFINED:
+						break;
+					case GDScriptParser::ClassNode::Member::CLASS:
+						p_archive.process(member.m_class);
+						break;
+					case GDScriptParser::ClassNode::Member::CONSTANT:
+						p_archive.process(member.constant);
+						break;
+					case GDScriptParser::ClassNode::Member::FUNCTION:
+						p_archive.process(member.function);
+						break;
+					case GDScriptParser::ClassNode::Member::SIGNAL:
+						p_archive.process(member.signal);
+						break;
+					case GDScriptParser::ClassNode::Member::VARIABLE:
+						p_archive.process(member.variable);
+						break;
+					case GDScriptParser::ClassNode::Member::ENUM:
+						p_archive.process(member.m_enum);
+						break;
+					case GDScriptParser::ClassNode::Member::ENUM_VALUE:
+						_process_enum_value(p_archive, member.enum_value);
+						break;
+					case GDScriptParser::ClassNode::Member::GROUP:
+						p_archive.process(member.annotation);
+						break;
+				}
+			}
+			p_archive.process(class_node->members_indices);
+			p_archive.process(class_node->outer);
+			p_archive.process(class_node->extends_used);
+			p_archive.process(class_node->onready_used);
+			p_archive.process(class_node->extends_path);
+			p_archive.process(class_node->extends);
+		} break;
+		case GDScriptParser::Node::CONSTANT: {
+			GDScriptParser::ConstantNode *constant = static_cast<GDScriptParser::ConstantNode *>(p_node);
+			p_archive.process(constant->identifier);
+			p_archive.process(constant->initializer);
+			p_archive.process(constant->datatype_specifier);
+			p_archive.process(constant->infer_datatype);
+			p_archive.process(constant->usages);
+		} break;
+		case GDScriptParser::Node::CONTINUE: {
+			GDScriptParser::ContinueNode *continue_node = static_cast<GDScriptParser::ContinueNode *>(p_node);
+			p_archive.process(continue_node->is_for_match);
+		} break;
+		case GDScriptParser::Node::DICTIONARY: {
+			GDScriptParser::DictionaryNode *dictionary = static_cast<GDScriptParser::DictionaryNode *>(p_node);
+			dictionary->elements.resize(p_archive.process_size(dictionary->elements.size()));
+			for (GDScriptParser::DictionaryNode::Pair &pair : dictionary->elements) {
+				p_archive.process(pair.key);
+				p_archive.process(pair.value);
+			}
+			p_archive.process_enum(dictionary->style, GDScriptParser::DictionaryNode::PYTHON_DICT + 1);
+		} break;
+		case GDScriptParser::Node::ENUM: {
+			GDScriptParser::EnumNode *enum_node = static_cast<GDScriptParser::EnumNode *>(p_node);
+			p_archive.process(enum_node->identifier);
+			enum_node->values.resize(p_archive.process_size(enum_node->values.size()));
+			for (GDScriptParser::EnumNode::Value &value : enum_node->values) {
+				_process_enum_value(p_archive, value);
+			}
+		} break;
+		case GDScriptParser::Node::FOR: {
+			GDScriptParser::ForNode *for_node = static_cast<GDScriptParser::ForNode *>(p_node);
+			p_archive.process(for_node->variable);
+			p_archive.process(for_node->list);
+			p_archive.process(for_node->loop);
+		} break;
+		case GDScriptParser::Node::FUNCTION: {
+			GDScriptParser::FunctionNode *function = static_cast<GDScriptParser::FunctionNode *>(p_node);
+			p_archive.process(function->identifier);
+			p_archive.process(function->parameters);
+			p_archive.process(function->parameters_indices);
+			p_archive.process(function->return_type);
+			p_archive.process(function->body);
+			p_archive.process(function->is_static);
+			p_archive.process(function->is_coroutine);
+			p_archive.process(function->rpc_config);
+			p_archive.process(function->source_lambda);
+		} break;
+		case GDScriptParser::Node::GET_NODE: {
+			GDScriptParser::GetNodeNode *get_node = static_cast<GDScriptParser::GetNodeNode *>(p_node);
+			p_archive.process(get_node->full_path);
+			// Stored by every build, so trees exported from the editor load in release templates.
+#ifdef DEBUG_ENABLED
+			p_archive.process(get_node->use_dollar);
+#else
+			bool use_dollar = true;
+			p_archive.process(use_dollar);
+#endif
+		} break;
+		case GDScriptParser::Node::IDENTIFIER: {
+			GDScriptParser::IdentifierNode *identifier = static_cast<GDScriptParser::IdentifierNode *>(p_node);
+			p_archive.process(identifier->name);
+			p_archive.process_enum(identifier->source, GDScriptParser::IdentifierNode::INHERITED_VARIABLE + 1);
+			switch (identifier->source) {
+				case GDScriptParser::IdentifierNode::UNDEFINED_SOURCE:
+					break;
+				case GDScriptParser::IdentifierNode::FUNCTION_PARAMETER:
+					p_archive.process(identifier->parameter_source);
+					break;
+				case GDScriptParser::IdentifierNode::LOCAL_CONSTANT:
+				case GDScriptParser::IdentifierNode::MEMBER_CONSTANT:
+					p_archive.process(identifier->constant_source);
+					break;
+				case GDScriptParser::IdentifierNode::LOCAL_VARIABLE:
+				case GDScriptParser::IdentifierNode::MEMBER_VARIABLE:
+				case GDScriptParser::IdentifierNode::INHERITED_VARIABLE:
+					p_archive.process(identifier->variable_source);
+					break;
+				case GDScriptParser::IdentifierNode::LOCAL_ITERATOR:
+				case GDScriptParser::IdentifierNode::LOCAL_BIND:
+					p_archive.process(identifier->bind_source);
+					break;
+			}
+			p_archive.process(identifier->source_function);
+			p_archive.process(identifier->usages);
+		} break;
+		case GDScriptParser::Node::IF: {
+			GDScriptParser::IfNode *if_node = static_cast<GDScriptParser::IfNode *>(p_node);
+			p_archive.process(if_node->condition);
+			p_archive.process(if_node->true_block);
+			p_archive.process(if_node->false_block);
+		} break;
+		case GDScriptParser::Node::LAMBDA: {
+			GDScriptParser::LambdaNode *lambda = static_cast<GDScriptParser::LambdaNode *>(p_node);
+			p_archive.process(lambda->function);
+			p_archive.process(lambda->parent_function);
+			p_archive.process(lambda->captures);
+			p_archive.process(lambda->captures_indices);
+			p_archive.process(lambda->use_self);
+		} break;
+		case GDScriptParser::Node::LITERAL: {
+			GDScriptParser::LiteralNode *literal = static_cast<GDScriptParser::LiteralNode *>(p_node);
+			p_archive.process(literal->value);
+		} break;
+		case GDScriptParser::Node::MATCH: {
+			GDScriptParser::MatchNode *match = static_cast<GDScriptParser::MatchNode *>(p_node);
+			p_archive.process(match->test);
+			p_archive.process(match->branches);
+		} break;
+		case GDScriptParser::Node::MATCH_BRANCH: {
+			GDScriptParser::MatchBranchNode *branch = static_cast<GDScriptParser::MatchBranchNode *>(p_node);
+			p_archive.process(branch->patterns);
+			p_archive.process(branch->block);
+			p_archive.process(branch->has_wildcard);
+		} break;
+		case GDScriptParser::Node::PARAMETER: {
+			GDScriptParser::ParameterNode *parameter = static_cast<GDScriptParser::ParameterNode *>(p_node);
+			p_archive.process(parameter->identifier);
+			p_archive.process(parameter->default_value);
+			p_archive.process(parameter->datatype_specifier);
+			p_archive.process(parameter->infer_datatype);
+			p_archive.process(parameter->usages);
+		} break;
+		case GDScriptParser::Node::PATTERN: {
+			GDScriptParser::PatternNode *pattern = static_cast<GDScriptParser::PatternNode *>(p_node);
+			p_archive.process_enum(pattern->pattern_type, GDScriptParser::PatternNode::PT_WILDCARD + 1);
+			switch (pattern->pattern_type) {
+				case GDScriptParser::PatternNode::PT_LITERAL:
+					p_archive.process(pattern->literal);
+					break;
+				case GDScriptParser::PatternNode::PT_EXPRESSION:
+					p_archive.process(pattern->expression);
+					break;
+				case GDScriptParser::PatternNode::PT_BIND:
+					p_archive.process(pattern->bind);
+					break;
+				case GDScriptParser::PatternNode::PT_ARRAY:
+				case GDScriptParser::PatternNode::PT_DICTIONARY:
+				case GDScriptParser::PatternNode::PT_REST:
+				case GDScriptParser::PatternNode::PT_WILDCARD:
+					break;
+			}
+			p_archive.process(pattern->array);
+			p_archive.process(pattern->rest_used);
+			pattern->dictionary.resize(p_archive.process_size(pattern->dictionary.size()));
+			for (GDScriptParser::PatternNode::Pair &pair : pattern->dictionary) {
+				p_archive.process(pair.key);
+				p_archive.process(pair.value_pattern);
+			}
+			p_archive.process(pattern->binds);
+		} break;
+		case GDScriptParser::Node::PRELOAD: {
+			GDScriptParser::PreloadNode *preload = static_cast<GDScriptParser::PreloadNode *>(p_node);
+			p_archive.process(preload->path);
+			p_archive.process(preload->resolved_path);
+		} break;
+		case GDScriptParser::Node::RETURN: {
+			GDScriptParser::ReturnNode *return_node = static_cast<GDScriptParser::ReturnNode *>(p_node);
+			p_archive.process(return_node->return_value);
+		} break;
+		case GDScriptParser::Node::SELF: {
+			GDScriptParser::SelfNode *self = static_cast<GDScriptParser::SelfNode *>(p_node);
+			p_archive.process(self->current_class);
+		} break;
+		case GDScriptParser::Node::SIGNAL: {
+			GDScriptParser::SignalNode *signal = static_cast<GDScriptParser::SignalNode *>(p_node);
+			p_archive.process(signal->identifier);
+			p_archive.process(signal->parameters);
+			p_archive.process(signal->parameters_indices);
+		} break;
+		case GDScriptParser::Node::SUBSCRIPT: {
+			GDScriptParser::SubscriptNode *subscript = static_cast<GDScriptParser::SubscriptNode *>(p_node);
+			p_archive.process(subscript->base);
+			p_archive.process(subscript->is_attribute);
+			if (subscript->is_attribute) {
+				p_archive.process(subscript->attribute);
+			} else {
+				p_archive.process(subscript->index);
+			}
+		} break;
+		case GDScriptParser::Node::SUITE: {
+			GDScriptParser::SuiteNode *suite = static_cast<GDScriptParser::SuiteNode *>(p_node);
+			p_archive.process(suite->parent_block);
+			p_archive.process(suite->statements);
+			suite->locals.resize(p_archive.process_size(suite->locals.size()));
+			for (GDScriptParser::SuiteNode::Local &local : suite->locals) {
+				p_archive.process_enum(local.type, GDScriptParser::SuiteNode::Local::PATTERN_BIND + 1);
+				switch (local.type) {
+					case GDScriptParser::SuiteNode::Local::UNDEFINED:
+						break;
+					case GDScriptParser::SuiteNode::Local::CONSTANT:
+						p_archive.process(local.constant);
+						break;
+					case GDScriptParser::SuiteNode::Local::VARIABLE:
+						p_archive.process(local.variable);
+						break;
+					case GDScriptParser::SuiteNode::Local::PARAMETER:
+						p_archive.process(local.parameter);
+						break;
+					case GDScriptParser::SuiteNode::Local::FOR_VARIABLE:
+					case GDScriptParser::SuiteNode::Local::PATTERN_BIND:
+						p_archive.process(local.bind);
+						break;
+				}
+				p_archive.process(local.name);
+				p_archive.process(local.source_function);
+				p_archive.process(local.start_line);
+				p_archive.process(local.end_line);
+				p_archive.process(local.start_column);
+				p_archive.process(local.end_column);
+				p_archive.process(local.leftmost_column);
+				p_archive.process(local.rightmost_column);
+			}
+			p_archive.process(suite->locals_indices);
+			p_archive.process(suite->parent_function);
+			p_archive.process(suite->parent_for);
+			p_archive.process(suite->parent_if);
+			p_archive.process(suite->has_return);
+			p_archive.process(suite->has_continue);
+			p_archive.process(suite->has_unreachable_code);
+		} break;
+		case GDScriptParser::Node::TERNARY_OPERATOR: {
+			GDScriptParser::TernaryOpNode *ternary_op = static_cast<GDScriptParser::TernaryOpNode *>(p_node);
+			p_archive.process(ternary_op->condition);
+			p_archive.process(ternary_op->true_expr);
+			p_archive.process(ternary_op->false_expr);
+		} break;
+		case GDScriptParser::Node::TYPE: {
+			GDScriptParser::TypeNode *type = static_cast<GDScriptParser::TypeNode *>(p_node);
+			p_archive.process(type->type_chain);
+			p_archive.process(type->container_type);
+		} break;
+		case GDScriptParser::Node::UNARY_OPERATOR: {
+			GDScriptParser::UnaryOpNode *unary_op = static_cast<GDScriptParser::UnaryOpNode *>(p_node);
+			p_archive.process_enum(unary_op->operation, GDScriptParser::UnaryOpNode::OP_LOGIC_NOT + 1);
+			p_archive.process_enum(unary_op->variant_op, Variant::OP_MAX + 1);
+			p_archive.process(unary_op->operand);
+		} break;
+		case GDScriptParser::Node::VARIABLE: {
+			GDScriptParser::VariableNode *variable = static_cast<GDScriptParser::VariableNode *>(p_node);
+			p_archive.process(variable->identifier);
+			p_archive.process(variable->initializer);
+			p_archive.process(variable->datatype_specifier);
+			p_archive.process(variable->infer_datatype);
+			p_archive.process_enum(variable->property, GDScriptParser::VariableNode::PROP_SETGET + 1);
+			switch (variable->property) {
+				case GDScriptParser::VariableNode::PROP_NONE:
+					break;
+				case GDScriptParser::VariableNode::PROP_INLINE:
+					p_archive.process(variable->setter);
+					p_archive.process(variable->getter);
+					break;
+				case GDScriptParser::VariableNode::PROP_SETGET:
+					p_archive.process(variable->setter_pointer);
+					p_archive.process(variable->getter_pointer);
+					break;
+			}
+			p_archive.process(variable->setter_parameter);
+			p_archive.process(variable->exported);
+			p_archive.process(variable->onready);
+			_process_property_info(p_archive, variable->export_info);
+			p_archive.process(variable->assignments);
+			p_archive.process(variable->usages);
+			p_archive.process(variable->use_conversion_assign);
+		} break;
+		case GDScriptParser::Node::WHILE: {
+			GDScriptParser::WhileNode *while_node = static_cast<GDScriptParser::WhileNode *>(p_node);
+			p_archive.process(while_node->condition);
+			p_archive.process(while_node->loop);
+		} break;
+	}
+}
+
+#ifdef DEBUG_ENABLED
+template <class A>
+static void _process_warning(A &p_archive, GDScriptWarning &r_warning) {
+	p_archive.process_enum(r_warning.code, GDScriptWarning::WARNING_MAX);
+	p_archive.process(r_warning.start_line);
+	p_archive.process(r_warning.end_line);
+	p_archive.process(r_warning.leftmost_column);
+	p_archive.process(r_warning.rightmost_column);
+	p_archive.process(r_warning.symbols);
+}
+#endif // DEBUG_ENABLED
+
+static GDScriptParser::Node *_alloc_node(GDScriptParser::Node::Type p_type) {
+	switch (p_type) {
+		case GDScriptParser::Node::NONE:
+			break;
+		case GDScriptParser::Node::ANNOTATION:
+			return memnew(GDScriptParser::AnnotationNode);
+		case GDScriptParser::Node::ARRAY:
+			return memnew(GDScriptParser::ArrayNode);
+		case GDScriptParser::Node::ASSERT:
+			return memnew(GDScriptParser::AssertNode);
+		case GDScriptParser::Node::ASSIGNMENT:
+			return memnew(GDScriptParser::AssignmentNode);
+		case GDScriptParser::Node::AWAIT:
+			return memnew(GDScriptParser::AwaitNode);
+		case GDScriptParser::Node::BINARY_OPERATOR:
+			return memnew(GDScriptParser::BinaryOpNode);
+		case GDScriptParser::Node::BREAK:
+			return memnew(GDScriptParser::BreakNode);
+		case GDScriptParser::Node::BREAKPOINT:
+			return memnew(GDScriptParser::BreakpointNode);
+		case GDScriptParser::Node::CALL:
+			return memnew(GDScriptParser::CallNode);
+		case GDScriptParser::Node::CAST:
+			return memnew(GDScriptParser::CastNode);
+		case GDScriptParser::Node::CLASS:
+			return memnew(GDScriptParser::ClassNode);
+		case GDScriptParser::Node::CONSTANT:
+			return memnew(GDScriptParser::ConstantNode);
+		case GDScriptParser::Node::CONTINUE:
+			return memnew(GDScriptParser::ContinueNode);
+		case GDScriptParser::Node::DICTIONARY:
+			return memnew(GDScriptParser::DictionaryNode);
+		case GDScriptParser::Node::ENUM:
+			return memnew(GDScriptParser::EnumNode);
+		case GDScriptParser::Node::FOR:
+			return memnew(GDScriptParser::ForNode);
+		case GDScriptParser::Node::FUNCTION:
+			return memnew(GDScriptParser::FunctionNode);
+		case GDScriptParser::Node::GET_NODE:
+			return memnew(GDScriptParser::GetNodeNode);
+		case GDScriptParser::Node::IDENTIFIER:
+			return memnew(GDScriptParser::IdentifierNode);
+		case GDScriptParser::Node::IF:
+			return memnew(GDScriptParser::IfNode);
+		case GDScriptParser::Node::LAMBDA:
+			return memnew(GDScriptParser::LambdaNode);
+		case GDScriptParser::Node::LITERAL:
+			return memnew(GDScriptParser::LiteralNode);
+		case GDScriptParser::Node::MATCH:
+			return memnew(GDScriptParser::MatchNode);
+		case GDScriptParser::Node::MATCH_BRANCH:
+			return memnew(GDScriptParser::MatchBranchNode);
+		case GDScriptParser::Node::PARAMETER:
+			return memnew(GDScriptParser::ParameterNode);
+		case GDScriptParser::Node::PASS:
+			return memnew(GDScriptParser::PassNode);
+		case GDScriptParser::Node::PATTERN:
+			return memnew(GDScriptParser::PatternNode);
+		case GDScriptParser::Node::PRELOAD:
+			return memnew(GDScriptParser::PreloadNode);
+		case GDScriptParser::Node::RETURN:
+			return memnew(GDScriptParser::ReturnNode);
+		case GDScriptParser::Node::SELF:
+			return memnew(GDScriptParser::SelfNode);
+		case GDScriptParser::Node::SIGNAL:
+			return memnew(GDScriptParser::SignalNode);
+		case GDScriptParser::Node::SUBSCRIPT:
+			return memnew(GDScriptParser::SubscriptNode);
+		case GDScriptParser::Node::SUITE:
+			return memnew(GDScriptParser::SuiteNode);
+		case GDScriptParser::Node::TERNARY_OPERATOR:
+			return memnew(GDScriptParser::TernaryOpNode);
+		case GDScriptParser::Node::TYPE:
+			return memnew(GDScriptParser::TypeNode);
+		case GDScriptParser::Node::UNARY_OPERATOR:
+			return memnew(GDScriptParser::UnaryOpNode);
+		case GDScriptParser::Node::VARIABLE:
+			return memnew(GDScriptParser::VariableNode);
+		case GDScriptParser::Node::WHILE:
+			return memnew(GDScriptParser::WhileNode);
+	}
+	return nullptr;
+}
+
+template <class A>
+void GDScriptTreeBuffer::_process_tree(A &p_archive, GDScriptParser *p_parser) {
+	p_archive.process(p_parser->head);
+	p_archive.process(p_parser->_is_tool);
+
+	// Warnings are stored by every build, release builds skip them when loading.
+#ifdef DEBUG_ENABLED
+	int warning_count = p_archive.process_size(p_parser->warnings.size());
+	if (p_archive.is_reading()) {
+		for (int i = 0; i < warning_count; i++) {
+			GDScriptWarning warning;
+			_process_warning(p_archive, warning);
+			p_parser->warnings.push_back(warning);
+		}
+	} else {
+		for (GDScriptWarning &warning : p_parser->warnings) {
+			_process_warning(p_archive, warning);
+		}
+	}
+#else
+	int warning_count = p_archive.process_size(0);
+	for (int i = 0; i < warning_count; i++) {
+		uint32_t code = 0;
+		int line_and_columns[4] = {};
+		Vector<String> symbols;
+		p_archive.process(code);
+		for (int j = 0; j < 4; j++) {
+			p_archive.process(line_and_columns[j]);
+		}
+		p_archive.process(symbols);
+	}
+#endif // DEBUG_ENABLED
+
+	for (GDScriptParser::Node *node = p_parser->list; node; node = node->next) {
+		_process_node(p_archive, node);
+	}
+}
+
+bool GDScriptTreeBuffer::is_tree_buffer(const Vector<uint8_t> &p_buffer) {
+	const uint8_t *buf = p_buffer.ptr();
+	return p_buffer.size() >= 4 && buf[0] == 'G' && buf[1] == 'D' && buf[2] == 'S' && buf[3] == 'T';
+}
+
+Vector<uint8_t> GDScriptTreeBuffer::save_tree(const GDScriptParser &p_parser) {
+	ERR_FAIL_COND_V_MSG(!p_parser.errors.is_empty() || p_parser.head == nullptr, Vector<uint8_t>(), "Only scripts that parsed without errors can be saved as a parse tree.");
+	// The writer only reads through the fields it's given.
+	GDScriptParser *parser = const_cast<GDScriptParser *>(&p_parser);
+
+	GDScriptTreeWriter writer;
+	LocalVector<uint8_t> types;
+	uint32_t node_count = 0;
+	for (const GDScriptParser::Node *node = parser->list; node; node = node->next) {
+		writer.node_indices.insert(node, node_count++);
+		_encode_uint(types, node->type);
+	}
+	_process_tree(writer, parser);
+
+	LocalVector<uint8_t> payload;
+	_encode_uint(payload, writer.strings.size());
+	for (uint32_t i = 0; i < writer.strings.size(); i++) {
+		CharString utf8 = writer.strings[i].utf8();
+		_encode_uint(payload, utf8.length());
+		for (int j = 0; j < utf8.length(); j++) {
+			payload.push_back(utf8[j]);
+		}
+	}
+	_encode_uint(payload, writer.constants.size());
+	for (uint32_t i = 0; i < writer.constants.size(); i++) {
+		int len;
+		Error err = encode_variant(writer.constants[i], nullptr, len, false);
+		ERR_FAIL_COND_V(err != OK, Vector<uint8_t>());
+		_encode_uint(payload, len);
+		uint32_t pos = payload.size();
+		payload.resize(pos + len);
+		encode_variant(writer.constants[i], &payload[pos], len, false);
+	}
+	_encode_uint(payload, node_count);
+	uint32_t pos = payload.size();
+	payload.resize(pos + types.size() + writer.data.size());
+	memcpy(&payload[pos], types.ptr(), types.size());
+	memcpy(&payload[pos + types.size()], writer.data.ptr(), writer.data.size());
+
+	Vector<uint8_t> buffer;
+	buffer.resize(HEADER_SIZE + Compression::get_max_compressed_buffer_size(payload.size(), Compression::MODE_ZSTD));
+	uint8_t *w = buffer.ptrw();
+	w[0] = 'G';
+	w[1] = 'D';
+	w[2] = 'S';
+	w[3] = 'T';
+	encode_uint32(TREE_VERSION, &w[4]);
+	encode_uint32(GDScriptParser::Node::WHILE + 1, &w[8]);
+	encode_uint32(payload.size(), &w[12]);
+	encode_uint32((VERSION_MAJOR << 16) | VERSION_MINOR, &w[20]);
+
+	int compressed_size = Compression::compress(&w[HEADER_SIZE], payload.ptr(), payload.size(), Compression::MODE_ZSTD);
+	if (compressed_size > 0 && compressed_size < int(payload.size())) {
+		encode_uint32(compressed_size, &w[16]);
+		buffer.resize(HEADER_SIZE + compressed_size);
+	} else {
+		encode_uint32(0, &w[16]);
+		memcpy(&w[HEADER_SIZE], payload.ptr(), payload.size());
+		buffer.resize(HEADER_SIZE + payload.size());
+	}
+	return buffer;
+}
+
+Error GDScriptTreeBuffer::load_tree(GDScriptParser *p_parser, const Vector<uint8_t> &p_buffer) {
+	const uint8_t *buf = p_buffer.ptr();
+	ERR_FAIL_COND_V(p_buffer.size() < HEADER_SIZE || !is_tree_buffer(p_buffer), ERR_INVALID_DATA);
+	ERR_FAIL_COND_V_MSG(decode_uint32(&buf[4]) != TREE_VERSION || decode_uint32(&buf[8]) != GDScriptParser::Node::WHILE + 1, ERR_INVALID_DATA,
+			"GDScript parse tree was saved by an incompatible engine version. Export the project again.");
+	uint32_t engine_version = decode_uint32(&buf[20]);
+	ERR_FAIL_COND_V_MSG(engine_version != uint32_t((VERSION_MAJOR << 16) | VERSION_MINOR), ERR_INVALID_DATA,
+			vformat("GDScript parse tree was exported with Godot %d.%d, but this is Godot %d.%d. Export the project again.", engine_version >> 16, engine_version & 0xFFFF, VERSION_MAJOR, VERSION_MINOR));
+
+	uint32_t payload_size = decode_uint32(&buf[12]);
+	uint32_t compressed_size = decode_uint32(&buf[16]);
+	Vector<uint8_t> payload;
+	if (compressed_size == 0) {
+		ERR_FAIL_COND_V(payload_size != uint32_t(p_buffer.size() - HEADER_SIZE), ERR_INVALID_DATA);
+		payload = p_buffer.slice(HEADER_SIZE);
+	} else {
+		ERR_FAIL_COND_V(compressed_size != uint32_t(p_buffer.size() - HEADER_SIZE), ERR_INVALID_DATA);
+		payload.resize(payload_size);
+		int result = Compression::decompress(payload.ptrw(), payload_size, &buf[HEADER_SIZE], compressed_size, Compression::MODE_ZSTD);
+		ERR_FAIL_COND_V(result != int(payload_size), ERR_INVALID_DATA);
+	}
+
+	GDScriptTreeReader reader;
+	reader.ptr = payload.ptr();
+	reader.end = reader.ptr + payload.size();
+
+	int count = reader.process_size(0);
+	reader.strings.resize(count);
+	reader.string_names.resize(count);
+	for (int i = 0; i < count && !reader.error; i++) {
+		int len = reader.process_size(0);
+		String str;
+		str.parse_utf8((const char *)reader.ptr, len);
+		reader.strings.write[i] = str;
+		reader.string_names.write[i] = str;
+		reader.ptr += len;
+	}
+
+	count = reader.process_size(0);
+	reader.constants.resize(count);
+	for (int i = 0; i < count && !reader.error; i++) {
+		int len = reader.process_size(0);
+		Error err = decode_variant(reader.constants.write[i], reader.ptr, len, nullptr, false);
+		ERR_FAIL_COND_V(err != OK, ERR_INVALID_DATA);
+		reader.ptr += len;
+	}
+
+	// Nodes are linked into the parser's list as soon as they exist, so clear() frees them if loading fails.
+	count = reader.process_size(0);
+	reader.nodes.resize(count);
+	GDScriptParser::Node **tail = &p_parser->list;
+	for (int i = 0; i < count; i++) {
+		GDScriptParser::Node::Type type = GDScriptParser::Node::NONE;
+		reader.process_enum(type, GDScriptParser::Node::WHILE + 1);
+		GDScriptParser::Node *node = _alloc_node(type);
+		if (node == nullptr) {
+			p_parser->clear();
+			ERR_FAIL_V(ERR_INVALID_DATA);
+		}
+		reader.nodes[i] = node;
+		*tail = node;
+		tail = &node->next;
+	}
+
+	_process_tree(reader, p_parser);
+	if (reader.error || reader.ptr != reader.end || p_parser->head == nullptr) {
+		p_parser->clear();
+		ERR_FAIL_V(ERR_INVALID_DATA);
+	}
+
+	for (uint32_t i = 0; i < reader.nodes.size(); i++) {
+		GDScriptParser::Node *node = reader.nodes[i];
+		if (node->type == GDScriptParser::Node::ANNOTATION) {
+			GDScriptParser::AnnotationNode *annotation = static_cast<GDScriptParser::AnnotationNode *>(node);
+			annotation->info = p_parser->valid_annotations.getptr(annotation->name);
+			if (annotation->info == nullptr) {
+				p_parser->clear();
+				ERR_FAIL_V(ERR_INVALID_DATA);
+			}
+		}
+	}
+
+	// Where parsing leaves it, the analyzer relies on it before it visits the first class.
+	p_parser->current_class = p_parser->head;
+	return OK;
+}
@@ -0,0 +1,56 @@
+/*************************************************************************/
+/*  gdscript_tree_buffer.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_TREE_BUFFER_H
+#define GDSCRIPT_TREE_BUFFER_H
+
+#include "gdscript_parser.h"
+
+// Saves the tree a parser built, before the analyzer runs, so exported projects can load it instead of
+// parsing again. The analyzer and compiler still run on load, since they depend on the engine API and on
+// the other scripts of the project.
+class GDScriptTreeBuffer {
+public:
+	enum {
+		TREE_VERSION = 1, // Bump when the node structs or the fields stored for them change.
+		HEADER_SIZE = 24,
+	};
+
+private:
+	template <class A>
+	static void _process_tree(A &p_archive, GDScriptParser *p_parser);
+
+public:
+	static bool is_tree_buffer(const Vector<uint8_t> &p_buffer);
+	static Vector<uint8_t> save_tree(const GDScriptParser &p_parser);
+	static Error load_tree(GDScriptParser *p_parser, const Vector<uint8_t> &p_buffer);
+};
+
+#endif // GDSCRIPT_TREE_BUFFER_H
@@ -319,9 +319,10 @@ struct GDScriptUtilityFunctionsDefinitions {
 				d["@subpath"] = cp;
 				d["@path"] = p->get_path();
 
-				for (const KeyValue<StringName, GDScript::MemberInfo> &E : base->member_indices) {
-					if (!d.has(E.key)) {
-						d[E.key] = ins->members[E.value.index];
+				const Vector<StringName> names = base->get_member_names_by_index();
+				for (int i = 0; i < names.size(); i++) {
+					if (!d.has(names[i])) {
+						d[names[i]] = ins->members[i];
 					}
 				}
 				*r_ret = d;
@@ -186,6 +186,140 @@ String GDScriptFunction::_get_call_error(const Callable::CallError &p_err, const
 	return err_text;
 }
 
+const GDScriptFunction::InlineCacheEntry *GDScriptFunction::_get_inline_cache_entry(int p_cache, InlineCacheAccess p_access, Object *p_object, GDScriptInstance *p_instance, const StringName &p_name) {
+	InlineCache &cache = _inline_caches_ptr[p_cache];
+	const GDScript *script = p_instance ? p_instance->script.ptr() : nullptr;
+	const void *class_name = p_object->get_class_name().data_unique_pointer();
+
+	for (int i = 0; i < INLINE_CACHE_ENTRIES; i++) {
+		const InlineCacheEntry *entry = cache.entries[i].load(std::memory_order_acquire);
+		if (!entry) {
+			break;
+		}
+		if (entry->script == script && entry->class_name == class_name) {
+			if (likely(entry->layout_version == (script ? script->layout_version : 0) && entry->reload_version == GDScript::reload_version.get() && entry->methods_version == ClassDB::get_methods_version())) {
+				return entry;
+			}
+		}
+	}
+
+	if (cache.failed_fills.load(std::memory_order_relaxed) >= INLINE_CACHE_MAX_FAILED_FILLS) {
+		return nullptr;
+	}
+	return _fill_inline_cache(p_cache, p_access, p_object, p_instance, p_name);
+}
+
+static _FORCE_INLINE_ Object *_get_inline_cache_receiver(const Variant *p_base, GDScriptInstance *&r_instance) {
+	if (p_base->get_type() != Variant::OBJECT) {
+		return nullptr;
+	}
+	Object *obj = p_base->get_validated_object();
+	if (!obj) {
+		return nullptr;
+	}
+
+	r_instance = nullptr;
+	ScriptInstance *si = obj->get_script_instance();
+	if (si) {
+		// Other languages and placeholders resolve names on their own.
+#ifdef TOOLS_ENABLED
+		if (si->is_placeholder()) {
+			return nullptr;
+		}
+#endif
+		if (si->get_language() != GDScriptLanguage::get_singleton()) {
+			return nullptr;
+		}
+		r_instance = static_cast<GDScriptInstance *>(si);
+	}
+	return obj;
+}
+
+bool GDScriptFunction::_inline_cache_get_named(int p_cache, const Variant *p_base, const StringName &p_name, Variant *r_ret) {
+	GDScriptInstance *gi = nullptr;
+	Object *obj = _get_inline_cache_receiver(p_base, gi);
+	if (!obj) {
+		return false;
+	}
+	const InlineCacheEntry *entry = _get_inline_cache_entry(p_cache, INLINE_CACHE_GET, obj, gi, p_name);
+	if (!entry) {
+		return false;
+	}
+
+	if (entry->kind == InlineCacheEntry::SCRIPT_MEMBER) {
+		if (r_ret == p_base) {
+			Variant ret = gi->members[entry->index];
+			*r_ret = ret;
+		} else {
+			*r_ret = gi->members[entry->index];
+		}
+		return true;
+	}
+
+	Callable::CallError ce;
+	*r_ret = entry->method->call(obj, nullptr, 0, ce);
+	return true;
+}
+
+bool GDScriptFunction::_inline_cache_set_named(int p_cache, const Variant *p_base, const StringName &p_name, const Variant *p_value, bool &r_valid) {
+	GDScriptInstance *gi = nullptr;
+	Object *obj = _get_inline_cache_receiver(p_base, gi);
+	if (!obj) {
+		return false;
+	}
+	const InlineCacheEntry *entry = _get_inline_cache_entry(p_cache, INLINE_CACHE_SET, obj, gi, p_name);
+	if (!entry) {
+		return false;
+	}
+
+	if (entry->kind == InlineCacheEntry::SCRIPT_MEMBER) {
+		if (entry->value_type != Variant::NIL && entry->value_type != p_value->get_type()) {
+			return false;
+		}
+		gi->members.write[entry->index] = *p_value;
+		r_valid = true;
+		return true;
+	}
+
+	Callable::CallError ce;
+	if (entry->index >= 0) {
+		Variant index = entry->index;
+		const Variant *args[2] = { &index, p_value };
+		entry->method->call(obj, args, 2, ce);
+	} else {
+		entry->method->call(obj, &p_value, 1, ce);
+	}
+	r_valid = ce.error == Callable::CallError::CALL_OK;
+	return true;
+}
+
+bool GDScriptFunction::_inline_cache_call(int p_cache, const Variant *p_base, const StringName &p_name, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error) {
+	GDScriptInstance *gi = nullptr;
+	Object *obj = _get_inline_cache_receiver(p_base, gi);
+	if (!obj) {
+		return false;
+	}
+	const InlineCacheEntry *entry = _get_inline_cache_entry(p_cache, INLINE_CACHE_CALL, obj, gi, p_name);
+	if (!entry) {
+		return false;
+	}
+
+	r_error.error = Callable::CallError::CALL_OK;
+	Variant ret;
+	{
+#ifdef DEBUG_ENABLED
+		_ObjectDebugLock debug_lock(obj);
+#endif
+		if (entry->kind == InlineCacheEntry::SCRIPT_FUNCTION) {
+			ret = entry->function->call(gi, p_args, p_argcount, r_error);
+		} else {
+			ret = entry->method->call(obj, p_args, p_argcount, r_error);
+		}
+	}
+	r_ret = ret;
+	return true;
+}
+
 void (*type_init_function_table[])(Variant *) = {
 	nullptr, // NIL (shouldn't be called).
 	&VariantInitializer<bool>::init, // BOOL.
@@ -232,6 +366,29 @@ void (*type_init_function_table[])(Variant *) = {
 	static const void *switch_table_ops[] = {        \
 		&&OPCODE_OPERATOR,                           \
 		&&OPCODE_OPERATOR_VALIDATED,                 \
+		&&OPCODE_OPERATOR_ADD_INT,                   \
+		&&OPCODE_OPERATOR_SUBTRACT_INT,              \
+		&&OPCODE_OPERATOR_MULTIPLY_INT,              \
+		&&OPCODE_OPERATOR_EQUAL_INT,                 \
+		&&OPCODE_OPERATOR_NOT_EQUAL_INT,             \
+		&&OPCODE_OPERATOR_LESS_INT,                  \
+		&&OPCODE_OPERATOR_LESS_EQUAL_INT,            \
+		&&OPCODE_OPERATOR_GREATER_INT,               \
+		&&OPCODE_OPERATOR_GREATER_EQUAL_INT,         \
+		&&OPCODE_OPERATOR_ADD_FLOAT,                 \
+		&&OPCODE_OPERATOR_SUBTRACT_FLOAT,            \
+		&&OPCODE_OPERATOR_MULTIPLY_FLOAT,            \
+		&&OPCODE_OPERATOR_DIVIDE_FLOAT,              \
+		&&OPCODE_OPERATOR_LESS_FLOAT,                \
+		&&OPCODE_OPERATOR_LESS_EQUAL_FLOAT,          \
+		&&OPCODE_OPERATOR_GREATER_FLOAT,             \
+		&&OPCODE_OPERATOR_GREATER_EQUAL_FLOAT,       \
+		&&OPCODE_OPERATOR_ADD_VECTOR2,               \
+		&&OPCODE_OPERATOR_SUBTRACT_VECTOR2,          \
+		&&OPCODE_OPERATOR_MULTIPLY_VECTOR2_FLOAT,    \
+		&&OPCODE_OPERATOR_ADD_VECTOR3,               \
+		&&OPCODE_OPERATOR_SUBTRACT_VECTOR3,          \
+		&&OPCODE_OPERATOR_MULTIPLY_VECTOR3_FLOAT,    \
 		&&OPCODE_EXTENDS_TEST,                       \
 		&&OPCODE_IS_BUILTIN,                         \
 		&&OPCODE_SET_KEYED,                          \
@@ -706,6 +863,42 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			// Operands and target are known to hold these types, so work on the payloads directly.
+#define OPCODE_OPERATOR_TYPED(m_name, m_ret_type, m_left_type, m_right_type, m_op)                                                                                \
+	OPCODE(OPCODE_OPERATOR_##m_name) {                                                                                                                            \
+		CHECK_SPACE(4);                                                                                                                                           \
+		GET_INSTRUCTION_ARG(a, 0);                                                                                                                                \
+		GET_INSTRUCTION_ARG(b, 1);                                                                                                                                \
+		GET_INSTRUCTION_ARG(dst, 2);                                                                                                                              \
+		*VariantGetInternalPtr<m_ret_type>::get_ptr(dst) = *VariantGetInternalPtr<m_left_type>::get_ptr(a) m_op *VariantGetInternalPtr<m_right_type>::get_ptr(b); \
+		ip += 4;                                                                                                                                                  \
+	}                                                                                                                                                             \
+	DISPATCH_OPCODE
+
+			OPCODE_OPERATOR_TYPED(ADD_INT, int64_t, int64_t, int64_t, +);
+			OPCODE_OPERATOR_TYPED(SUBTRACT_INT, int64_t, int64_t, int64_t, -);
+			OPCODE_OPERATOR_TYPED(MULTIPLY_INT, int64_t, int64_t, int64_t, *);
+			OPCODE_OPERATOR_TYPED(EQUAL_INT, bool, int64_t, int64_t, ==);
+			OPCODE_OPERATOR_TYPED(NOT_EQUAL_INT, bool, int64_t, int64_t, !=);
+			OPCODE_OPERATOR_TYPED(LESS_INT, bool, int64_t, int64_t, <);
+			OPCODE_OPERATOR_TYPED(LESS_EQUAL_INT, bool, int64_t, int64_t, <=);
+			OPCODE_OPERATOR_TYPED(GREATER_INT, bool, int64_t, int64_t, >);
+			OPCODE_OPERATOR_TYPED(GREATER_EQUAL_INT, bool, int64_t, int64_t, >=);
+			OPCODE_OPERATOR_TYPED(ADD_FLOAT, double, double, double, +);
+			OPCODE_OPERATOR_TYPED(SUBTRACT_FLOAT, double, double, double, -);
+			OPCODE_OPERATOR_TYPED(MULTIPLY_FLOAT, double, double, double, *);
+			OPCODE_OPERATOR_TYPED(DIVIDE_FLOAT, double, double, double, /);
+			OPCODE_OPERATOR_TYPED(LESS_FLOAT, bool, double, double, <);
+			OPCODE_OPERATOR_TYPED(LESS_EQUAL_FLOAT, bool, double, double, <=);
+			OPCODE_OPERATOR_TYPED(GREATER_FLOAT, bool, double, double, >);
+			OPCODE_OPERATOR_TYPED(GREATER_EQUAL_FLOAT, bool, double, double, >=);
+			OPCODE_OPERATOR_TYPED(ADD_VECTOR2, Vector2, Vector2, Vector2, +);
+			OPCODE_OPERATOR_TYPED(SUBTRACT_VECTOR2, Vector2, Vector2, Vector2, -);
+			OPCODE_OPERATOR_TYPED(MULTIPLY_VECTOR2_FLOAT, Vector2, Vector2, double, *);
+			OPCODE_OPERATOR_TYPED(ADD_VECTOR3, Vector3, Vector3, Vector3, +);
+			OPCODE_OPERATOR_TYPED(SUBTRACT_VECTOR3, Vector3, Vector3, Vector3, -);
+			OPCODE_OPERATOR_TYPED(MULTIPLY_VECTOR3_FLOAT, Vector3, Vector3, double, *);
+
 			OPCODE(OPCODE_EXTENDS_TEST) {
 				CHECK_SPACE(4);
 
@@ -984,7 +1177,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_SET_NAMED) {
-				CHECK_SPACE(3);
+				CHECK_SPACE(5);
 
 				GET_INSTRUCTION_ARG(dst, 0);
 				GET_INSTRUCTION_ARG(value, 1);
@@ -994,8 +1187,13 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
+				int cache = _code_ptr[ip + 4];
+				GD_ERR_BREAK(cache < 0 || cache >= _inline_caches_count);
+
 				bool valid;
-				dst->set_named(*index, *value, valid);
+				if (!_inline_cache_set_named(cache, dst, *index, value, valid)) {
+					dst->set_named(*index, *value, valid);
+				}
 
 #ifdef DEBUG_ENABLED
 				if (!valid) {
@@ -1004,7 +1202,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					OPCODE_BREAK;
 				}
 #endif
-				ip += 4;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -1024,7 +1222,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_GET_NAMED) {
-				CHECK_SPACE(4);
+				CHECK_SPACE(5);
 
 				GET_INSTRUCTION_ARG(src, 0);
 				GET_INSTRUCTION_ARG(dst, 1);
@@ -1034,22 +1232,27 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
-				bool valid;
+				int cache = _code_ptr[ip + 4];
+				GD_ERR_BREAK(cache < 0 || cache >= _inline_caches_count);
+
+				if (!_inline_cache_get_named(cache, src, *index, dst)) {
+					bool valid;
 #ifdef DEBUG_ENABLED
-				//allow better error message in cases where src and dst are the same stack position
-				Variant ret = src->get_named(*index, valid);
+					//allow better error message in cases where src and dst are the same stack position
+					Variant ret = src->get_named(*index, valid);
 
 #else
-				*dst = src->get_named(*index, valid);
+					*dst = src->get_named(*index, valid);
 #endif
 #ifdef DEBUG_ENABLED
-				if (!valid) {
-					err_text = "Invalid get index '" + index->operator String() + "' (on base: '" + _get_var_type(src) + "').";
-					OPCODE_BREAK;
-				}
-				*dst = ret;
+					if (!valid) {
+						err_text = "Invalid get index '" + index->operator String() + "' (on base: '" + _get_var_type(src) + "').";
+						OPCODE_BREAK;
+					}
+					*dst = ret;
 #endif
-				ip += 4;
+				}
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -1504,7 +1707,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			OPCODE(OPCODE_CALL_ASYNC)
 			OPCODE(OPCODE_CALL_RETURN)
 			OPCODE(OPCODE_CALL) {
-				CHECK_SPACE(3 + instr_arg_count);
+				CHECK_SPACE(4 + instr_arg_count);
 				bool call_ret = (_code_ptr[ip] & INSTR_MASK) != OPCODE_CALL;
 #ifdef DEBUG_ENABLED
 				bool call_async = (_code_ptr[ip] & INSTR_MASK) == OPCODE_CALL_ASYNC;
@@ -1519,6 +1722,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(methodname_idx < 0 || methodname_idx >= _global_names_count);
 				const StringName *methodname = &_global_names_ptr[methodname_idx];
 
+				int cache = _code_ptr[ip + 3];
+				GD_ERR_BREAK(cache < 0 || cache >= _inline_caches_count);
+
 				GET_INSTRUCTION_ARG(base, argc);
 				Variant **argptrs = instruction_args;
 
@@ -1533,7 +1739,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				Callable::CallError err;
 				if (call_ret) {
 					GET_INSTRUCTION_ARG(ret, argc + 1);
-					base->callp(*methodname, (const Variant **)argptrs, argc, *ret, err);
+					if (!_inline_cache_call(cache, base, *methodname, (const Variant **)argptrs, argc, *ret, err)) {
+						base->callp(*methodname, (const Variant **)argptrs, argc, *ret, err);
+					}
 #ifdef DEBUG_ENABLED
 					if (!call_async && ret->get_type() == Variant::OBJECT) {
 						// Check if getting a function state without await.
@@ -1552,7 +1760,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #endif
 				} else {
 					Variant ret;
-					base->callp(*methodname, (const Variant **)argptrs, argc, ret, err);
+					if (!_inline_cache_call(cache, base, *methodname, (const Variant **)argptrs, argc, ret, err)) {
+						base->callp(*methodname, (const Variant **)argptrs, argc, ret, err);
+					}
 				}
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling) {
@@ -1597,7 +1807,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				}
 #endif
 
-				ip += 3;
+				ip += 4;
 			}
 			DISPATCH_OPCODE;
 
@@ -37,7 +37,9 @@
 #include "gdscript.h"
 #include "gdscript_analyzer.h"
 #include "gdscript_cache.h"
+#include "gdscript_parser.h"
 #include "gdscript_tokenizer.h"
+#include "gdscript_tree_buffer.h"
 #include "gdscript_utility_functions.h"
 
 #ifdef TESTS_ENABLED
@@ -85,8 +87,24 @@ public:
 			return;
 		}
 
-		// TODO: Re-add compiled GDScript on export.
-		return;
+		String source = FileAccess::get_file_as_string(p_path);
+		if (source.is_empty()) {
+			return;
+		}
+
+		// Scripts are stored as their parse tree, so loading them skips the parser. Scripts that don't parse are
+		// kept as text so errors point to the source.
+		GDScriptParser parser;
+		if (parser.parse(source, p_path, false) != OK) {
+			return;
+		}
+
+		Vector<uint8_t> file = GDScriptTreeBuffer::save_tree(parser);
+		if (file.is_empty()) {
+			return;
+		}
+
+		add_file(p_path.get_basename() + ".gdc", file, true);
 	}
 
 	virtual String _get_name() const override { return "GDScript"; }
@@ -34,6 +34,8 @@
 #include "../gdscript_analyzer.h"
 #include "../gdscript_compiler.h"
 #include "../gdscript_parser.h"
+#include "../gdscript_tokenizer_buffer.h"
+#include "../gdscript_tree_buffer.h"
 
 #include "core/config/project_settings.h"
 #include "core/core_globals.h"
@@ -121,9 +123,10 @@ void finish_language() {
 
 StringName GDScriptTestRunner::test_function_name;
 
-GDScriptTestRunner::GDScriptTestRunner(const String &p_source_dir, bool p_init_language) {
+GDScriptTestRunner::GDScriptTestRunner(const String &p_source_dir, bool p_init_language, BinaryMode p_binary_mode) {
 	test_function_name = StaticCString::create("test");
 	do_init_languages = p_init_language;
+	binary_mode = p_binary_mode;
 
 	source_dir = p_source_dir;
 	if (!source_dir.ends_with("/")) {
@@ -272,7 +275,7 @@ bool GDScriptTestRunner::make_tests_for_dir(const String &p_dir) {
 				if (!is_generating && !dir->file_exists(out_file)) {
 					ERR_FAIL_V_MSG(false, "Could not find output file for " + next);
 				}
-				GDScriptTest test(current_dir.path_join(next), current_dir.path_join(out_file), source_dir);
+				GDScriptTest test(current_dir.path_join(next), current_dir.path_join(out_file), source_dir, binary_mode);
 				tests.push_back(test);
 			}
 		}
@@ -313,10 +316,11 @@ bool GDScriptTestRunner::generate_class_index() {
 	return true;
 }
 
-GDScriptTest::GDScriptTest(const String &p_source_path, const String &p_output_path, const String &p_base_dir) {
+GDScriptTest::GDScriptTest(const String &p_source_path, const String &p_output_path, const String &p_base_dir, BinaryMode p_binary_mode) {
 	source_file = p_source_path;
 	output_file = p_output_path;
 	base_dir = p_base_dir;
+	binary_mode = p_binary_mode;
 	_print_handler.printfunc = print_handler;
 	_error_handler.errfunc = error_handler;
 }
@@ -473,6 +477,15 @@ GDScriptTest::TestResult GDScriptTest::execute_test_code(bool p_is_generating) {
 	// Test parsing.
 	GDScriptParser parser;
 	err = parser.parse(script->get_source_code(), source_file, false);
+	if (err == OK && binary_mode != BINARY_NONE) {
+		// Go through the binary script from here on, like exported projects do. The script reloads from it too.
+		if (binary_mode == BINARY_TREE) {
+			script->set_binary_tokens_source(GDScriptTreeBuffer::save_tree(parser));
+		} else {
+			script->set_binary_tokens_source(GDScriptTokenizerBuffer::parse_code_string(script->get_source_code()));
+		}
+		err = parser.parse_binary(script->get_binary_tokens_source(), source_file);
+	}
 	if (err != OK) {
 		enable_stdout();
 		result.status = GDTEST_PARSER_ERROR;
@@ -43,6 +43,13 @@ void init_autoloads();
 void init_language(const String &p_base_path);
 void finish_language();
 
+// How tests load scripts once they parsed, binary ones go the way exported projects do.
+enum BinaryMode {
+	BINARY_NONE,
+	BINARY_TOKENS,
+	BINARY_TREE,
+};
+
 // Single test instance in a suite.
 class GDScriptTest {
 public:
@@ -74,6 +81,7 @@ private:
 	String source_file;
 	String output_file;
 	String base_dir;
+	BinaryMode binary_mode = BINARY_NONE;
 
 	PrintHandlerList _print_handler;
 	ErrorHandlerList _error_handler;
@@ -94,7 +102,7 @@ public:
 	const String &get_source_file() const { return source_file; }
 	const String &get_output_file() const { return output_file; }
 
-	GDScriptTest(const String &p_source_path, const String &p_output_path, const String &p_base_dir);
+	GDScriptTest(const String &p_source_path, const String &p_output_path, const String &p_base_dir, BinaryMode p_binary_mode = BINARY_NONE);
 	GDScriptTest() :
 			GDScriptTest(String(), String(), String()) {} // Needed to use in Vector.
 };
@@ -105,6 +113,7 @@ class GDScriptTestRunner {
 
 	bool is_generating = false;
 	bool do_init_languages = false;
+	BinaryMode binary_mode = BINARY_NONE;
 
 	bool make_tests();
 	bool make_tests_for_dir(const String &p_dir);
@@ -117,7 +126,7 @@ public:
 	int run_tests();
 	bool generate_outputs();
 
-	GDScriptTestRunner(const String &p_source_dir, bool p_init_language);
+	GDScriptTestRunner(const String &p_source_dir, bool p_init_language, BinaryMode p_binary_mode = BINARY_NONE);
 	~GDScriptTestRunner();
 };
 
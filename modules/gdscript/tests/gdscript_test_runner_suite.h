@@ -32,6 +32,12 @@
 #define GDSCRIPT_TEST_RUNNER_SUITE_H
 
 #include "gdscript_test_runner.h"
+
+#include "../gdscript_cache.h"
+#include "../gdscript_parser.h"
+#include "../gdscript_tokenizer_buffer.h"
+#include "../gdscript_tree_buffer.h"
+
 #include "tests/test_macros.h"
 
 namespace GDScriptTests {
@@ -46,6 +52,20 @@ TEST_SUITE("[Modules][GDScript]") {
 		INFO("Make sure `*.out` files have expected results.");
 		REQUIRE_MESSAGE(fail_count == 0, "All GDScript tests should pass.");
 	}
+
+	TEST_CASE("Script compilation and runtime using binary tokens") {
+		GDScriptTestRunner runner("modules/gdscript/tests/scripts", true, BINARY_TOKENS);
+		int fail_count = runner.run_tests();
+		INFO("Make sure `*.out` files have expected results.");
+		REQUIRE_MESSAGE(fail_count == 0, "All GDScript tests should pass using binary tokens.");
+	}
+
+	TEST_CASE("Script compilation and runtime using parse trees") {
+		GDScriptTestRunner runner("modules/gdscript/tests/scripts", true, BINARY_TREE);
+		int fail_count = runner.run_tests();
+		INFO("Make sure `*.out` files have expected results.");
+		REQUIRE_MESSAGE(fail_count == 0, "All GDScript tests should pass using parse trees.");
+	}
 }
 
 TEST_CASE("[Modules][GDScript] Load source code dynamically and run it") {
@@ -69,6 +89,119 @@ func _init():
 	CHECK_MESSAGE(int(ref_counted->get_meta("result")) == 42, "The script should assign object metadata successfully.");
 }
 
+TEST_CASE("[Modules][GDScript] Binary tokens") {
+	const String source = R"(
+extends RefCounted
+
+const GREETING = "Hello"
+
+func _init():
+	var values = [1, 2.5,
+		"three"]
+	if values.size() == 3:
+		set_meta("result", GREETING + " " + str(values[2]))
+)";
+	Vector<uint8_t> buffer = GDScriptTokenizerBuffer::parse_code_string(source);
+	REQUIRE_MESSAGE(buffer.size() > GDScriptTokenizerBuffer::HEADER_SIZE, "Tokenizing should produce a buffer.");
+
+	GDScriptParser parser;
+	CHECK_MESSAGE(parser.parse_binary(buffer, "") == OK, "Binary tokens should parse successfully.");
+
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_binary_tokens_source(buffer);
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	CHECK_MESSAGE(error == OK, "The script should load from binary tokens.");
+
+	Ref<RefCounted> ref_counted = memnew(RefCounted);
+	ref_counted->set_script(gdscript);
+	CHECK_MESSAGE(String(ref_counted->get_meta("result")) == "Hello three", "The script should run from binary tokens.");
+
+	Vector<uint8_t> bad_version = buffer;
+	bad_version.write[4] = GDScriptTokenizerBuffer::TOKENIZER_VERSION + 1;
+	Vector<uint8_t> other_engine = buffer;
+	other_engine.write[20] ^= 1; // Minor version.
+	Vector<uint8_t> truncated = buffer.slice(0, buffer.size() - 1);
+	ERR_PRINT_OFF;
+	CHECK_MESSAGE(parser.parse_binary(bad_version, "") != OK, "Tokens from another format version should be rejected.");
+	CHECK_MESSAGE(parser.parse_binary(other_engine, "") != OK, "Tokens exported with another engine version should be rejected.");
+	CHECK_MESSAGE(parser.parse_binary(truncated, "") != OK, "Truncated tokens should be rejected.");
+	ERR_PRINT_ON;
+}
+
+TEST_CASE("[Modules][GDScript] Binary parse tree") {
+	const String source = R"(
+extends RefCounted
+
+enum { FIRST, SECOND = 5 }
+const GREETING = "Hello"
+
+func _init():
+	var values = [1, 2.5, "three", {"key": SECOND}]
+	match values[3]:
+		{"key": var value}:
+			set_meta("result", GREETING + " " + str(values[2]) + " " + str(value))
+)";
+	GDScriptParser source_parser;
+	REQUIRE(source_parser.parse(source, "", false) == OK);
+	Vector<uint8_t> buffer = GDScriptTreeBuffer::save_tree(source_parser);
+	REQUIRE_MESSAGE(buffer.size() > GDScriptTreeBuffer::HEADER_SIZE, "Saving the parse tree should produce a buffer.");
+
+	GDScriptParser parser;
+	CHECK_MESSAGE(parser.parse_binary(buffer, "") == OK, "The parse tree should load successfully.");
+	REQUIRE(parser.get_tree() != nullptr);
+	CHECK(parser.get_tree()->members.size() == source_parser.get_tree()->members.size());
+
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_binary_tokens_source(buffer);
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	CHECK_MESSAGE(error == OK, "The script should load from its parse tree.");
+
+	Ref<RefCounted> ref_counted = memnew(RefCounted);
+	ref_counted->set_script(gdscript);
+	CHECK_MESSAGE(String(ref_counted->get_meta("result")) == "Hello three 5", "The script should run from its parse tree.");
+
+	Vector<uint8_t> bad_version = buffer;
+	bad_version.write[4] = GDScriptTreeBuffer::TREE_VERSION + 1;
+	Vector<uint8_t> other_engine = buffer;
+	other_engine.write[20] ^= 1; // Minor version.
+	Vector<uint8_t> truncated = buffer.slice(0, buffer.size() - 1);
+	ERR_PRINT_OFF;
+	CHECK_MESSAGE(parser.parse_binary(bad_version, "") != OK, "A parse tree from another format version should be rejected.");
+	CHECK_MESSAGE(parser.parse_binary(other_engine, "") != OK, "A parse tree exported with another engine version should be rejected.");
+	CHECK_MESSAGE(parser.parse_binary(truncated, "") != OK, "A truncated parse tree should be rejected.");
+	ERR_PRINT_ON;
+	CHECK_MESSAGE(parser.get_tree() == nullptr, "A rejected parse tree should leave no nodes behind.");
+}
+
+TEST_CASE("[Modules][GDScript] Parse scripts in parallel before compiling") {
+	Vector<Ref<GDScript>> scripts;
+	for (int i = 0; i < 4; i++) {
+		Ref<GDScript> gdscript = memnew(GDScript);
+		gdscript->set_path(vformat("res://parallel_parse_%d.gd", i), true);
+		gdscript->set_source_code(vformat("extends RefCounted\n\nfunc _init():\n\tset_meta(\"result\", %d)\n", i));
+		scripts.push_back(gdscript);
+	}
+	CHECK_MESSAGE(GDScriptCache::parse_scripts(scripts) == scripts.size(), "All scripts should be parsed ahead.");
+
+	// A script edited after it was parsed ahead must not use the stale parse.
+	scripts.write[3]->set_source_code("extends RefCounted\n\nfunc _init():\n\tset_meta(\"result\", 42)\n");
+
+	for (int i = 0; i < scripts.size(); i++) {
+		ERR_PRINT_OFF;
+		const Error error = scripts.write[i]->reload();
+		ERR_PRINT_ON;
+		CHECK_MESSAGE(error == OK, "The script should compile from its parse.");
+
+		Ref<RefCounted> ref_counted = memnew(RefCounted);
+		ref_counted->set_script(scripts[i]);
+		CHECK(int(ref_counted->get_meta("result")) == (i == 3 ? 42 : i));
+	}
+}
+
 TEST_CASE("[Modules][GDScript] Validate built-in API") {
 	GDScriptLanguage *lang = GDScriptLanguage::get_singleton();
 
@@ -103,6 +236,98 @@ TEST_CASE("[Modules][GDScript] Validate built-in API") {
 	}
 }
 
+static Variant run_script_loop(const String &p_source, int p_iterations, const StringName &p_result_meta) {
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(p_source);
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	CHECK_MESSAGE(error == OK, "The script should parse successfully.");
+
+	Ref<RefCounted> ref_counted = memnew(RefCounted);
+	ref_counted->set_script(gdscript);
+	ref_counted->call("run", p_iterations);
+	return ref_counted->get_meta(p_result_meta, Variant());
+}
+
+TEST_CASE("[Modules][GDScript] Typed and untyped gameplay loops give the same results") {
+	// Typical per-frame work: integrating bodies and counting hits against a radius.
+	const String typed_source = R"(
+extends RefCounted
+
+func run(iterations: int) -> void:
+	var position := Vector2.ZERO
+	var velocity := Vector2(3, 0)
+	var gravity := Vector2(0, 9.8)
+	var delta := 0.016
+	var radius := 100.0
+	var hits := 0
+	var i := 0
+	while i < iterations:
+		velocity = velocity + gravity * delta
+		position = position + velocity * delta
+		if position.x * position.x + position.y * position.y > radius * radius:
+			position = Vector2.ZERO
+			velocity = Vector2(3, 0)
+			hits = hits + 1
+		i = i + 1
+	set_meta("hits", hits)
+)";
+	const String untyped_source = typed_source.replace(": int", "").replace(" -> void", "").replace(":=", "=");
+
+	// Typed code goes through the typed operator opcodes, untyped code through the generic evaluators.
+	const int iterations = 10000;
+	const Variant typed_hits = run_script_loop(typed_source, iterations, "hits");
+	const Variant untyped_hits = run_script_loop(untyped_source, iterations, "hits");
+	CHECK(typed_hits.get_type() == Variant::INT);
+	CHECK(int64_t(typed_hits) > 0);
+	CHECK(typed_hits == untyped_hits);
+}
+
+TEST_CASE("[Modules][GDScript] Named access on duck-typed receivers") {
+	// Entities of several classes updated through the same untyped code, as in most gameplay scripts.
+	const String source = R"(
+extends RefCounted
+
+class Walker:
+	var health = 100
+	func damage(amount):
+		health -= amount
+
+class Flyer extends Walker:
+	var altitude = 10
+
+class Prop:
+	var health = 5
+	func damage(_amount):
+		health = 0
+
+func run(iterations):
+	var entities = []
+	for i in CLASSES:
+		entities.append([Walker, Flyer, Prop][i % 3].new())
+	var total = 0
+	for i in iterations:
+		var entity = entities[i % entities.size()]
+		entity.damage(1)
+		if entity.health <= 0:
+			entity.health = 100
+		total += entity.health
+	set_meta("total", total)
+)";
+
+	// The same accesses through get(), set() and call() are looked up by name every time.
+	const String dynamic_source = source.replace("entity.damage(1)", "entity.call(\"damage\", 1)").replace("entity.health = 100", "entity.set(\"health\", 100)").replace("entity.health", "entity.get(\"health\")");
+
+	const int iterations = 1000;
+	for (int classes = 1; classes <= 3; classes++) {
+		const Variant cached_total = run_script_loop(source.replace("CLASSES", itos(classes)), iterations, "total");
+		const Variant dynamic_total = run_script_loop(dynamic_source.replace("CLASSES", itos(classes)), iterations, "total");
+		CHECK(cached_total.get_type() == Variant::INT);
+		CHECK_MESSAGE(cached_total == dynamic_total, vformat("Cached accesses on %d receiver classes should match dynamic lookups.", classes));
+	}
+}
+
 } // namespace GDScriptTests
 
 #endif // GDSCRIPT_TEST_RUNNER_SUITE_H
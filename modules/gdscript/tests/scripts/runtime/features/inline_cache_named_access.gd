@@ -0,0 +1,90 @@
+class Enemy:
+	var health = 10
+	var speed: float = 1.0
+
+	func hit(amount):
+		health -= amount
+		return health
+
+class Boss extends Enemy:
+	var armor = 2
+
+	func hit(amount):
+		health -= max(amount - armor, 0)
+		return health
+
+class Crate:
+	var health = 3
+
+	func hit(_amount):
+		health = 0
+		return health
+
+class Item extends Resource:
+	var count = 1
+
+class Dynamic extends Resource:
+	func _get(property):
+		if property == &"resource_name":
+			return "dynamic"
+		return null
+
+# Shadows Resource.get_name() when called on the script itself.
+static func get_name():
+	return "static"
+
+static func read_static_name():
+	return get_name()
+
+@warning_ignore(unsafe_property_access, unsafe_method_access)
+func read_health(target):
+	return target.health
+
+@warning_ignore(unsafe_property_access, unsafe_method_access)
+func damage_all(targets, amount):
+	var results = []
+	for target in targets:
+		results.append(target.hit(amount))
+	return results
+
+@warning_ignore(unsafe_property_access, unsafe_method_access)
+func read_name(target):
+	return target.resource_name
+
+@warning_ignore(unsafe_property_access, unsafe_method_access)
+func test():
+	# Same instruction sites see several receiver classes.
+	var targets = [Enemy.new(), Boss.new(), Crate.new(), Enemy.new()]
+	for _i in 3:
+		print(damage_all(targets, 3))
+
+	var total = 0
+	for target in targets:
+		total += read_health(target)
+	print(total)
+
+	for target in targets:
+		target.health = 5
+	print(damage_all(targets, 1))
+
+	# Typed members still convert values of other types.
+	var enemy = targets[0]
+	enemy.speed = 2
+	print(enemy.speed == 2.0, " ", typeof(enemy.speed) == TYPE_FLOAT)
+	enemy.speed = 3.5
+	print(enemy.speed)
+
+	# Native properties and methods, with and without a script.
+	var plain = Resource.new()
+	var item = Item.new()
+	var dynamic = Dynamic.new()
+	plain.resource_name = "plain"
+	item.resource_name = "item"
+	item.count = 4
+	for target in [plain, item, dynamic, plain]:
+		print(read_name(target), "/", target.get_name())
+	print(item.count)
+
+	# Calls on the script resource go to its static functions.
+	for _i in 2:
+		print(read_static_name())
@@ -0,0 +1,38 @@
+func integrate(position: Vector2, velocity: Vector2, delta: float, steps: int) -> Vector2:
+	var gravity := Vector2(0, 2)
+	var i := 0
+	while i < steps:
+		velocity = velocity + gravity * delta
+		position = position + velocity * delta
+		i = i + 1
+	return position
+
+func test():
+	var a := 7
+	var b := 3
+	print(a + b, " ", a - b, " ", a * b)
+	print(a == b, " ", a != b, " ", a < b, " ", a <= b, " ", a > b, " ", a >= b)
+
+	var x := 1.5
+	var y := 0.5
+	print(x + y, " ", x - y, " ", x * y, " ", x / y)
+	print(x < y, " ", x <= y, " ", x > y, " ", x >= y)
+
+	var v2 := Vector2(1, 2)
+	var w2 := Vector2(0.5, 0.25)
+	print(v2 + w2, " ", v2 - w2, " ", v2 * y)
+
+	var v3 := Vector3(1, 2, 3)
+	var w3 := Vector3(0.5, 0.25, 0.125)
+	print(v3 + w3, " ", v3 - w3, " ", v3 * x)
+
+	# Temporaries are reused across iterations.
+	var sum := 0
+	for i in 10:
+		sum = sum + i * i
+	print(sum)
+	print(integrate(Vector2.ZERO, Vector2(1, 0), 0.5, 4))
+
+	# Untyped operands still go through the generic path.
+	var untyped = 2
+	print(untyped + a, " ", untyped * x)
@@ -30,6 +30,7 @@
 
 #include "cpu_particles_3d.h"
 
+#include "core/math/batch_math.h"
 #include "scene/3d/camera_3d.h"
 #include "scene/3d/gpu_particles_3d.h"
 #include "scene/main/viewport.h"
@@ -1184,16 +1185,27 @@ void CPUParticles3D::_update_particle_data_buffer() {
 		}
 	}
 
+	if (!order && pc > 0) {
+		// Unsorted, so all transforms can be written at once. Inactive ones are cleared below.
+		if (local_coords) {
+			BatchMath::transforms_to_buffer(&r[0].transform, sizeof(Particle), w, 20, pc);
+		} else {
+			BatchMath::multiply_transforms_to_buffer(inv_emission_transform, &r[0].transform, sizeof(Particle), w, 20, pc);
+		}
+	}
+
 	for (int i = 0; i < pc; i++) {
 		int idx = order ? order[i] : i;
 
-		Transform3D t = r[idx].transform;
+		if (!r[idx].active) {
+			memset(ptr, 0, sizeof(Transform3D));
+		} else if (order) {
+			Transform3D t = r[idx].transform;
 
-		if (!local_coords) {
-			t = inv_emission_transform * t;
-		}
+			if (!local_coords) {
+				t = inv_emission_transform * t;
+			}
 
-		if (r[idx].active) {
 			ptr[0] = t.basis.rows[0][0];
 			ptr[1] = t.basis.rows[0][1];
 			ptr[2] = t.basis.rows[0][2];
@@ -1206,8 +1218,6 @@ void CPUParticles3D::_update_particle_data_buffer() {
 			ptr[9] = t.basis.rows[2][1];
 			ptr[10] = t.basis.rows[2][2];
 			ptr[11] = t.origin.z;
-		} else {
-			memset(ptr, 0, sizeof(Transform3D));
 		}
 
 		Color c = r[idx].color;
@@ -1296,23 +1306,12 @@ void CPUParticles3D::_notification(int p_what) {
 				const Particle *r = particles.ptr();
 				float *ptr = w;
 
+				if (pc > 0) {
+					BatchMath::multiply_transforms_to_buffer(inv_emission_transform, &r[0].transform, sizeof(Particle), w, 20, pc);
+				}
+
 				for (int i = 0; i < pc; i++) {
-					Transform3D t = inv_emission_transform * r[i].transform;
-
-					if (r[i].active) {
-						ptr[0] = t.basis.rows[0][0];
-						ptr[1] = t.basis.rows[0][1];
-						ptr[2] = t.basis.rows[0][2];
-						ptr[3] = t.origin.x;
-						ptr[4] = t.basis.rows[1][0];
-						ptr[5] = t.basis.rows[1][1];
-						ptr[6] = t.basis.rows[1][2];
-						ptr[7] = t.origin.y;
-						ptr[8] = t.basis.rows[2][0];
-						ptr[9] = t.basis.rows[2][1];
-						ptr[10] = t.basis.rows[2][2];
-						ptr[11] = t.origin.z;
-					} else {
+					if (!r[i].active) {
 						memset(ptr, 0, sizeof(float) * 12);
 					}
 
@@ -30,6 +30,8 @@
 
 #include "mesh.h"
 
+#include "core/crypto/crypto_core.h"
+#include "core/io/derived_data_cache.h"
 #include "core/math/convex_hull.h"
 #include "core/templates/pair.h"
 #include "scene/resources/surface_tool.h"
@@ -257,8 +259,29 @@ Ref<TriangleMesh> Mesh::generate_triangle_mesh() const {
 	}
 
 	triangle_mesh = Ref<TriangleMesh>(memnew(TriangleMesh));
+
+	// Building the BVH is costly for big meshes, so it's reused across runs when possible.
+	String faces_hash;
+	if (DerivedDataCache::is_enabled() && !get_path().is_empty()) {
+		unsigned char hash[32];
+		CryptoCore::SHA256Context ctx;
+		ctx.start();
+		ctx.update((const uint8_t *)faces.ptr(), faces.size() * sizeof(Vector3));
+		ctx.finish(hash);
+		faces_hash = String::hex_encode_buffer(hash, 32);
+
+		Vector<uint8_t> cached;
+		if (DerivedDataCache::get(get_path(), "triangle_mesh", faces_hash, cached) && triangle_mesh->load_from_buffer(cached) == OK) {
+			return triangle_mesh;
+		}
+	}
+
 	triangle_mesh->create(faces);
 
+	if (!faces_hash.is_empty() && triangle_mesh->is_valid()) {
+		DerivedDataCache::store(get_path(), "triangle_mesh", faces_hash, triangle_mesh->save_to_buffer());
+	}
+
 	return triangle_mesh;
 }
 
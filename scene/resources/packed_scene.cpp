@@ -70,7 +70,102 @@ static Array _sanitize_node_pinned_properties(Node *p_node) {
 	return pinned;
 }
 
-Node *SceneState::instantiate(GenEditState p_edit_state) const {
+SceneState::InstantiatePlan *SceneState::_acquire_instantiate_plan() const {
+	MutexLock lock(instantiate_plan_mutex);
+
+	// Setters are method binds, which are gone if their class is unregistered.
+	uint32_t methods_version = ClassDB::get_methods_version();
+	if (instantiate_plan && instantiate_plan->methods_version == methods_version) {
+		instantiate_plan->refcount.ref();
+		return instantiate_plan;
+	}
+
+	if (instantiate_plan) {
+		_release_instantiate_plan(instantiate_plan);
+	}
+
+	InstantiatePlan *plan = memnew(InstantiatePlan);
+	plan->refcount.init(); // The reference kept here.
+	plan->methods_version = methods_version;
+
+	int nc = nodes.size();
+	plan->node_setters_from.resize(nc + 1);
+	for (int i = 0; i < nc; i++) {
+		const NodeData &n = nodes[i];
+		plan->node_setters_from[i] = plan->setters.size();
+
+		// Only nodes created here are known to be of their type, and extension classes may intercept any property.
+		bool use_setters = n.instance < 0 && n.type != TYPE_INSTANCED && !(i == 0 && base_scene_idx >= 0) && n.type >= 0 && n.type < names.size();
+		if (use_setters) {
+			ClassDB::APIType api = ClassDB::get_api_type(names[n.type]);
+			use_setters = api == ClassDB::API_CORE || api == ClassDB::API_EDITOR;
+		}
+
+		for (int j = 0; j < n.properties.size(); j++) {
+			InstantiatePlan::PropertySetter setter;
+			int name = n.properties[j].name;
+			if (use_setters && !(name & FLAG_PATH_PROPERTY_IS_NODE) && name >= 0 && name < names.size() && names[name] != CoreStringNames::get_singleton()->_script) {
+				setter.bind = ClassDB::get_property_setter_bind(names[n.type], names[name], &setter.index);
+			}
+			plan->setters.push_back(setter);
+		}
+	}
+	plan->node_setters_from[nc] = plan->setters.size();
+
+	plan->connection_binds.resize(connections.size());
+	for (int i = 0; i < connections.size(); i++) {
+		const ConnectionData &c = connections[i];
+		if (c.unbinds > 0) {
+			continue;
+		}
+		for (int j = 0; j < c.binds.size(); j++) {
+			ERR_CONTINUE(c.binds[j] < 0 || c.binds[j] >= variants.size());
+			plan->connection_binds[i].push_back(variants[c.binds[j]]);
+		}
+	}
+
+	instantiate_plan = plan;
+	instantiate_plan->refcount.ref();
+	return instantiate_plan;
+}
+
+void SceneState::_release_instantiate_plan(InstantiatePlan *p_plan) const {
+	if (p_plan->refcount.unref()) {
+		memdelete(p_plan);
+	}
+}
+
+void SceneState::_clear_instantiate_plan() {
+	MutexLock lock(instantiate_plan_mutex);
+	if (instantiate_plan) {
+		_release_instantiate_plan(instantiate_plan);
+		instantiate_plan = nullptr;
+	}
+}
+
+static _FORCE_INLINE_ void _call_property_setter(Object *p_object, MethodBind *p_setter, int p_index, const Variant &p_value) {
+	Callable::CallError ce;
+	if (p_index >= 0) {
+		Variant index = p_index;
+		const Variant *args[2] = { &index, &p_value };
+		p_setter->call(p_object, args, 2, ce);
+	} else {
+		const Variant *args[1] = { &p_value };
+		p_setter->call(p_object, args, 1, ce);
+	}
+}
+
+void SceneState::_instantiate_sub_scene_threaded(SubSceneInstance *p_instance) const {
+	int idx = p_instance->index;
+	int value = idx == 0 && base_scene_idx >= 0 ? base_scene_idx : (nodes[idx].instance & FLAG_MASK);
+
+	Ref<PackedScene> sdata = variants[value];
+	if (sdata.is_valid()) {
+		p_instance->node = sdata->_instantiate(GEN_EDIT_STATE_DISABLED, true);
+	}
+}
+
+Node *SceneState::instantiate(GenEditState p_edit_state, bool p_parallel) const {
 	// nodes where instancing failed (because something is missing)
 	List<Node *> stray_instances;
 
@@ -111,6 +206,44 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 
 	LocalVector<DeferredNodePathProperties> deferred_node_paths;
 
+	// At runtime, what can be looked up once is taken from the plan. The edit states keep setting everything by name.
+	InstantiatePlan *plan = p_edit_state == GEN_EDIT_STATE_DISABLED ? _acquire_instantiate_plan() : nullptr;
+	InstantiatePlanRelease plan_release(this, plan);
+
+	// Instantiated sub-scenes don't depend on anything built here, so with more than one they are all built in parallel first.
+	// The edit states are left out, as they fill caches of the scene states.
+	Node **sub_scene_nodes = nullptr;
+	uint64_t parallel_from = 0;
+	if (p_parallel && p_edit_state == GEN_EDIT_STATE_DISABLED) {
+		LocalVector<SubSceneInstance> sub_scenes;
+		for (int i = 0; i < nc; i++) {
+			if ((i == 0 && base_scene_idx >= 0) || (nd[i].instance >= 0 && !(nd[i].instance & FLAG_INSTANCE_IS_PLACEHOLDER))) {
+				ERR_FAIL_INDEX_V(i == 0 && base_scene_idx >= 0 ? base_scene_idx : (nd[i].instance & FLAG_MASK), prop_count, nullptr);
+				SubSceneInstance sub_scene;
+				sub_scene.index = i;
+				sub_scenes.push_back(sub_scene);
+			}
+		}
+
+		if (sub_scenes.size() > 1) {
+			parallel_from = OS::get_singleton()->get_ticks_usec();
+
+			// Separate tasks rather than a group, as waiting on a task lets a worker thread run others meanwhile, so nested sub-scenes can't starve the pool.
+			LocalVector<WorkerThreadPool::TaskID> tasks;
+			tasks.resize(sub_scenes.size());
+			for (uint32_t i = 0; i < sub_scenes.size(); i++) {
+				tasks[i] = WorkerThreadPool::get_singleton()->add_template_task(this, &SceneState::_instantiate_sub_scene_threaded, &sub_scenes[i], true, SNAME("SceneStateInstantiateSubScene"));
+			}
+
+			sub_scene_nodes = (Node **)alloca(sizeof(Node *) * nc);
+			memset(sub_scene_nodes, 0, sizeof(Node *) * nc);
+			for (uint32_t i = 0; i < sub_scenes.size(); i++) {
+				WorkerThreadPool::get_singleton()->wait_for_task_completion(tasks[i]);
+				sub_scene_nodes[sub_scenes[i].index] = sub_scenes[i].node;
+			}
+		}
+	}
+
 	for (int i = 0; i < nc; i++) {
 		const NodeData &n = nd[i];
 
@@ -136,12 +269,17 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 
 		Node *node = nullptr;
 		MissingNode *missing_node = nullptr;
+		bool is_planned_type = false;
 
 		if (i == 0 && base_scene_idx >= 0) {
 			//scene inheritance on root node
 			Ref<PackedScene> sdata = props[base_scene_idx];
 			ERR_FAIL_COND_V(!sdata.is_valid(), nullptr);
-			node = sdata->instantiate(p_edit_state == GEN_EDIT_STATE_DISABLED ? PackedScene::GEN_EDIT_STATE_DISABLED : PackedScene::GEN_EDIT_STATE_INSTANCE); //only main gets main edit state
+			if (sub_scene_nodes) {
+				node = sub_scene_nodes[i];
+			} else {
+				node = sdata->instantiate(p_edit_state == GEN_EDIT_STATE_DISABLED ? PackedScene::GEN_EDIT_STATE_DISABLED : PackedScene::GEN_EDIT_STATE_INSTANCE); //only main gets main edit state
+			}
 			ERR_FAIL_COND_V(!node, nullptr);
 			if (p_edit_state != GEN_EDIT_STATE_DISABLED) {
 				node->set_scene_inherited_state(sdata->get_state());
@@ -165,7 +303,11 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 			} else {
 				Ref<PackedScene> sdata = props[n.instance & FLAG_MASK];
 				ERR_FAIL_COND_V(!sdata.is_valid(), nullptr);
-				node = sdata->instantiate(p_edit_state == GEN_EDIT_STATE_DISABLED ? PackedScene::GEN_EDIT_STATE_DISABLED : PackedScene::GEN_EDIT_STATE_INSTANCE);
+				if (sub_scene_nodes) {
+					node = sub_scene_nodes[i];
+				} else {
+					node = sdata->instantiate(p_edit_state == GEN_EDIT_STATE_DISABLED ? PackedScene::GEN_EDIT_STATE_DISABLED : PackedScene::GEN_EDIT_STATE_INSTANCE);
+				}
 				ERR_FAIL_COND_V(!node, nullptr);
 			}
 
@@ -184,6 +326,7 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 			Object *obj = ClassDB::instantiate(snames[n.type]);
 
 			node = Object::cast_to<Node>(obj);
+			is_planned_type = node != nullptr;
 
 			if (!node) {
 				if (obj) {
@@ -228,6 +371,7 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 			int nprop_count = n.properties.size();
 			if (nprop_count) {
 				const NodeData::Property *nprops = &n.properties[0];
+				const InstantiatePlan::PropertySetter *setters = plan && is_planned_type ? plan->setters.ptr() + plan->node_setters_from[i] : nullptr;
 
 				Dictionary missing_resource_properties;
 
@@ -328,7 +472,15 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 						}
 
 						if (set_valid) {
-							node->set(snames[nprops[j].name], value, &valid);
+							if (setters && setters[j].bind && !node->get_script_instance()) {
+								// Same as what Object::set() ends up doing, without looking up the property through the class hierarchy.
+								_call_property_setter(node, setters[j].bind, setters[j].index, value);
+#ifdef TOOLS_ENABLED
+								node->set_edited(true);
+#endif
+							} else {
+								node->set(snames[nprops[j].name], value, &valid);
+							}
 						}
 					}
 				}
@@ -434,6 +586,13 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 		Callable callable(cto, snames[c.method]);
 		if (c.unbinds > 0) {
 			callable = callable.unbind(c.unbinds);
+		} else if (plan && !plan->connection_binds[i].is_empty()) {
+			const Vector<Variant> &binds = plan->connection_binds[i];
+			const Variant **argptrs = (const Variant **)alloca(sizeof(Variant *) * binds.size());
+			for (int j = 0; j < binds.size(); j++) {
+				argptrs[j] = &binds[j];
+			}
+			callable = callable.bindp(argptrs, binds.size());
 		} else if (!c.binds.is_empty()) {
 			Vector<Variant> binds;
 			if (c.binds.size()) {
@@ -468,6 +627,10 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 		}
 	}
 
+	if (sub_scene_nodes) {
+		print_verbose(vformat("Instantiated scene '%s' with %d nodes and sub-scenes built in parallel in %d usec.", get_path(), nc, OS::get_singleton()->get_ticks_usec() - parallel_from));
+	}
+
 	return ret_nodes[0];
 }
 
@@ -1003,6 +1166,7 @@ void SceneState::clear() {
 	node_paths.clear();
 	editable_instances.clear();
 	base_scene_idx = -1;
+	_clear_instantiate_plan();
 }
 
 Ref<SceneState> SceneState::get_base_scene_state() const {
@@ -1153,6 +1317,8 @@ void SceneState::set_bundled_scene(const Dictionary &p_dictionary) {
 	ERR_FAIL_COND(!p_dictionary.has("conns"));
 	//ERR_FAIL_COND( !p_dictionary.has("path"));
 
+	_clear_instantiate_plan();
+
 	int version = 1;
 	if (p_dictionary.has("version")) {
 		version = p_dictionary["version"];
@@ -1619,6 +1785,7 @@ int SceneState::add_node(int p_parent, int p_owner, int p_type, int p_name, int
 	nd.index = p_index;
 
 	nodes.push_back(nd);
+	_clear_instantiate_plan();
 
 	return nodes.size() - 1;
 }
@@ -1635,6 +1802,7 @@ void SceneState::add_node_property(int p_node, int p_name, int p_value, bool p_d
 	}
 	prop.value = p_value;
 	nodes.write[p_node].properties.push_back(prop);
+	_clear_instantiate_plan();
 }
 
 void SceneState::add_node_group(int p_node, int p_group) {
@@ -1646,6 +1814,7 @@ void SceneState::add_node_group(int p_node, int p_group) {
 void SceneState::set_base_scene(int p_idx) {
 	ERR_FAIL_INDEX(p_idx, variants.size());
 	base_scene_idx = p_idx;
+	_clear_instantiate_plan();
 }
 
 void SceneState::add_connection(int p_from, int p_to, int p_signal, int p_method, int p_flags, int p_unbinds, const Vector<int> &p_binds) {
@@ -1664,6 +1833,7 @@ void SceneState::add_connection(int p_from, int p_to, int p_signal, int p_method
 	c.unbinds = p_unbinds;
 	c.binds = p_binds;
 	connections.push_back(c);
+	_clear_instantiate_plan();
 }
 
 void SceneState::add_editable_instance(const NodePath &p_path) {
@@ -1719,6 +1889,10 @@ void SceneState::_bind_methods() {
 SceneState::SceneState() {
 }
 
+SceneState::~SceneState() {
+	_clear_instantiate_plan();
+}
+
 ////////////////
 
 void PackedScene::_set_bundled_scene(const Dictionary &p_scene) {
@@ -1742,16 +1916,20 @@ bool PackedScene::can_instantiate() const {
 }
 
 Node *PackedScene::instantiate(GenEditState p_edit_state) const {
+	return _instantiate((SceneState::GenEditState)p_edit_state, false);
+}
+
+Node *PackedScene::_instantiate(SceneState::GenEditState p_edit_state, bool p_parallel) const {
 #ifndef TOOLS_ENABLED
-	ERR_FAIL_COND_V_MSG(p_edit_state != GEN_EDIT_STATE_DISABLED, nullptr, "Edit state is only for editors, does not work without tools compiled.");
+	ERR_FAIL_COND_V_MSG(p_edit_state != SceneState::GEN_EDIT_STATE_DISABLED, nullptr, "Edit state is only for editors, does not work without tools compiled.");
 #endif
 
-	Node *s = state->instantiate((SceneState::GenEditState)p_edit_state);
+	Node *s = state->instantiate(p_edit_state, p_parallel);
 	if (!s) {
 		return nullptr;
 	}
 
-	if (p_edit_state != GEN_EDIT_STATE_DISABLED) {
+	if (p_edit_state != SceneState::GEN_EDIT_STATE_DISABLED) {
 		s->set_scene_instance_state(state);
 	}
 
@@ -1764,6 +1942,45 @@ Node *PackedScene::instantiate(GenEditState p_edit_state) const {
 	return s;
 }
 
+void PackedScene::_instantiate_threaded(void *p_userdata) {
+	ThreadedInstance *instance = (ThreadedInstance *)p_userdata;
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	instance->node = instance->scene->_instantiate(SceneState::GEN_EDIT_STATE_DISABLED, true);
+	print_verbose(vformat("Instantiated scene '%s' on a worker thread in %d usec.", instance->scene->get_path(), OS::get_singleton()->get_ticks_usec() - from));
+}
+
+WorkerThreadPool::TaskID PackedScene::instantiate_threaded_request() {
+	ERR_FAIL_COND_V(!can_instantiate(), WorkerThreadPool::INVALID_TASK_ID);
+
+	ThreadedInstance *instance = memnew(ThreadedInstance);
+	instance->scene = Ref<PackedScene>(this);
+
+	MutexLock lock(threaded_instances_mutex);
+	// Low priority, so building scenes ahead of time doesn't get in the way of the engine's own tasks.
+	WorkerThreadPool::TaskID task = WorkerThreadPool::get_singleton()->add_native_task(&PackedScene::_instantiate_threaded, instance, false, "Instantiate " + get_path());
+	threaded_instances.insert(task, instance);
+	return task;
+}
+
+Node *PackedScene::instantiate_threaded_get(WorkerThreadPool::TaskID p_task) {
+	ThreadedInstance *instance = nullptr;
+	{
+		MutexLock lock(threaded_instances_mutex);
+		HashMap<WorkerThreadPool::TaskID, ThreadedInstance *>::Iterator E = threaded_instances.find(p_task);
+		ERR_FAIL_COND_V_MSG(!E, nullptr, "No scene is being instantiated by task " + itos(p_task) + ".");
+		ERR_FAIL_COND_V_MSG(E->value->scene.ptr() != this, nullptr, "Task " + itos(p_task) + " instantiates another scene.");
+		instance = E->value;
+		threaded_instances.remove(E);
+	}
+
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(p_task);
+
+	Node *node = instance->node;
+	memdelete(instance);
+	return node;
+}
+
 void PackedScene::replace_state(Ref<SceneState> p_by) {
 	state = p_by;
 	state->set_path(get_path());
@@ -1796,6 +2013,8 @@ void PackedScene::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("pack", "path"), &PackedScene::pack);
 	ClassDB::bind_method(D_METHOD("instantiate", "edit_state"), &PackedScene::instantiate, DEFVAL(GEN_EDIT_STATE_DISABLED));
 	ClassDB::bind_method(D_METHOD("can_instantiate"), &PackedScene::can_instantiate);
+	ClassDB::bind_method(D_METHOD("instantiate_threaded_request"), &PackedScene::instantiate_threaded_request);
+	ClassDB::bind_method(D_METHOD("instantiate_threaded_get", "task_id"), &PackedScene::instantiate_threaded_get);
 	ClassDB::bind_method(D_METHOD("_set_bundled_scene", "scene"), &PackedScene::_set_bundled_scene);
 	ClassDB::bind_method(D_METHOD("_get_bundled_scene"), &PackedScene::_get_bundled_scene);
 	ClassDB::bind_method(D_METHOD("get_state"), &PackedScene::get_state);
@@ -1808,6 +2027,9 @@ void PackedScene::_bind_methods() {
 	BIND_ENUM_CONSTANT(GEN_EDIT_STATE_MAIN_INHERITED);
 }
 
+Mutex PackedScene::threaded_instances_mutex;
+HashMap<WorkerThreadPool::TaskID, PackedScene::ThreadedInstance *> PackedScene::threaded_instances;
+
 PackedScene::PackedScene() {
 	state = Ref<SceneState>(memnew(SceneState));
 }
@@ -32,6 +32,7 @@
 #define PACKED_SCENE_H
 
 #include "core/io/resource.h"
+#include "core/object/worker_thread_pool.h"
 #include "scene/main/node.h"
 
 class SceneState : public RefCounted {
@@ -89,6 +90,48 @@ class SceneState : public RefCounted {
 
 	Vector<ConnectionData> connections;
 
+	// What repeated instantiation can look up once, rebuilt when the scene or ClassDB change.
+	struct InstantiatePlan {
+		struct PropertySetter {
+			MethodBind *bind = nullptr; // nullptr to go through Object::set().
+			int index = -1;
+		};
+
+		SafeRefCount refcount;
+		uint32_t methods_version = 0;
+		// Setters of all the node properties, for the class each node is created as, starting at node_setters_from[node].
+		LocalVector<PropertySetter> setters;
+		LocalVector<uint32_t> node_setters_from;
+		// Bound arguments of each connection, looked up from the variants.
+		LocalVector<Vector<Variant>> connection_binds;
+	};
+
+	mutable Mutex instantiate_plan_mutex;
+	mutable InstantiatePlan *instantiate_plan = nullptr;
+
+	InstantiatePlan *_acquire_instantiate_plan() const;
+	void _release_instantiate_plan(InstantiatePlan *p_plan) const;
+	void _clear_instantiate_plan();
+
+	struct InstantiatePlanRelease {
+		const SceneState *state;
+		InstantiatePlan *plan;
+		InstantiatePlanRelease(const SceneState *p_state, InstantiatePlan *p_plan) :
+				state(p_state), plan(p_plan) {}
+		~InstantiatePlanRelease() {
+			if (plan) {
+				state->_release_instantiate_plan(plan);
+			}
+		}
+	};
+
+	struct SubSceneInstance {
+		int index = 0;
+		Node *node = nullptr;
+	};
+
+	void _instantiate_sub_scene_threaded(SubSceneInstance *p_instance) const;
+
 	Error _parse_node(Node *p_owner, Node *p_node, int p_parent_idx, HashMap<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, HashMap<Node *, int> &node_map, HashMap<Node *, int> &nodepath_map);
 	Error _parse_connections(Node *p_owner, Node *p_node, HashMap<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, HashMap<Node *, int> &node_map, HashMap<Node *, int> &nodepath_map);
 
@@ -145,7 +188,8 @@ public:
 	void clear();
 
 	bool can_instantiate() const;
-	Node *instantiate(GenEditState p_edit_state) const;
+	// With p_parallel, the instantiated sub-scenes are built beforehand on the WorkerThreadPool. Only for GEN_EDIT_STATE_DISABLED.
+	Node *instantiate(GenEditState p_edit_state, bool p_parallel = false) const;
 
 	Ref<SceneState> get_base_scene_state() const;
 
@@ -199,6 +243,7 @@ public:
 	static String get_meta_pointer_property(const String &p_property);
 
 	SceneState();
+	~SceneState();
 };
 
 VARIANT_ENUM_CAST(SceneState::GenEditState)
@@ -209,9 +254,22 @@ class PackedScene : public Resource {
 
 	Ref<SceneState> state;
 
+	struct ThreadedInstance {
+		Ref<PackedScene> scene;
+		Node *node = nullptr;
+	};
+
+	static Mutex threaded_instances_mutex;
+	static HashMap<WorkerThreadPool::TaskID, ThreadedInstance *> threaded_instances;
+
+	static void _instantiate_threaded(void *p_userdata);
+
 	void _set_bundled_scene(const Dictionary &p_scene);
 	Dictionary _get_bundled_scene() const;
 
+	friend class SceneState;
+	Node *_instantiate(SceneState::GenEditState p_edit_state, bool p_parallel) const;
+
 protected:
 	virtual bool editor_can_reload_from_file() override { return false; } // this is handled by editor better
 	static void _bind_methods();
@@ -232,6 +290,10 @@ public:
 	bool can_instantiate() const;
 	Node *instantiate(GenEditState p_edit_state = GEN_EDIT_STATE_DISABLED) const;
 
+	// Builds an instance on a worker thread, to be picked up with instantiate_threaded_get() and added to the tree from the main thread.
+	WorkerThreadPool::TaskID instantiate_threaded_request();
+	Node *instantiate_threaded_get(WorkerThreadPool::TaskID p_task);
+
 	void recreate_state();
 	void replace_state(Ref<SceneState> p_by);
 
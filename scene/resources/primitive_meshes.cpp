@@ -31,6 +31,7 @@
 #include "primitive_meshes.h"
 
 #include "core/core_string_names.h"
+#include "core/templates/owned_vector.h"
 #include "scene/resources/theme.h"
 #include "scene/theme/theme_db.h"
 #include "servers/rendering_server.h"
@@ -287,11 +288,11 @@ void CapsuleMesh::create_mesh_array(Array &p_arr, const float radius, const floa
 
 	// note, this has been aligned with our collision shape but I've left the descriptions as top/middle/bottom
 
-	Vector<Vector3> points;
-	Vector<Vector3> normals;
-	Vector<float> tangents;
-	Vector<Vector2> uvs;
-	Vector<int> indices;
+	OwnedVector<Vector3> points;
+	OwnedVector<Vector3> normals;
+	OwnedVector<float> tangents;
+	OwnedVector<Vector2> uvs;
+	OwnedVector<int> indices;
 	point = 0;
 
 #define ADD_TANGENT(m_x, m_y, m_z, m_d) \
@@ -418,11 +419,11 @@ void CapsuleMesh::create_mesh_array(Array &p_arr, const float radius, const floa
 		thisrow = point;
 	};
 
-	p_arr[RS::ARRAY_VERTEX] = points;
-	p_arr[RS::ARRAY_NORMAL] = normals;
-	p_arr[RS::ARRAY_TANGENT] = tangents;
-	p_arr[RS::ARRAY_TEX_UV] = uvs;
-	p_arr[RS::ARRAY_INDEX] = indices;
+	p_arr[RS::ARRAY_VERTEX] = points.release();
+	p_arr[RS::ARRAY_NORMAL] = normals.release();
+	p_arr[RS::ARRAY_TANGENT] = tangents.release();
+	p_arr[RS::ARRAY_TEX_UV] = uvs.release();
+	p_arr[RS::ARRAY_INDEX] = indices.release();
 }
 
 void CapsuleMesh::_bind_methods() {
@@ -756,11 +757,11 @@ void CylinderMesh::create_mesh_array(Array &p_arr, float top_radius, float botto
 	int i, j, prevrow, thisrow, point;
 	float x, y, z, u, v, radius;
 
-	Vector<Vector3> points;
-	Vector<Vector3> normals;
-	Vector<float> tangents;
-	Vector<Vector2> uvs;
-	Vector<int> indices;
+	OwnedVector<Vector3> points;
+	OwnedVector<Vector3> normals;
+	OwnedVector<float> tangents;
+	OwnedVector<Vector2> uvs;
+	OwnedVector<int> indices;
 	point = 0;
 
 #define ADD_TANGENT(m_x, m_y, m_z, m_d) \
@@ -882,11 +883,11 @@ void CylinderMesh::create_mesh_array(Array &p_arr, float top_radius, float botto
 		};
 	};
 
-	p_arr[RS::ARRAY_VERTEX] = points;
-	p_arr[RS::ARRAY_NORMAL] = normals;
-	p_arr[RS::ARRAY_TANGENT] = tangents;
-	p_arr[RS::ARRAY_TEX_UV] = uvs;
-	p_arr[RS::ARRAY_INDEX] = indices;
+	p_arr[RS::ARRAY_VERTEX] = points.release();
+	p_arr[RS::ARRAY_NORMAL] = normals.release();
+	p_arr[RS::ARRAY_TANGENT] = tangents.release();
+	p_arr[RS::ARRAY_TEX_UV] = uvs.release();
+	p_arr[RS::ARRAY_INDEX] = indices.release();
 }
 
 void CylinderMesh::_bind_methods() {
@@ -1429,11 +1430,11 @@ void SphereMesh::create_mesh_array(Array &p_arr, float radius, float height, int
 
 	// set our bounding box
 
-	Vector<Vector3> points;
-	Vector<Vector3> normals;
-	Vector<float> tangents;
-	Vector<Vector2> uvs;
-	Vector<int> indices;
+	OwnedVector<Vector3> points;
+	OwnedVector<Vector3> normals;
+	OwnedVector<float> tangents;
+	OwnedVector<Vector2> uvs;
+	OwnedVector<int> indices;
 	point = 0;
 
 #define ADD_TANGENT(m_x, m_y, m_z, m_d) \
@@ -1487,11 +1488,11 @@ void SphereMesh::create_mesh_array(Array &p_arr, float radius, float height, int
 		thisrow = point;
 	};
 
-	p_arr[RS::ARRAY_VERTEX] = points;
-	p_arr[RS::ARRAY_NORMAL] = normals;
-	p_arr[RS::ARRAY_TANGENT] = tangents;
-	p_arr[RS::ARRAY_TEX_UV] = uvs;
-	p_arr[RS::ARRAY_INDEX] = indices;
+	p_arr[RS::ARRAY_VERTEX] = points.release();
+	p_arr[RS::ARRAY_NORMAL] = normals.release();
+	p_arr[RS::ARRAY_TANGENT] = tangents.release();
+	p_arr[RS::ARRAY_TEX_UV] = uvs.release();
+	p_arr[RS::ARRAY_INDEX] = indices.release();
 }
 
 void SphereMesh::_bind_methods() {
@@ -1569,11 +1570,11 @@ SphereMesh::SphereMesh() {}
 void TorusMesh::_create_mesh_array(Array &p_arr) const {
 	// set our bounding box
 
-	Vector<Vector3> points;
-	Vector<Vector3> normals;
-	Vector<float> tangents;
-	Vector<Vector2> uvs;
-	Vector<int> indices;
+	OwnedVector<Vector3> points;
+	OwnedVector<Vector3> normals;
+	OwnedVector<float> tangents;
+	OwnedVector<Vector2> uvs;
+	OwnedVector<int> indices;
 
 #define ADD_TANGENT(m_x, m_y, m_z, m_d) \
 	tangents.push_back(m_x);            \
@@ -1624,11 +1625,11 @@ void TorusMesh::_create_mesh_array(Array &p_arr) const {
 		}
 	}
 
-	p_arr[RS::ARRAY_VERTEX] = points;
-	p_arr[RS::ARRAY_NORMAL] = normals;
-	p_arr[RS::ARRAY_TANGENT] = tangents;
-	p_arr[RS::ARRAY_TEX_UV] = uvs;
-	p_arr[RS::ARRAY_INDEX] = indices;
+	p_arr[RS::ARRAY_VERTEX] = points.release();
+	p_arr[RS::ARRAY_NORMAL] = normals.release();
+	p_arr[RS::ARRAY_TANGENT] = tangents.release();
+	p_arr[RS::ARRAY_TEX_UV] = uvs.release();
+	p_arr[RS::ARRAY_INDEX] = indices.release();
 }
 
 void TorusMesh::_bind_methods() {
@@ -34,6 +34,7 @@
 #include "core/io/dir_access.h"
 #include "core/io/missing_resource.h"
 #include "core/io/resource_format_binary.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/version.h"
 
 // Version 2: changed names for Basis, AABB, Vectors, etc.
@@ -123,8 +124,10 @@ Error ResourceLoaderText::_parse_sub_resource(VariantParser::Stream *p_stream, R
 	}
 
 	String id = token.value;
-	ERR_FAIL_COND_V(!int_resources.has(id), ERR_INVALID_PARAMETER);
-	r_res = int_resources[id];
+	// Sub-resources can be parsed on several threads at once, only look them up.
+	const Ref<Resource> *res = int_resources.getptr(id);
+	ERR_FAIL_COND_V(!res, ERR_INVALID_PARAMETER);
+	r_res = *res;
 
 	VariantParser::get_token(p_stream, token, line, r_err_str);
 	if (token.type != VariantParser::TK_PARENTHESIS_CLOSE) {
@@ -146,36 +149,23 @@ Error ResourceLoaderText::_parse_ext_resource(VariantParser::Stream *p_stream, R
 	String id = token.value;
 
 	if (!ignore_resource_parsing) {
-		if (!ext_resources.has(id)) {
+		ExtResource *ext_resource = ext_resources.getptr(id);
+		if (!ext_resource) {
 			r_err_str = "Can't load cached ext-resource id: " + id;
 			return ERR_PARSE_ERROR;
 		}
 
-		String path = ext_resources[id].path;
-		String type = ext_resources[id].type;
-
-		if (ext_resources[id].cache.is_valid()) {
-			r_res = ext_resources[id].cache;
-		} else if (use_sub_threads) {
-			Ref<Resource> res = ResourceLoader::load_threaded_get(path);
-			if (res.is_null()) {
-				if (ResourceLoader::get_abort_on_missing_resources()) {
-					error = ERR_FILE_MISSING_DEPENDENCIES;
-					error_text = "[ext_resource] referenced nonexistent resource at: " + path;
-					_printerr();
-					return error;
-				} else {
-					ResourceLoader::notify_dependency_error(local_path, path, type);
-				}
-			} else {
-				ext_resources[id].cache = res;
-				r_res = res;
+		if (ext_resource->cache.is_valid()) {
+			r_res = ext_resource->cache;
+		} else if (ext_resource->requested) {
+			Error err = _get_requested_ext_resource(*ext_resource);
+			if (err != OK) {
+				return err;
 			}
-		} else {
-			error = ERR_FILE_MISSING_DEPENDENCIES;
-			error_text = "[ext_resource] referenced non-loaded resource at: " + path;
-			_printerr();
-			return error;
+			r_res = ext_resource->cache;
+		} else if (!use_sub_threads) {
+			r_err_str = "[ext_resource] referenced non-loaded resource at: " + ext_resource->path;
+			return ERR_FILE_MISSING_DEPENDENCIES;
 		}
 	} else {
 		r_res = Ref<Resource>();
@@ -190,6 +180,447 @@ Error ResourceLoaderText::_parse_ext_resource(VariantParser::Stream *p_stream, R
 	return OK;
 }
 
+Error ResourceLoaderText::_get_requested_ext_resource(ExtResource &r_ext_resource) {
+	r_ext_resource.requested = false;
+
+	Ref<Resource> res = ResourceLoader::load_threaded_get(r_ext_resource.path);
+	if (res.is_null()) {
+		if (ResourceLoader::get_abort_on_missing_resources()) {
+			error = ERR_FILE_MISSING_DEPENDENCIES;
+			error_text = "[ext_resource] referenced nonexistent resource at: " + r_ext_resource.path;
+			_printerr();
+			return error;
+		} else {
+			ResourceLoader::notify_dependency_error(local_path, r_ext_resource.path, r_ext_resource.type);
+		}
+	} else {
+		r_ext_resource.cache = res;
+	}
+
+	return OK;
+}
+
+Error ResourceLoaderText::_begin_sub_resource(const VariantParser::Tag &p_tag, SubResource &r_sub_resource) {
+	if (ResourceLoader::is_load_canceled()) {
+		if (use_sub_threads) {
+			// Drop the external resources still requested, so they don't keep loading for nobody.
+			for (KeyValue<String, ExtResource> &E : ext_resources) {
+				if (E.value.requested) {
+					E.value.requested = false;
+					ResourceLoader::load_threaded_cancel(E.value.path);
+				}
+			}
+		}
+		error = ERR_SKIP;
+		return error;
+	}
+
+	if (!p_tag.fields.has("type")) {
+		error = ERR_FILE_CORRUPT;
+		error_text = "Missing 'type' in external resource tag";
+		_printerr();
+		return error;
+	}
+
+	if (!p_tag.fields.has("id")) {
+		error = ERR_FILE_CORRUPT;
+		error_text = "Missing 'id' in external resource tag";
+		_printerr();
+		return error;
+	}
+
+	String type = p_tag.fields["type"];
+	String id = p_tag.fields["id"];
+
+	String path = local_path + "::" + id;
+
+	//bool exists=ResourceCache::has(path);
+
+	Ref<Resource> res;
+	bool do_assign = false;
+
+	if (cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE && ResourceCache::has(path)) {
+		//reuse existing
+		Ref<Resource> cache = ResourceCache::get_ref(path);
+		if (cache.is_valid() && cache->get_class() == type) {
+			res = cache;
+			res->reset_state();
+			do_assign = true;
+		}
+	}
+
+	MissingResource *missing_resource = nullptr;
+
+	if (res.is_null()) { //not reuse
+		Ref<Resource> cache = ResourceCache::get_ref(path);
+		if (cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE && cache.is_valid()) { //only if it doesn't exist
+			//cached, do not assign
+			res = cache;
+		} else {
+			//create
+
+			Object *obj = ClassDB::instantiate(type);
+			if (!obj) {
+				if (ResourceLoader::is_creating_missing_resources_if_class_unavailable_enabled()) {
+					missing_resource = memnew(MissingResource);
+					missing_resource->set_original_class(type);
+					missing_resource->set_recording_properties(true);
+					obj = missing_resource;
+				} else {
+					error_text += "Can't create sub resource of type: " + type;
+					_printerr();
+					error = ERR_FILE_CORRUPT;
+					return error;
+				}
+			}
+
+			Resource *r = Object::cast_to<Resource>(obj);
+			if (!r) {
+				error_text += "Can't create sub resource of type, because not a resource: " + type;
+				_printerr();
+				error = ERR_FILE_CORRUPT;
+				return error;
+			}
+
+			res = Ref<Resource>(r);
+			do_assign = true;
+		}
+	}
+
+	resource_current++;
+
+	int_resources[id] = res; //always assign int resources
+	if (do_assign && cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE) {
+		res->set_path(path, cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE);
+		res->set_scene_unique_id(id);
+	}
+
+	r_sub_resource.res = res;
+	r_sub_resource.missing_resource = missing_resource;
+	r_sub_resource.do_assign = do_assign;
+
+	return OK;
+}
+
+void ResourceLoaderText::_set_sub_resource_property(SubResource &r_sub_resource, const String &p_name, const Variant &p_value) {
+	if (!r_sub_resource.do_assign) {
+		return;
+	}
+
+	if (p_value.get_type() == Variant::OBJECT && r_sub_resource.missing_resource != nullptr) {
+		// If the property being set is a missing resource (and the parent is not),
+		// then setting it will most likely not work.
+		// Instead, save it as metadata.
+
+		Ref<MissingResource> mr = p_value;
+		if (mr.is_valid()) {
+			r_sub_resource.missing_resource_properties[p_name] = mr;
+			return;
+		}
+	}
+
+	r_sub_resource.res->set(p_name, p_value);
+}
+
+void ResourceLoaderText::_end_sub_resource(SubResource &r_sub_resource) {
+	if (r_sub_resource.missing_resource) {
+		r_sub_resource.missing_resource->set_recording_properties(false);
+	}
+
+	if (!r_sub_resource.missing_resource_properties.is_empty()) {
+		r_sub_resource.res->set_meta(META_MISSING_RESOURCES, r_sub_resource.missing_resource_properties);
+	}
+
+	if (progress && resources_total > 0) {
+		*progress = resource_current / float(resources_total);
+	}
+}
+
+// Scanning helpers, to find where sections end without parsing their values.
+// They follow the structure VariantParser::parse_tag_assign_eof() reads, so brackets
+// in strings, comments, values and property names are told apart from tags.
+
+static uint64_t _skip_text_string(const uint8_t *p_data, uint64_t p_pos, uint64_t p_length, int &r_lines) {
+	while (p_pos < p_length) {
+		uint8_t c = p_data[p_pos++];
+		if (c == '"') {
+			return p_pos;
+		} else if (c == '\\') {
+			p_pos++;
+		} else if (c == '\n') {
+			r_lines++;
+		}
+	}
+	return p_length;
+}
+
+static uint64_t _skip_text_comment(const uint8_t *p_data, uint64_t p_pos, uint64_t p_length, int &r_lines) {
+	while (p_pos < p_length) {
+		if (p_data[p_pos++] == '\n') {
+			r_lines++;
+			return p_pos;
+		}
+	}
+	return p_length;
+}
+
+static uint64_t _skip_text_whitespace(const uint8_t *p_data, uint64_t p_pos, uint64_t p_length, int &r_lines) {
+	while (p_pos < p_length) {
+		uint8_t c = p_data[p_pos];
+		if (c == ';') {
+			p_pos = _skip_text_comment(p_data, p_pos, p_length, r_lines);
+		} else if (c <= 32) {
+			r_lines += c == '\n';
+			p_pos++;
+		} else {
+			break;
+		}
+	}
+	return p_pos;
+}
+
+static uint64_t _skip_text_group(const uint8_t *p_data, uint64_t p_pos, uint64_t p_length, int &r_lines) {
+	int depth = 0;
+	while (p_pos < p_length) {
+		uint8_t c = p_data[p_pos++];
+		switch (c) {
+			case '(':
+			case '[':
+			case '{': {
+				depth++;
+			} break;
+			case ')':
+			case ']':
+			case '}': {
+				depth--;
+				if (depth == 0) {
+					return p_pos;
+				}
+			} break;
+			case '"': {
+				p_pos = _skip_text_string(p_data, p_pos, p_length, r_lines);
+			} break;
+			case ';': {
+				p_pos = _skip_text_comment(p_data, p_pos, p_length, r_lines);
+			} break;
+			case '\n': {
+				r_lines++;
+			} break;
+		}
+	}
+	return p_length;
+}
+
+static uint64_t _skip_text_value(const uint8_t *p_data, uint64_t p_pos, uint64_t p_length, int &r_lines) {
+	p_pos = _skip_text_whitespace(p_data, p_pos, p_length, r_lines);
+	if (p_pos == p_length) {
+		return p_length;
+	}
+
+	uint8_t c = p_data[p_pos];
+	if (c == '"') {
+		return _skip_text_string(p_data, p_pos + 1, p_length, r_lines);
+	} else if ((c == '&' || c == '@') && p_pos + 1 < p_length && p_data[p_pos + 1] == '"') {
+		return _skip_text_string(p_data, p_pos + 2, p_length, r_lines);
+	} else if (c == '(' || c == '[' || c == '{') {
+		return _skip_text_group(p_data, p_pos, p_length, r_lines);
+	}
+
+	// Numbers, colors, keywords and constructors.
+	bool identifier = is_ascii_char(c) || is_underscore(c);
+	while (p_pos < p_length && p_data[p_pos] > 32 && !strchr("\"()[]{},;:=", p_data[p_pos])) {
+		p_pos++;
+	}
+	if (identifier) {
+		int lines = 0;
+		uint64_t args = _skip_text_whitespace(p_data, p_pos, p_length, lines);
+		if (args < p_length && p_data[args] == '(') {
+			r_lines += lines;
+			return _skip_text_group(p_data, args, p_length, r_lines);
+		}
+	}
+	return p_pos;
+}
+
+// Returns where the tag following the properties at p_pos starts, or p_length if none does.
+static uint64_t _find_next_text_tag(const uint8_t *p_data, uint64_t p_pos, uint64_t p_length, int &r_lines) {
+	bool name = false;
+	while (p_pos < p_length) {
+		uint8_t c = p_data[p_pos];
+		if (c == ';') {
+			p_pos = _skip_text_comment(p_data, p_pos, p_length, r_lines);
+		} else if (c == '[' && !name) {
+			return p_pos;
+		} else if (c == '"') {
+			p_pos = _skip_text_string(p_data, p_pos + 1, p_length, r_lines);
+			name = true;
+		} else if (c == '=') {
+			p_pos = _skip_text_value(p_data, p_pos + 1, p_length, r_lines);
+			name = false;
+		} else {
+			if (c == '\n') {
+				r_lines++;
+			} else if (c > 32) {
+				name = true;
+			}
+			p_pos++;
+		}
+	}
+	return p_length;
+}
+
+void ResourceLoaderText::_parse_sub_resource_sections(SubResourceSectionRange *p_range) {
+	for (uint32_t i = p_range->from; i < p_range->to; i++) {
+		SubResourceSection &section = p_range->sections[i];
+
+		VariantParser::StreamBuffer section_stream;
+		section_stream.data = data.ptr();
+		section_stream.length = section.to;
+		section_stream.pos = section.from;
+
+		int line = section.line;
+		while (true) {
+			String assign;
+			Variant value;
+			VariantParser::Tag tag;
+
+			Error err = VariantParser::parse_tag_assign_eof(&section_stream, line, section.error_text, tag, assign, value, &rp);
+			if (err == ERR_FILE_EOF) {
+				break;
+			}
+			if (err == OK && assign.is_empty()) {
+				err = ERR_FILE_CORRUPT;
+				section.error_text = "Unexpected tag while parsing [sub_resource]";
+			}
+			if (err != OK) {
+				section.error = err;
+				section.line = line;
+				break;
+			}
+
+			if (section.sub_resource.do_assign) {
+				section.properties.push_back(Pair<String, Variant>(assign, value));
+			}
+		}
+	}
+}
+
+Error ResourceLoaderText::_load_sub_resources_threaded() {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (!pool || pool->get_thread_count() == 0 || stream_buffer.saved) {
+		return OK;
+	}
+
+	// Split the run of [sub_resource] tags into sections. One ending the file is left to the serial
+	// parser, which reports it.
+	const uint8_t *file_data = data.ptr();
+	uint64_t file_length = stream_buffer.length;
+	uint64_t from = stream_buffer.pos;
+	int line = lines;
+	VariantParser::Tag tag = next_tag;
+	int end_line = line;
+	String tag_error;
+
+	LocalVector<SubResourceSection> sections;
+	LocalVector<VariantParser::Tag> tags;
+	while (tag.name == "sub_resource") {
+		int to_line = line;
+		uint64_t to = _find_next_text_tag(file_data, from, file_length, to_line);
+		if (to == file_length) {
+			break;
+		}
+
+		sections.push_back(SubResourceSection());
+		sections[sections.size() - 1].from = from;
+		sections[sections.size() - 1].to = to;
+		sections[sections.size() - 1].line = line;
+		tags.push_back(tag);
+		end_line = to_line;
+
+		VariantParser::StreamBuffer tag_stream;
+		tag_stream.data = file_data;
+		tag_stream.length = file_length;
+		tag_stream.pos = to;
+		line = to_line;
+		if (VariantParser::parse_tag(&tag_stream, line, tag_error, tag, &rp) != OK) {
+			break;
+		}
+		from = tag_stream.pos;
+	}
+
+	if (sections.size() < 2 || sections[sections.size() - 1].to - sections[0].from < THREADED_SUB_RESOURCES_MIN_SIZE) {
+		return OK;
+	}
+
+	// Resources are created in order on this thread, so their properties can refer to any of them.
+	for (uint32_t i = 0; i < sections.size(); i++) {
+		Error err = _begin_sub_resource(tags[i], sections[i].sub_resource);
+		if (err != OK) {
+			return err;
+		}
+	}
+
+	// Resources loading on other threads have to be collected first, parsing only looks them up.
+	for (KeyValue<String, ExtResource> &E : ext_resources) {
+		if (E.value.requested) {
+			Error err = _get_requested_ext_resource(E.value);
+			if (err != OK) {
+				return err;
+			}
+		}
+	}
+
+	LocalVector<SubResourceSectionRange> ranges;
+	SubResourceSectionRange range;
+	range.sections = sections.ptr();
+	for (uint32_t i = 0; i < sections.size(); i++) {
+		range.to = i + 1;
+		if (sections[i].to - sections[range.from].from >= THREADED_SUB_RESOURCES_MIN_SIZE || range.to == sections.size()) {
+			ranges.push_back(range);
+			range.from = range.to;
+		}
+	}
+
+	LocalVector<WorkerThreadPool::TaskID> tasks;
+	tasks.resize(ranges.size());
+	for (uint32_t i = 0; i < ranges.size(); i++) {
+		tasks[i] = pool->add_template_task(this, &ResourceLoaderText::_parse_sub_resource_sections, &ranges[i], true, "Parse sub-resources");
+	}
+	for (uint32_t i = 0; i < tasks.size(); i++) {
+		pool->wait_for_task_completion(tasks[i]);
+	}
+
+	// Properties are set in file order, as the serial parser would.
+	Error err = OK;
+	for (uint32_t i = 0; i < sections.size(); i++) {
+		SubResourceSection &section = sections[i];
+		if (section.error != OK) {
+			err = section.error;
+			lines = section.line;
+			error_text = section.error_text;
+			_printerr();
+			break;
+		}
+
+		for (uint32_t j = 0; j < section.properties.size(); j++) {
+			_set_sub_resource_property(section.sub_resource, section.properties[j].first, section.properties[j].second);
+		}
+		_end_sub_resource(section.sub_resource);
+	}
+	if (err != OK) {
+		return err;
+	}
+
+	// Continue serially from the tag after the last section.
+	stream_buffer.pos = sections[sections.size() - 1].to;
+	lines = end_line;
+	err = VariantParser::parse_tag(stream, lines, error_text, next_tag, &rp);
+	if (err != OK) {
+		_printerr();
+	}
+	return err;
+}
+
 Ref<PackedScene> ResourceLoaderText::_parse_node_tag(VariantParser::ResourceParser &parser) {
 	Ref<PackedScene> packed_scene;
 	packed_scene.instantiate();
@@ -278,7 +709,7 @@ Ref<PackedScene> ResourceLoaderText::_parse_node_tag(VariantParser::ResourcePars
 				String assign;
 				Variant value;
 
-				error = VariantParser::parse_tag_assign_eof(&stream, lines, error_text, next_tag, assign, value, &parser);
+				error = VariantParser::parse_tag_assign_eof(stream, lines, error_text, next_tag, assign, value, &parser);
 
 				if (error) {
 					if (error == ERR_FILE_MISSING_DEPENDENCIES) {
@@ -361,7 +792,7 @@ Ref<PackedScene> ResourceLoaderText::_parse_node_tag(VariantParser::ResourcePars
 					unbinds,
 					bind_ints);
 
-			error = VariantParser::parse_tag(&stream, lines, error_text, next_tag, &parser);
+			error = VariantParser::parse_tag(stream, lines, error_text, next_tag, &parser);
 
 			if (error) {
 				if (error != ERR_FILE_EOF) {
@@ -384,7 +815,7 @@ Ref<PackedScene> ResourceLoaderText::_parse_node_tag(VariantParser::ResourcePars
 
 			packed_scene->get_state()->add_editable_instance(path.simplified());
 
-			error = VariantParser::parse_tag(&stream, lines, error_text, next_tag, &parser);
+			error = VariantParser::parse_tag(stream, lines, error_text, next_tag, &parser);
 
 			if (error) {
 				if (error != ERR_FILE_EOF) {
@@ -471,6 +902,7 @@ Error ResourceLoaderText::load() {
 
 		if (use_sub_threads) {
 			Error err = ResourceLoader::load_threaded_request(path, type, use_sub_threads, ResourceFormatLoader::CACHE_MODE_REUSE, local_path);
+			er.requested = err == OK;
 
 			if (err != OK) {
 				if (ResourceLoader::get_abort_on_missing_resources()) {
@@ -507,7 +939,7 @@ Error ResourceLoaderText::load() {
 
 		ext_resources[id] = er;
 
-		error = VariantParser::parse_tag(&stream, lines, error_text, next_tag, &rp);
+		error = VariantParser::parse_tag(stream, lines, error_text, next_tag, &rp);
 
 		if (error) {
 			_printerr();
@@ -520,98 +952,29 @@ Error ResourceLoaderText::load() {
 	resources_total -= resource_current;
 	resource_current = 0;
 
+	if (next_tag.name == "sub_resource" && stream == &stream_buffer) {
+		error = _load_sub_resources_threaded();
+		if (error != OK) {
+			return error;
+		}
+	}
+
 	while (true) {
 		if (next_tag.name != "sub_resource") {
 			break;
 		}
 
-		if (!next_tag.fields.has("type")) {
-			error = ERR_FILE_CORRUPT;
-			error_text = "Missing 'type' in external resource tag";
-			_printerr();
-			return error;
-		}
-
-		if (!next_tag.fields.has("id")) {
-			error = ERR_FILE_CORRUPT;
-			error_text = "Missing 'id' in external resource tag";
-			_printerr();
+		SubResource sub_resource;
+		error = _begin_sub_resource(next_tag, sub_resource);
+		if (error != OK) {
 			return error;
 		}
 
-		String type = next_tag.fields["type"];
-		String id = next_tag.fields["id"];
-
-		String path = local_path + "::" + id;
-
-		//bool exists=ResourceCache::has(path);
-
-		Ref<Resource> res;
-		bool do_assign = false;
-
-		if (cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE && ResourceCache::has(path)) {
-			//reuse existing
-			Ref<Resource> cache = ResourceCache::get_ref(path);
-			if (cache.is_valid() && cache->get_class() == type) {
-				res = cache;
-				res->reset_state();
-				do_assign = true;
-			}
-		}
-
-		MissingResource *missing_resource = nullptr;
-
-		if (res.is_null()) { //not reuse
-			Ref<Resource> cache = ResourceCache::get_ref(path);
-			if (cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE && cache.is_valid()) { //only if it doesn't exist
-				//cached, do not assign
-				res = cache;
-			} else {
-				//create
-
-				Object *obj = ClassDB::instantiate(type);
-				if (!obj) {
-					if (ResourceLoader::is_creating_missing_resources_if_class_unavailable_enabled()) {
-						missing_resource = memnew(MissingResource);
-						missing_resource->set_original_class(type);
-						missing_resource->set_recording_properties(true);
-						obj = missing_resource;
-					} else {
-						error_text += "Can't create sub resource of type: " + type;
-						_printerr();
-						error = ERR_FILE_CORRUPT;
-						return error;
-					}
-				}
-
-				Resource *r = Object::cast_to<Resource>(obj);
-				if (!r) {
-					error_text += "Can't create sub resource of type, because not a resource: " + type;
-					_printerr();
-					error = ERR_FILE_CORRUPT;
-					return error;
-				}
-
-				res = Ref<Resource>(r);
-				do_assign = true;
-			}
-		}
-
-		resource_current++;
-
-		int_resources[id] = res; //always assign int resources
-		if (do_assign && cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE) {
-			res->set_path(path, cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE);
-			res->set_scene_unique_id(id);
-		}
-
-		Dictionary missing_resource_properties;
-
 		while (true) {
 			String assign;
 			Variant value;
 
-			error = VariantParser::parse_tag_assign_eof(&stream, lines, error_text, next_tag, assign, value, &rp);
+			error = VariantParser::parse_tag_assign_eof(stream, lines, error_text, next_tag, assign, value, &rp);
 
 			if (error) {
 				_printerr();
@@ -619,25 +982,7 @@ Error ResourceLoaderText::load() {
 			}
 
 			if (!assign.is_empty()) {
-				if (do_assign) {
-					bool set_valid = true;
-
-					if (value.get_type() == Variant::OBJECT && missing_resource != nullptr) {
-						// If the property being set is a missing resource (and the parent is not),
-						// then setting it will most likely not work.
-						// Instead, save it as metadata.
-
-						Ref<MissingResource> mr = value;
-						if (mr.is_valid()) {
-							missing_resource_properties[assign] = mr;
-							set_valid = false;
-						}
-					}
-
-					if (set_valid) {
-						res->set(assign, value);
-					}
-				}
+				_set_sub_resource_property(sub_resource, assign, value);
 				//it's assignment
 			} else if (!next_tag.name.is_empty()) {
 				error = OK;
@@ -650,17 +995,7 @@ Error ResourceLoaderText::load() {
 			}
 		}
 
-		if (missing_resource) {
-			missing_resource->set_recording_properties(false);
-		}
-
-		if (!missing_resource_properties.is_empty()) {
-			res->set_meta(META_MISSING_RESOURCES, missing_resource_properties);
-		}
-
-		if (progress && resources_total > 0) {
-			*progress = resource_current / float(resources_total);
-		}
+		_end_sub_resource(sub_resource);
 	}
 
 	while (true) {
@@ -718,7 +1053,7 @@ Error ResourceLoaderText::load() {
 			String assign;
 			Variant value;
 
-			error = VariantParser::parse_tag_assign_eof(&stream, lines, error_text, next_tag, assign, value, &rp);
+			error = VariantParser::parse_tag_assign_eof(stream, lines, error_text, next_tag, assign, value, &rp);
 
 			if (error) {
 				if (error != ERR_FILE_EOF) {
@@ -877,7 +1212,7 @@ void ResourceLoaderText::get_dependencies(Ref<FileAccess> p_f, List<String> *p_d
 
 		p_dependencies->push_back(path);
 
-		Error err = VariantParser::parse_tag(&stream, lines, error_text, next_tag, &rp);
+		Error err = VariantParser::parse_tag(stream, lines, error_text, next_tag, &rp);
 
 		if (err) {
 			print_line(error_text + " - " + itos(lines));
@@ -901,7 +1236,7 @@ Error ResourceLoaderText::rename_dependencies(Ref<FileAccess> p_f, const String
 	uint64_t tag_end = f->get_position();
 
 	while (true) {
-		Error err = VariantParser::parse_tag(&stream, lines, error_text, next_tag, &rp);
+		Error err = VariantParser::parse_tag(stream, lines, error_text, next_tag, &rp);
 
 		if (err != OK) {
 			error = ERR_FILE_CORRUPT;
@@ -994,19 +1329,31 @@ Error ResourceLoaderText::rename_dependencies(Ref<FileAccess> p_f, const String
 	return OK;
 }
 
-void ResourceLoaderText::open(Ref<FileAccess> p_f, bool p_skip_first_tag) {
+void ResourceLoaderText::open(Ref<FileAccess> p_f, bool p_skip_first_tag, bool p_in_memory) {
 	error = OK;
 
 	lines = 1;
 	f = p_f;
 
-	stream.f = f;
+	if (p_in_memory) {
+		// Tokenizing from memory is much faster than reading characters one by one through FileAccess,
+		// and lets independent sections be parsed in parallel.
+		data.resize(f->get_length());
+		uint8_t *w = data.ptrw();
+		stream_buffer.data = w;
+		stream_buffer.length = f->get_buffer(w, data.size());
+		stream_buffer.pos = 0;
+		stream = &stream_buffer;
+	} else {
+		stream_file.f = f;
+		stream = &stream_file;
+	}
 	is_scene = false;
 	ignore_resource_parsing = false;
 	resource_current = 0;
 
 	VariantParser::Tag tag;
-	Error err = VariantParser::parse_tag(&stream, lines, error_text, tag);
+	Error err = VariantParser::parse_tag(stream, lines, error_text, tag);
 
 	if (err) {
 		error = err;
@@ -1057,7 +1404,7 @@ void ResourceLoaderText::open(Ref<FileAccess> p_f, bool p_skip_first_tag) {
 	}
 
 	if (!p_skip_first_tag) {
-		err = VariantParser::parse_tag(&stream, lines, error_text, next_tag, &rp);
+		err = VariantParser::parse_tag(stream, lines, error_text, next_tag, &rp);
 
 		if (err) {
 			error_text = "Unexpected end of file";
@@ -1168,7 +1515,7 @@ Error ResourceLoaderText::save_as_binary(const String &p_path) {
 		dummy_read.external_resources[dr] = lindex;
 		dummy_read.rev_external_resources[id] = dr;
 
-		error = VariantParser::parse_tag(&stream, lines, error_text, next_tag, &rp_new);
+		error = VariantParser::parse_tag(stream, lines, error_text, next_tag, &rp_new);
 
 		if (error) {
 			_printerr();
@@ -1251,7 +1598,7 @@ Error ResourceLoaderText::save_as_binary(const String &p_path) {
 				String assign;
 				Variant value;
 
-				error = VariantParser::parse_tag_assign_eof(&stream, lines, error_text, next_tag, assign, value, &rp_new);
+				error = VariantParser::parse_tag_assign_eof(stream, lines, error_text, next_tag, assign, value, &rp_new);
 
 				if (error) {
 					if (main_res && error == ERR_FILE_EOF) {
@@ -1376,7 +1723,7 @@ Error ResourceLoaderText::get_classes_used(HashSet<StringName> *r_classes) {
 	rp_new.userdata = &dummy_read;
 
 	while (next_tag.name == "ext_resource") {
-		error = VariantParser::parse_tag(&stream, lines, error_text, next_tag, &rp_new);
+		error = VariantParser::parse_tag(stream, lines, error_text, next_tag, &rp_new);
 
 		if (error) {
 			_printerr();
@@ -1403,7 +1750,7 @@ Error ResourceLoaderText::get_classes_used(HashSet<StringName> *r_classes) {
 			String assign;
 			Variant value;
 
-			error = VariantParser::parse_tag_assign_eof(&stream, lines, error_text, next_tag, assign, value, &rp_new);
+			error = VariantParser::parse_tag_assign_eof(stream, lines, error_text, next_tag, assign, value, &rp_new);
 
 			if (error) {
 				if (error == ERR_FILE_EOF) {
@@ -1451,7 +1798,7 @@ Error ResourceLoaderText::get_classes_used(HashSet<StringName> *r_classes) {
 			String assign;
 			Variant value;
 
-			error = VariantParser::parse_tag_assign_eof(&stream, lines, error_text, next_tag, assign, value, &rp_new);
+			error = VariantParser::parse_tag_assign_eof(stream, lines, error_text, next_tag, assign, value, &rp_new);
 
 			if (error) {
 				if (error == ERR_FILE_MISSING_DEPENDENCIES) {
@@ -1487,12 +1834,13 @@ String ResourceLoaderText::recognize(Ref<FileAccess> p_f) {
 	lines = 1;
 	f = p_f;
 
-	stream.f = f;
+	stream_file.f = f;
+	stream = &stream_file;
 
 	ignore_resource_parsing = true;
 
 	VariantParser::Tag tag;
-	Error err = VariantParser::parse_tag(&stream, lines, error_text, tag);
+	Error err = VariantParser::parse_tag(stream, lines, error_text, tag);
 
 	if (err) {
 		_printerr();
@@ -1531,12 +1879,13 @@ ResourceUID::ID ResourceLoaderText::get_uid(Ref<FileAccess> p_f) {
 	lines = 1;
 	f = p_f;
 
-	stream.f = f;
+	stream_file.f = f;
+	stream = &stream_file;
 
 	ignore_resource_parsing = true;
 
 	VariantParser::Tag tag;
-	Error err = VariantParser::parse_tag(&stream, lines, error_text, tag);
+	Error err = VariantParser::parse_tag(stream, lines, error_text, tag);
 
 	if (err) {
 		_printerr();
@@ -1560,7 +1909,7 @@ Ref<Resource> ResourceFormatLoaderText::load(const String &p_path, const String
 
 	Error err;
 
-	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ, &err);
+	Ref<FileAccess> f = ResourceLoader::open_file(p_path, &err);
 
 	ERR_FAIL_COND_V_MSG(err != OK, Ref<Resource>(), "Cannot open file '" + p_path + "'.");
 
@@ -1571,7 +1920,7 @@ Ref<Resource> ResourceFormatLoaderText::load(const String &p_path, const String
 	loader.local_path = ProjectSettings::get_singleton()->localize_path(path);
 	loader.progress = r_progress;
 	loader.res_path = loader.local_path;
-	loader.open(f);
+	loader.open(f, false, true);
 	err = loader.load();
 	if (r_error) {
 		*r_error = err;
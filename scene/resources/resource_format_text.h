@@ -32,8 +32,11 @@
 #define RESOURCE_FORMAT_TEXT_H
 
 #include "core/io/file_access.h"
+#include "core/io/missing_resource.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/pair.h"
 #include "core/variant/variant_parser.h"
 #include "scene/resources/packed_scene.h"
 
@@ -45,12 +48,45 @@ class ResourceLoaderText {
 
 	Ref<FileAccess> f;
 
-	VariantParser::StreamFile stream;
+	// Files opened for loading are read into memory and parsed from there.
+	Vector<uint8_t> data;
+	VariantParser::StreamFile stream_file;
+	VariantParser::StreamBuffer stream_buffer;
+	VariantParser::Stream *stream = &stream_file;
 
 	struct ExtResource {
 		Ref<Resource> cache;
 		String path;
 		String type;
+		bool requested = false; // Loading on a thread, still to be collected with load_threaded_get().
+	};
+
+	struct SubResource {
+		Ref<Resource> res;
+		MissingResource *missing_resource = nullptr;
+		bool do_assign = false;
+		Dictionary missing_resource_properties;
+	};
+
+	// A [sub_resource] whose properties are parsed on a worker thread.
+	struct SubResourceSection {
+		SubResource sub_resource;
+		uint64_t from = 0;
+		uint64_t to = 0;
+		int line = 0;
+		LocalVector<Pair<String, Variant>> properties;
+		Error error = OK;
+		String error_text;
+	};
+
+	struct SubResourceSectionRange {
+		SubResourceSection *sections = nullptr;
+		uint32_t from = 0;
+		uint32_t to = 0;
+	};
+
+	enum {
+		THREADED_SUB_RESOURCES_MIN_SIZE = 64 * 1024,
 	};
 
 	bool is_scene = false;
@@ -83,6 +119,13 @@ class ResourceLoaderText {
 
 	Error _parse_sub_resource(VariantParser::Stream *p_stream, Ref<Resource> &r_res, int &line, String &r_err_str);
 	Error _parse_ext_resource(VariantParser::Stream *p_stream, Ref<Resource> &r_res, int &line, String &r_err_str);
+	Error _get_requested_ext_resource(ExtResource &r_ext_resource);
+
+	Error _begin_sub_resource(const VariantParser::Tag &p_tag, SubResource &r_sub_resource);
+	void _set_sub_resource_property(SubResource &r_sub_resource, const String &p_name, const Variant &p_value);
+	void _end_sub_resource(SubResource &r_sub_resource);
+	void _parse_sub_resource_sections(SubResourceSectionRange *p_range);
+	Error _load_sub_resources_threaded();
 
 	// for converter
 	class DummyResource : public Resource {
@@ -121,7 +164,7 @@ public:
 	int get_stage_count() const;
 	void set_translation_remapped(bool p_remapped);
 
-	void open(Ref<FileAccess> p_f, bool p_skip_first_tag = false);
+	void open(Ref<FileAccess> p_f, bool p_skip_first_tag = false, bool p_in_memory = false);
 	String recognize(Ref<FileAccess> p_f);
 	ResourceUID::ID get_uid(Ref<FileAccess> p_f);
 	void get_dependencies(Ref<FileAccess> p_f, List<String> *p_dependencies, bool p_add_types);
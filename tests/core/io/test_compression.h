@@ -0,0 +1,116 @@
+/*************************************************************************/
+/*  test_compression.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_COMPRESSION_H
+#define TEST_COMPRESSION_H
+
+#include "core/io/compression.h"
+#include "core/io/file_access_compressed.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestCompression {
+
+// Small records sharing most of their structure, like sub-resources or network packets.
+static Vector<uint8_t> _make_record(int p_index) {
+	String record = vformat("{\"type\": \"Enemy\", \"name\": \"enemy_%d\", \"health\": %d, \"position\": [%d, %d], \"tags\": [\"hostile\", \"spawned\", \"wave_%d\"]}", p_index, 100 + p_index % 7, p_index * 3, p_index * 5, p_index % 4);
+	return record.to_utf8_buffer();
+}
+
+TEST_CASE("[Compression] Zstandard dictionaries") {
+	Vector<Vector<uint8_t>> samples;
+	for (int i = 0; i < 500; i++) {
+		samples.push_back(_make_record(i));
+	}
+	const Vector<uint8_t> dictionary = Compression::train_zstd_dictionary(samples, 4096);
+	REQUIRE_MESSAGE(!dictionary.is_empty(), "Training a dictionary from enough similar samples should succeed.");
+	CHECK(dictionary.size() <= 4096);
+
+	ERR_PRINT_OFF;
+	CHECK_MESSAGE(Compression::train_zstd_dictionary(Vector<Vector<uint8_t>>()).is_empty(), "Training a dictionary needs samples.");
+	ERR_PRINT_ON;
+
+	uint32_t id = Compression::add_zstd_dictionary(dictionary);
+	REQUIRE(id != 0);
+	CHECK(Compression::has_zstd_dictionary(id));
+	CHECK_MESSAGE(Compression::add_zstd_dictionary(dictionary) == id, "Dictionaries should be identified by their content.");
+
+	const Vector<uint8_t> record = _make_record(1000);
+	Vector<uint8_t> compressed;
+	compressed.resize(Compression::get_max_compressed_buffer_size(record.size()));
+	int plain_size = Compression::compress(compressed.ptrw(), record.ptr(), record.size());
+	int dictionary_size = Compression::compress(compressed.ptrw(), record.ptr(), record.size(), Compression::MODE_ZSTD, id);
+	REQUIRE(dictionary_size > 0);
+	CHECK_MESSAGE(dictionary_size < plain_size, "Small inputs similar to the samples should compress better with the dictionary.");
+
+	Vector<uint8_t> decompressed;
+	decompressed.resize(record.size());
+	CHECK(Compression::decompress(decompressed.ptrw(), decompressed.size(), compressed.ptr(), dictionary_size, Compression::MODE_ZSTD, id) == record.size());
+	CHECK(decompressed == record);
+
+	// Files compressed with a dictionary find it again by ID.
+	const String path = OS::get_singleton()->get_cache_path().path_join("compressed_dictionary.bin");
+	{
+		Ref<FileAccessCompressed> fac;
+		fac.instantiate();
+		fac->configure("TEST", Compression::MODE_ZSTD, 4096, id);
+		REQUIRE(fac->open_internal(path, FileAccess::WRITE) == OK);
+		for (int i = 0; i < 100; i++) {
+			Vector<uint8_t> r = _make_record(i);
+			fac->store_buffer(r.ptr(), r.size());
+		}
+	}
+
+	Ref<FileAccessCompressed> fac;
+	fac.instantiate();
+	fac->configure("TEST");
+	REQUIRE(fac->open_internal(path, FileAccess::READ) == OK);
+	for (int i = 0; i < 100; i++) {
+		Vector<uint8_t> expected = _make_record(i);
+		Vector<uint8_t> r;
+		r.resize(expected.size());
+		CHECK(fac->get_buffer(r.ptrw(), r.size()) == uint64_t(r.size()));
+		CHECK(r == expected);
+	}
+	fac.unref();
+
+	Compression::remove_zstd_dictionary(id);
+	CHECK_FALSE(Compression::has_zstd_dictionary(id));
+	fac.instantiate();
+	fac->configure("TEST");
+	ERR_PRINT_OFF;
+	CHECK_MESSAGE(fac->open_internal(path, FileAccess::READ) == ERR_FILE_MISSING_DEPENDENCIES, "Files can't be read without their dictionary.");
+	ERR_PRINT_ON;
+}
+
+} // namespace TestCompression
+
+#endif // TEST_COMPRESSION_H
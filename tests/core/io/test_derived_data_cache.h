@@ -0,0 +1,145 @@
+/*************************************************************************/
+/*  test_derived_data_cache.h                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_DERIVED_DATA_CACHE_H
+#define TEST_DERIVED_DATA_CACHE_H
+
+#include "core/io/derived_data_cache.h"
+#include "core/math/triangle_mesh.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestDerivedDataCache {
+
+TEST_CASE("[DerivedDataCache] Storing and getting entries") {
+	bool was_enabled = DerivedDataCache::enabled;
+	String old_path = DerivedDataCache::path;
+	DerivedDataCache::enabled = true;
+	DerivedDataCache::path = OS::get_singleton()->get_cache_path().path_join("derived_data_cache_test");
+	DerivedDataCache::clear();
+
+	const String resource_path = "res://derived_data_cache_test.tres::Resource_1";
+	Vector<uint8_t> data;
+	for (int i = 0; i < 1000; i++) {
+		data.push_back(i * 7);
+	}
+
+	Vector<uint8_t> read;
+	CHECK_FALSE(DerivedDataCache::get(resource_path, "test", "hash_a", read));
+
+	DerivedDataCache::store(resource_path, "test", "hash_a", data);
+	CHECK(DerivedDataCache::get(resource_path, "test", "hash_a", read));
+	CHECK(read == data);
+
+	CHECK_FALSE_MESSAGE(DerivedDataCache::get(resource_path, "test", "hash_b", read), "Entries are only valid for the content they were made from.");
+	CHECK_FALSE_MESSAGE(DerivedDataCache::get(resource_path, "other_test", "hash_a", read), "Kinds of data are kept apart.");
+	CHECK_FALSE_MESSAGE(DerivedDataCache::get("res://derived_data_cache_test.tres::Resource_2", "test", "hash_a", read), "Sub-resources are kept apart.");
+
+	// A changed resource replaces its entry.
+	DerivedDataCache::store(resource_path, "test", "hash_b", Vector<uint8_t>());
+	CHECK_FALSE(DerivedDataCache::get(resource_path, "test", "hash_a", read));
+	CHECK(DerivedDataCache::get(resource_path, "test", "hash_b", read));
+	CHECK(read.is_empty());
+
+	DerivedDataCache::clear();
+	CHECK_FALSE(DerivedDataCache::get(resource_path, "test", "hash_b", read));
+
+	DerivedDataCache::enabled = false;
+	DerivedDataCache::store(resource_path, "test", "hash_a", data);
+	DerivedDataCache::enabled = true;
+	CHECK_FALSE_MESSAGE(DerivedDataCache::get(resource_path, "test", "hash_a", read), "Nothing should be stored when disabled.");
+
+	DerivedDataCache::enabled = was_enabled;
+	DerivedDataCache::path = old_path;
+}
+
+TEST_CASE("[DerivedDataCache] TriangleMesh buffers") {
+	Vector<Vector3> faces;
+	for (int i = 0; i < 64; i++) {
+		faces.push_back(Vector3(i, 0, 0));
+		faces.push_back(Vector3(i + 1, 0, 0));
+		faces.push_back(Vector3(i, 1, 1));
+	}
+	Ref<TriangleMesh> built;
+	built.instantiate();
+	built->create(faces);
+	REQUIRE(built->is_valid());
+
+	Ref<TriangleMesh> loaded;
+	loaded.instantiate();
+	REQUIRE(loaded->load_from_buffer(built->save_to_buffer()) == OK);
+	CHECK(loaded->is_valid());
+	Vector<Face3> loaded_faces = loaded->get_faces();
+	Vector<Face3> built_faces = built->get_faces();
+	REQUIRE(loaded_faces.size() == built_faces.size());
+	for (int i = 0; i < built_faces.size(); i++) {
+		for (int j = 0; j < 3; j++) {
+			CHECK(loaded_faces[i].vertex[j] == built_faces[i].vertex[j]);
+		}
+	}
+
+	Vector3 point;
+	Vector3 normal;
+	CHECK(loaded->intersect_ray(Vector3(10.25, 0.25, 5), Vector3(0, 0, -1), point, normal));
+	CHECK(point.is_equal_approx(Vector3(10.25, 0.25, 0.25)));
+
+	ERR_PRINT_OFF;
+	Vector<uint8_t> truncated = built->save_to_buffer();
+	truncated.resize(truncated.size() - 1);
+	CHECK(loaded->load_from_buffer(truncated) == ERR_INVALID_DATA);
+	CHECK_FALSE(loaded->is_valid());
+
+	// The depth sizes the stacks of queries, it must be bounded and match the tree.
+	Vector<uint8_t> deep = built->save_to_buffer();
+	uint32_t *deep_header = (uint32_t *)deep.ptrw();
+	deep_header[5] = 1000000;
+	CHECK(loaded->load_from_buffer(deep) == ERR_INVALID_DATA);
+	deep_header[5] = 1;
+	CHECK_MESSAGE(loaded->load_from_buffer(deep) == ERR_INVALID_DATA, "A tree deeper than its stored depth should be rejected.");
+
+	// The root is the last node, its child indices follow its AABB and center.
+	const Vector<uint8_t> saved = built->save_to_buffer();
+	const uint32_t *saved_header = (const uint32_t *)saved.ptr();
+	const int root_index = saved_header[4] - 1;
+	const int root_left_offset = saved.size() - saved_header[1] + 9 * sizeof(real_t);
+	Vector<uint8_t> cyclic = saved;
+	memcpy(cyclic.ptrw() + root_left_offset, &root_index, sizeof(int));
+	CHECK_MESSAGE(loaded->load_from_buffer(cyclic) == ERR_INVALID_DATA, "A node that is its own child should be rejected.");
+	Vector<uint8_t> missing_child = saved;
+	const int no_child = -1;
+	memcpy(missing_child.ptrw() + root_left_offset, &no_child, sizeof(int));
+	CHECK_MESSAGE(loaded->load_from_buffer(missing_child) == ERR_INVALID_DATA, "Inner nodes without both children should be rejected.");
+	CHECK_FALSE(loaded->is_valid());
+	ERR_PRINT_ON;
+}
+} // namespace TestDerivedDataCache
+
+#endif // TEST_DERIVED_DATA_CACHE_H
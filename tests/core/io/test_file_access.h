@@ -32,6 +32,8 @@
 #define TEST_FILE_ACCESS_H
 
 #include "core/io/file_access.h"
+#include "core/io/file_access_compressed.h"
+#include "core/os/os.h"
 #include "tests/test_macros.h"
 #include "tests/test_utils.h"
 
@@ -101,6 +103,123 @@ TEST_CASE("[FileAccess] Get as UTF-8 String") {
 	CHECK(s_cr == "Hello darkness\rMy old friend\rI've come to talk\rWith you again\r");
 	CHECK(s_cr_nocr == "Hello darknessMy old friendI've come to talkWith you again");
 }
+
+TEST_CASE("[FileAccess] Buffer views") {
+	Ref<FileAccess> f = FileAccess::open(TestUtils::get_data_path("translations.csv"), FileAccess::READ);
+	const uint64_t length = f->get_length();
+	REQUIRE(length > 16);
+	Vector<uint8_t> data;
+	data.resize(length);
+	REQUIRE(f->get_buffer(data.ptrw(), length) == length);
+
+	f->seek(4);
+	const uint8_t *view = f->get_buffer_view(8);
+	if (!view) {
+		// Not every backend can provide views, in which case nothing must be read.
+		CHECK(f->get_position() == 4);
+		return;
+	}
+	CHECK(memcmp(view, data.ptr() + 4, 8) == 0);
+	CHECK(f->get_position() == 12);
+	CHECK(f->get_8() == data[12]);
+
+	// Views past the end are refused without moving.
+	CHECK(f->get_buffer_view(length) == nullptr);
+	CHECK(f->get_position() == 13);
+
+	f->seek(0);
+	Vector<uint8_t> copy;
+	copy.resize(length);
+	CHECK(f->get_buffer(copy.ptrw(), length) == length);
+	CHECK(copy == data);
+	CHECK(f->get_buffer_view(1) == nullptr);
+}
+
+// Compressible, but not trivially so.
+static Vector<uint8_t> _make_compressed_test_data(int p_size) {
+	Vector<uint8_t> data;
+	data.resize(p_size);
+	uint8_t *w = data.ptrw();
+	uint32_t seed = 1234;
+	for (int i = 0; i < p_size; i++) {
+		seed = seed * 1103515245 + 12345;
+		w[i] = (i % 64 < 48) ? uint8_t(i / 64) : uint8_t(seed >> 24);
+	}
+	return data;
+}
+
+static void _store_compressed(const String &p_path, const Vector<uint8_t> &p_data, uint32_t p_block_size) {
+	Ref<FileAccessCompressed> fac;
+	fac.instantiate();
+	fac->configure("TEST", Compression::MODE_ZSTD, p_block_size);
+	REQUIRE(fac->open_internal(p_path, FileAccess::WRITE) == OK);
+	fac->store_buffer(p_data.ptr(), p_data.size());
+}
+
+static Ref<FileAccessCompressed> _open_compressed(const String &p_path, uint32_t p_block_size) {
+	Ref<FileAccessCompressed> fac;
+	fac.instantiate();
+	fac->configure("TEST", Compression::MODE_ZSTD, p_block_size);
+	if (fac->open_internal(p_path, FileAccess::READ) != OK) {
+		return Ref<FileAccessCompressed>();
+	}
+	return fac;
+}
+
+TEST_CASE("[FileAccessCompressed] Round trip over many blocks") {
+	const String path = OS::get_singleton()->get_cache_path().path_join("compressed.bin");
+	const Vector<uint8_t> data = _make_compressed_test_data(3 * 1024 * 1024 + 123);
+	_store_compressed(path, data, 4096);
+
+	Ref<FileAccessCompressed> fac = _open_compressed(path, 4096);
+	REQUIRE(fac.is_valid());
+	CHECK(fac->get_length() == uint64_t(data.size()));
+
+	SUBCASE("Sequential reads") {
+		Vector<uint8_t> read;
+		read.resize(data.size());
+		// Odd sizes, so reads straddle blocks and read-ahead runs.
+		uint64_t pos = 0;
+		while (pos < uint64_t(read.size())) {
+			pos += fac->get_buffer(read.ptrw() + pos, MIN(uint64_t(10007), read.size() - pos));
+		}
+		CHECK(read == data);
+		CHECK_FALSE(fac->eof_reached());
+		uint8_t extra;
+		CHECK(fac->get_buffer(&extra, 1) == 0);
+		CHECK(fac->eof_reached());
+	}
+
+	SUBCASE("Seeking around") {
+		const uint64_t positions[] = { 2 * 1024 * 1024 + 5, 17, 4095, 4096, uint64_t(data.size() - 1), 1024 * 1024 };
+		for (uint64_t position : positions) {
+			fac->seek(position);
+			CHECK(fac->get_position() == position);
+			CHECK(fac->get_8() == data[position]);
+		}
+
+		fac->seek(4090);
+		uint8_t bytes[16];
+		CHECK(fac->get_buffer(bytes, 16) == 16);
+		CHECK(memcmp(bytes, data.ptr() + 4090, 16) == 0);
+		CHECK(fac->get_position() == 4106);
+	}
+}
+
+TEST_CASE("[FileAccessCompressed] Reading many blocks in one call") {
+	// Larger than the read-ahead window, so blocks are decompressed in several parallel batches.
+	const String path = OS::get_singleton()->get_cache_path().path_join("compressed_large.bin");
+	const Vector<uint8_t> data = _make_compressed_test_data(8 * 1024 * 1024 + 77);
+	_store_compressed(path, data, 65536);
+
+	Ref<FileAccessCompressed> fac = _open_compressed(path, 65536);
+	REQUIRE(fac.is_valid());
+	Vector<uint8_t> read;
+	read.resize(data.size());
+	CHECK(fac->get_buffer(read.ptrw(), read.size()) == uint64_t(read.size()));
+	CHECK(read == data);
+	CHECK(fac->get_position() == uint64_t(data.size()));
+}
 } // namespace TestFileAccess
 
 #endif // TEST_FILE_ACCESS_H
@@ -0,0 +1,180 @@
+/*************************************************************************/
+/*  test_file_access_async.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_FILE_ACCESS_ASYNC_H
+#define TEST_FILE_ACCESS_ASYNC_H
+
+#include "core/io/file_access.h"
+#include "core/io/file_access_async.h"
+#include "core/io/resource_loader.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestFileAccessAsync {
+
+static String _write_test_file(const String &p_name, int p_size) {
+	const String path = OS::get_singleton()->get_cache_path().path_join(p_name);
+	Ref<FileAccess> f = FileAccess::open(path, FileAccess::WRITE);
+	for (int i = 0; i < p_size; i++) {
+		f->store_8(i * 7 + p_size);
+	}
+	return path;
+}
+
+static Vector<uint8_t> _expected_data(int p_size, int p_offset, int p_length) {
+	Vector<uint8_t> data;
+	for (int i = p_offset; i < MIN(p_offset + p_length, p_size); i++) {
+		data.push_back(i * 7 + p_size);
+	}
+	return data;
+}
+
+static void _check_reads(FileAccessAsync *p_file_access_async) {
+	const String path = _write_test_file("file_access_async.bin", 100000);
+
+	FileAccessAsync::ReadID whole = p_file_access_async->read(path);
+	FileAccessAsync::ReadID range = p_file_access_async->read(path, 1000, 500);
+	FileAccessAsync::ReadID past_end = p_file_access_async->read(path, 99900, 500);
+	FileAccessAsync::ReadID missing = p_file_access_async->read(path + ".missing");
+
+	Vector<uint8_t> data;
+	CHECK(p_file_access_async->wait_for_read(whole, &data) == OK);
+	CHECK(data == _expected_data(100000, 0, 100000));
+	CHECK(p_file_access_async->wait_for_read(range, &data) == OK);
+	CHECK(data == _expected_data(100000, 1000, 500));
+	CHECK_MESSAGE(p_file_access_async->wait_for_read(past_end, &data) == OK, "Reads past the end should return what is there.");
+	CHECK(data.size() == 100);
+	CHECK(data == _expected_data(100000, 99900, 500));
+	CHECK(p_file_access_async->wait_for_read(missing, &data) != OK);
+	CHECK(data.is_empty());
+
+	ERR_PRINT_OFF;
+	CHECK_MESSAGE(p_file_access_async->wait_for_read(whole) == ERR_INVALID_PARAMETER, "Reads can only be waited for once.");
+	ERR_PRINT_ON;
+}
+
+TEST_CASE("[FileAccessAsync] Reading files") {
+	REQUIRE(FileAccessAsync::get_singleton());
+	_check_reads(FileAccessAsync::get_singleton());
+}
+
+TEST_CASE("[FileAccessAsync] Reading files on the WorkerThreadPool") {
+	// The fallback used by platforms without asynchronous system calls, and for files they can't read.
+	FileAccessAsync file_access_async;
+	_check_reads(&file_access_async);
+}
+
+struct CallbackResults {
+	SafeNumeric<int> calls;
+	SafeNumeric<int> bytes;
+};
+
+static void _read_callback(void *p_userdata, FileAccessAsync::ReadID p_read_id, Error p_error, const Vector<uint8_t> &p_data) {
+	CallbackResults *results = (CallbackResults *)p_userdata;
+	if (p_error == OK) {
+		results->calls.increment();
+		results->bytes.add(p_data.size());
+	}
+}
+
+TEST_CASE("[FileAccessAsync] Batched reads with callbacks") {
+	FileAccessAsync *file_access_async = FileAccessAsync::get_singleton();
+	REQUIRE(file_access_async);
+
+	CallbackResults results;
+	Vector<FileAccessAsync::ReadID> reads;
+	for (int i = 0; i < 300; i++) {
+		const String path = _write_test_file(vformat("file_access_async_%d.bin", i), 100 + i);
+		reads.push_back(file_access_async->read(path, 0, -1, _read_callback, &results));
+	}
+
+	int total = 0;
+	for (int i = 0; i < reads.size(); i++) {
+		Vector<uint8_t> data;
+		CHECK(file_access_async->wait_for_read(reads[i], &data) == OK);
+		CHECK(data == _expected_data(100 + i, 0, 100 + i));
+		total += 100 + i;
+	}
+	CHECK_MESSAGE(results.calls.get() == reads.size(), "Callbacks should have run once wait_for_read() returns.");
+	CHECK(results.bytes.get() == total);
+}
+
+TEST_CASE("[FileAccessAsync] Prefetched files for resource loading") {
+	const String path = _write_test_file("file_access_async_prefetch.tres", 1000);
+	const String other_path = _write_test_file("file_access_async_prefetch.txt", 1000);
+
+	Vector<String> paths;
+	paths.push_back(path);
+	paths.push_back(other_path);
+	Vector<String> files = ResourceLoader::prefetch_files(paths);
+	CHECK_MESSAGE(files.size() == 1, "Only files of resource formats read through ResourceLoader::open_file() should be prefetched.");
+
+	Error err = FAILED;
+	Ref<FileAccess> f = ResourceLoader::open_file(path, &err);
+	CHECK(err == OK);
+	REQUIRE(f.is_valid());
+	CHECK(f->get_length() == 1000);
+	CHECK(f->_get_buffer(1000) == _expected_data(1000, 0, 1000));
+	ResourceLoader::release_prefetched_files(files);
+
+	// Unused prefetched files are dropped.
+	files = ResourceLoader::prefetch_files(paths);
+	ResourceLoader::release_prefetched_files(files);
+	f = ResourceLoader::open_file(path, &err);
+	CHECK(err == OK);
+	REQUIRE(f.is_valid());
+	CHECK(f->_get_buffer(1000) == _expected_data(1000, 0, 1000));
+}
+
+TEST_CASE("[FileAccessAsync] More pending reads than the queue holds") {
+	FileAccessAsync *file_access_async = FileAccessAsync::get_singleton();
+	REQUIRE(file_access_async);
+
+	// More than the submission queue of the io_uring backend, waited for in reverse order.
+	const int count = 1000;
+	Vector<FileAccessAsync::ReadID> reads;
+	for (int i = 0; i < count; i++) {
+		const String path = _write_test_file(vformat("file_access_async_pending_%d.bin", i), 4096 + i);
+		reads.push_back(file_access_async->read(path));
+	}
+
+	int failed = 0;
+	for (int i = count - 1; i >= 0; i--) {
+		Vector<uint8_t> data;
+		if (file_access_async->wait_for_read(reads[i], &data) != OK || data != _expected_data(4096 + i, 0, 4096 + i)) {
+			failed++;
+		}
+	}
+	CHECK_MESSAGE(failed == 0, "All pending reads should complete with the file contents.");
+}
+} // namespace TestFileAccessAsync
+
+#endif // TEST_FILE_ACCESS_ASYNC_H
@@ -31,8 +31,11 @@
 #ifndef TEST_PCK_PACKER_H
 #define TEST_PCK_PACKER_H
 
+#include "core/io/compression.h"
 #include "core/io/file_access_pack.h"
 #include "core/io/pck_packer.h"
+#include "core/io/resource_loader.h"
+#include "core/io/resource_saver.h"
 #include "core/os/os.h"
 
 #include "tests/test_utils.h"
@@ -117,6 +120,59 @@ TEST_CASE("[PCKPacker] Pack a PCK file with some files and directories") {
 			f->get_length() <= 35000,
 			"The generated non-empty PCK file shouldn't be too large.");
 }
+
+TEST_CASE("[PCKPacker] Pack a Zstandard dictionary") {
+	Vector<uint8_t> dictionary;
+	dictionary.resize(1000);
+	for (int i = 0; i < dictionary.size(); i++) {
+		dictionary.write[i] = i % 251;
+	}
+	const uint32_t dictionary_id = Compression::add_zstd_dictionary(dictionary);
+	REQUIRE(dictionary_id != 0);
+
+	// A resource compressed with the dictionary, which is only available from the package afterwards.
+	const String resource_path = OS::get_singleton()->get_cache_path().path_join("dictionary_resource.res");
+	Ref<Resource> resource = memnew(Resource);
+	resource->set_name("Compressed with a dictionary");
+	const uint32_t previous_dictionary_id = Compression::zstd_dictionary_id;
+	Compression::zstd_dictionary_id = dictionary_id;
+	CHECK(ResourceSaver::save(resource, resource_path, ResourceSaver::FLAG_COMPRESS) == OK);
+	Compression::zstd_dictionary_id = previous_dictionary_id;
+
+	PCKPacker pck_packer;
+	const String output_pck_path = OS::get_singleton()->get_cache_path().path_join("output_dictionary.pck");
+	REQUIRE(pck_packer.pck_start(output_pck_path) == OK);
+	CHECK(pck_packer.add_file("res://dictionary_resource.res", resource_path) == OK);
+	CHECK_MESSAGE(
+			pck_packer.set_zstd_dictionary(dictionary) == OK,
+			"Setting a dictionary should return an OK error code.");
+	ERR_PRINT_OFF;
+	CHECK_MESSAGE(
+			pck_packer.set_zstd_dictionary(dictionary) == ERR_ALREADY_EXISTS,
+			"A package should only hold one dictionary.");
+	ERR_PRINT_ON;
+	CHECK(pck_packer.flush() == OK);
+
+	Compression::remove_zstd_dictionary(dictionary_id);
+	REQUIRE_FALSE(Compression::has_zstd_dictionary(dictionary_id));
+
+	PackedData *packed_data = memnew(PackedData);
+	CHECK(packed_data->add_pack(output_pck_path, true, 0) == OK);
+	CHECK_MESSAGE(
+			Compression::has_zstd_dictionary(dictionary_id),
+			"Loading the package should register its dictionary.");
+
+	Ref<Resource> loaded_resource = ResourceLoader::load("res://dictionary_resource.res", "", ResourceFormatLoader::CACHE_MODE_IGNORE);
+	CHECK_MESSAGE(
+			loaded_resource.is_valid(),
+			"A resource compressed with the package's dictionary should load.");
+	if (loaded_resource.is_valid()) {
+		CHECK(loaded_resource->get_name() == resource->get_name());
+	}
+
+	memdelete(packed_data);
+	Compression::remove_zstd_dictionary(dictionary_id);
+}
 } // namespace TestPCKPacker
 
 #endif // TEST_PCK_PACKER_H
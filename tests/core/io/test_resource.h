@@ -109,6 +109,232 @@ TEST_CASE("[Resource] Saving and loading") {
 			loaded_child_resource_text->get_name() == "I'm a child resource",
 			"The loaded child resource name should be equal to the expected value.");
 }
+
+TEST_CASE("[Resource] Threaded loading") {
+	Ref<Resource> resource = memnew(Resource);
+	resource->set_name("Hello threads");
+	Ref<Resource> child_resource = memnew(Resource);
+	child_resource->set_name("I'm a child resource");
+	resource->set_meta("other_resource", child_resource);
+	const String save_path_binary = OS::get_singleton()->get_cache_path().path_join("resource_threaded.res");
+	const String save_path_text = OS::get_singleton()->get_cache_path().path_join("resource_threaded.tres");
+	ResourceSaver::save(resource, save_path_binary);
+	ResourceSaver::save(resource, save_path_text);
+
+	CHECK(ResourceLoader::load_threaded_request(save_path_binary) == OK);
+	CHECK(ResourceLoader::load_threaded_request(save_path_text, "", true) == OK);
+	// A second request for the same path shares the load.
+	CHECK(ResourceLoader::load_threaded_request(save_path_text) == OK);
+
+	Error err = FAILED;
+	Ref<Resource> loaded_resource_binary = ResourceLoader::load_threaded_get(save_path_binary, &err);
+	CHECK(err == OK);
+	REQUIRE(loaded_resource_binary.is_valid());
+	CHECK(loaded_resource_binary->get_name() == "Hello threads");
+	CHECK(Ref<Resource>(loaded_resource_binary->get_meta("other_resource"))->get_name() == "I'm a child resource");
+
+	float progress = 0.0;
+	CHECK(ResourceLoader::load_threaded_get_status(save_path_text, &progress) != ResourceLoader::THREAD_LOAD_INVALID_RESOURCE);
+	Ref<Resource> loaded_resource_text = ResourceLoader::load_threaded_get(save_path_text, &err);
+	CHECK(err == OK);
+	REQUIRE(loaded_resource_text.is_valid());
+	CHECK(loaded_resource_text->get_name() == "Hello threads");
+	CHECK_MESSAGE(
+			ResourceLoader::load_threaded_get(save_path_text) == loaded_resource_text,
+			"The second request should get the same resource.");
+	CHECK_MESSAGE(
+			ResourceLoader::load_threaded_get_status(save_path_text) == ResourceLoader::THREAD_LOAD_INVALID_RESOURCE,
+			"The load should be gone once all requests got their result.");
+}
+
+TEST_CASE("[Resource] Threaded loading cancellation") {
+	Ref<Resource> resource = memnew(Resource);
+	resource->set_name("Never mind");
+	const String save_path = OS::get_singleton()->get_cache_path().path_join("resource_canceled.res");
+	ResourceSaver::save(resource, save_path);
+
+	CHECK(ResourceLoader::load_threaded_request(save_path) == OK);
+	ResourceLoader::load_threaded_cancel(save_path);
+
+	// Whether it was stopped or had already finished, it goes away on its own.
+	uint64_t timeout = OS::get_singleton()->get_ticks_msec() + 10000;
+	while (ResourceLoader::load_threaded_get_status(save_path) != ResourceLoader::THREAD_LOAD_INVALID_RESOURCE && OS::get_singleton()->get_ticks_msec() < timeout) {
+		OS::get_singleton()->delay_usec(1000);
+	}
+	CHECK(ResourceLoader::load_threaded_get_status(save_path) == ResourceLoader::THREAD_LOAD_INVALID_RESOURCE);
+
+	// It can be requested again afterwards.
+	CHECK(ResourceLoader::load_threaded_request(save_path) == OK);
+	Ref<Resource> loaded_resource = ResourceLoader::load_threaded_get(save_path);
+	REQUIRE(loaded_resource.is_valid());
+	CHECK(loaded_resource->get_name() == "Never mind");
+}
+
+// Records how many of its loads run at the same time.
+class ResourceFormatLoaderConcurrency : public ResourceFormatLoader {
+public:
+	SafeNumeric<int> loading;
+	SafeNumeric<int> max_loading;
+
+	virtual Ref<Resource> load(const String &p_path, const String &p_original_path, Error *r_error, bool p_use_sub_threads, float *r_progress, CacheMode p_cache_mode) override {
+		max_loading.exchange_if_greater(loading.increment());
+		OS::get_singleton()->delay_usec(2000);
+		loading.decrement();
+		if (r_error) {
+			*r_error = OK;
+		}
+		return memnew(Resource);
+	}
+	virtual void get_recognized_extensions(List<String> *p_extensions) const override {
+		p_extensions->push_back("concurrencytest");
+	}
+	virtual bool handles_type(const String &p_type) const override {
+		return p_type == "Resource";
+	}
+	virtual String get_resource_type(const String &p_path) const override {
+		return p_path.get_extension() == "concurrencytest" ? "Resource" : "";
+	}
+};
+
+TEST_CASE("[Resource] Threaded loading runs a limited number of loads at once") {
+	Ref<ResourceFormatLoaderConcurrency> loader = memnew(ResourceFormatLoaderConcurrency);
+	ResourceLoader::add_resource_format_loader(loader, true);
+
+	const int max_loads = OS::get_singleton()->get_processor_count();
+	const int count = max_loads * 3 + 1;
+	for (int i = 0; i < count; i++) {
+		CHECK(ResourceLoader::load_threaded_request(vformat("res://resource_concurrency_%d.concurrencytest", i)) == OK);
+	}
+	// Gotten in reverse order, so the last ones are still queued when they are waited for.
+	for (int i = count - 1; i >= 0; i--) {
+		Error err = FAILED;
+		CHECK(ResourceLoader::load_threaded_get(vformat("res://resource_concurrency_%d.concurrencytest", i), &err).is_valid());
+		CHECK(err == OK);
+	}
+
+	CHECK(loader->loading.get() == 0);
+	CHECK(loader->max_loading.get() >= 1);
+	CHECK_MESSAGE(loader->max_loading.get() <= max_loads, "No more loads than processors should run at once.");
+
+	ResourceLoader::remove_resource_format_loader(loader);
+}
+
+// Loads "top" resources sharing a "mid" dependency, which waits on a slow "leaf" of its own.
+// While mid waits, its worker thread may pick up one of the tops, which then needs mid from on top of it.
+class ResourceFormatLoaderSharedDependency : public ResourceFormatLoader {
+public:
+	virtual Ref<Resource> load(const String &p_path, const String &p_original_path, Error *r_error, bool p_use_sub_threads, float *r_progress, CacheMode p_cache_mode) override {
+		String name = p_path.get_file().get_basename();
+		String dependency;
+		if (name.begins_with("shared_dependency_top")) {
+			dependency = "res://shared_dependency_mid.shareddeptest";
+		} else if (name == "shared_dependency_mid") {
+			dependency = "res://shared_dependency_leaf.shareddeptest";
+		} else {
+			OS::get_singleton()->delay_usec(20000);
+		}
+
+		Error err = OK;
+		if (!dependency.is_empty()) {
+			err = ResourceLoader::load_threaded_request(dependency, "", false, CACHE_MODE_REUSE, p_path);
+			if (err == OK) {
+				ResourceLoader::load_threaded_get(dependency, &err);
+			}
+		}
+		if (r_error) {
+			*r_error = err;
+		}
+		return err == OK ? Ref<Resource>(memnew(Resource)) : Ref<Resource>();
+	}
+	virtual void get_recognized_extensions(List<String> *p_extensions) const override {
+		p_extensions->push_back("shareddeptest");
+	}
+	virtual bool handles_type(const String &p_type) const override {
+		return p_type == "Resource";
+	}
+	virtual String get_resource_type(const String &p_path) const override {
+		return p_path.get_extension() == "shareddeptest" ? "Resource" : "";
+	}
+};
+
+TEST_CASE("[Resource] Threaded loads sharing a dependency") {
+	Ref<ResourceFormatLoaderSharedDependency> loader = memnew(ResourceFormatLoaderSharedDependency);
+	ResourceLoader::add_resource_format_loader(loader, true);
+
+	const String paths[] = { "res://shared_dependency_top_a.shareddeptest", "res://shared_dependency_top_b.shareddeptest" };
+	for (const String &path : paths) {
+		CHECK(ResourceLoader::load_threaded_request(path) == OK);
+	}
+	// Reaching the end at all is the point. A top started on the thread mid waits on can't have mid,
+	// it must fail instead of waiting forever for a load that is below it on its own thread.
+	ERR_PRINT_OFF;
+	for (const String &path : paths) {
+		Error err = FAILED;
+		Ref<Resource> resource = ResourceLoader::load_threaded_get(path, &err);
+		CHECK_MESSAGE((err == OK || err == ERR_BUSY), "Loads sharing a dependency should end, either loaded or reporting the wait they can't do.");
+		CHECK(resource.is_valid() == (err == OK));
+	}
+	ERR_PRINT_ON;
+
+	ResourceLoader::remove_resource_format_loader(loader);
+}
+
+static Ref<Resource> _make_resource_with_sub_resources(int p_count, int p_array_size) {
+	Ref<Resource> resource = memnew(Resource);
+	Ref<Resource> previous;
+	for (int i = 0; i < p_count; i++) {
+		Ref<Resource> child = memnew(Resource);
+		// Things that look like tags inside values must not split sections.
+		child->set_name(vformat("Child %d\n[sub_resource type=\"Resource\" id=\"fake\"]", i));
+		PackedFloat32Array floats;
+		floats.resize(p_array_size);
+		for (int j = 0; j < p_array_size; j++) {
+			floats.set(j, i + j * 0.25);
+		}
+		child->set_meta("floats", floats);
+		Dictionary dictionary;
+		dictionary["[not a tag]"] = Array();
+		dictionary[Array()] = Vector3(i, -i, 0.5);
+		child->set_meta("dictionary", dictionary);
+		if (previous.is_valid()) {
+			child->set_meta("previous", previous);
+		}
+		resource->set_meta(vformat("child_%d", i), child);
+		previous = child;
+	}
+	return resource;
+}
+
+TEST_CASE("[Resource] Loading text resources with many sub-resources") {
+	const String save_path = OS::get_singleton()->get_cache_path().path_join("resource_sub_resources.tres");
+	// Large enough for the sub-resources to be parsed on several threads.
+	const int count = 64;
+	const int array_size = 2048;
+	REQUIRE(ResourceSaver::save(_make_resource_with_sub_resources(count, array_size), save_path) == OK);
+
+	Ref<Resource> loaded = ResourceLoader::load(save_path, "", ResourceFormatLoader::CACHE_MODE_IGNORE);
+	REQUIRE(loaded.is_valid());
+	for (int i = 0; i < count; i++) {
+		Ref<Resource> child = loaded->get_meta(vformat("child_%d", i));
+		REQUIRE(child.is_valid());
+		CHECK(child->get_name() == vformat("Child %d\n[sub_resource type=\"Resource\" id=\"fake\"]", i));
+
+		PackedFloat32Array floats = child->get_meta("floats");
+		REQUIRE(floats.size() == array_size);
+		CHECK(floats[0] == float(i));
+		CHECK(floats[array_size - 1] == float(i + (array_size - 1) * 0.25));
+
+		Dictionary dictionary = child->get_meta("dictionary");
+		CHECK(dictionary.has("[not a tag]"));
+		CHECK(dictionary[Array()] == Variant(Vector3(i, -i, 0.5)));
+
+		if (i > 0) {
+			CHECK_MESSAGE(
+					Ref<Resource>(child->get_meta("previous")) == Ref<Resource>(loaded->get_meta(vformat("child_%d", i - 1))),
+					"References between sub-resources should be kept.");
+		}
+	}
+}
 } // namespace TestResource
 
 #endif // TEST_RESOURCE_H
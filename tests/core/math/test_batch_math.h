@@ -0,0 +1,172 @@
+/*************************************************************************/
+/*  test_batch_math.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_BATCH_MATH_H
+#define TEST_BATCH_MATH_H
+
+#include "core/math/batch_math.h"
+#include "core/math/random_pcg.h"
+#include "core/templates/local_vector.h"
+
+#include "tests/test_macros.h"
+
+namespace TestBatchMath {
+
+// Odd sizes, so SIMD implementations also go through their remainder loops.
+const uint32_t TEST_COUNT = 37;
+
+Vector3 random_vector(RandomPCG &p_rng) {
+	return Vector3(p_rng.random(-100.0, 100.0), p_rng.random(-100.0, 100.0), p_rng.random(-100.0, 100.0));
+}
+
+Transform3D random_transform(RandomPCG &p_rng) {
+	Basis basis(random_vector(p_rng).normalized(), p_rng.random(-Math_PI, Math_PI));
+	basis.scale(Vector3(p_rng.random(0.1, 3.0), p_rng.random(0.1, 3.0), p_rng.random(0.1, 3.0)));
+	return Transform3D(basis, random_vector(p_rng));
+}
+
+void fill_test_data(LocalVector<Vector3> &r_vectors, LocalVector<AABB> &r_aabbs, LocalVector<Transform3D> &r_transforms) {
+	RandomPCG rng(42);
+	r_vectors.resize(TEST_COUNT);
+	r_aabbs.resize(TEST_COUNT);
+	r_transforms.resize(TEST_COUNT);
+	for (uint32_t i = 0; i < TEST_COUNT; i++) {
+		r_vectors[i] = random_vector(rng);
+		// Sizes are sometimes negative, which xform() handles.
+		r_aabbs[i] = AABB(random_vector(rng), random_vector(rng) * 0.1);
+		r_transforms[i] = random_transform(rng);
+	}
+	r_vectors[3] = Vector3(); // Normalizes to zero.
+}
+
+TEST_CASE("[BatchMath] All implementations give the same results as Transform3D") {
+	LocalVector<Vector3> vectors;
+	LocalVector<AABB> aabbs;
+	LocalVector<Transform3D> transforms;
+	fill_test_data(vectors, aabbs, transforms);
+	RandomPCG rng(7);
+	const Transform3D transform = random_transform(rng);
+
+	const BatchMath::Implementation default_implementation = BatchMath::get_implementation();
+	CHECK(BatchMath::is_implementation_supported(BatchMath::IMPLEMENTATION_SCALAR));
+	CHECK(BatchMath::is_implementation_supported(default_implementation));
+
+	for (int implementation = 0; implementation < BatchMath::IMPLEMENTATION_MAX; implementation++) {
+		if (!BatchMath::is_implementation_supported(BatchMath::Implementation(implementation))) {
+			continue;
+		}
+		BatchMath::set_implementation(BatchMath::Implementation(implementation));
+		INFO(BatchMath::get_implementation_name(BatchMath::Implementation(implementation)));
+
+		LocalVector<Vector3> points;
+		points.resize(TEST_COUNT);
+		BatchMath::xform_points(transform, vectors.ptr(), points.ptr(), TEST_COUNT);
+		LocalVector<Vector3> normals;
+		normals.resize(TEST_COUNT);
+		BatchMath::xform_normals(transform.basis, vectors.ptr(), normals.ptr(), TEST_COUNT);
+		bool points_match = true;
+		bool normals_match = true;
+		for (uint32_t i = 0; i < TEST_COUNT; i++) {
+			points_match = points_match && points[i] == transform.xform(vectors[i]);
+			normals_match = normals_match && normals[i] == transform.basis.xform(vectors[i]).normalized();
+		}
+		CHECK(points_match);
+		CHECK(normals_match);
+		CHECK(normals[3] == Vector3());
+
+		LocalVector<AABB> transformed_aabbs;
+		transformed_aabbs.resize(TEST_COUNT);
+		BatchMath::xform_aabbs(transform, aabbs.ptr(), transformed_aabbs.ptr(), TEST_COUNT);
+		bool aabbs_match = true;
+		AABB merged = transform.xform(aabbs[0]);
+		for (uint32_t i = 0; i < TEST_COUNT; i++) {
+			aabbs_match = aabbs_match && transformed_aabbs[i] == transform.xform(aabbs[i]);
+			merged.merge_with(transformed_aabbs[i]);
+		}
+		CHECK(aabbs_match);
+		CHECK(BatchMath::merge_aabbs(transformed_aabbs.ptr(), TEST_COUNT).is_equal_approx(merged));
+		CHECK(BatchMath::merge_aabbs(nullptr, 0) == AABB());
+
+		LocalVector<Transform3D> products;
+		products.resize(TEST_COUNT);
+		BatchMath::multiply_transforms(transform, transforms.ptr(), products.ptr(), TEST_COUNT);
+		bool products_match = true;
+		for (uint32_t i = 0; i < TEST_COUNT; i++) {
+			products_match = products_match && products[i] == transform * transforms[i];
+		}
+		CHECK(products_match);
+
+		// Every other slot of the buffer is left alone, to check the stride.
+		const uint32_t stride = 12 * 2;
+		LocalVector<float> buffer;
+		buffer.resize(TEST_COUNT * stride);
+		for (uint32_t i = 0; i < buffer.size(); i++) {
+			buffer[i] = -1.0f;
+		}
+		BatchMath::transforms_to_buffer(transforms.ptr(), sizeof(Transform3D), buffer.ptr(), stride, TEST_COUNT);
+		bool buffer_matches = true;
+		for (uint32_t i = 0; i < TEST_COUNT; i++) {
+			const float *row = buffer.ptr() + i * stride;
+			for (int j = 0; j < 3; j++) {
+				buffer_matches = buffer_matches && row[j * 4 + 0] == transforms[i].basis.rows[j][0];
+				buffer_matches = buffer_matches && row[j * 4 + 1] == transforms[i].basis.rows[j][1];
+				buffer_matches = buffer_matches && row[j * 4 + 2] == transforms[i].basis.rows[j][2];
+				buffer_matches = buffer_matches && row[j * 4 + 3] == transforms[i].origin[j];
+				buffer_matches = buffer_matches && row[12 + j * 4] == -1.0f;
+			}
+		}
+		CHECK(buffer_matches);
+
+		BatchMath::multiply_transforms_to_buffer(transform, transforms.ptr(), sizeof(Transform3D), buffer.ptr(), stride, TEST_COUNT);
+		bool multiplied_buffer_matches = true;
+		for (uint32_t i = 0; i < TEST_COUNT; i++) {
+			const float *row = buffer.ptr() + i * stride;
+			for (int j = 0; j < 3; j++) {
+				multiplied_buffer_matches = multiplied_buffer_matches && row[j * 4 + 0] == products[i].basis.rows[j][0];
+				multiplied_buffer_matches = multiplied_buffer_matches && row[j * 4 + 3] == products[i].origin[j];
+			}
+		}
+		CHECK(multiplied_buffer_matches);
+
+		// In place.
+		LocalVector<Vector3> in_place = vectors;
+		BatchMath::xform_points(transform, in_place.ptr(), in_place.ptr(), TEST_COUNT);
+		CHECK(in_place[TEST_COUNT - 1] == points[TEST_COUNT - 1]);
+		LocalVector<Transform3D> in_place_transforms = transforms;
+		BatchMath::multiply_transforms(transform, in_place_transforms.ptr(), in_place_transforms.ptr(), TEST_COUNT);
+		CHECK(in_place_transforms[TEST_COUNT - 1] == products[TEST_COUNT - 1]);
+	}
+
+	BatchMath::set_implementation(default_implementation);
+}
+
+} // namespace TestBatchMath
+
+#endif // TEST_BATCH_MATH_H
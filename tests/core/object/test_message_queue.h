@@ -0,0 +1,160 @@
+/*************************************************************************/
+/*  test_message_queue.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_MESSAGE_QUEUE_H
+#define TEST_MESSAGE_QUEUE_H
+
+#include "core/object/message_queue.h"
+#include "core/os/thread.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMessageQueue {
+
+struct ReceivedCalls {
+	LocalVector<int> values[4];
+	int total = 0;
+};
+
+static ReceivedCalls *received = nullptr;
+
+static void static_deferred_call(int p_thread, int p_value) {
+	received->values[p_thread].push_back(p_value);
+	received->total++;
+}
+
+static void static_reposting_call(int p_remaining) {
+	received->total++;
+	if (p_remaining > 0) {
+		MessageQueue::get_singleton()->push_callable(callable_mp_static(static_reposting_call), p_remaining - 1);
+	}
+}
+
+static const int calls_per_thread = 20000;
+
+static void static_posting_thread(void *p_arg) {
+	int thread = (int)(intptr_t)p_arg;
+	for (int i = 0; i < calls_per_thread; i++) {
+		MessageQueue::get_singleton()->push_callable(callable_mp_static(static_deferred_call), thread, i);
+	}
+}
+
+TEST_CASE("[MessageQueue] Deferred calls from several threads keep their order") {
+	bool own_queue = MessageQueue::get_singleton() == nullptr;
+	if (own_queue) {
+		memnew(MessageQueue);
+	}
+	ReceivedCalls calls;
+	received = &calls;
+
+	Thread threads[3];
+	for (int i = 0; i < 3; i++) {
+		threads[i].start(static_posting_thread, (void *)(intptr_t)(i + 1));
+	}
+	static_posting_thread((void *)(intptr_t)0);
+	for (int i = 0; i < 3; i++) {
+		threads[i].wait_to_finish();
+	}
+
+	MessageQueue::get_singleton()->flush();
+
+	// Way more than fits in a single page, so the queue had to grow.
+	CHECK(calls.total == calls_per_thread * 4);
+	for (int i = 0; i < 4; i++) {
+		REQUIRE(calls.values[i].size() == (uint32_t)calls_per_thread);
+		bool in_order = true;
+		for (int j = 0; j < calls_per_thread; j++) {
+			in_order = in_order && calls.values[i][j] == j;
+		}
+		CHECK_MESSAGE(in_order, "Calls from a thread must be flushed in the order they were posted.");
+	}
+
+	received = nullptr;
+	if (own_queue) {
+		memdelete(MessageQueue::get_singleton());
+	}
+}
+
+TEST_CASE("[MessageQueue] Calls posted while flushing are flushed too") {
+	bool own_queue = MessageQueue::get_singleton() == nullptr;
+	if (own_queue) {
+		memnew(MessageQueue);
+	}
+	ReceivedCalls calls;
+	received = &calls;
+
+	MessageQueue::get_singleton()->push_callable(callable_mp_static(static_reposting_call), 10);
+	MessageQueue::get_singleton()->flush();
+	CHECK(calls.total == 11);
+	CHECK_FALSE(MessageQueue::get_singleton()->is_flushing());
+
+	received = nullptr;
+	if (own_queue) {
+		memdelete(MessageQueue::get_singleton());
+	}
+}
+
+static void static_short_lived_thread(void *p_arg) {
+	MessageQueue::get_singleton()->push_callable(callable_mp_static(static_deferred_call), 0, (int)(intptr_t)p_arg);
+}
+
+TEST_CASE("[MessageQueue] Buffers of exited threads are reused") {
+	bool own_queue = MessageQueue::get_singleton() == nullptr;
+	if (own_queue) {
+		memnew(MessageQueue);
+	}
+	ReceivedCalls calls;
+	received = &calls;
+
+	// The first thread may need a new buffer, the following ones reuse it.
+	const int buffers_before = MessageQueue::get_singleton()->get_thread_buffer_count();
+	for (int i = 0; i < 16; i++) {
+		Thread thread;
+		thread.start(static_short_lived_thread, (void *)(intptr_t)i);
+		thread.wait_to_finish();
+	}
+	CHECK(MessageQueue::get_singleton()->get_thread_buffer_count() <= buffers_before + 1);
+
+	// Messages left in the buffer of a thread that exited are still flushed, in order.
+	MessageQueue::get_singleton()->flush();
+	REQUIRE(calls.values[0].size() == 16);
+	for (int i = 0; i < 16; i++) {
+		CHECK(calls.values[0][i] == i);
+	}
+
+	received = nullptr;
+	if (own_queue) {
+		memdelete(MessageQueue::get_singleton());
+	}
+}
+
+} // namespace TestMessageQueue
+
+#endif // TEST_MESSAGE_QUEUE_H
@@ -32,6 +32,7 @@
 #define TEST_OBJECT_H
 
 #include "core/core_string_names.h"
+#include "core/io/resource.h"
 #include "core/object/class_db.h"
 #include "core/object/object.h"
 #include "core/object/script_language.h"
@@ -281,6 +282,24 @@ TEST_CASE("[Object] Absent name getter") {
 			actual_value == Variant(),
 			"The returned value should equal nil variant.");
 }
+
+TEST_CASE("[Object] Cached method lookup") {
+	CHECK(ClassDB::get_method_cached("Resource", "get_instance_id") == ClassDB::get_method("Object", "get_instance_id"));
+	CHECK(ClassDB::get_method_cached("Resource", "get_path") == ClassDB::get_method("Resource", "get_path"));
+	// Cached now.
+	CHECK(ClassDB::get_method_cached("Resource", "get_path") == ClassDB::get_method("Resource", "get_path"));
+	CHECK(ClassDB::get_method_cached("Object", "get_path") == nullptr);
+	CHECK(ClassDB::get_method_cached("Resource", "absent_method") == nullptr);
+	CHECK(ClassDB::get_method_cached("AbsentClass", "get_instance_id") == nullptr);
+
+	Ref<Resource> resource;
+	resource.instantiate();
+	Callable::CallError error;
+	CHECK(resource->callp("get_instance_id", nullptr, 0, error) == Variant(resource->get_instance_id()));
+	CHECK(error.error == Callable::CallError::CALL_OK);
+	resource->callp("absent_method", nullptr, 0, error);
+	CHECK(error.error == Callable::CallError::CALL_ERROR_INVALID_METHOD);
+}
 } // namespace TestObject
 
 #endif // TEST_OBJECT_H
@@ -0,0 +1,133 @@
+/*************************************************************************/
+/*  test_small_allocator.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_SMALL_ALLOCATOR_H
+#define TEST_SMALL_ALLOCATOR_H
+
+#include "core/os/os.h"
+#include "core/os/small_allocator.h"
+#include "core/os/thread.h"
+#include "core/templates/safe_refcount.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSmallAllocator {
+
+TEST_CASE("[SmallAllocator] Size classes") {
+	for (uint32_t size = 1; size <= SmallAllocator::MAX_SIZE; size++) {
+		uint32_t size_class = SmallAllocator::get_size_class(size);
+		REQUIRE(size_class < SmallAllocator::SIZE_CLASS_COUNT);
+		CHECK(SmallAllocator::get_size_class_block_size(size_class) >= size);
+		if (size_class > 0) {
+			CHECK(SmallAllocator::get_size_class_block_size(size_class - 1) < size);
+		}
+	}
+	CHECK(SmallAllocator::get_size_class_block_size(SmallAllocator::SIZE_CLASS_COUNT - 1) == SmallAllocator::MAX_SIZE);
+}
+
+TEST_CASE("[SmallAllocator] Allocate, write and free blocks") {
+	const int count = 4096;
+	uint8_t *blocks[count];
+	for (int i = 0; i < count; i++) {
+		uint32_t size = 1 + (i * 37) % SmallAllocator::MAX_SIZE;
+		blocks[i] = (uint8_t *)SmallAllocator::alloc(size);
+		REQUIRE(blocks[i] != nullptr);
+		memset(blocks[i], i & 0xFF, size);
+	}
+	bool intact = true;
+	for (int i = 0; i < count; i++) {
+		uint32_t size = 1 + (i * 37) % SmallAllocator::MAX_SIZE;
+		for (uint32_t j = 0; j < size; j++) {
+			intact = intact && blocks[i][j] == (i & 0xFF);
+		}
+		SmallAllocator::free(blocks[i], size);
+	}
+	CHECK_MESSAGE(intact, "Blocks must not overlap.");
+}
+
+struct ChurnData {
+	int iterations = 0;
+	SafeNumeric<uint32_t> corrupted_blocks;
+};
+
+static void churn_thread(void *p_userdata) {
+	ChurnData *data = (ChurnData *)p_userdata;
+	const int live_count = 256;
+	uint8_t *live[live_count] = {};
+	uint32_t sizes[live_count] = {};
+	uint8_t tags[live_count] = {};
+	uint32_t seed = 12345 + (uint32_t)(uintptr_t)&live; // Differs per thread.
+
+	// Mimics Variant/StringName/Object churn: mostly small sizes, freed in a different order.
+	// Each block is filled with a tag, which must still be intact when it's freed.
+	for (int i = 0; i < data->iterations; i++) {
+		seed = seed * 1103515245 + 12345;
+		int slot = (seed >> 8) % live_count;
+		if (live[slot]) {
+			for (uint32_t j = 0; j < sizes[slot]; j++) {
+				if (live[slot][j] != tags[slot]) {
+					data->corrupted_blocks.increment();
+					break;
+				}
+			}
+			SmallAllocator::free(live[slot], sizes[slot]);
+		}
+		sizes[slot] = 16 + (seed >> 16) % 240;
+		tags[slot] = seed >> 24;
+		live[slot] = (uint8_t *)SmallAllocator::alloc(sizes[slot]);
+		memset(live[slot], tags[slot], sizes[slot]);
+	}
+	for (int i = 0; i < live_count; i++) {
+		if (live[i]) {
+			SmallAllocator::free(live[i], sizes[i]);
+		}
+	}
+}
+
+TEST_CASE("[SmallAllocator] Blocks allocated and freed from many threads stay intact") {
+	const int thread_count = CLAMP(OS::get_singleton()->get_processor_count(), 2, 16);
+
+	ChurnData data;
+	data.iterations = 100000;
+
+	Thread threads[16];
+	for (int i = 0; i < thread_count; i++) {
+		threads[i].start(churn_thread, &data);
+	}
+	for (int i = 0; i < thread_count; i++) {
+		threads[i].wait_to_finish();
+	}
+
+	CHECK_MESSAGE(data.corrupted_blocks.get() == 0, "Blocks handed out to different threads must not overlap.");
+}
+
+} // namespace TestSmallAllocator
+
+#endif // TEST_SMALL_ALLOCATOR_H
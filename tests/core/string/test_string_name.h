@@ -0,0 +1,112 @@
+/*************************************************************************/
+/*  test_string_name.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_STRING_NAME_H
+#define TEST_STRING_NAME_H
+
+#include "core/os/thread.h"
+#include "core/string/string_name.h"
+
+#include "tests/test_macros.h"
+
+namespace TestStringName {
+
+TEST_CASE("[StringName] Interning and search") {
+	StringName a = String("test_string_name_interning");
+	StringName b = "test_string_name_interning";
+	CHECK(a == b);
+	CHECK(a.data_unique_pointer() == b.data_unique_pointer());
+	CHECK(StringName::search(String("test_string_name_interning")) == a);
+	CHECK(StringName::search(U"test_string_name_interning") == a);
+
+	a = StringName();
+	b = StringName();
+	CHECK_MESSAGE(StringName::search("test_string_name_interning") == StringName(), "Names should be removed once no longer referenced.");
+}
+
+struct InternData {
+	Vector<String> names;
+	int rounds = 0;
+	const void *pointers[8][64] = {};
+	SafeNumeric<uint32_t> next_thread;
+};
+
+static void intern_thread(void *p_arg) {
+	InternData *data = (InternData *)p_arg;
+	uint32_t thread = data->next_thread.postincrement();
+	for (int round = 0; round < data->rounds; round++) {
+		// Half of the names are released every round, so adding and removing race with searching.
+		Vector<StringName> kept;
+		for (int i = 0; i < data->names.size(); i++) {
+			StringName name = data->names[(i + thread) % data->names.size()];
+			if ((i + round) % 2 == 0) {
+				kept.push_back(name);
+			}
+		}
+	}
+	for (int i = 0; i < 64 && i < data->names.size(); i++) {
+		StringName name = data->names[i];
+		data->pointers[thread][i] = name.data_unique_pointer();
+	}
+}
+
+TEST_CASE("[StringName] Interning from several threads") {
+	InternData data;
+	for (int i = 0; i < 64; i++) {
+		data.names.push_back(vformat("test_string_name_thread_%d", i));
+	}
+	data.rounds = 200;
+
+	// Hold the names while checking, so the threads' pointers are comparable.
+	Vector<StringName> held;
+	for (int i = 0; i < data.names.size(); i++) {
+		held.push_back(data.names[i]);
+	}
+
+	Thread threads[8];
+	for (int i = 0; i < 8; i++) {
+		threads[i].start(intern_thread, &data);
+	}
+	for (int i = 0; i < 8; i++) {
+		threads[i].wait_to_finish();
+	}
+
+	bool all_match = true;
+	for (int i = 0; i < 8; i++) {
+		for (int j = 0; j < 64; j++) {
+			all_match = all_match && data.pointers[i][j] == held[j].data_unique_pointer();
+		}
+	}
+	CHECK_MESSAGE(all_match, "Every thread must get the same entry for a name.");
+}
+
+} // namespace TestStringName
+
+#endif // TEST_STRING_NAME_H
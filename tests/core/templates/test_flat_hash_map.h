@@ -0,0 +1,189 @@
+/*************************************************************************/
+/*  test_flat_hash_map.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_FLAT_HASH_MAP_H
+#define TEST_FLAT_HASH_MAP_H
+
+#include "core/math/random_pcg.h"
+#include "core/string/string_name.h"
+#include "core/templates/flat_hash_map.h"
+#include "core/templates/hash_map.h"
+
+#include "tests/test_macros.h"
+
+namespace TestFlatHashMap {
+
+TEST_CASE("[FlatHashMap] Insert element") {
+	FlatHashMap<int, int> map;
+	FlatHashMap<int, int>::Iterator e = map.insert(42, 84);
+
+	CHECK(e);
+	CHECK(e->key == 42);
+	CHECK(e->value == 84);
+	CHECK(map[42] == 84);
+	CHECK(map.has(42));
+	CHECK(map.find(42));
+	CHECK_FALSE(map.find(43));
+}
+
+TEST_CASE("[FlatHashMap] Overwrite element") {
+	FlatHashMap<int, int> map;
+	map.insert(42, 84);
+	map.insert(42, 1234);
+
+	CHECK(map[42] == 1234);
+	CHECK(map.size() == 1);
+}
+
+TEST_CASE("[FlatHashMap] Erase via element and key") {
+	FlatHashMap<int, int> map;
+	FlatHashMap<int, int>::Iterator e = map.insert(42, 84);
+	map.insert(43, 86);
+	map.remove(e);
+	CHECK(!map.has(42));
+	CHECK(!map.find(42));
+
+	CHECK(map.erase(43));
+	CHECK_FALSE(map.erase(43));
+	CHECK(map.is_empty());
+}
+
+TEST_CASE("[FlatHashMap] Iteration visits each element once") {
+	FlatHashMap<int, int> map;
+	for (int i = 0; i < 1000; i++) {
+		map.insert(i, i * 2);
+	}
+	for (int i = 0; i < 1000; i += 3) {
+		map.erase(i);
+	}
+
+	int count = 0;
+	int64_t key_sum = 0;
+	bool values_match = true;
+	for (const KeyValue<int, int> &E : map) {
+		count++;
+		key_sum += E.key;
+		values_match = values_match && E.value == E.key * 2 && E.key % 3 != 0;
+	}
+	CHECK(count == 666);
+	CHECK(count == (int)map.size());
+	CHECK(values_match);
+
+	int64_t expected_sum = 0;
+	for (int i = 0; i < 1000; i++) {
+		expected_sum += i % 3 != 0 ? i : 0;
+	}
+	CHECK(key_sum == expected_sum);
+
+	// Erasing while iterating is allowed.
+	for (FlatHashMap<int, int>::Iterator E = map.begin(); E; ++E) {
+		map.remove(E);
+	}
+	CHECK(map.is_empty());
+	CHECK(map.begin() == map.end());
+}
+
+TEST_CASE("[FlatHashMap] Same contents as HashMap after many insertions and erasures") {
+	FlatHashMap<uint32_t, uint32_t> map;
+	HashMap<uint32_t, uint32_t> reference;
+	RandomPCG rng(1234);
+
+	// A small key range, so erasures leave many deleted entries to be reused and cleaned up.
+	for (int i = 0; i < 100000; i++) {
+		uint32_t key = rng.rand() % 512;
+		if (rng.rand() % 3 == 0) {
+			CHECK(map.erase(key) == reference.erase(key));
+		} else {
+			map[key] = i;
+			reference[key] = i;
+		}
+	}
+
+	CHECK(map.size() == reference.size());
+	CHECK(map.get_capacity() <= 1024);
+	bool same = true;
+	for (const KeyValue<uint32_t, uint32_t> &E : reference) {
+		const uint32_t *value = map.getptr(E.key);
+		same = same && value && *value == E.value;
+	}
+	CHECK(same);
+}
+
+TEST_CASE("[FlatHashMap] Copy, reserve and clear") {
+	FlatHashMap<StringName, String> map;
+	map.reserve(100);
+	const uint32_t capacity = map.get_capacity();
+	for (int i = 0; i < 100; i++) {
+		map.insert(StringName(itos(i)), itos(i * 2));
+	}
+	CHECK(map.get_capacity() == capacity);
+
+	const FlatHashMap<StringName, String> copy = map;
+	CHECK(copy.size() == 100);
+	CHECK(copy[StringName("50")] == "100");
+	CHECK(copy.find(StringName("99"))->value == "198");
+
+	map.clear();
+	CHECK(map.is_empty());
+	CHECK(!map.has(StringName("50")));
+	CHECK(copy.has(StringName("50")));
+}
+
+TEST_CASE("[FlatHashMap] Same contents as HashMap with random insertions and erasures") {
+	const int count = 100000;
+
+	FlatHashMap<uint32_t, uint32_t> flat_map;
+	HashMap<uint32_t, uint32_t> hash_map;
+	RandomPCG rng(42);
+	for (int i = 0; i < count; i++) {
+		uint32_t key = rng.rand() % (count * 2);
+		if (i % 4 == 3) {
+			// Erasing leaves tombstones that later probes must skip.
+			CHECK(flat_map.erase(key) == hash_map.erase(key));
+		} else {
+			flat_map[key] = i;
+			hash_map[key] = i;
+		}
+	}
+
+	CHECK(flat_map.size() == hash_map.size());
+	bool same = true;
+	for (uint32_t key = 0; key < uint32_t(count * 2); key++) {
+		const uint32_t *flat_value = flat_map.getptr(key);
+		const uint32_t *hash_value = hash_map.getptr(key);
+		same = same && (flat_value == nullptr) == (hash_value == nullptr);
+		same = same && (flat_value == nullptr || *flat_value == *hash_value);
+	}
+	CHECK_MESSAGE(same, "Every key must map to the same value as in HashMap.");
+}
+
+} // namespace TestFlatHashMap
+
+#endif // TEST_FLAT_HASH_MAP_H
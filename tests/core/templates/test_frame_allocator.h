@@ -0,0 +1,104 @@
+/*************************************************************************/
+/*  test_frame_allocator.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_FRAME_ALLOCATOR_H
+#define TEST_FRAME_ALLOCATOR_H
+
+#include "core/os/thread.h"
+#include "core/templates/frame_allocator.h"
+
+#include "thirdparty/doctest/doctest.h"
+
+namespace TestFrameAllocator {
+
+TEST_CASE("[FrameAllocator] FrameLocalVector push back and remove") {
+	FrameLocalVector<int> first;
+	FrameLocalVector<int> second;
+	for (int i = 0; i < 10000; i++) {
+		first.push_back(i);
+		second.push_back(-i);
+	}
+	first.remove_at(0);
+
+	CHECK(first.size() == 9999);
+	CHECK(second.size() == 10000);
+	bool all_match = true;
+	for (int i = 0; i < 9999; i++) {
+		all_match = all_match && first[i] == i + 1 && second[i] == -i;
+	}
+	CHECK_MESSAGE(all_match, "Interleaved growth must keep the contents of both vectors.");
+}
+
+TEST_CASE("[FrameAllocator] Memory is reused once freed") {
+	void *first = FrameAllocator::alloc(64);
+	FrameAllocator::free(first);
+	void *second = FrameAllocator::alloc(64);
+	CHECK_MESSAGE(first == second, "Freeing the most recent allocation should give its memory back.");
+
+	void *grown = FrameAllocator::realloc(second, 1024);
+	CHECK_MESSAGE(grown == second, "The most recent allocation should grow in place.");
+	CHECK(uint64_t(grown) % FrameAllocator::ALIGNMENT == 0);
+	FrameAllocator::free(grown);
+
+	size_t reserved = FrameAllocator::get_thread_reserved_bytes();
+	for (int frame = 0; frame < 10; frame++) {
+		FrameLocalVector<uint64_t> scratch;
+		scratch.resize(1000);
+		FrameAllocator::advance_frame();
+	}
+	CHECK_MESSAGE(FrameAllocator::get_thread_reserved_bytes() <= reserved, "Transient allocations should not make the arena grow across frames.");
+}
+
+static void static_alloc_thread(void *p_arg) {
+	void **ptrs = (void **)p_arg;
+	for (int i = 0; i < 100; i++) {
+		ptrs[i] = FrameAllocator::alloc(100 + i);
+		memset(ptrs[i], i, 100 + i);
+	}
+}
+
+TEST_CASE("[FrameAllocator] Freeing from another thread after the owner exited") {
+	void *ptrs[100];
+	Thread thread;
+	thread.start(static_alloc_thread, ptrs);
+	thread.wait_to_finish();
+
+	bool all_match = true;
+	for (int i = 0; i < 100; i++) {
+		const uint8_t *bytes = (const uint8_t *)ptrs[i];
+		all_match = all_match && bytes[0] == i && bytes[99 + i] == i;
+		FrameAllocator::free(ptrs[i]);
+	}
+	CHECK_MESSAGE(all_match, "Allocations must stay valid after the thread that made them exits.");
+}
+
+} // namespace TestFrameAllocator
+
+#endif // TEST_FRAME_ALLOCATOR_H
@@ -0,0 +1,99 @@
+/*************************************************************************/
+/*  test_owned_vector.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_OWNED_VECTOR_H
+#define TEST_OWNED_VECTOR_H
+
+#include "core/templates/owned_vector.h"
+
+#include "tests/test_macros.h"
+
+namespace TestOwnedVector {
+
+TEST_CASE("[OwnedVector] Push back and remove") {
+	OwnedVector<int> vector;
+	for (int i = 0; i < 100; i++) {
+		vector.push_back(i);
+	}
+	vector.remove_at(0);
+
+	CHECK(vector.size() == 99);
+	CHECK(vector[0] == 1);
+	CHECK(vector[98] == 99);
+	CHECK(vector.has(50));
+	CHECK_FALSE(vector.has(0));
+
+	int sum = 0;
+	for (int value : vector) {
+		sum += value;
+	}
+	CHECK(sum == 4950);
+}
+
+TEST_CASE("[OwnedVector] Conversions from and to Vector don't copy") {
+	Vector<float> vector = { 1, 2, 3 };
+	const float *data = vector.ptr();
+
+	OwnedVector<float> owned = OwnedVector<float>::take(vector);
+	CHECK(vector.is_empty());
+	CHECK_MESSAGE(owned.ptr() == data, "Unshared data should be adopted as is.");
+	owned[1] = 5;
+
+	Vector<float> released = owned.release();
+	CHECK(owned.is_empty());
+	CHECK_MESSAGE(released.ptr() == data, "Data should be handed over as is.");
+	CHECK(released == Vector<float>({ 1, 5, 3 }));
+}
+
+TEST_CASE("[OwnedVector] Shared data is copied") {
+	Vector<float> vector = { 1, 2, 3 };
+	Vector<float> shared = vector;
+
+	OwnedVector<float> owned = OwnedVector<float>::take(vector);
+	CHECK(owned.ptr() != shared.ptr());
+	owned[0] = 10;
+	CHECK_MESSAGE(shared[0] == 1, "Writing must not affect other Vectors.");
+
+	OwnedVector<float> copy = owned;
+	copy[0] = 20;
+	CHECK(owned[0] == 10);
+
+	OwnedVector<float> moved = std::move(copy);
+	CHECK(copy.is_empty());
+	CHECK(moved[0] == 20);
+
+	Vector<float> copied = moved.to_vector();
+	CHECK(copied.ptr() != moved.ptr());
+	CHECK(copied == Vector<float>({ 20, 2, 3 }));
+}
+
+} // namespace TestOwnedVector
+
+#endif // TEST_OWNED_VECTOR_H
@@ -153,6 +153,149 @@ TEST_CASE("[WorkerThreadPool] Process 256 elements on native task group low prio
 	CHECK(callable_group_counter.get() == count - 1);
 }
 
+struct DependencyTestData {
+	SafeNumeric<uint32_t> sequence;
+	uint32_t order[4] = {};
+	SafeNumeric<uint32_t> group_counter;
+};
+
+template <int N>
+static void static_dependency_test(void *p_arg) {
+	DependencyTestData *data = (DependencyTestData *)p_arg;
+	data->order[N] = data->sequence.increment();
+}
+
+static void static_dependency_group_test(void *p_arg, uint32_t p_index) {
+	DependencyTestData *data = (DependencyTestData *)p_arg;
+	data->group_counter.increment();
+}
+
+TEST_CASE("[WorkerThreadPool] Dependent tasks run after their dependencies") {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	DependencyTestData data;
+
+	// Chain, where each task is a continuation of the previous one.
+	WorkerThreadPool::TaskID first = pool->add_native_task(static_dependency_test<0>, &data, true);
+	Vector<WorkerThreadPool::TaskID> dependencies;
+	dependencies.push_back(first);
+	WorkerThreadPool::TaskID second = pool->add_native_dependent_task(static_dependency_test<1>, &data, dependencies, true);
+
+	// Group depending on the chain.
+	dependencies.clear();
+	dependencies.push_back(second);
+	WorkerThreadPool::GroupID group = pool->add_native_dependent_group_task(static_dependency_group_test, &data, 256, dependencies, -1, true);
+
+	// Diamond join of the group and the first task.
+	dependencies.clear();
+	dependencies.push_back(group);
+	dependencies.push_back(first);
+	WorkerThreadPool::TaskID last = pool->add_native_dependent_task(static_dependency_test<2>, &data, dependencies, true);
+
+	pool->wait_for_task_completion(last);
+	CHECK(data.group_counter.get() == 256);
+	CHECK(data.order[0] == 1);
+	CHECK(data.order[1] == 2);
+	CHECK(data.order[2] == 3);
+
+	pool->wait_for_group_task_completion(group);
+	pool->wait_for_task_completion(second);
+	pool->wait_for_task_completion(first);
+}
+
+TEST_CASE("[WorkerThreadPool] Dependent tasks on already completed tasks") {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	DependencyTestData data;
+
+	WorkerThreadPool::TaskID first = pool->add_native_task(static_dependency_test<0>, &data, true);
+	pool->wait_for_task_completion(first);
+
+	// The dependency was already waited for and released, so this runs right away.
+	Vector<WorkerThreadPool::TaskID> dependencies;
+	dependencies.push_back(first);
+	WorkerThreadPool::TaskID second = pool->add_native_dependent_task(static_dependency_test<1>, &data, dependencies, false);
+	pool->wait_for_task_completion(second);
+
+	CHECK(data.order[0] == 1);
+	CHECK(data.order[1] == 2);
+}
+
+struct NestedTaskData {
+	WorkerThreadPool *pool = nullptr;
+	SafeNumeric<uint32_t> counter;
+	int children = 0;
+};
+
+static void static_nested_test(void *p_arg) {
+	NestedTaskData *data = (NestedTaskData *)p_arg;
+	// Tasks posted from a worker go to its own queue, the other workers must steal them.
+	LocalVector<WorkerThreadPool::TaskID> tasks;
+	for (int i = 0; i < data->children; i++) {
+		tasks.push_back(data->pool->add_native_task(static_test, &data->counter, true));
+	}
+	for (uint32_t i = 0; i < tasks.size(); i++) {
+		data->pool->wait_for_task_completion(tasks[i]);
+	}
+}
+
+TEST_CASE("[WorkerThreadPool] Process tasks posted from worker threads") {
+	const int count = 16;
+	NestedTaskData data;
+	data.pool = WorkerThreadPool::get_singleton();
+	data.children = 64;
+	WorkerThreadPool::TaskID tasks[count];
+	for (int i = 0; i < count; i++) {
+		tasks[i] = WorkerThreadPool::get_singleton()->add_native_task(static_nested_test, &data, true);
+	}
+	for (int i = 0; i < count; i++) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(tasks[i]);
+	}
+
+	CHECK(data.counter.get() == count * data.children);
+}
+
+TEST_CASE("[WorkerThreadPool] Process tasks with any number of threads") {
+	const int count = 4096;
+	const int fan_out = 64;
+
+	LocalVector<int> thread_counts;
+	int max_threads = OS::get_singleton()->get_processor_count();
+	for (int i = 1; i < max_threads; i *= 2) {
+		thread_counts.push_back(i);
+	}
+	thread_counts.push_back(max_threads);
+
+	for (uint32_t t = 0; t < thread_counts.size(); t++) {
+		WorkerThreadPool *pool = memnew(WorkerThreadPool);
+		pool->init(thread_counts[t]);
+
+		// Tasks posted from outside the pool.
+		SafeNumeric<uint32_t> counter;
+		LocalVector<WorkerThreadPool::TaskID> tasks;
+		tasks.resize(count);
+		for (int i = 0; i < count; i++) {
+			tasks[i] = pool->add_native_task(static_test, &counter, true);
+		}
+		for (int i = 0; i < count; i++) {
+			pool->wait_for_task_completion(tasks[i]);
+		}
+		CHECK(counter.get() == count);
+
+		// Tasks posted from workers, fanning out through their own queues.
+		NestedTaskData data;
+		data.pool = pool;
+		data.children = fan_out;
+		for (int i = 0; i < count / fan_out; i++) {
+			tasks[i] = pool->add_native_task(static_nested_test, &data, true);
+		}
+		for (int i = 0; i < count / fan_out; i++) {
+			pool->wait_for_task_completion(tasks[i]);
+		}
+		CHECK(data.counter.get() == count);
+
+		memdelete(pool);
+	}
+}
+
 } // namespace TestWorkerThreadPool
 
 #endif // TEST_WORKER_THREAD_POOL_H
@@ -126,6 +126,53 @@ TEST_CASE("[Variant] Writer and parser Variant::FLOAT") {
 	CHECK_MESSAGE(float_parsed == 1.0e+100, "Should match the double literal.");
 }
 
+static Variant parse_from_buffer(const String &p_text, int &r_line) {
+	CharString utf8 = p_text.utf8();
+	VariantParser::StreamBuffer sb;
+	sb.data = (const uint8_t *)utf8.get_data();
+	sb.length = utf8.length();
+
+	String errs;
+	Variant parsed;
+	r_line = 1;
+	Error err = VariantParser::parse(&sb, parsed, errs, r_line);
+	CHECK_MESSAGE(err == OK, errs);
+	return parsed;
+}
+
+TEST_CASE("[Variant] Parser packed arrays from memory") {
+	int line = 0;
+	PackedVector3Array vectors;
+	vectors.push_back(Vector3(1, -2.5, 300));
+	vectors.push_back(Vector3(4, 5, 0.125));
+	CHECK(parse_from_buffer("PackedVector3Array(1, -2.5, 3e2,\n4, 5 ,1.25e-1)", line) == Variant(vectors));
+	CHECK_MESSAGE(line == 2, "Line breaks between the numbers should be counted.");
+
+	CHECK(parse_from_buffer("PackedFloat32Array()", line) == Variant(PackedFloat32Array()));
+	CHECK(parse_from_buffer("PackedInt32Array( 7 )", line) == Variant(PackedInt32Array({ 7 })));
+
+	// Anything but plain numbers goes through the tokenizer, which carries on from the last number parsed in bulk.
+	const String mixed = "PackedFloat32Array(1, 2, inf, ; comment\n3, inf_neg\n)";
+	VariantParser::StreamString ss;
+	ss.s = mixed;
+	String errs;
+	int string_line = 1;
+	Variant from_string;
+	CHECK(VariantParser::parse(&ss, from_string, errs, string_line) == OK);
+	CHECK(parse_from_buffer(mixed, line) == from_string);
+	CHECK(line == string_line);
+	CHECK(PackedFloat32Array(from_string).size() == 5);
+
+	// Mismatches are still reported.
+	CharString broken = String("PackedFloat32Array(1, 2 x)").utf8();
+	VariantParser::StreamBuffer sb;
+	sb.data = (const uint8_t *)broken.get_data();
+	sb.length = broken.length();
+	Variant parsed;
+	line = 1;
+	CHECK(VariantParser::parse(&sb, parsed, errs, line) == ERR_PARSE_ERROR);
+}
+
 TEST_CASE("[Variant] Assignment To Bool from Int,Float,String,Vec2,Vec2i,Vec3,Vec3i and Color") {
 	Variant int_v = 0;
 	Variant bool_v = true;
@@ -0,0 +1,107 @@
+/*************************************************************************/
+/*  test_mesh_library.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_MESH_LIBRARY_H
+#define TEST_MESH_LIBRARY_H
+
+#include "core/config/project_settings.h"
+#include "core/io/resource_loader.h"
+#include "core/io/resource_saver.h"
+#include "core/os/os.h"
+#include "scene/resources/mesh_library.h"
+#include "scene/resources/primitive_meshes.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMeshLibrary {
+
+// Saves a library where item i uses a mesh with the "Mesh_i" ID.
+static void _save_mesh_library(const String &p_path, int p_items) {
+	Ref<SphereMesh> sphere = memnew(SphereMesh);
+	sphere->set_radial_segments(32);
+	sphere->set_rings(16);
+	Array arrays = sphere->get_mesh_arrays();
+
+	Ref<MeshLibrary> library = memnew(MeshLibrary);
+	for (int i = 0; i < p_items; i++) {
+		Ref<ArrayMesh> mesh = memnew(ArrayMesh);
+		mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+		mesh->set_scene_unique_id(vformat("Mesh_%d", i));
+		library->create_item(i);
+		library->set_item_name(i, vformat("Item %d", i));
+		library->set_item_mesh(i, mesh);
+	}
+	REQUIRE(ResourceSaver::save(library, p_path) == OK);
+}
+
+TEST_CASE("[SceneTree][MeshLibrary] Loading the meshes of single items") {
+	const String path = OS::get_singleton()->get_cache_path().path_join("mesh_library.res");
+	_save_mesh_library(path, 8);
+	const String local_path = ProjectSettings::get_singleton()->localize_path(path);
+
+	Ref<ArrayMesh> mesh = ResourceLoader::load(path + "::Mesh_3");
+	REQUIRE(mesh.is_valid());
+	CHECK(mesh->get_surface_count() == 1);
+	CHECK(mesh->get_scene_unique_id() == "Mesh_3");
+	CHECK_MESSAGE(!ResourceCache::has(local_path), "The library itself should not have been loaded.");
+	CHECK_MESSAGE(!ResourceCache::has(local_path + "::Mesh_4"), "Other items should not have been loaded.");
+
+	ERR_PRINT_OFF;
+	CHECK(ResourceLoader::load(path + "::Mesh_100").is_null());
+	ERR_PRINT_ON;
+
+	// Loading the whole library later reuses what was loaded already.
+	Ref<MeshLibrary> library = ResourceLoader::load(path);
+	REQUIRE(library.is_valid());
+	CHECK(library->get_item_list().size() == 8);
+	CHECK(library->get_item_mesh(3) == mesh);
+	CHECK(library->get_item_mesh(4).is_valid());
+}
+
+TEST_CASE("[SceneTree][MeshLibrary] Loading a few items of a large library") {
+	const String path = OS::get_singleton()->get_cache_path().path_join("mesh_library_large.res");
+	const int item_count = 200;
+	const int used_count = 20;
+	_save_mesh_library(path, item_count);
+
+	// Items spread over the whole file, including the last one.
+	for (int i = 1; i <= used_count; i++) {
+		const String id = vformat("Mesh_%d", i * (item_count / used_count) - 1);
+		Ref<ArrayMesh> mesh = ResourceLoader::load(path + "::" + id, "", ResourceFormatLoader::CACHE_MODE_IGNORE);
+		REQUIRE(mesh.is_valid());
+		CHECK(mesh->get_scene_unique_id() == id);
+		CHECK(mesh->get_surface_count() == 1);
+	}
+	CHECK_MESSAGE(!ResourceCache::has(ProjectSettings::get_singleton()->localize_path(path)), "The library itself should not have been loaded.");
+}
+
+} // namespace TestMeshLibrary
+
+#endif // TEST_MESH_LIBRARY_H
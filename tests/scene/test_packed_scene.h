@@ -0,0 +1,161 @@
+/*************************************************************************/
+/*  test_packed_scene.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_PACKED_SCENE_H
+#define TEST_PACKED_SCENE_H
+
+#include "scene/2d/node_2d.h"
+#include "scene/resources/packed_scene.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPackedScene {
+
+// A root with two instances of a small sub-scene, a Node2D with a child.
+static Ref<PackedScene> _create_scene_with_sub_scenes() {
+	Node2D *sub_root = memnew(Node2D);
+	sub_root->set_name("SubRoot");
+	sub_root->set_position(Vector2(10, 20));
+	Node *leaf = memnew(Node);
+	leaf->set_name("Leaf");
+	sub_root->add_child(leaf);
+	leaf->set_owner(sub_root);
+
+	Ref<PackedScene> sub_scene = memnew(PackedScene);
+	sub_scene->pack(sub_root);
+	memdelete(sub_root);
+
+	Ref<PackedScene> scene = memnew(PackedScene);
+	Ref<SceneState> state = scene->get_state();
+	int sub_scene_value = state->add_value(sub_scene);
+	int root = state->add_node(-1, -1, state->add_name("Node"), state->add_name("Root"), -1, -1);
+	state->add_node(root, root, SceneState::TYPE_INSTANCED, state->add_name("A"), sub_scene_value, -1);
+	state->add_node(root, root, SceneState::TYPE_INSTANCED, state->add_name("B"), sub_scene_value, -1);
+	return scene;
+}
+
+static void _check_scene_with_sub_scenes(Node *p_root) {
+	REQUIRE(p_root);
+	CHECK(p_root->get_name() == "Root");
+	REQUIRE(p_root->get_child_count() == 2);
+	CHECK(p_root->get_child(0)->get_name() == "A");
+	CHECK(p_root->get_child(1)->get_name() == "B");
+	for (int i = 0; i < 2; i++) {
+		Node2D *sub_root = Object::cast_to<Node2D>(p_root->get_child(i));
+		REQUIRE(sub_root);
+		CHECK(sub_root->get_position() == Vector2(10, 20));
+		CHECK(sub_root->get_owner() == p_root);
+		CHECK(sub_root->get_node_or_null(NodePath("Leaf")) != nullptr);
+	}
+}
+
+TEST_CASE("[PackedScene] Instantiation with sub-scenes") {
+	Ref<PackedScene> scene = _create_scene_with_sub_scenes();
+
+	Node *root = scene->instantiate();
+	_check_scene_with_sub_scenes(root);
+	memdelete(root);
+}
+
+TEST_CASE("[PackedScene] Threaded instantiation") {
+	Ref<PackedScene> scene = _create_scene_with_sub_scenes();
+
+	WorkerThreadPool::TaskID task_a = scene->instantiate_threaded_request();
+	WorkerThreadPool::TaskID task_b = scene->instantiate_threaded_request();
+	REQUIRE(task_a != WorkerThreadPool::INVALID_TASK_ID);
+	REQUIRE(task_b != WorkerThreadPool::INVALID_TASK_ID);
+
+	Node *root_b = scene->instantiate_threaded_get(task_b);
+	Node *root_a = scene->instantiate_threaded_get(task_a);
+	CHECK(root_a != root_b);
+	_check_scene_with_sub_scenes(root_a);
+	_check_scene_with_sub_scenes(root_b);
+	memdelete(root_a);
+	memdelete(root_b);
+
+	ERR_PRINT_OFF;
+	CHECK_MESSAGE(scene->instantiate_threaded_get(task_a) == nullptr, "A request can only be picked up once.");
+	ERR_PRINT_ON;
+}
+
+// A root with many Node2D children, each with a few properties set.
+static Ref<PackedScene> _create_scene_with_properties(int p_children) {
+	Node *root = memnew(Node);
+	root->set_name("Root");
+	for (int i = 0; i < p_children; i++) {
+		Node2D *child = memnew(Node2D);
+		child->set_name(vformat("Child%d", i));
+		child->set_position(Vector2(i, -i));
+		child->set_rotation(0.5);
+		child->set_scale(Vector2(2, 3));
+		child->set_z_index(i % 8);
+		root->add_child(child);
+		child->set_owner(root);
+	}
+
+	Ref<PackedScene> scene = memnew(PackedScene);
+	scene->pack(root);
+	memdelete(root);
+	return scene;
+}
+
+TEST_CASE("[PackedScene] Repeated instantiation") {
+	Ref<PackedScene> scene = _create_scene_with_properties(4);
+
+	for (int i = 0; i < 3; i++) {
+		Node *root = scene->instantiate();
+		REQUIRE(root != nullptr);
+		CHECK(root->get_child_count() == 4);
+		Node2D *child = Object::cast_to<Node2D>(root->get_child(3));
+		REQUIRE(child != nullptr);
+		CHECK(child->get_position().is_equal_approx(Vector2(3, -3)));
+		CHECK(child->get_rotation() == doctest::Approx(0.5));
+		CHECK(child->get_scale().is_equal_approx(Vector2(2, 3)));
+		CHECK(child->get_z_index() == 3);
+		memdelete(root);
+	}
+
+	SUBCASE("Changing the state after instantiating is picked up") {
+		Ref<SceneState> state = scene->get_state();
+		state->add_node_property(1, state->add_name("visible"), state->add_value(false));
+
+		Node *root = scene->instantiate();
+		REQUIRE(root != nullptr);
+		Node2D *child = Object::cast_to<Node2D>(root->get_child(0));
+		REQUIRE(child != nullptr);
+		CHECK_FALSE(child->is_visible());
+		CHECK(child->get_position().is_equal_approx(Vector2(0, 0)));
+		memdelete(root);
+	}
+}
+
+} // namespace TestPackedScene
+
+#endif // TEST_PACKED_SCENE_H